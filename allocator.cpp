@@ -0,0 +1,475 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "allocator.h"
+#include "imgui.h"
+#include "vkutils.h"
+
+namespace engine {
+
+    // Every host allocation is preceded by this header, it keeps the blocks 16 byte aligned
+    struct host_allocation_header {
+        uint64_t size;
+        uint32_t offset;        // Distance from the malloc'ed base to the returned pointer
+        uint16_t sizeClass;     // Pool index or host_unpooled
+        uint16_t scope;
+    };
+    static_assert(sizeof(host_allocation_header) == 16, "host allocation header has to keep 16 byte alignment");
+
+    static const uint16_t host_unpooled = 0xffff;
+    static const size_t host_min_pooled_size = 16;
+    static const size_t host_chunk_size = 64 * 1024;
+
+    static size_t host_size_class(size_t size) {
+        size_t sizeClass = 0;
+        while ((host_min_pooled_size << sizeClass) < size)
+            sizeClass++;
+        return sizeClass;
+    }
+
+    hostAllocator::hostAllocator() {
+        m_callbacks.pUserData = this;
+        m_callbacks.pfnAllocation = allocate;
+        m_callbacks.pfnReallocation = reallocate;
+        m_callbacks.pfnFree = release;
+        m_callbacks.pfnInternalAllocation = internalAllocate;
+        m_callbacks.pfnInternalFree = internalRelease;
+        m_freeLists.resize(host_size_class(maxPooledSize) + 1, nullptr);
+    }
+
+    hostAllocator::~hostAllocator() {
+        for (void *chunk: m_chunks)
+            std::free(chunk);
+    }
+
+    hostMemoryStatistics hostAllocator::stats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    void *hostAllocator::allocate(void *userData, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+        auto self = (hostAllocator *) userData;
+        std::lock_guard<std::mutex> lock(self->m_mutex);
+        return self->allocateLocked(size, alignment, scope);
+    }
+
+    void *hostAllocator::reallocate(void *userData, void *original, size_t size, size_t alignment,
+                                    VkSystemAllocationScope scope) {
+        auto self = (hostAllocator *) userData;
+        std::lock_guard<std::mutex> lock(self->m_mutex);
+        if (original == nullptr)
+            return self->allocateLocked(size, alignment, scope);
+        if (size == 0) {
+            self->releaseLocked(original);
+            return nullptr;
+        }
+        // The original allocation has to stay intact if the new one fails
+        void *memory = self->allocateLocked(size, alignment, scope);
+        if (memory == nullptr)
+            return nullptr;
+        auto header = (const host_allocation_header *) original - 1;
+        memcpy(memory, original, std::min<size_t>(size, (size_t) header->size));
+        self->releaseLocked(original);
+        return memory;
+    }
+
+    void hostAllocator::release(void *userData, void *memory) {
+        if (memory == nullptr)
+            return;
+        auto self = (hostAllocator *) userData;
+        std::lock_guard<std::mutex> lock(self->m_mutex);
+        self->releaseLocked(memory);
+    }
+
+    void hostAllocator::internalAllocate(void *userData, size_t size, VkInternalAllocationType,
+                                         VkSystemAllocationScope) {
+        auto self = (hostAllocator *) userData;
+        std::lock_guard<std::mutex> lock(self->m_mutex);
+        self->m_stats.internalBytes += size;
+    }
+
+    void hostAllocator::internalRelease(void *userData, size_t size, VkInternalAllocationType,
+                                        VkSystemAllocationScope) {
+        auto self = (hostAllocator *) userData;
+        std::lock_guard<std::mutex> lock(self->m_mutex);
+        self->m_stats.internalBytes -= std::min<uint64_t>(size, self->m_stats.internalBytes);
+    }
+
+    void *hostAllocator::allocateLocked(size_t size, size_t alignment, VkSystemAllocationScope scope) {
+        if (size == 0)
+            return nullptr;
+        auto header_size = sizeof(host_allocation_header);
+        host_allocation_header *header;
+        if (size <= maxPooledSize && alignment <= header_size) {
+            size_t size_class = host_size_class(size);
+            size_t block_size = header_size + (host_min_pooled_size << size_class);
+            if (m_freeLists[size_class] == nullptr) {
+                // Carve a new chunk into blocks and thread them onto the free list
+                auto chunk = (uint8_t *) std::malloc(host_chunk_size);
+                if (chunk == nullptr)
+                    return nullptr;
+                m_chunks.push_back(chunk);
+                m_stats.poolBytes += host_chunk_size;
+                for (size_t offset = 0; offset + block_size <= host_chunk_size; offset += block_size) {
+                    *(void **) (chunk + offset) = m_freeLists[size_class];
+                    m_freeLists[size_class] = chunk + offset;
+                }
+            }
+            void *block = m_freeLists[size_class];
+            m_freeLists[size_class] = *(void **) block;
+            header = (host_allocation_header *) block;
+            header->offset = 0;
+            header->sizeClass = (uint16_t) size_class;
+        } else {
+            alignment = std::max(alignment, header_size);
+            auto base = (uint8_t *) std::malloc(size + alignment + header_size);
+            if (base == nullptr)
+                return nullptr;
+            auto address = ((uintptr_t) base + header_size + alignment - 1) & ~(uintptr_t) (alignment - 1);
+            header = (host_allocation_header *) address - 1;
+            header->offset = (uint32_t) (address - (uintptr_t) base);
+            header->sizeClass = host_unpooled;
+        }
+        header->size = size;
+        header->scope = (uint16_t) scope;
+
+        hostScopeStatistics &scope_stats = m_stats.scopes[scope];
+        scope_stats.currentBytes += size;
+        scope_stats.peakBytes = std::max(scope_stats.peakBytes, scope_stats.currentBytes);
+        scope_stats.liveAllocations++;
+        scope_stats.totalAllocations++;
+        m_stats.currentBytes += size;
+        m_stats.peakBytes = std::max(m_stats.peakBytes, m_stats.currentBytes);
+        return header + 1;
+    }
+
+    void hostAllocator::releaseLocked(void *memory) {
+        auto header = (host_allocation_header *) memory - 1;
+        hostScopeStatistics &scope_stats = m_stats.scopes[header->scope];
+        scope_stats.currentBytes -= header->size;
+        scope_stats.liveAllocations--;
+        m_stats.currentBytes -= header->size;
+        if (header->sizeClass == host_unpooled) {
+            std::free((uint8_t *) memory - header->offset);
+        } else {
+            *(void **) header = m_freeLists[header->sizeClass];
+            m_freeLists[header->sizeClass] = header;
+        }
+    }
+
+    void deviceAllocator::create(VkPhysicalDevice physicalDevice, VkDevice device,
+                                 const VkAllocationCallbacks *allocator, VkDeviceSize blockSize) {
+        m_physicalDevice = physicalDevice;
+        m_device = device;
+        m_allocator = allocator;
+        m_blockSize = blockSize;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_memoryProperties);
+    }
+
+    void deviceAllocator::destroy() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        IM_ASSERT(m_dedicated == 0);
+        for (auto &b: m_blocks) {
+            if (b.memory == VK_NULL_HANDLE)
+                continue;
+            IM_ASSERT(b.allocations == 0);
+            if (b.mapped != nullptr)
+                vkUnmapMemory(m_device, b.memory);
+            vkFreeMemory(m_device, b.memory, m_allocator);
+        }
+        m_blocks.clear();
+        m_usedBytes = 0;
+        m_heapDedicated.fill(0);
+        m_heapBuffers.fill(0);
+        m_heapImages.fill(0);
+    }
+
+    VkResult deviceAllocator::allocate(const VkMemoryRequirements &requirements, VkMemoryPropertyFlags required,
+                                       VkMemoryPropertyFlags preferred, bool linear, deviceAllocation &allocation) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Types with the preferred properties first, then every other type that is good enough
+        VkResult err = VK_ERROR_OUT_OF_DEVICE_MEMORY;
+        for (VkMemoryPropertyFlags properties: {required | preferred, required}) {
+            for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; i++) {
+                VkMemoryPropertyFlags flags = m_memoryProperties.memoryTypes[i].propertyFlags;
+                if (!(requirements.memoryTypeBits & (1u << i)) || (flags & properties) != properties)
+                    continue;
+                if (properties == required && (flags & (required | preferred)) == (required | preferred))
+                    continue;   // Already tried in the first pass
+                err = allocateFromType(i, requirements, linear, allocation);
+                if (err == VK_SUCCESS) {
+                    m_allocations++;
+                    m_usedBytes += allocation.size;
+                    (linear ? m_heapBuffers : m_heapImages)[heapOf(i)] += allocation.size;
+                    m_peakUsedBytes = std::max(m_peakUsedBytes, m_usedBytes);
+                    return VK_SUCCESS;
+                }
+            }
+            if (preferred == 0)
+                break;
+        }
+        return err;
+    }
+
+    VkResult deviceAllocator::allocateFromType(uint32_t memoryType, const VkMemoryRequirements &requirements,
+                                               bool linear, deviceAllocation &allocation) {
+        VkResult err;
+        allocation = {};
+        allocation.memoryType = memoryType;
+        allocation.size = requirements.size;
+        allocation.linear = linear;
+
+        // Large resources would mostly waste a block
+        if (requirements.size > m_blockSize / 2) {
+            uint8_t *mapped;
+            err = allocateMemory(memoryType, requirements.size, allocation.memory, mapped);
+            if (err != VK_SUCCESS)
+                return err;
+            allocation.mapped = mapped;
+            m_dedicated++;
+            m_dedicatedBytes += requirements.size;
+            m_heapDedicated[heapOf(memoryType)] += requirements.size;
+            return VK_SUCCESS;
+        }
+
+        size_t free_slot = m_blocks.size();
+        for (size_t i = 0; i < m_blocks.size(); i++) {
+            block &b = m_blocks[i];
+            if (b.memory == VK_NULL_HANDLE) {
+                free_slot = std::min(free_slot, i);
+                continue;
+            }
+            if (b.memoryType != memoryType || b.linear != linear ||
+                !takeRange(b, requirements.size, requirements.alignment, allocation.offset))
+                continue;
+            b.allocations++;
+            allocation.memory = b.memory;
+            allocation.mapped = b.mapped != nullptr ? b.mapped + allocation.offset : nullptr;
+            allocation.block = (uint32_t) i;
+            return VK_SUCCESS;
+        }
+
+        block b;
+        err = allocateMemory(memoryType, m_blockSize, b.memory, b.mapped);
+        if (err != VK_SUCCESS)
+            return err;
+        b.size = m_blockSize;
+        b.memoryType = memoryType;
+        b.linear = linear;
+        b.freeRanges.emplace_back(0, m_blockSize);
+        takeRange(b, requirements.size, requirements.alignment, allocation.offset);
+        b.allocations = 1;
+        if (free_slot == m_blocks.size())
+            m_blocks.push_back(std::move(b));
+        else
+            m_blocks[free_slot] = std::move(b);
+        allocation.memory = m_blocks[free_slot].memory;
+        allocation.mapped = m_blocks[free_slot].mapped != nullptr ? m_blocks[free_slot].mapped + allocation.offset
+                                                                  : nullptr;
+        allocation.block = (uint32_t) free_slot;
+        return VK_SUCCESS;
+    }
+
+    VkResult deviceAllocator::allocateMemory(uint32_t memoryType, VkDeviceSize size, VkDeviceMemory &memory,
+                                             uint8_t *&mapped) {
+        VkMemoryAllocateInfo alloc_info = {};
+        alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        alloc_info.allocationSize = size;
+        alloc_info.memoryTypeIndex = memoryType;
+        VkResult err = vkAllocateMemory(m_device, &alloc_info, m_allocator, &memory);
+        if (err != VK_SUCCESS)
+            return err;
+        m_deviceAllocations++;
+        mapped = nullptr;
+        if (m_memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+            err = vkMapMemory(m_device, memory, 0, VK_WHOLE_SIZE, 0, (void **) &mapped);
+            check_vk_result(err);
+        }
+        return VK_SUCCESS;
+    }
+
+    bool deviceAllocator::takeRange(block &b, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize &offset) {
+        alignment = std::max<VkDeviceSize>(alignment, 1);
+        for (size_t i = 0; i < b.freeRanges.size(); i++) {
+            VkDeviceSize start = b.freeRanges[i].first;
+            VkDeviceSize end = start + b.freeRanges[i].second;
+            VkDeviceSize aligned = (start + alignment - 1) / alignment * alignment;
+            if (aligned + size > end)
+                continue;
+            // Keep the alignment padding in front and the rest behind as separate free ranges
+            b.freeRanges.erase(b.freeRanges.begin() + (ptrdiff_t) i);
+            if (aligned + size < end)
+                b.freeRanges.insert(b.freeRanges.begin() + (ptrdiff_t) i, {aligned + size, end - aligned - size});
+            if (aligned > start)
+                b.freeRanges.insert(b.freeRanges.begin() + (ptrdiff_t) i, {start, aligned - start});
+            offset = aligned;
+            return true;
+        }
+        return false;
+    }
+
+    void deviceAllocator::free(deviceAllocation &allocation) {
+        if (!allocation.valid())
+            return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_allocations--;
+        m_usedBytes -= allocation.size;
+        const uint32_t heap = heapOf(allocation.memoryType);
+        (allocation.linear ? m_heapBuffers : m_heapImages)[heap] -= allocation.size;
+        if (allocation.block == (uint32_t) -1) {
+            if (allocation.mapped != nullptr)
+                vkUnmapMemory(m_device, allocation.memory);
+            vkFreeMemory(m_device, allocation.memory, m_allocator);
+            m_dedicated--;
+            m_dedicatedBytes -= allocation.size;
+            m_heapDedicated[heap] -= allocation.size;
+            allocation = {};
+            return;
+        }
+
+        block &b = m_blocks[allocation.block];
+        auto &ranges = b.freeRanges;
+        auto it = std::lower_bound(ranges.begin(), ranges.end(),
+                                   std::make_pair(allocation.offset, (VkDeviceSize) 0));
+        it = ranges.insert(it, {allocation.offset, allocation.size});
+        // Merge with the following and the preceding range
+        if (it + 1 != ranges.end() && it->first + it->second == (it + 1)->first) {
+            it->second += (it + 1)->second;
+            ranges.erase(it + 1);
+        }
+        if (it != ranges.begin() && (it - 1)->first + (it - 1)->second == it->first) {
+            (it - 1)->second += it->second;
+            ranges.erase(it);
+        }
+
+        // Keep one empty block per kind around, so a series of create/destroy does not hit the driver every time
+        if (--b.allocations == 0) {
+            bool other = std::any_of(m_blocks.begin(), m_blocks.end(), [&b](const block &o) {
+                return &o != &b && o.memory != VK_NULL_HANDLE && o.allocations == 0 &&
+                       o.memoryType == b.memoryType && o.linear == b.linear;
+            });
+            if (other || !m_keepEmptyBlocks)
+                releaseBlock(b);
+        }
+        allocation = {};
+    }
+
+    void deviceAllocator::releaseBlock(block &b) {
+        if (b.mapped != nullptr)
+            vkUnmapMemory(m_device, b.memory);
+        vkFreeMemory(m_device, b.memory, m_allocator);
+        b = block();
+    }
+
+    void deviceAllocator::setKeepEmptyBlocks(bool keep) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_keepEmptyBlocks = keep;
+    }
+
+    VkDeviceSize deviceAllocator::trim() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        VkDeviceSize released = 0;
+        for (auto &b: m_blocks) {
+            if (b.memory == VK_NULL_HANDLE || b.allocations != 0)
+                continue;
+            released += b.size;
+            releaseBlock(b);
+        }
+        return released;
+    }
+
+    VkResult deviceAllocator::createBuffer(const VkBufferCreateInfo &info, VkMemoryPropertyFlags required,
+                                           VkMemoryPropertyFlags preferred, VkBuffer &buffer,
+                                           deviceAllocation &allocation) {
+        VkResult err = vkCreateBuffer(m_device, &info, m_allocator, &buffer);
+        if (err != VK_SUCCESS)
+            return err;
+        VkMemoryRequirements req;
+        vkGetBufferMemoryRequirements(m_device, buffer, &req);
+        err = allocate(req, required, preferred, true, allocation);
+        if (err != VK_SUCCESS) {
+            vkDestroyBuffer(m_device, buffer, m_allocator);
+            buffer = VK_NULL_HANDLE;
+            return err;
+        }
+        return vkBindBufferMemory(m_device, buffer, allocation.memory, allocation.offset);
+    }
+
+    VkResult deviceAllocator::createImage(const VkImageCreateInfo &info, VkMemoryPropertyFlags required,
+                                          VkMemoryPropertyFlags preferred, VkImage &image,
+                                          deviceAllocation &allocation) {
+        VkResult err = vkCreateImage(m_device, &info, m_allocator, &image);
+        if (err != VK_SUCCESS)
+            return err;
+        VkMemoryRequirements req;
+        vkGetImageMemoryRequirements(m_device, image, &req);
+        err = allocate(req, required, preferred, info.tiling == VK_IMAGE_TILING_LINEAR, allocation);
+        if (err != VK_SUCCESS) {
+            vkDestroyImage(m_device, image, m_allocator);
+            image = VK_NULL_HANDLE;
+            return err;
+        }
+        return vkBindImageMemory(m_device, image, allocation.memory, allocation.offset);
+    }
+
+    void deviceAllocator::destroyBuffer(VkBuffer &buffer, deviceAllocation &allocation) {
+        if (buffer != VK_NULL_HANDLE)
+            vkDestroyBuffer(m_device, buffer, m_allocator);
+        buffer = VK_NULL_HANDLE;
+        free(allocation);
+    }
+
+    void deviceAllocator::destroyImage(VkImage &image, deviceAllocation &allocation) {
+        if (image != VK_NULL_HANDLE)
+            vkDestroyImage(m_device, image, m_allocator);
+        image = VK_NULL_HANDLE;
+        free(allocation);
+    }
+
+    deviceMemoryStatistics deviceAllocator::stats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        deviceMemoryStatistics stats;
+        VkDeviceSize free_bytes = 0;
+        for (const auto &b: m_blocks) {
+            if (b.memory == VK_NULL_HANDLE)
+                continue;
+            stats.blocks++;
+            stats.reservedBytes += b.size;
+            for (const auto &range: b.freeRanges) {
+                free_bytes += range.second;
+                stats.largestFreeRange = std::max(stats.largestFreeRange, range.second);
+            }
+        }
+        stats.dedicatedAllocations = m_dedicated;
+        stats.allocations = m_allocations;
+        stats.deviceAllocations = m_deviceAllocations;
+        stats.reservedBytes += m_dedicatedBytes;
+        stats.usedBytes = m_usedBytes;
+        stats.peakUsedBytes = m_peakUsedBytes;
+        stats.fragmentation = free_bytes > 0 ? 1.0f - (float) stats.largestFreeRange / (float) free_bytes : 0.0f;
+        return stats;
+    }
+
+    std::vector<deviceHeapStatistics> deviceAllocator::heapStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<deviceHeapStatistics> heaps(m_memoryProperties.memoryHeapCount);
+        for (const auto &b: m_blocks) {
+            if (b.memory == VK_NULL_HANDLE)
+                continue;
+            deviceHeapStatistics &heap = heaps[heapOf(b.memoryType)];
+            heap.reservedBytes += b.size;
+            if (b.allocations == 0)
+                heap.emptyBlockBytes += b.size;
+        }
+        for (uint32_t i = 0; i < (uint32_t) heaps.size(); i++) {
+            heaps[i].reservedBytes += m_heapDedicated[i];
+            heaps[i].bufferBytes = m_heapBuffers[i];
+            heaps[i].imageBytes = m_heapImages[i];
+        }
+        return heaps;
+    }
+
+} // engine
@@ -0,0 +1,238 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_ALLOCATOR_H
+#define EASYGRAPHICSLIB_ALLOCATOR_H
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "vulkan/vulkan.h"
+
+namespace engine {
+
+    /**
+     * @brief Host memory statistics of one VkSystemAllocationScope
+     */
+    struct hostScopeStatistics {
+        uint64_t currentBytes = 0;
+        uint64_t peakBytes = 0;
+        uint64_t liveAllocations = 0;
+        uint64_t totalAllocations = 0;
+    };
+
+    struct hostMemoryStatistics {
+        std::array<hostScopeStatistics, 5> scopes;  // Indexed by VkSystemAllocationScope
+        uint64_t currentBytes = 0;
+        uint64_t peakBytes = 0;
+        uint64_t poolBytes = 0;                     // Bytes held by the small allocation pools
+        uint64_t internalBytes = 0;                 // Driver internal allocations reported through the callbacks
+    };
+
+    /**
+     * @brief VkAllocationCallbacks backed by pools for small allocations, with statistics per allocation scope.
+     *
+     * Allocations up to maxPooledSize with at most 16 byte alignment are served from free lists of fixed size
+     * blocks carved out of 64 KiB chunks. Chunks are only released when the allocator is destroyed, so the
+     * many short lived command and object allocations of the driver never reach malloc. Everything else goes
+     * to malloc. The callbacks are thread safe and the allocator has to outlive every object created with it.
+     */
+    class hostAllocator {
+
+    public:
+        static constexpr size_t maxPooledSize = 2048;
+
+        hostAllocator();
+
+        hostAllocator(const hostAllocator &) = delete;
+
+        hostAllocator &operator=(const hostAllocator &) = delete;
+
+        ~hostAllocator();
+
+        [[nodiscard]] const VkAllocationCallbacks *callbacks() const { return &m_callbacks; }
+
+        [[nodiscard]] hostMemoryStatistics stats() const;
+
+    private:
+        static VKAPI_ATTR void *VKAPI_CALL allocate(void *userData, size_t size, size_t alignment,
+                                                    VkSystemAllocationScope scope);
+
+        static VKAPI_ATTR void *VKAPI_CALL reallocate(void *userData, void *original, size_t size, size_t alignment,
+                                                      VkSystemAllocationScope scope);
+
+        static VKAPI_ATTR void VKAPI_CALL release(void *userData, void *memory);
+
+        static VKAPI_ATTR void VKAPI_CALL internalAllocate(void *userData, size_t size,
+                                                           VkInternalAllocationType type,
+                                                           VkSystemAllocationScope scope);
+
+        static VKAPI_ATTR void VKAPI_CALL internalRelease(void *userData, size_t size,
+                                                          VkInternalAllocationType type,
+                                                          VkSystemAllocationScope scope);
+
+        void *allocateLocked(size_t size, size_t alignment, VkSystemAllocationScope scope);
+
+        void releaseLocked(void *memory);
+
+        VkAllocationCallbacks m_callbacks = {};
+        mutable std::mutex m_mutex;
+        std::vector<void *> m_freeLists;
+        std::vector<void *> m_chunks;
+        hostMemoryStatistics m_stats;
+    };
+
+    /**
+     * @brief A range of device memory handed out by deviceAllocator
+     */
+    struct deviceAllocation {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        void *mapped = nullptr;                 // Host address of offset if the memory is host visible
+        uint32_t memoryType = (uint32_t) -1;
+        uint32_t block = (uint32_t) -1;         // Index of the shared block, (uint32_t)-1 for dedicated memory
+        bool linear = true;                     // Buffers and linear images, false for optimal images
+
+        [[nodiscard]] bool valid() const { return memory != VK_NULL_HANDLE; }
+    };
+
+    struct deviceMemoryStatistics {
+        uint64_t blocks = 0;                    // Shared blocks currently allocated from the device
+        uint64_t dedicatedAllocations = 0;      // Resources too large for a block
+        uint64_t allocations = 0;               // Live allocations, shared and dedicated
+        uint64_t deviceAllocations = 0;         // vkAllocateMemory calls made so far
+        VkDeviceSize reservedBytes = 0;         // Device memory held by blocks and dedicated allocations
+        VkDeviceSize usedBytes = 0;
+        VkDeviceSize peakUsedBytes = 0;
+        VkDeviceSize largestFreeRange = 0;
+        float fragmentation = 0.0f;             // 1 - largest free range / free bytes across all blocks
+    };
+
+    /**
+     * @brief What deviceAllocator holds in one memory heap
+     */
+    struct deviceHeapStatistics {
+        VkDeviceSize reservedBytes = 0;         // Blocks and dedicated allocations in the heap
+        VkDeviceSize bufferBytes = 0;           // Used by buffers and linear images
+        VkDeviceSize imageBytes = 0;            // Used by optimal images
+        VkDeviceSize emptyBlockBytes = 0;       // Blocks kept around without allocations, see trim()
+    };
+
+    /**
+     * @brief Sub-allocates buffers and images from large VkDeviceMemory blocks.
+     *
+     * Each memory type gets its own list of blocks, split again into buffer and optimal image blocks so
+     * bufferImageGranularity never has to be considered. Free ranges are kept sorted and merged on release,
+     * first fit picks the range. Host visible blocks are mapped once for their whole lifetime, so users must
+     * not call vkMapMemory on an allocation and use deviceAllocation::mapped instead. Thread safe.
+     */
+    class deviceAllocator {
+
+    public:
+        static constexpr VkDeviceSize defaultBlockSize = 64ull << 20;
+
+        void create(VkPhysicalDevice physicalDevice, VkDevice device, const VkAllocationCallbacks *allocator,
+                    VkDeviceSize blockSize = defaultBlockSize);
+
+        /**
+         * @brief Frees all blocks. Every allocation has to be released before
+         */
+        void destroy();
+
+        /**
+         * @param required Properties the memory type must have
+         * @param preferred Additional properties that are used when a matching type has memory left
+         * @param linear false for optimal tiling images, which are kept in separate blocks
+         */
+        VkResult allocate(const VkMemoryRequirements &requirements, VkMemoryPropertyFlags required,
+                          VkMemoryPropertyFlags preferred, bool linear, deviceAllocation &allocation);
+
+        void free(deviceAllocation &allocation);
+
+        /**
+         * @brief Creates a buffer and binds it to newly allocated memory
+         */
+        VkResult createBuffer(const VkBufferCreateInfo &info, VkMemoryPropertyFlags required,
+                              VkMemoryPropertyFlags preferred, VkBuffer &buffer, deviceAllocation &allocation);
+
+        /**
+         * @brief Creates an image and binds it to newly allocated memory
+         */
+        VkResult createImage(const VkImageCreateInfo &info, VkMemoryPropertyFlags required,
+                             VkMemoryPropertyFlags preferred, VkImage &image, deviceAllocation &allocation);
+
+        void destroyBuffer(VkBuffer &buffer, deviceAllocation &allocation);
+
+        void destroyImage(VkImage &image, deviceAllocation &allocation);
+
+        /**
+         * @brief Whether a block that became empty is kept for the next allocation of its kind, on by default.
+         * Turned off while a window is under memory pressure, see deviceContext::beginMemoryPressure()
+         */
+        void setKeepEmptyBlocks(bool keep);
+
+        /**
+         * @brief Frees every block without allocations
+         * @return Bytes given back to the device
+         */
+        VkDeviceSize trim();
+
+        [[nodiscard]] deviceMemoryStatistics stats() const;
+
+        /**
+         * @brief Statistics per memory heap, indexed like VkPhysicalDeviceMemoryProperties::memoryHeaps
+         */
+        [[nodiscard]] std::vector<deviceHeapStatistics> heapStats() const;
+
+        [[nodiscard]] const VkPhysicalDeviceMemoryProperties &memoryProperties() const { return m_memoryProperties; }
+
+    private:
+        struct block {
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+            VkDeviceSize size = 0;
+            uint8_t *mapped = nullptr;
+            uint32_t memoryType = 0;
+            bool linear = true;
+            uint32_t allocations = 0;
+            std::vector<std::pair<VkDeviceSize, VkDeviceSize>> freeRanges; // Offset and size, sorted by offset
+        };
+
+        VkResult allocateFromType(uint32_t memoryType, const VkMemoryRequirements &requirements, bool linear,
+                                  deviceAllocation &allocation);
+
+        VkResult allocateMemory(uint32_t memoryType, VkDeviceSize size, VkDeviceMemory &memory, uint8_t *&mapped);
+
+        static bool takeRange(block &b, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize &offset);
+
+        void releaseBlock(block &b);
+
+        [[nodiscard]] uint32_t heapOf(uint32_t memoryType) const {
+            return m_memoryProperties.memoryTypes[memoryType].heapIndex;
+        }
+
+        VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
+        VkDevice m_device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks *m_allocator = nullptr;
+        VkPhysicalDeviceMemoryProperties m_memoryProperties = {};
+        VkDeviceSize m_blockSize = defaultBlockSize;
+
+        mutable std::mutex m_mutex;
+        std::vector<block> m_blocks;            // Released blocks stay as empty entries so indices remain valid
+        uint64_t m_dedicated = 0;
+        uint64_t m_allocations = 0;
+        uint64_t m_deviceAllocations = 0;
+        VkDeviceSize m_dedicatedBytes = 0;
+        VkDeviceSize m_usedBytes = 0;
+        VkDeviceSize m_peakUsedBytes = 0;
+        bool m_keepEmptyBlocks = true;
+        std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> m_heapDedicated{};
+        std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> m_heapBuffers{};
+        std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> m_heapImages{};
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_ALLOCATOR_H
@@ -0,0 +1,88 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+// Throughput microbenchmark for engine::channel. Producer threads push as fast as they can while a
+// consumer thread drains in a loop, imitating the render loop draining once per frame.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "channel.h"
+
+struct sample {
+    uint64_t timestamp;
+    double value;
+};
+
+struct result {
+    double pushesPerSecond;
+    uint64_t received;
+    uint64_t dropped;
+    uint64_t coalesced;
+};
+
+static result run(int producers, size_t samplesPerProducer, size_t batch, engine::overflowPolicy policy,
+                  size_t capacity) {
+    std::atomic<uint64_t> received{0};
+    engine::channel<sample> ch("bench", capacity, policy, [&](const sample *, size_t count) {
+        received.fetch_add(count, std::memory_order_relaxed);
+    });
+
+    std::atomic<bool> start{false};
+    std::atomic<int> running{producers};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&, p]() {
+            std::vector<sample> buffer(batch);
+            while (!start.load(std::memory_order_acquire)) {}
+            for (size_t i = 0; i < samplesPerProducer; i += batch) {
+                size_t n = std::min(batch, samplesPerProducer - i);
+                for (size_t k = 0; k < n; k++)
+                    buffer[k] = {i + k, (double) p};
+                if (n == 1)
+                    ch.push(buffer[0]);
+                else
+                    ch.push(buffer.data(), n);
+            }
+            running.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    while (running.load(std::memory_order_acquire) > 0)
+        ch.drain();
+    auto end = std::chrono::steady_clock::now();
+    for (auto &t: threads)
+        t.join();
+    ch.drain();
+
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    return {(double) producers * (double) samplesPerProducer / seconds, received.load(), ch.dropped(),
+            ch.coalesced()};
+}
+
+int main(int argc, char **argv) {
+    size_t samplesPerProducer = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const size_t capacity = 4096;
+
+    printf("%-10s %-10s %-6s %14s %12s %12s %12s\n", "policy", "producers", "batch", "pushes/s", "received",
+           "dropped", "coalesced");
+    for (auto policy: {engine::overflowPolicy::dropOldest, engine::overflowPolicy::coalesce}) {
+        for (int producers: {1, 2, 4, 8}) {
+            for (size_t batch: {(size_t) 1, (size_t) 64}) {
+                result r = run(producers, samplesPerProducer, batch, policy, capacity);
+                printf("%-10s %-10d %-6zu %14.0f %12llu %12llu %12llu\n",
+                       policy == engine::overflowPolicy::dropOldest ? "dropOldest" : "coalesce", producers, batch,
+                       r.pushesPerSecond, (unsigned long long) r.received, (unsigned long long) r.dropped,
+                       (unsigned long long) r.coalesced);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,328 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+// Drives engine::window headlessly with synthetic ImGui workloads and reports frame time percentiles,
+// CPU time per phase, allocations per frame and vertex/index counts as JSON.
+//
+// Usage: FrameBenchmark [--frames N] [--warmup N] [--windows N] [--widgets N] [--plot-points N]
+//                       [--log-lines N] [--viewports N] [--width N] [--height N] [--windowed]
+//                       [--pipelined] [--parallel-viewports] [--no-frame-skip] [--frames-in-flight N]
+//                       [--output file.json]
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+#include "imgui.h"
+#include "window.h"
+
+// Every C++ and ImGui heap allocation of the process is counted, so per frame numbers include the engine
+static std::atomic<uint64_t> s_allocations{0};
+static std::atomic<uint64_t> s_allocatedBytes{0};
+
+void *operator new(size_t size) {
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+static void *countingImGuiAlloc(size_t size, void *) {
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size);
+}
+
+static void countingImGuiFree(void *ptr, void *) {
+    std::free(ptr);
+}
+
+struct workload {
+    int windows = 8;
+    int widgets = 50;
+    int plotPoints = 10000;
+    int logLines = 100000;
+    int viewports = 0;
+};
+
+struct config {
+    workload load;
+    int frames = 600;
+    int warmup = 60;
+    int width = 1280;
+    int height = 720;
+    bool windowed = false;
+    bool pipelined = false;     // Render thread, only used together with --windowed
+    bool parallelViewports = false; // Platform windows recorded on workers, needs --windowed and --viewports
+    bool frameSkipping = true;      // Unchanged frames are not presented again, only used with --windowed
+    int framesInFlight = 2;         // 1 to 4, the fenceWait phase shows what the CPU waits for the GPU
+    std::string output;
+};
+
+static void printDistribution(FILE *out, const char *name, const engine::timingStats &d, bool last) {
+    fprintf(out, "    \"%s\": {\"mean\": %.6f, \"p50\": %.6f, \"p90\": %.6f, \"p99\": %.6f, \"max\": %.6f}%s\n",
+            name, d.mean, d.p50, d.p90, d.p99, d.max, last ? "" : ",");
+}
+
+static bool parseArguments(int argc, char **argv, config &cfg) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char * { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char *value = nullptr;
+        if (arg == "--windowed") {
+            cfg.windowed = true;
+            continue;
+        }
+        if (arg == "--pipelined") {
+            cfg.pipelined = true;
+            continue;
+        }
+        if (arg == "--parallel-viewports") {
+            cfg.parallelViewports = true;
+            continue;
+        }
+        if (arg == "--no-frame-skip") {
+            cfg.frameSkipping = false;
+            continue;
+        }
+        if ((value = next()) == nullptr) {
+            fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return false;
+        }
+        if (arg == "--frames") cfg.frames = atoi(value);
+        else if (arg == "--warmup") cfg.warmup = atoi(value);
+        else if (arg == "--windows") cfg.load.windows = atoi(value);
+        else if (arg == "--widgets") cfg.load.widgets = atoi(value);
+        else if (arg == "--plot-points") cfg.load.plotPoints = atoi(value);
+        else if (arg == "--log-lines") cfg.load.logLines = atoi(value);
+        else if (arg == "--viewports") cfg.load.viewports = atoi(value);
+        else if (arg == "--frames-in-flight") cfg.framesInFlight = atoi(value);
+        else if (arg == "--width") cfg.width = atoi(value);
+        else if (arg == "--height") cfg.height = atoi(value);
+        else if (arg == "--output") cfg.output = value;
+        else {
+            fprintf(stderr, "Unknown argument %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Synthetic UI built every frame from the workload parameters
+ */
+class syntheticUi {
+
+public:
+    explicit syntheticUi(const workload &load) : m_load(load) {
+        m_plot.resize((size_t) std::max(0, load.plotPoints));
+        m_values.resize((size_t) std::max(0, load.windows * load.widgets));
+        m_logLines.reserve((size_t) std::max(0, load.logLines));
+        for (int i = 0; i < load.logLines; i++) {
+            char line[96];
+            snprintf(line, sizeof(line), "[%08d] worker %d: processed batch with %d items", i, i % 16, (i * 37) % 1000);
+            m_logLines.emplace_back(line);
+        }
+    }
+
+    void draw() {
+        m_time += 1.0f / 60.0f;
+        for (size_t i = 0; i < m_plot.size(); i++)
+            m_plot[i] = std::sin(m_time + (float) i * 0.01f);
+
+        for (int w = 0; w < m_load.windows; w++) {
+            char title[32];
+            snprintf(title, sizeof(title), "Window %d", w);
+            ImGui::SetNextWindowPos(ImVec2(20.0f + (float) (w % 8) * 30.0f, 20.0f + (float) (w / 8) * 30.0f),
+                                    ImGuiCond_Once);
+            ImGui::SetNextWindowSize(ImVec2(320, 400), ImGuiCond_Once);
+            ImGui::Begin(title);
+            for (int i = 0; i < m_load.widgets; i++) {
+                float &value = m_values[(size_t) (w * m_load.widgets + i)];
+                ImGui::PushID(i);
+                switch (i % 4) {
+                    case 0:
+                        ImGui::Text("Value %d: %.3f", i, value);
+                        break;
+                    case 1:
+                        ImGui::SliderFloat("slider", &value, 0.0f, 1.0f);
+                        break;
+                    case 2:
+                        ImGui::Button("button");
+                        break;
+                    default:
+                        ImGui::ProgressBar(std::fmod(m_time + (float) i * 0.1f, 1.0f));
+                        break;
+                }
+                ImGui::PopID();
+            }
+            ImGui::End();
+        }
+
+        if (!m_plot.empty()) {
+            ImGui::SetNextWindowSize(ImVec2(800, 300), ImGuiCond_Once);
+            ImGui::Begin("Plot");
+            ImGui::PlotLines("##plot", m_plot.data(), (int) m_plot.size(), 0, nullptr, -1.0f, 1.0f,
+                             ImVec2(-1, -1));
+            ImGui::End();
+        }
+
+        if (!m_logLines.empty()) {
+            ImGui::SetNextWindowSize(ImVec2(600, 400), ImGuiCond_Once);
+            ImGui::Begin("Log");
+            ImGuiListClipper clipper;
+            clipper.Begin((int) m_logLines.size());
+            while (clipper.Step()) {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+                    ImGui::TextUnformatted(m_logLines[(size_t) i].c_str());
+            }
+            ImGui::SetScrollY(ImGui::GetScrollMaxY());
+            ImGui::End();
+        }
+
+        // Placed outside the main viewport, so with viewports enabled each one becomes a platform window
+        for (int v = 0; v < m_load.viewports; v++) {
+            char title[32];
+            snprintf(title, sizeof(title), "Viewport %d", v);
+            const ImGuiViewport *main = ImGui::GetMainViewport();
+            ImGui::SetNextWindowPos(ImVec2(main->Pos.x + main->Size.x + 10.0f + (float) v * 40.0f,
+                                           main->Pos.y + (float) v * 40.0f), ImGuiCond_Once);
+            ImGui::SetNextWindowSize(ImVec2(300, 200), ImGuiCond_Once);
+            ImGui::Begin(title);
+            ImGui::Text("Frame time %.3f ms", 1000.0f / ImGui::GetIO().Framerate);
+            ImGui::PlotLines("##vp", m_plot.data(), std::min((int) m_plot.size(), 512));
+            ImGui::End();
+        }
+    }
+
+private:
+    workload m_load;
+    float m_time = 0.0f;
+    std::vector<float> m_plot;
+    std::vector<float> m_values;
+    std::vector<std::string> m_logLines;
+};
+
+int main(int argc, char **argv) {
+    config cfg;
+    if (!parseArguments(argc, argv, cfg))
+        return 2;
+
+    ImGui::SetAllocatorFunctions(countingImGuiAlloc, countingImGuiFree);
+
+    engine::window window(cfg.width, cfg.height);
+    window.setHeadless(!cfg.windowed);
+    window.setPipelined(cfg.pipelined);
+    window.setParallelViewports(cfg.parallelViewports);
+    window.setFrameSkipping(cfg.frameSkipping);
+    window.setFramesInFlight(cfg.framesInFlight);
+    window.setProfilingEnabled(true);
+    syntheticUi ui(cfg.load);
+    window.registerOnUpdateCallback([&ui]() { ui.draw(); });
+    if (window.create() != 0) {
+        fprintf(stderr, "Failed to create window\n");
+        return 1;
+    }
+
+    for (int i = 0; i < cfg.warmup; i++)
+        window.updateFrame();
+
+    std::vector<double> frameTimes, allocations, allocatedBytes, vertices, indices;
+    std::vector<std::vector<double>> phases(engine::framePhaseCount);
+    for (int i = 0; i < cfg.frames && !window.shouldClose(); i++) {
+        uint64_t allocationsBefore = s_allocations.load(std::memory_order_relaxed);
+        uint64_t bytesBefore = s_allocatedBytes.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+
+        window.updateFrame();
+
+        auto end = std::chrono::steady_clock::now();
+        frameTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        allocations.push_back((double) (s_allocations.load(std::memory_order_relaxed) - allocationsBefore));
+        allocatedBytes.push_back((double) (s_allocatedBytes.load(std::memory_order_relaxed) - bytesBefore));
+
+        // Sum every viewport, so the numbers stay comparable whether viewports are active or not
+        int vtx = 0, idx = 0;
+        for (ImGuiViewport *viewport: ImGui::GetPlatformIO().Viewports) {
+            if (viewport->DrawData != nullptr) {
+                vtx += viewport->DrawData->TotalVtxCount;
+                idx += viewport->DrawData->TotalIdxCount;
+            }
+        }
+        vertices.push_back(vtx);
+        indices.push_back(idx);
+
+        if (const engine::frameTiming *timing = window.profiler().latest()) {
+            for (size_t p = 0; p < engine::framePhaseCount; p++)
+                phases[p].push_back(timing->cpu[p]);
+        }
+    }
+    engine::timingStats gpu = window.profiler().gpuStats();
+    engine::frameSkipStatistics skips = window.skipStats();
+    window.cleanup();
+
+    FILE *out = cfg.output.empty() ? stdout : fopen(cfg.output.c_str(), "w");
+    if (out == nullptr) {
+        fprintf(stderr, "Failed to open %s\n", cfg.output.c_str());
+        return 1;
+    }
+    fprintf(out, "{\n  \"config\": {\"frames\": %zu, \"warmup\": %d, \"width\": %d, \"height\": %d, "
+                 "\"headless\": %s, \"windows\": %d, \"widgets\": %d, \"plotPoints\": %d, \"logLines\": %d, "
+                 "\"viewports\": %d, \"pipelined\": %s, \"parallelViewports\": %s, \"frameSkipping\": %s, "
+                 "\"framesInFlight\": %u},\n",
+            frameTimes.size(), cfg.warmup, cfg.width, cfg.height, cfg.windowed ? "false" : "true", cfg.load.windows,
+            cfg.load.widgets, cfg.load.plotPoints, cfg.load.logLines, cfg.load.viewports,
+            cfg.pipelined ? "true" : "false", cfg.parallelViewports ? "true" : "false",
+            cfg.frameSkipping ? "true" : "false", window.framesInFlight());
+    engine::timingStats frame = engine::computeTimingStats(std::move(frameTimes));
+    fprintf(out, "  \"frameTimeMs\": {\"mean\": %.6f, \"p50\": %.6f, \"p90\": %.6f, \"p99\": %.6f, \"max\": %.6f},\n",
+            frame.mean, frame.p50, frame.p90, frame.p99, frame.max);
+    fprintf(out, "  \"gpuMs\": {\"mean\": %.6f, \"p50\": %.6f, \"p90\": %.6f, \"p99\": %.6f, \"max\": %.6f, "
+                 "\"samples\": %zu},\n", gpu.mean, gpu.p50, gpu.p90, gpu.p99, gpu.max, gpu.samples);
+    // Counted over warmup and measured frames
+    fprintf(out, "  \"frameSkipping\": {\"hashedFrames\": %llu, \"skippedFrames\": %llu, \"callbackFrames\": %llu, "
+                 "\"hashedBytes\": %llu},\n", (unsigned long long) skips.hashedFrames,
+            (unsigned long long) skips.skippedFrames, (unsigned long long) skips.callbackFrames,
+            (unsigned long long) skips.hashedBytes);
+    fprintf(out, "  \"phasesMs\": {\n");
+    for (size_t p = 0; p < engine::framePhaseCount; p++)
+        printDistribution(out, engine::framePhaseName((engine::framePhase) p),
+                          engine::computeTimingStats(std::move(phases[p])), p + 1 == engine::framePhaseCount);
+    fprintf(out, "  },\n  \"perFrame\": {\n");
+    printDistribution(out, "allocations", engine::computeTimingStats(allocations), false);
+    printDistribution(out, "allocatedBytes", engine::computeTimingStats(allocatedBytes), false);
+    printDistribution(out, "vertices", engine::computeTimingStats(vertices), false);
+    printDistribution(out, "indices", engine::computeTimingStats(indices), true);
+    fprintf(out, "  }\n}\n");
+    if (out != stdout)
+        fclose(out);
+    return 0;
+}
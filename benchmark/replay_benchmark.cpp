@@ -0,0 +1,205 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+// Replays a capture written by engine::window::startCapture() through the render path as fast as possible and
+// reports frame time percentiles and CPU time per phase as JSON. The captured input events are queued into the
+// replaying context as well, the UI of the original application is not needed.
+//
+// Usage: ReplayBenchmark capture.bin [--loops N] [--warmup N] [--width N] [--height N] [--windowed]
+//                        [--pipelined] [--output file.json]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "capture.h"
+#include "imgui.h"
+#include "window.h"
+
+struct config {
+    std::string capture;
+    int loops = 1;
+    int warmup = 60;
+    int width = 0;              // 0 takes the display size of the first captured frame
+    int height = 0;
+    bool windowed = false;
+    bool pipelined = false;
+    std::string output;
+};
+
+struct distribution {
+    double mean = 0.0, p50 = 0.0, p90 = 0.0, p99 = 0.0, max = 0.0;
+};
+
+static distribution summarize(std::vector<double> values) {
+    distribution d;
+    if (values.empty())
+        return d;
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (double v: values)
+        sum += v;
+    auto percentile = [&](double p) {
+        return values[std::min(values.size() - 1, (size_t) (p * (double) (values.size() - 1) + 0.5))];
+    };
+    d.mean = sum / (double) values.size();
+    d.p50 = percentile(0.50);
+    d.p90 = percentile(0.90);
+    d.p99 = percentile(0.99);
+    d.max = values.back();
+    return d;
+}
+
+static void printDistribution(FILE *out, const char *name, const distribution &d, bool last) {
+    fprintf(out, "    \"%s\": {\"mean\": %.6f, \"p50\": %.6f, \"p90\": %.6f, \"p99\": %.6f, \"max\": %.6f}%s\n",
+            name, d.mean, d.p50, d.p90, d.p99, d.max, last ? "" : ",");
+}
+
+static bool parseArguments(int argc, char **argv, config &cfg) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char * { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char *value = nullptr;
+        if (arg == "--windowed") {
+            cfg.windowed = true;
+            continue;
+        }
+        if (arg == "--pipelined") {
+            cfg.pipelined = true;
+            continue;
+        }
+        if (arg.rfind("--", 0) != 0 && cfg.capture.empty()) {
+            cfg.capture = arg;
+            continue;
+        }
+        if ((value = next()) == nullptr) {
+            fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return false;
+        }
+        if (arg == "--loops") cfg.loops = std::max(1, atoi(value));
+        else if (arg == "--warmup") cfg.warmup = atoi(value);
+        else if (arg == "--width") cfg.width = atoi(value);
+        else if (arg == "--height") cfg.height = atoi(value);
+        else if (arg == "--output") cfg.output = value;
+        else {
+            fprintf(stderr, "Unknown argument %s\n", arg.c_str());
+            return false;
+        }
+    }
+    if (cfg.capture.empty()) {
+        fprintf(stderr, "No capture given\n");
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    config cfg;
+    if (!parseArguments(argc, argv, cfg))
+        return 2;
+
+    engine::captureReader reader;
+    if (!reader.open(cfg.capture) || reader.frameCount() == 0) {
+        fprintf(stderr, "Nothing to replay in %s\n", cfg.capture.c_str());
+        return 1;
+    }
+    engine::captureReader::frameInfo info;
+    if (cfg.width <= 0 || cfg.height <= 0) {
+        if (!reader.readFrame(0, &info) || reader.data() == nullptr) {
+            fprintf(stderr, "Failed to read the first frame of %s\n", cfg.capture.c_str());
+            return 1;
+        }
+        cfg.width = std::max(1, (int) reader.data()->DisplaySize.x);
+        cfg.height = std::max(1, (int) reader.data()->DisplaySize.y);
+    }
+
+    // Nothing may be skipped or throttled, every captured frame goes through recording and submission
+    engine::window window(cfg.width, cfg.height);
+    window.setHeadless(!cfg.windowed);
+    window.setPipelined(cfg.pipelined);
+    window.setPlatformWindowsEnabled(false);
+    window.setFrameSkipping(false);
+    window.setPresentProfile(engine::presentProfile::throughput);
+    window.setProfilingEnabled(true);
+
+    size_t next = 0;
+    uint64_t decodeFailures = 0;
+    window.registerOnUpdateCallback([&]() {
+        size_t frame = next++ % reader.frameCount();
+        if (!reader.readFrame(frame, &info)) {
+            decodeFailures++;
+            window.setExternalDrawData(nullptr);
+            return;
+        }
+        // Processed by the next NewFrame, the replaying context has no windows that would react to them
+        engine::captureReader::queueInput(info);
+        window.setExternalDrawData(reader.data());
+    });
+    if (window.create() != 0) {
+        fprintf(stderr, "Failed to create window\n");
+        return 1;
+    }
+    ImFontAtlas *fonts = ImGui::GetIO().Fonts;
+    if (!reader.setFontTexture(fonts->TexID, (uint32_t) fonts->TexWidth, (uint32_t) fonts->TexHeight))
+        fprintf(stderr, "The font atlas differs from the captured one, text will be garbled\n");
+
+    for (int i = 0; i < cfg.warmup; i++)
+        window.updateFrame();
+
+    const size_t frames = reader.frameCount() * (size_t) cfg.loops;
+    std::vector<double> frameTimes, vertices, indices;
+    std::vector<std::vector<double>> phases(engine::framePhaseCount);
+    frameTimes.reserve(frames);
+    auto replayStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < frames && !window.shouldClose(); i++) {
+        auto start = std::chrono::steady_clock::now();
+
+        window.updateFrame();
+
+        auto end = std::chrono::steady_clock::now();
+        frameTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        if (const ImDrawData *drawData = window.drawData()) {
+            vertices.push_back(drawData->TotalVtxCount);
+            indices.push_back(drawData->TotalIdxCount);
+        }
+        if (const engine::frameTiming *timing = window.profiler().latest()) {
+            for (size_t p = 0; p < engine::framePhaseCount; p++)
+                phases[p].push_back(timing->cpu[p]);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - replayStart).count();
+    engine::timingStats gpu = window.profiler().gpuStats();
+    window.cleanup();
+
+    FILE *out = cfg.output.empty() ? stdout : fopen(cfg.output.c_str(), "w");
+    if (out == nullptr) {
+        fprintf(stderr, "Failed to open %s\n", cfg.output.c_str());
+        return 1;
+    }
+    fprintf(out, "{\n  \"config\": {\"capture\": \"%s\", \"capturedFrames\": %zu, \"indexed\": %s, \"loops\": %d, "
+                 "\"warmup\": %d, \"width\": %d, \"height\": %d, \"headless\": %s, \"pipelined\": %s},\n",
+            cfg.capture.c_str(), reader.frameCount(), reader.indexed() ? "true" : "false", cfg.loops, cfg.warmup,
+            cfg.width, cfg.height, cfg.windowed ? "false" : "true", cfg.pipelined ? "true" : "false");
+    fprintf(out, "  \"replay\": {\"frames\": %zu, \"seconds\": %.6f, \"framesPerSecond\": %.3f, "
+                 "\"decodeFailures\": %llu},\n", frameTimes.size(), seconds,
+            seconds > 0.0 ? (double) frameTimes.size() / seconds : 0.0, (unsigned long long) decodeFailures);
+    distribution frame = summarize(frameTimes);
+    fprintf(out, "  \"frameTimeMs\": {\"mean\": %.6f, \"p50\": %.6f, \"p90\": %.6f, \"p99\": %.6f, \"max\": %.6f},\n",
+            frame.mean, frame.p50, frame.p90, frame.p99, frame.max);
+    fprintf(out, "  \"gpuMs\": {\"mean\": %.6f, \"p50\": %.6f, \"p90\": %.6f, \"p99\": %.6f, \"max\": %.6f, "
+                 "\"samples\": %zu},\n", gpu.mean, gpu.p50, gpu.p90, gpu.p99, gpu.max, gpu.samples);
+    fprintf(out, "  \"phasesMs\": {\n");
+    for (size_t p = 0; p < engine::framePhaseCount; p++)
+        printDistribution(out, engine::framePhaseName((engine::framePhase) p), summarize(phases[p]),
+                          p + 1 == engine::framePhaseCount);
+    fprintf(out, "  },\n  \"perFrame\": {\n");
+    printDistribution(out, "vertices", summarize(vertices), false);
+    printDistribution(out, "indices", summarize(indices), true);
+    fprintf(out, "  }\n}\n");
+    if (out != stdout)
+        fclose(out);
+    return 0;
+}
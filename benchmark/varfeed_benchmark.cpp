@@ -0,0 +1,149 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+// Throughput benchmark for variable feeds. Writer processes publish through varfeed.h as fast as they can
+// while a reader takes snapshots in a loop, like the render loop does once per frame. Every variable holds
+// eight copies of the same counter, a snapshot with differing copies would be torn.
+//
+// Usage: VarFeedBenchmark [seconds per run]
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "variablefeed.h"
+#include "varfeed.h"
+
+static const uint32_t variable_count = 64;
+static const uint32_t copies = 8;
+
+// Live in an anonymous shared mapping, so the forked writers can be started and report back
+struct control {
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+};
+
+struct writerResult {
+    std::atomic<uint64_t> written;
+    std::atomic<uint64_t> dropped;
+};
+
+struct result {
+    double writesPerSecond;
+    uint64_t dropped;
+    double snapshotsPerSecond;
+    engine::variableFeedStatistics reader;
+    uint64_t torn;
+};
+
+static void write_loop(const char *name, int writer, int writers, bool shared, control *ctl, writerResult *out) {
+    egl_varfeed feed;
+    if (egl_varfeed_open(&feed, name) != 0) {
+        perror("egl_varfeed_open");
+        return;
+    }
+    uint64_t values[copies];
+    uint64_t written = 0, dropped = 0;
+    while (!ctl->start.load(std::memory_order_acquire)) {}
+    for (uint64_t counter = 1; !ctl->stop.load(std::memory_order_relaxed); counter++) {
+        // Own variables are split between the writers, shared ones are written by all of them
+        uint32_t index = shared ? (uint32_t) (counter % variable_count)
+                                : (uint32_t) (writer + (int) (counter % (variable_count / writers)) * writers);
+        for (uint64_t &value: values)
+            value = counter;
+        if (egl_varfeed_write(&feed, index, values, sizeof(values)) == 1)
+            written++;
+        else
+            dropped++;
+    }
+    out->written.store(written);
+    out->dropped.store(dropped);
+    egl_varfeed_close(&feed);
+}
+
+static result run(int writers, bool shared, double seconds) {
+    const std::string name = "/easygraphicslib-bench-" + std::to_string(getpid());
+    std::vector<egl_varfeed_var> vars(variable_count);
+    std::vector<std::string> names(variable_count);
+    for (uint32_t i = 0; i < variable_count; i++) {
+        names[i] = "var" + std::to_string(i);
+        vars[i] = {names[i].c_str(), "", EGL_VARFEED_U64, copies};
+    }
+    egl_varfeed feed;
+    if (egl_varfeed_create(&feed, name.c_str(), vars.data(), variable_count) != 0) {
+        perror("egl_varfeed_create");
+        exit(1);
+    }
+
+    size_t sharedSize = sizeof(control) + writers * sizeof(writerResult);
+    void *mapping = mmap(nullptr, sharedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    auto *ctl = new(mapping) control();
+    auto *results = (writerResult *) ((uint8_t *) mapping + sizeof(control));
+    std::vector<pid_t> children;
+    for (int w = 0; w < writers; w++) {
+        new(results + w) writerResult();
+        pid_t pid = fork();
+        if (pid == 0) {
+            write_loop(name.c_str(), w, writers, shared, ctl, results + w);
+            _exit(0);
+        }
+        children.push_back(pid);
+    }
+
+    engine::variableFeed reader(name);
+    uint64_t torn = 0, snapshots = 0;
+    ctl->start.store(true, std::memory_order_release);
+    auto begin = std::chrono::steady_clock::now();
+    auto end = begin;
+    while (std::chrono::duration<double>(end - begin).count() < seconds) {
+        reader.snapshot();
+        snapshots++;
+        for (const engine::feedVariable &variable: reader.variables()) {
+            const auto *values = (const uint64_t *) variable.data;
+            for (uint32_t c = 1; c < copies; c++)
+                torn += values[c] != values[0];
+        }
+        end = std::chrono::steady_clock::now();
+    }
+    ctl->stop.store(true);
+    for (pid_t pid: children)
+        waitpid(pid, nullptr, 0);
+
+    double elapsed = std::chrono::duration<double>(end - begin).count();
+    result r = {};
+    for (int w = 0; w < writers; w++) {
+        r.writesPerSecond += (double) results[w].written.load() / elapsed;
+        r.dropped += results[w].dropped.load();
+    }
+    r.snapshotsPerSecond = (double) snapshots / elapsed;
+    r.reader = reader.stats();
+    r.torn = torn;
+    munmap(mapping, sharedSize);
+    reader.close();
+    egl_varfeed_close(&feed);
+    return r;
+}
+
+int main(int argc, char **argv) {
+    double seconds = argc > 1 ? std::strtod(argv[1], nullptr) : 1.0;
+
+    printf("%-7s %-8s %14s %12s %12s %12s %10s %10s %8s\n", "mode", "writers", "writes/s", "dropped",
+           "snapshots/s", "copies", "retries", "stale", "torn");
+    for (bool shared: {false, true}) {
+        for (int writers: {1, 2, 4, 8, 16}) {
+            result r = run(writers, shared, seconds);
+            printf("%-7s %-8d %14.0f %12llu %12.0f %12llu %10llu %10llu %8llu\n", shared ? "shared" : "own",
+                   writers, r.writesPerSecond, (unsigned long long) r.dropped, r.snapshotsPerSecond,
+                   (unsigned long long) r.reader.copies, (unsigned long long) r.reader.retries,
+                   (unsigned long long) r.reader.stale, (unsigned long long) r.torn);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,323 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "imgui_internal.h"
+#include "capture.h"
+
+namespace engine {
+
+    using namespace capture_format;
+
+    static const size_t record_header_size = sizeof(recordHeader);
+
+    // Mapping offsets have to be page aligned, 64 KiB covers every page size in use
+    static const uint64_t chunk_granularity = 64 * 1024;
+
+#ifndef _WIN32
+    bool captureWriter::open(const std::string &path, ImTextureID fontTexture, uint32_t fontWidth,
+                             uint32_t fontHeight, uint64_t chunkSize) {
+        close();
+        m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (m_fd < 0) {
+            fprintf(stderr, "[capture] Could not create '%s': %s\n", path.c_str(), strerror(errno));
+            return false;
+        }
+        m_chunkSize = std::max<uint64_t>(chunk_granularity,
+                                         (chunkSize + chunk_granularity - 1) / chunk_granularity * chunk_granularity);
+        m_stats = captureStatistics();
+        m_index.clear();
+        if (!mapChunk(0, m_chunkSize)) {
+            close();
+            return false;
+        }
+
+        fileHeader header = {};
+        header.magic = magic;
+        header.version = version;
+        header.vertexSize = sizeof(ImDrawVert);
+        header.indexSize = sizeof(ImDrawIdx);
+        header.inputEventSize = sizeof(ImGuiInputEvent);
+        header.chunkSize = m_chunkSize;
+        header.fontTexture = (uint64_t) fontTexture;
+        header.fontWidth = fontWidth;
+        header.fontHeight = fontHeight;
+        memcpy(m_chunk, &header, sizeof(header));
+        m_position = headerSize;
+        return true;
+    }
+
+    void captureWriter::close() {
+        if (m_fd < 0)
+            return;
+
+        // Index record, then the header learns where it is
+        size_t indexSize = sizeof(uint64_t) + m_index.size() * sizeof(indexEntry);
+        uint64_t indexOffset = m_position;
+        uint8_t *dst = m_chunk != nullptr ? beginRecord(index, indexSize) : nullptr;
+        if (dst != nullptr) {
+            indexOffset = m_position - record_header_size - align(indexSize);
+            uint64_t count = m_index.size();
+            memcpy(dst, &count, sizeof(count));
+            if (!m_index.empty())
+                memcpy(dst + sizeof(count), m_index.data(), m_index.size() * sizeof(indexEntry));
+        }
+        unmapChunk();
+        if (dst != nullptr) {
+            if (pwrite(m_fd, &indexOffset, sizeof(indexOffset), offsetof(fileHeader, indexOffset)) !=
+                (ssize_t) sizeof(indexOffset))
+                fprintf(stderr, "[capture] Could not write the index offset: %s\n", strerror(errno));
+        }
+        // The last chunk is only partially used
+        if (ftruncate(m_fd, (off_t) m_position) != 0)
+            fprintf(stderr, "[capture] Could not trim the capture: %s\n", strerror(errno));
+        ::close(m_fd);
+        m_fd = -1;
+        m_position = 0;
+        m_index.clear();
+    }
+
+    bool captureWriter::mapChunk(uint64_t offset, uint64_t size) {
+        unmapChunk();
+        if (ftruncate(m_fd, (off_t) (offset + size)) != 0) {
+            fprintf(stderr, "[capture] Could not grow the capture: %s\n", strerror(errno));
+            return false;
+        }
+        void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, (off_t) offset);
+        if (mapping == MAP_FAILED) {
+            fprintf(stderr, "[capture] Could not map the capture: %s\n", strerror(errno));
+            return false;
+        }
+        m_chunk = (uint8_t *) mapping;
+        m_chunkOffset = offset;
+        m_chunkBytes = size;
+        m_stats.chunks++;
+        return true;
+    }
+
+    void captureWriter::unmapChunk() {
+        if (m_chunk != nullptr)
+            munmap(m_chunk, m_chunkBytes);
+        m_chunk = nullptr;
+        m_chunkBytes = 0;
+    }
+#else
+    // Captures are written and read through file mappings, only implemented with POSIX mmap so far
+    bool captureWriter::open(const std::string &path, ImTextureID, uint32_t, uint32_t, uint64_t) {
+        fprintf(stderr, "[capture] Could not create '%s': not supported on this platform\n", path.c_str());
+        return false;
+    }
+
+    void captureWriter::close() {}
+
+    bool captureWriter::mapChunk(uint64_t, uint64_t) {
+        return false;
+    }
+
+    void captureWriter::unmapChunk() {}
+#endif
+
+    uint8_t *captureWriter::beginRecord(uint32_t type, size_t size) {
+        const uint64_t total = record_header_size + align(size);
+        if (size > UINT32_MAX)
+            return nullptr;
+        uint64_t chunkEnd = m_chunkOffset + m_chunkBytes;
+        if (m_position + total > chunkEnd) {
+            // Records are 8 byte aligned, so there is always room for the skip record's header
+            if (m_position < chunkEnd) {
+                recordHeader tail = {skip, (uint32_t) (chunkEnd - m_position - record_header_size)};
+                memcpy(m_chunk + (m_position - m_chunkOffset), &tail, record_header_size);
+                m_stats.bytes += chunkEnd - m_position;
+            }
+            uint64_t chunks = (total + m_chunkSize - 1) / m_chunkSize;
+            if (!mapChunk(chunkEnd, chunks * m_chunkSize))
+                return nullptr;
+            m_position = chunkEnd;
+        }
+        uint8_t *dst = m_chunk + (m_position - m_chunkOffset);
+        recordHeader header = {type, (uint32_t) size};
+        memcpy(dst, &header, record_header_size);
+        m_position += total;
+        m_stats.bytes += total;
+        return dst + record_header_size;
+    }
+
+    bool captureWriter::writeFrame(const ImDrawData *drawData, uint64_t frameNumber, double time, float deltaTime,
+                                   const ImGuiInputEvent *events, uint32_t eventCount) {
+        if (m_chunk == nullptr)
+            return false;
+        // Every frame is complete, so the reader can start anywhere
+        size_t drawDataSize = m_encoder.measure(drawData);
+        size_t eventBytes = eventCount * sizeof(ImGuiInputEvent);
+        size_t size = align(sizeof(frameRecord)) + align(eventBytes) + drawDataSize;
+        uint8_t *dst = beginRecord(frame, size);
+        if (dst == nullptr)
+            return false;
+        // A skip record may have moved the record to the next chunk
+        uint64_t offset = m_position - record_header_size - align(size);
+
+        frameRecord record = {};
+        record.frameNumber = frameNumber;
+        record.time = time;
+        record.deltaTime = deltaTime;
+        record.inputCount = eventCount;
+        record.drawDataSize = (uint32_t) drawDataSize;
+        memcpy(dst, &record, sizeof(record));
+        dst += align(sizeof(record));
+        if (eventBytes > 0)
+            memcpy(dst, events, eventBytes);
+        dst += align(eventBytes);
+        // Captured on screen, the replay has no reason to be at the same place
+        m_encoder.write(drawData, frameNumber, dst, true);
+
+        m_index.push_back({frameNumber, offset, time});
+        m_stats.frames++;
+        return true;
+    }
+
+#ifndef _WIN32
+    bool captureReader::open(const std::string &path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            fprintf(stderr, "[capture] Could not open '%s': %s\n", path.c_str(), strerror(errno));
+            return false;
+        }
+        struct stat info = {};
+        void *mapping = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && (size_t) info.st_size >= headerSize)
+            mapping = mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            fprintf(stderr, "[capture] '%s' is not a capture\n", path.c_str());
+            return false;
+        }
+        m_mapping = mapping;
+        m_size = (size_t) info.st_size;
+        m_header = (const fileHeader *) mapping;
+        if (m_header->magic != magic || m_header->version != version || m_header->vertexSize != sizeof(ImDrawVert) ||
+            m_header->indexSize != sizeof(ImDrawIdx) || m_header->inputEventSize != sizeof(ImGuiInputEvent) ||
+            m_header->chunkSize == 0) {
+            fprintf(stderr, "[capture] '%s' was written by an incompatible build\n", path.c_str());
+            close();
+            return false;
+        }
+
+        const auto *bytes = (const uint8_t *) m_mapping;
+        uint64_t indexOffset = m_header->indexOffset;
+        recordHeader record = {};
+        if (indexOffset != 0 && indexOffset <= m_size &&
+            record_header_size + sizeof(uint64_t) <= m_size - indexOffset)
+            memcpy(&record, bytes + indexOffset, record_header_size);
+        uint64_t count = 0;
+        if (record.type == index) {
+            memcpy(&count, bytes + indexOffset + record_header_size, sizeof(count));
+            // Divided rather than multiplied, a corrupt count must not wrap around
+            m_indexed = record.size <= m_size - indexOffset - record_header_size &&
+                        record.size >= sizeof(count) &&
+                        count <= (record.size - sizeof(count)) / sizeof(indexEntry);
+        }
+        if (m_indexed) {
+            m_index.resize(count);
+            if (count > 0)
+                memcpy(m_index.data(), bytes + indexOffset + record_header_size + sizeof(count),
+                       count * sizeof(indexEntry));
+        } else if (!rebuildIndex()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void captureReader::close() {
+        m_decoder.clear();
+        m_decoder.clearTextures();
+        if (m_mapping != nullptr)
+            munmap(m_mapping, m_size);
+        m_mapping = nullptr;
+        m_size = 0;
+        m_header = nullptr;
+        m_index.clear();
+        m_indexed = false;
+    }
+#else
+    bool captureReader::open(const std::string &path) {
+        fprintf(stderr, "[capture] Could not open '%s': not supported on this platform\n", path.c_str());
+        return false;
+    }
+
+    void captureReader::close() {}
+#endif
+
+    bool captureReader::rebuildIndex() {
+        const auto *bytes = (const uint8_t *) m_mapping;
+        uint64_t position = headerSize;
+        while (position + record_header_size <= m_size) {
+            recordHeader record;
+            memcpy(&record, bytes + position, record_header_size);
+            uint64_t next = position + record_header_size + align(record.size);
+            if (record.type == end || next > m_size)
+                break;
+            if (record.type == frame && record.size >= sizeof(frameRecord)) {
+                frameRecord frame_record;
+                memcpy(&frame_record, bytes + position + record_header_size, sizeof(frame_record));
+                m_index.push_back({frame_record.frameNumber, position, frame_record.time});
+            }
+            position = next;
+        }
+        fprintf(stderr, "[capture] The capture was not closed, recovered %zu frames\n", m_index.size());
+        return true;
+    }
+
+    bool captureReader::readFrame(size_t i, frameInfo *info) {
+        if (i >= m_index.size())
+            return false;
+        const auto *bytes = (const uint8_t *) m_mapping;
+        uint64_t offset = m_index[i].offset;
+        recordHeader header;
+        if (offset + record_header_size > m_size)
+            return false;
+        memcpy(&header, bytes + offset, record_header_size);
+        const uint8_t *payload = bytes + offset + record_header_size;
+        if (header.type != frame || header.size < sizeof(frameRecord) ||
+            offset + record_header_size + header.size > m_size)
+            return false;
+
+        frameRecord record;
+        memcpy(&record, payload, sizeof(record));
+        size_t eventBytes = record.inputCount * sizeof(ImGuiInputEvent);
+        size_t drawDataOffset = align(sizeof(record)) + align(eventBytes);
+        if (drawDataOffset + record.drawDataSize > header.size)
+            return false;
+        if (info != nullptr) {
+            info->frameNumber = record.frameNumber;
+            info->time = record.time;
+            info->deltaTime = record.deltaTime;
+            info->events = (const ImGuiInputEvent *) (payload + align(sizeof(record)));
+            info->eventCount = record.inputCount;
+        }
+        return m_decoder.decode(payload + drawDataOffset, record.drawDataSize, true);
+    }
+
+    void captureReader::queueInput(const frameInfo &info) {
+        ImGuiContext &g = *ImGui::GetCurrentContext();
+        for (uint32_t i = 0; i < info.eventCount; i++)
+            g.InputEventsQueue.push_back(info.events[i]);
+    }
+
+    bool captureReader::setFontTexture(ImTextureID local, uint32_t width, uint32_t height) {
+        m_decoder.setTexture(m_header->fontTexture, local);
+        return width == m_header->fontWidth && height == m_header->fontHeight;
+    }
+
+} // engine
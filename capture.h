@@ -0,0 +1,213 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_CAPTURE_H
+#define EASYGRAPHICSLIB_CAPTURE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "drawcodec.h"
+#include "imgui.h"
+
+struct ImGuiInputEvent;
+
+namespace engine {
+
+    /**
+     * @brief File layout of a capture. The file is written in chunks of chunkSize bytes, records never cross
+     * a chunk boundary unless they are larger than a chunk, in which case they start one
+     */
+    namespace capture_format {
+        constexpr uint32_t magic = 0x43474c45; // "EGLC"
+        constexpr uint32_t version = 1;
+
+        struct fileHeader {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t vertexSize;
+            uint32_t indexSize;
+            uint32_t inputEventSize;
+            uint32_t fontWidth;
+            uint64_t chunkSize;
+            uint64_t fontTexture;       // Texture id of the font atlas in the capturing process
+            uint32_t fontHeight;
+            uint32_t padding;
+            uint64_t indexOffset;       // Offset of the index record, 0 if the capture was not closed
+        };
+
+        constexpr size_t headerSize = (sizeof(fileHeader) + 63) & ~(size_t) 63;
+
+        enum recordType : uint32_t {
+            end = 0,        // Zeroed space, nothing was written after this
+            frame = 1,
+            skip = 2,       // The rest of the chunk is unused
+            index = 3
+        };
+
+        struct recordHeader {
+            uint32_t type;
+            uint32_t size;  // Payload bytes, the next record starts 8 byte aligned
+        };
+
+        // Followed by inputCount ImGuiInputEvent, then a draw_format frame, each padded to 8 bytes
+        struct frameRecord {
+            uint64_t frameNumber;
+            double time;                // Seconds since the capture started
+            float deltaTime;            // ImGuiIO::DeltaTime of the frame
+            uint32_t inputCount;
+            uint32_t drawDataSize;
+            uint32_t padding;
+        };
+
+        // The index record is a uint64_t count followed by the entries
+        struct indexEntry {
+            uint64_t frameNumber;
+            uint64_t offset;            // Of the frame record header
+            double time;
+        };
+
+        using draw_format::align;
+    }
+
+    struct captureStatistics {
+        uint64_t frames = 0;
+        uint64_t bytes = 0;             // Records written, including skipped chunk tails
+        uint64_t chunks = 0;
+    };
+
+    /**
+     * @brief Appends frames to a memory-mapped capture file.
+     *
+     * Records are written straight into the mapped chunk at the end of the file, the file grows one chunk at a
+     * time. close() appends an index of all frames. Without it, e.g. after a crash, the reader rebuilds the
+     * index by walking the records. Only use from one thread.
+     */
+    class captureWriter {
+
+    public:
+        static constexpr uint64_t defaultChunkSize = 16ull << 20;
+
+        captureWriter() = default;
+
+        captureWriter(const captureWriter &) = delete;
+
+        captureWriter &operator=(const captureWriter &) = delete;
+
+        ~captureWriter() { close(); }
+
+        /**
+         * @param fontTexture Texture id of the font atlas, so a replay can draw the text with its own
+         */
+        bool open(const std::string &path, ImTextureID fontTexture, uint32_t fontWidth, uint32_t fontHeight,
+                  uint64_t chunkSize = defaultChunkSize);
+
+        void close();
+
+        [[nodiscard]] bool isOpen() const { return m_fd >= 0; }
+
+        /**
+         * @param events Input events ImGui processed in the frame
+         */
+        bool writeFrame(const ImDrawData *drawData, uint64_t frameNumber, double time, float deltaTime,
+                        const ImGuiInputEvent *events, uint32_t eventCount);
+
+        [[nodiscard]] const captureStatistics &stats() const { return m_stats; }
+
+    private:
+        /**
+         * @brief Maps space for a record of size payload bytes and writes its header
+         */
+        uint8_t *beginRecord(uint32_t type, size_t size);
+
+        bool mapChunk(uint64_t offset, uint64_t size);
+
+        void unmapChunk();
+
+        int m_fd = -1;
+        uint64_t m_chunkSize = defaultChunkSize;
+        uint64_t m_chunkOffset = 0;     // File offset of the mapping
+        uint64_t m_chunkBytes = 0;
+        uint8_t *m_chunk = nullptr;
+        uint64_t m_position = 0;        // File offset of the next record
+        std::vector<capture_format::indexEntry> m_index;
+        drawDataEncoder m_encoder;
+        captureStatistics m_stats;
+    };
+
+    /**
+     * @brief Maps a capture file and decodes its frames in place, without copying vertices or indices
+     */
+    class captureReader {
+
+    public:
+        struct frameInfo {
+            uint64_t frameNumber = 0;
+            double time = 0.0;
+            float deltaTime = 0.0f;
+            const ImGuiInputEvent *events = nullptr;
+            uint32_t eventCount = 0;
+        };
+
+        captureReader() = default;
+
+        captureReader(const captureReader &) = delete;
+
+        captureReader &operator=(const captureReader &) = delete;
+
+        ~captureReader() { close(); }
+
+        bool open(const std::string &path);
+
+        void close();
+
+        [[nodiscard]] size_t frameCount() const { return m_index.size(); }
+
+        /**
+         * @brief Whether the file had an index, false if it was rebuilt from the records
+         */
+        [[nodiscard]] bool indexed() const { return m_indexed; }
+
+        /**
+         * @brief Decodes frame i into data(), info receives its timing and input
+         */
+        bool readFrame(size_t i, frameInfo *info = nullptr);
+
+        /**
+         * @brief The decoded frame, valid until the next readFrame() or close()
+         */
+        [[nodiscard]] const ImDrawData *data() const { return m_decoder.data(); }
+
+        /**
+         * @brief Queues the input events of a frame into the current ImGui context, as if they just happened
+         */
+        static void queueInput(const frameInfo &info);
+
+        /**
+         * @brief Texture id draw commands with the captured texture get. Everything but the font atlas, see
+         * setFontTexture(), is dropped unless it is mapped here
+         */
+        void setTexture(uint64_t captured, ImTextureID local) { m_decoder.setTexture(captured, local); }
+
+        /**
+         * @brief Maps the captured font atlas to the current one, both have to be built from the same fonts
+         * @return false if the atlas sizes differ, the text would come out garbled then
+         */
+        bool setFontTexture(ImTextureID local, uint32_t width, uint32_t height);
+
+    private:
+        bool rebuildIndex();
+
+        void *m_mapping = nullptr;
+        size_t m_size = 0;
+        const capture_format::fileHeader *m_header = nullptr;
+        std::vector<capture_format::indexEntry> m_index;
+        bool m_indexed = false;
+        drawDataDecoder m_decoder;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_CAPTURE_H
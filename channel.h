@@ -0,0 +1,287 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_CHANNEL_H
+#define EASYGRAPHICSLIB_CHANNEL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace engine {
+
+    /**
+     * @brief What a channel does with a sample that arrives while the ring is full
+     */
+    enum class overflowPolicy {
+        dropOldest, // Evict the oldest queued sample to make room for the new one
+        coalesce    // Keep the queue as is and collapse all overflow into a single "latest" sample
+    };
+
+    /**
+     * @brief Type erased part of a channel, so the window can drain all channels once per frame
+     */
+    class channelBase {
+    public:
+        explicit channelBase(std::string name) : m_name(std::move(name)) {}
+
+        virtual ~channelBase() = default;
+
+        channelBase(const channelBase &) = delete;
+
+        channelBase &operator=(const channelBase &) = delete;
+
+        /**
+         * @brief Moves all pending samples to the consumer callback. Must only be called from the render thread
+         * @return Number of samples handed to the consumer
+         */
+        virtual size_t drain() = 0;
+
+        [[nodiscard]] const std::string &name() const { return m_name; }
+
+        /**
+         * @brief Sets a function that is called when the first sample after a drain arrives,
+         * e.g. to wake up a render loop that sleeps while idle. Called on the producing thread
+         */
+        void setNotify(std::function<void()> notify) { m_notify = std::move(notify); }
+
+    protected:
+        // One notification per drain keeps the cost of a push at a single exchange
+        void notify() {
+            if (m_notify != nullptr && !m_signalled.exchange(true, std::memory_order_acq_rel))
+                m_notify();
+        }
+
+        void rearmNotify() { m_signalled.store(false, std::memory_order_release); }
+
+    private:
+        std::string m_name;
+        std::function<void()> m_notify = nullptr;
+        std::atomic<bool> m_signalled{false};
+    };
+
+    /**
+     * @brief Bounded lock-free multi-producer ring buffer (Vyukov style sequence numbered cells)
+     *
+     * Any number of threads may push, the render thread drains once per frame and gets every
+     * pending sample as one contiguous batch. Producers never block: a full ring is resolved
+     * according to the overflow policy.
+     */
+    template<typename T>
+    class channel : public channelBase {
+    public:
+        using drainCallback = std::function<void(const T *samples, size_t count)>;
+
+        channel(std::string name, size_t capacity, overflowPolicy policy, drainCallback cb) :
+                channelBase(std::move(name)), m_policy(policy), m_onDrain(std::move(cb)) {
+            // Round the capacity up to a power of two so the index wraps with a mask
+            size_t size = 2;
+            while (size < capacity)
+                size <<= 1;
+            m_mask = size - 1;
+            m_cells = std::make_unique<cell[]>(size);
+            for (size_t i = 0; i < size; i++)
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+            m_scratch.reserve(size + 1);
+        }
+
+        /**
+         * @brief Pushes a single sample. Safe to call from any thread
+         * @return false if the sample had to be discarded
+         */
+        bool push(const T &sample) {
+            return push(&sample, 1) == 1;
+        }
+
+        /**
+         * @brief Pushes a batch of samples, claiming as many consecutive cells as possible per CAS
+         * @return Number of samples that were queued or coalesced
+         */
+        size_t push(const T *samples, size_t count) {
+            size_t accepted = 0;
+            while (accepted < count) {
+                size_t queued = tryEnqueue(samples + accepted, count - accepted);
+                if (queued > 0) {
+                    accepted += queued;
+                    continue;
+                }
+
+                // Ring is full
+                if (m_policy == overflowPolicy::dropOldest) {
+                    if (tryDequeue([](size_t, T &&) {}))
+                        m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+
+                // Coalesce: only the newest sample of the remaining batch survives
+                if (storeCoalesced(samples[count - 1])) {
+                    m_coalesced.fetch_add(count - accepted - 1, std::memory_order_relaxed);
+                    accepted = count;
+                } else {
+                    m_dropped.fetch_add(count - accepted, std::memory_order_relaxed);
+                }
+                break;
+            }
+            if (accepted > 0)
+                notify();
+            return accepted;
+        }
+
+        size_t drain() override {
+            m_scratch.clear();
+            rearmNotify();
+
+            // Never take more than one ring worth of samples, so busy producers cannot stall the frame
+            bool empty = false;
+            for (size_t i = 0; i <= m_mask && !empty; i++) {
+                empty = !tryDequeue([this](size_t position, T &&sample) {
+                    // A sample that overflowed before this one was queued is older, so it goes first
+                    if (m_policy == overflowPolicy::coalesce)
+                        takeCoalesced(position);
+                    m_scratch.push_back(std::move(sample));
+                });
+            }
+
+            // Newer than everything that was drained. Samples left in the ring are older, so it waits for them
+            if (empty && m_policy == overflowPolicy::coalesce)
+                takeCoalesced(SIZE_MAX);
+
+            if (!m_scratch.empty() && m_onDrain != nullptr)
+                m_onDrain(m_scratch.data(), m_scratch.size());
+            return m_scratch.size();
+        }
+
+        [[nodiscard]] size_t capacity() const { return m_mask + 1; }
+
+        [[nodiscard]] overflowPolicy policy() const { return m_policy; }
+
+        /**
+         * @brief Samples lost because of overflow (evicted with dropOldest, or contended with coalesce)
+         */
+        [[nodiscard]] uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Samples that were merged away by the coalesce policy
+         */
+        [[nodiscard]] uint64_t coalesced() const { return m_coalesced.load(std::memory_order_relaxed); }
+
+    private:
+        struct cell {
+            std::atomic<size_t> sequence{0};
+            std::optional<T> value;
+        };
+
+        size_t tryEnqueue(const T *samples, size_t count) {
+            size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+            for (;;) {
+                // Count the consecutive free cells starting at pos
+                size_t free = 0;
+                while (free < count && free <= m_mask) {
+                    size_t seq = m_cells[(pos + free) & m_mask].sequence.load(std::memory_order_acquire);
+                    if (seq != pos + free)
+                        break;
+                    free++;
+                }
+
+                if (free == 0) {
+                    size_t seq = m_cells[pos & m_mask].sequence.load(std::memory_order_acquire);
+                    if ((intptr_t) (seq - pos) < 0)
+                        return 0; // full
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                    continue;
+                }
+
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + free, std::memory_order_relaxed)) {
+                    for (size_t i = 0; i < free; i++) {
+                        cell &c = m_cells[(pos + i) & m_mask];
+                        c.value = samples[i];
+                        c.sequence.store(pos + i + 1, std::memory_order_release);
+                    }
+                    return free;
+                }
+            }
+        }
+
+        /**
+         * @brief Hands the oldest sample and its position to consume, which runs before the cell is released.
+         * Consumers are the render thread and, with dropOldest, producers evicting the oldest sample
+         */
+        template<typename Consume>
+        bool tryDequeue(Consume &&consume) {
+            size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+            for (;;) {
+                cell &c = m_cells[pos & m_mask];
+                size_t seq = c.sequence.load(std::memory_order_acquire);
+                auto diff = (intptr_t) (seq - (pos + 1));
+                if (diff == 0) {
+                    if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        consume(pos, std::move(*c.value));
+                        c.value.reset();
+                        c.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false; // empty
+                } else {
+                    pos = m_dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Try-lock only: a producer that loses the race drops its sample instead of waiting
+        bool storeCoalesced(const T &sample) {
+            if (m_coalesceLock.test_and_set(std::memory_order_acquire))
+                return false;
+            if (m_hasCoalesced.load(std::memory_order_relaxed))
+                m_coalesced.fetch_add(1, std::memory_order_relaxed);
+            m_coalescedSample = sample;
+            // Everything queued at a lower position was queued before the overflow
+            m_coalescedPosition = m_enqueuePos.load(std::memory_order_relaxed);
+            m_hasCoalesced.store(true, std::memory_order_release);
+            m_coalesceLock.clear(std::memory_order_release);
+            return true;
+        }
+
+        // Render thread only, moves the coalesced sample to the batch if it overflowed before position was queued
+        void takeCoalesced(size_t position) {
+            if (!m_hasCoalesced.load(std::memory_order_acquire) ||
+                m_coalesceLock.test_and_set(std::memory_order_acquire))
+                return;
+            if (m_hasCoalesced.load(std::memory_order_relaxed) && m_coalescedPosition <= position) {
+                m_scratch.push_back(std::move(*m_coalescedSample));
+                m_coalescedSample.reset();
+                m_hasCoalesced.store(false, std::memory_order_relaxed);
+            }
+            m_coalesceLock.clear(std::memory_order_release);
+        }
+
+        overflowPolicy m_policy;
+        drainCallback m_onDrain;
+        size_t m_mask = 0;
+        std::unique_ptr<cell[]> m_cells;
+
+        alignas(64) std::atomic<size_t> m_enqueuePos{0};
+        alignas(64) std::atomic<size_t> m_dequeuePos{0};
+
+        alignas(64) std::atomic_flag m_coalesceLock = ATOMIC_FLAG_INIT;
+        std::atomic<bool> m_hasCoalesced{false};
+        std::optional<T> m_coalescedSample;
+        size_t m_coalescedPosition = 0;
+
+        alignas(64) std::atomic<uint64_t> m_dropped{0};
+        std::atomic<uint64_t> m_coalesced{0};
+
+        //Render thread only
+        std::vector<T> m_scratch;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_CHANNEL_H
@@ -0,0 +1,299 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "imgui.h"
+
+#define GLFW_INCLUDE_NONE
+#define GLFW_INCLUDE_VULKAN
+
+#include <GLFW/glfw3.h>
+#include "devicecontext.h"
+#include "vkutils.h"
+
+#ifdef _DEBUG
+#define IMGUI_VULKAN_DEBUG_REPORT
+#endif
+
+namespace engine {
+
+    std::mutex deviceContext::s_mutex;
+    std::weak_ptr<deviceContext> deviceContext::s_shared[2];
+
+#ifdef IMGUI_VULKAN_DEBUG_REPORT
+    static VKAPI_ATTR VkBool32 VKAPI_CALL debug_report(VkDebugReportFlagsEXT flags, VkDebugReportObjectTypeEXT objectType, uint64_t object, size_t location, int32_t messageCode, const char* pLayerPrefix, const char* pMessage, void* pUserData)
+{
+    (void)flags; (void)object; (void)location; (void)messageCode; (void)pUserData; (void)pLayerPrefix; // Unused arguments
+    fprintf(stderr, "[vulkan] Debug report from ObjectType: %i\nMessage: %s\n\n", objectType, pMessage);
+    return VK_FALSE;
+}
+#endif // IMGUI_VULKAN_DEBUG_REPORT
+
+    static bool instance_extension_available(const char *name) {
+        uint32_t count = 0;
+        vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr);
+        std::vector<VkExtensionProperties> properties(count);
+        vkEnumerateInstanceExtensionProperties(nullptr, &count, properties.data());
+        for (const VkExtensionProperties &p: properties)
+            if (strcmp(p.extensionName, name) == 0)
+                return true;
+        return false;
+    }
+
+    static bool device_extension_available(VkPhysicalDevice physicalDevice, const char *name) {
+        uint32_t count = 0;
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, nullptr);
+        std::vector<VkExtensionProperties> properties(count);
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, properties.data());
+        for (const VkExtensionProperties &p: properties)
+            if (strcmp(p.extensionName, name) == 0)
+                return true;
+        return false;
+    }
+
+    std::shared_ptr<deviceContext> deviceContext::acquire(const deviceContextSettings &settings) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        std::weak_ptr<deviceContext> &shared = s_shared[settings.headless ? 1 : 0];
+        std::shared_ptr<deviceContext> context = shared.lock();
+        if (context == nullptr) {
+            context = std::shared_ptr<deviceContext>(new deviceContext());
+            context->create(settings);
+            shared = context;
+        }
+        return context;
+    }
+
+    void deviceContext::create(const deviceContextSettings &settings) {
+        VkResult err;
+        m_headless = settings.headless;
+        m_allocator = settings.hostAllocator ? m_hostMemory.callbacks() : nullptr;
+        m_pipelineCachePath = settings.pipelineCachePath;
+
+        // VK_EXT_memory_budget is queried through vkGetPhysicalDeviceMemoryProperties2, which a 1.0 instance
+        // only has with VK_KHR_get_physical_device_properties2
+        const bool properties2 = settings.memoryBudget &&
+                                 instance_extension_available(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+
+        // Create Vulkan Instance
+        {
+            // Headless mode renders offscreen only, so it needs no surface extensions
+            uint32_t extensions_count = 0;
+            const char **required = m_headless ? nullptr : glfwGetRequiredInstanceExtensions(&extensions_count);
+            std::vector<const char *> instance_extensions(required, required + extensions_count);
+            if (properties2)
+                instance_extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+            extensions_count = (uint32_t) instance_extensions.size();
+            const char **extensions = instance_extensions.data();
+
+            VkInstanceCreateInfo create_info = {};
+            create_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+            create_info.enabledExtensionCount = extensions_count;
+            create_info.ppEnabledExtensionNames = extensions;
+#ifdef IMGUI_VULKAN_DEBUG_REPORT
+            // Enabling validation layers
+        const char* layers[] = { "VK_LAYER_KHRONOS_validation" };
+        create_info.enabledLayerCount = 1;
+        create_info.ppEnabledLayerNames = layers;
+
+        // Enable debug report extension (we need additional storage, so we duplicate the user array to add our new extension to it)
+        const char** extensions_ext = (const char**)malloc(sizeof(const char*) * (extensions_count + 1));
+        if (extensions_count > 0)
+            memcpy(extensions_ext, extensions, extensions_count * sizeof(const char*));
+        extensions_ext[extensions_count] = "VK_EXT_debug_report";
+        create_info.enabledExtensionCount = extensions_count + 1;
+        create_info.ppEnabledExtensionNames = extensions_ext;
+
+        // Create Vulkan Instance
+        err = vkCreateInstance(&create_info, m_allocator, &m_instance);
+        check_vk_result(err);
+        free(extensions_ext);
+
+        // Get the function pointer (required for any extensions)
+        auto vkCreateDebugReportCallbackEXT = (PFN_vkCreateDebugReportCallbackEXT)vkGetInstanceProcAddr(m_instance, "vkCreateDebugReportCallbackEXT");
+        IM_ASSERT(vkCreateDebugReportCallbackEXT != NULL);
+
+        // Setup the debug report callback
+        VkDebugReportCallbackCreateInfoEXT debug_report_ci = {};
+        debug_report_ci.sType = VK_STRUCTURE_TYPE_DEBUG_REPORT_CALLBACK_CREATE_INFO_EXT;
+        debug_report_ci.flags = VK_DEBUG_REPORT_ERROR_BIT_EXT | VK_DEBUG_REPORT_WARNING_BIT_EXT | VK_DEBUG_REPORT_PERFORMANCE_WARNING_BIT_EXT;
+        debug_report_ci.pfnCallback = debug_report;
+        debug_report_ci.pUserData = NULL;
+        err = vkCreateDebugReportCallbackEXT(m_instance, &debug_report_ci, m_allocator, &m_debugReport);
+        check_vk_result(err);
+#else
+            // Create Vulkan Instance without any debug feature
+            err = vkCreateInstance(&create_info, m_allocator, &m_instance);
+            check_vk_result(err);
+            IM_UNUSED(m_debugReport);
+#endif
+        }
+
+        // Select GPU
+        {
+            uint32_t gpu_count;
+            err = vkEnumeratePhysicalDevices(m_instance, &gpu_count, nullptr);
+            check_vk_result(err);
+            IM_ASSERT(gpu_count > 0);
+
+            auto *gpus = (VkPhysicalDevice *) malloc(sizeof(VkPhysicalDevice) * gpu_count);
+            err = vkEnumeratePhysicalDevices(m_instance, &gpu_count, gpus);
+            check_vk_result(err);
+
+            // If a number >1 of GPUs got reported, find discrete GPU if present, or use first one available. This covers
+            // most common cases (multi-gpu/integrated+dedicated graphics). Handling more complicated setups (multiple
+            // dedicated GPUs) is out of scope of this sample.
+            int use_gpu = 0;
+            for (int i = 0; i < (int) gpu_count; i++) {
+                VkPhysicalDeviceProperties properties;
+                vkGetPhysicalDeviceProperties(gpus[i], &properties);
+                if (properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
+                    use_gpu = i;
+                    break;
+                }
+            }
+
+            m_physicalDevice = gpus[use_gpu];
+            free(gpus);
+        }
+
+        // Select graphics queue family
+        {
+            uint32_t count;
+            vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &count, nullptr);
+            auto *queues = (VkQueueFamilyProperties *) malloc(sizeof(VkQueueFamilyProperties) * count);
+            vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &count, queues);
+            for (uint32_t i = 0; i < count; i++)
+                if (queues[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+                    m_queueFamily = i;
+                    break;
+                }
+
+            // A transfer-only family usually maps to a copy engine that runs alongside rendering
+            for (uint32_t i = 0; i < count; i++)
+                if ((queues[i].queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+                    !(queues[i].queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+                    m_transferQueueFamily = i;
+                    break;
+                }
+            free(queues);
+            IM_ASSERT(m_queueFamily != (uint32_t) -1);
+        }
+
+        // Create Logical Device (with 1 queue, plus 1 for uploads if there is a transfer family)
+        {
+            std::vector<const char *> device_extensions;
+            if (!m_headless)
+                device_extensions.push_back("VK_KHR_swapchain");
+            const bool memory_budget = properties2 &&
+                                       device_extension_available(m_physicalDevice,
+                                                                  VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+            if (memory_budget)
+                device_extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+            const float queue_priority[] = {1.0f};
+            VkDeviceQueueCreateInfo queue_info[2] = {};
+            queue_info[0].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            queue_info[0].queueFamilyIndex = m_queueFamily;
+            queue_info[0].queueCount = 1;
+            queue_info[0].pQueuePriorities = queue_priority;
+            queue_info[1] = queue_info[0];
+            queue_info[1].queueFamilyIndex = m_transferQueueFamily;
+            VkDeviceCreateInfo create_info = {};
+            create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+            create_info.queueCreateInfoCount = m_transferQueueFamily != (uint32_t) -1 ? 2 : 1;
+            create_info.pQueueCreateInfos = queue_info;
+            create_info.enabledExtensionCount = (uint32_t) device_extensions.size();
+            create_info.ppEnabledExtensionNames = device_extensions.data();
+            err = vkCreateDevice(m_physicalDevice, &create_info, m_allocator, &m_device);
+            check_vk_result(err);
+            if (memory_budget)
+                m_getMemoryProperties2 = (PFN_vkGetPhysicalDeviceMemoryProperties2KHR) vkGetInstanceProcAddr(
+                        m_instance, "vkGetPhysicalDeviceMemoryProperties2KHR");
+            vkGetDeviceQueue(m_device, m_queueFamily, 0, &m_queue);
+            if (m_transferQueueFamily != (uint32_t) -1)
+                vkGetDeviceQueue(m_device, m_transferQueueFamily, 0, &m_transferQueue);
+        }
+
+        // Create Descriptor Pool, shared by the ImGui backends and heatmaps of all windows
+        {
+            VkDescriptorPoolSize pool_sizes[] =
+                    {
+                            {VK_DESCRIPTOR_TYPE_SAMPLER,                1000},
+                            {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1000},
+                            {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,          1000},
+                            {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          1000},
+                            {VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER,   1000},
+                            {VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER,   1000},
+                            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,         1000},
+                            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         1000},
+                            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1000},
+                            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1000},
+                            {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,       1000}
+                    };
+            VkDescriptorPoolCreateInfo pool_info = {};
+            pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+            pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+            pool_info.maxSets = 1000 * IM_ARRAYSIZE(pool_sizes);
+            m_descriptorPoolSets = pool_info.maxSets;
+            pool_info.poolSizeCount = (uint32_t) IM_ARRAYSIZE(pool_sizes);
+            pool_info.pPoolSizes = pool_sizes;
+            err = vkCreateDescriptorPool(m_device, &pool_info, m_allocator, &m_descriptorPool);
+            check_vk_result(err);
+        }
+
+        m_deviceMemory.create(m_physicalDevice, m_device, m_allocator);
+        m_pipelineCache.create(m_physicalDevice, m_device, m_allocator, m_pipelineCachePath);
+    }
+
+    bool deviceContext::queryMemoryBudget(std::vector<VkDeviceSize> &budget, std::vector<VkDeviceSize> &usage) const {
+        if (m_getMemoryProperties2 == nullptr)
+            return false;
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT budget_properties = {};
+        budget_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+        VkPhysicalDeviceMemoryProperties2 properties = {};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        properties.pNext = &budget_properties;
+        m_getMemoryProperties2(m_physicalDevice, &properties);
+        const uint32_t heaps = properties.memoryProperties.memoryHeapCount;
+        budget.assign(budget_properties.heapBudget, budget_properties.heapBudget + heaps);
+        usage.assign(budget_properties.heapUsage, budget_properties.heapUsage + heaps);
+        return true;
+    }
+
+    void deviceContext::beginMemoryPressure() {
+        std::lock_guard<std::mutex> lock(m_pressureMutex);
+        if (m_pressureCount++ == 0)
+            m_deviceMemory.setKeepEmptyBlocks(false);
+    }
+
+    void deviceContext::endMemoryPressure() {
+        std::lock_guard<std::mutex> lock(m_pressureMutex);
+        if (m_pressureCount > 0 && --m_pressureCount == 0)
+            m_deviceMemory.setKeepEmptyBlocks(true);
+    }
+
+    deviceContext::~deviceContext() {
+        if (m_device == VK_NULL_HANDLE)
+            return;
+        VkResult err = vkDeviceWaitIdle(m_device);
+        check_vk_result(err);
+
+        if (!m_pipelineCache.save())
+            fprintf(stderr, "Failed to save the pipeline cache to %s\n", m_pipelineCachePath.c_str());
+        m_pipelineCache.destroy();
+        m_deviceMemory.destroy();
+        vkDestroyDescriptorPool(m_device, m_descriptorPool, m_allocator);
+
+#ifdef IMGUI_VULKAN_DEBUG_REPORT
+        // Remove the debug report callback
+    auto vkDestroyDebugReportCallbackEXT = (PFN_vkDestroyDebugReportCallbackEXT)vkGetInstanceProcAddr(m_instance, "vkDestroyDebugReportCallbackEXT");
+    vkDestroyDebugReportCallbackEXT(m_instance, m_debugReport, m_allocator);
+#endif // IMGUI_VULKAN_DEBUG_REPORT
+
+        vkDestroyDevice(m_device, m_allocator);
+        vkDestroyInstance(m_instance, m_allocator);
+    }
+
+} // engine
@@ -0,0 +1,142 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_DEVICECONTEXT_H
+#define EASYGRAPHICSLIB_DEVICECONTEXT_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "vulkan/vulkan.h"
+#include "allocator.h"
+#include "pipelinecache.h"
+
+namespace engine {
+
+    struct deviceContextSettings {
+        bool headless = false;          // No surface or swapchain extensions
+        bool hostAllocator = true;      // Route host allocations through hostAllocator
+        std::string pipelineCachePath;  // Empty keeps the pipeline cache in memory only
+        bool memoryBudget = true;       // Enable VK_EXT_memory_budget if the driver has it
+    };
+
+    /**
+     * @brief Vulkan instance, device, queues, pipeline cache, descriptor pool and allocators shared by all
+     * windows of a process.
+     *
+     * Windows attach with acquire() and keep the context alive through the returned shared_ptr, the last
+     * window to detach destroys the device and saves the pipeline cache. Headless and windowed contexts are
+     * separate, since only the latter need the surface extensions. Queues and the descriptor pool are externally
+     * synchronized, so windows sharing a context have to be driven from the same thread. A window with a render
+     * thread holds queueMutex() around its submissions and presents, and so does everything else that submits
+     * while the render thread runs.
+     */
+    class deviceContext {
+
+    public:
+        deviceContext(const deviceContext &) = delete;
+
+        deviceContext &operator=(const deviceContext &) = delete;
+
+        ~deviceContext();
+
+        /**
+         * @brief Returns the shared context, creating it on first use. GLFW has to be initialized before a
+         * windowed context is acquired. The settings only apply when the context is created
+         */
+        static std::shared_ptr<deviceContext> acquire(const deviceContextSettings &settings);
+
+        [[nodiscard]] bool headless() const { return m_headless; }
+
+        [[nodiscard]] VkInstance instance() const { return m_instance; }
+
+        [[nodiscard]] VkPhysicalDevice physicalDevice() const { return m_physicalDevice; }
+
+        [[nodiscard]] VkDevice device() const { return m_device; }
+
+        [[nodiscard]] uint32_t queueFamily() const { return m_queueFamily; }
+
+        [[nodiscard]] VkQueue queue() const { return m_queue; }
+
+        /**
+         * @brief Transfer-only queue family, (uint32_t)-1 if the device has none
+         */
+        [[nodiscard]] uint32_t transferQueueFamily() const { return m_transferQueueFamily; }
+
+        [[nodiscard]] VkQueue transferQueue() const { return m_transferQueue; }
+
+        [[nodiscard]] VkDescriptorPool descriptorPool() const { return m_descriptorPool; }
+
+        /**
+         * @brief Number of sets the descriptor pool was created for
+         */
+        [[nodiscard]] uint32_t descriptorPoolSets() const { return m_descriptorPoolSets; }
+
+        /**
+         * @brief Whether VK_EXT_memory_budget got enabled, see queryMemoryBudget()
+         */
+        [[nodiscard]] bool memoryBudgetEnabled() const { return m_getMemoryProperties2 != nullptr; }
+
+        /**
+         * @brief Budget and usage of this process per memory heap as reported by the driver, indexed like
+         * VkPhysicalDeviceMemoryProperties::memoryHeaps. Returns false without VK_EXT_memory_budget
+         */
+        bool queryMemoryBudget(std::vector<VkDeviceSize> &budget, std::vector<VkDeviceSize> &usage) const;
+
+        /**
+         * @brief Serializes access to both queues between the threads of a window
+         */
+        [[nodiscard]] std::mutex &queueMutex() { return m_queueMutex; }
+
+        [[nodiscard]] const VkAllocationCallbacks *allocator() const { return m_allocator; }
+
+        [[nodiscard]] pipelineCache &pipelines() { return m_pipelineCache; }
+
+        [[nodiscard]] const hostAllocator &hostMemory() const { return m_hostMemory; }
+
+        [[nodiscard]] deviceAllocator &deviceMemory() { return m_deviceMemory; }
+
+        /**
+         * @brief Counts the windows that are under memory pressure. Empty blocks of the device allocator are freed
+         * while any of them is, and kept again once the last one left the pressure state
+         */
+        void beginMemoryPressure();
+
+        void endMemoryPressure();
+
+    private:
+        deviceContext() = default;
+
+        void create(const deviceContextSettings &settings);
+
+        static std::mutex s_mutex;
+        static std::weak_ptr<deviceContext> s_shared[2];   // Windowed and headless
+
+        bool m_headless = false;
+        hostAllocator m_hostMemory;
+        const VkAllocationCallbacks *m_allocator = nullptr;
+        VkInstance m_instance = VK_NULL_HANDLE;
+        VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
+        VkDevice m_device = VK_NULL_HANDLE;
+        uint32_t m_queueFamily = (uint32_t) -1;
+        VkQueue m_queue = VK_NULL_HANDLE;
+        uint32_t m_transferQueueFamily = (uint32_t) -1;
+        VkQueue m_transferQueue = VK_NULL_HANDLE;
+        std::mutex m_queueMutex;
+        VkDebugReportCallbackEXT m_debugReport = VK_NULL_HANDLE;
+        VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
+        uint32_t m_descriptorPoolSets = 0;
+        PFN_vkGetPhysicalDeviceMemoryProperties2KHR m_getMemoryProperties2 = nullptr;
+        pipelineCache m_pipelineCache;
+        std::string m_pipelineCachePath;
+        deviceAllocator m_deviceMemory;
+        std::mutex m_pressureMutex;
+        uint32_t m_pressureCount = 0;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_DEVICECONTEXT_H
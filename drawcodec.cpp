@@ -0,0 +1,297 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <cstdio>
+#include <cstring>
+#include "drawcodec.h"
+#include "renderthread.h"
+
+namespace engine {
+
+    using namespace draw_format;
+
+    static inline bool is_drawn(const ImDrawCmd &cmd) {
+        return cmd.UserCallback == nullptr && cmd.ElemCount > 0;
+    }
+
+    static uint32_t drawn_commands(const ImDrawList *list) {
+        uint32_t count = 0;
+        for (const ImDrawCmd &cmd: list->CmdBuffer)
+            count += is_drawn(cmd);
+        return count;
+    }
+
+    template<typename T>
+    static void write_struct(uint8_t *&dst, const T &value) {
+        memcpy(dst, &value, sizeof(T));
+        dst += align(sizeof(T));
+    }
+
+    size_t drawDataEncoder::measure(const ImDrawData *drawData, bool delta) {
+        const int count = drawData->CmdListsCount;
+        m_listHashes.resize((size_t) count);
+        m_reuse.assign((size_t) count, false);
+        size_t size = align(sizeof(frameHeader));
+        for (int n = 0; n < count; n++) {
+            const ImDrawList *list = drawData->CmdLists[n];
+            size += align(sizeof(listHeader));
+            if (delta) {
+                m_listHashes[n] = hashDrawList(list, (uint64_t) n);
+                if ((size_t) n < m_committedHashes.size() && m_committedHashes[n] == m_listHashes[n]) {
+                    m_reuse[n] = true;
+                    continue;
+                }
+            } else {
+                m_listHashes[n] = 0;
+            }
+            size += align(drawn_commands(list) * sizeof(drawCommand));
+            size += align((size_t) list->VtxBuffer.Size * sizeof(ImDrawVert));
+            size += align((size_t) list->IdxBuffer.Size * sizeof(ImDrawIdx));
+        }
+        return size;
+    }
+
+    void drawDataEncoder::write(const ImDrawData *drawData, uint64_t frameNumber, uint8_t *dst, bool toOrigin) {
+        const ImVec2 offset = toOrigin ? drawData->DisplayPos : ImVec2(0.0f, 0.0f);
+        const bool move = offset.x != 0.0f || offset.y != 0.0f;
+
+        frameHeader frame = {};
+        frame.frameNumber = frameNumber;
+        frame.displayPos[0] = drawData->DisplayPos.x - offset.x;
+        frame.displayPos[1] = drawData->DisplayPos.y - offset.y;
+        frame.displaySize[0] = drawData->DisplaySize.x;
+        frame.displaySize[1] = drawData->DisplaySize.y;
+        frame.framebufferScale[0] = drawData->FramebufferScale.x;
+        frame.framebufferScale[1] = drawData->FramebufferScale.y;
+        frame.listCount = (uint32_t) drawData->CmdListsCount;
+        frame.totalVtxCount = (uint32_t) drawData->TotalVtxCount;
+        frame.totalIdxCount = (uint32_t) drawData->TotalIdxCount;
+        write_struct(dst, frame);
+
+        for (int n = 0; n < drawData->CmdListsCount; n++) {
+            const ImDrawList *list = drawData->CmdLists[n];
+            listHeader header = {};
+            if (m_reuse[n]) {
+                header.flags = listReused;
+                write_struct(dst, header);
+                m_listsReused++;
+                continue;
+            }
+            header.cmdCount = drawn_commands(list);
+            header.vtxCount = (uint32_t) list->VtxBuffer.Size;
+            header.idxCount = (uint32_t) list->IdxBuffer.Size;
+            write_struct(dst, header);
+
+            uint8_t *commands = dst;
+            for (const ImDrawCmd &cmd: list->CmdBuffer) {
+                if (!is_drawn(cmd))
+                    continue;
+                drawCommand command = {};
+                command.clipRect[0] = cmd.ClipRect.x - offset.x;
+                command.clipRect[1] = cmd.ClipRect.y - offset.y;
+                command.clipRect[2] = cmd.ClipRect.z - offset.x;
+                command.clipRect[3] = cmd.ClipRect.w - offset.y;
+                command.texture = (uint64_t) cmd.GetTexID();
+                command.vtxOffset = cmd.VtxOffset;
+                command.idxOffset = cmd.IdxOffset;
+                command.elemCount = cmd.ElemCount;
+                memcpy(commands, &command, sizeof(command));
+                commands += sizeof(command);
+            }
+            dst += align(header.cmdCount * sizeof(drawCommand));
+
+            size_t vtxBytes = (size_t) header.vtxCount * sizeof(ImDrawVert);
+            if (move) {
+                auto *vertices = (ImDrawVert *) dst;
+                for (int v = 0; v < list->VtxBuffer.Size; v++) {
+                    ImDrawVert vertex = list->VtxBuffer.Data[v];
+                    vertex.pos.x -= offset.x;
+                    vertex.pos.y -= offset.y;
+                    memcpy(vertices + v, &vertex, sizeof(vertex));
+                }
+            } else if (vtxBytes > 0) {
+                memcpy(dst, list->VtxBuffer.Data, vtxBytes);
+            }
+            dst += align(vtxBytes);
+
+            size_t idxBytes = (size_t) header.idxCount * sizeof(ImDrawIdx);
+            if (idxBytes > 0)
+                memcpy(dst, list->IdxBuffer.Data, idxBytes);
+            dst += align(idxBytes);
+            m_listsWritten++;
+        }
+    }
+
+    void drawDataDecoder::releaseAliases() {
+        for (int n = 0; n < m_lists.Size; n++) {
+            if (!m_aliased[n])
+                continue;
+            ImDrawList *list = m_lists[n];
+            list->VtxBuffer.Data = nullptr;
+            list->VtxBuffer.Size = list->VtxBuffer.Capacity = 0;
+            list->IdxBuffer.Data = nullptr;
+            list->IdxBuffer.Size = list->IdxBuffer.Capacity = 0;
+            m_aliased[n] = false;
+        }
+    }
+
+    void drawDataDecoder::clear() {
+        releaseAliases();
+        for (ImDrawList *list: m_lists)
+            IM_DELETE(list);
+        m_lists.clear();
+        m_aliased.clear();
+        m_owned.clear();
+        m_commands.clear();
+        m_listCount = 0;
+        m_valid = false;
+    }
+
+    // Points an ImVector at memory it does not own, see releaseAliases()
+    template<typename T>
+    static void alias_vector(ImVector<T> &dst, const uint8_t *data, uint32_t count) {
+        dst.Data = (T *) data;
+        dst.Size = dst.Capacity = (int) count;
+    }
+
+    template<typename T>
+    static void copy_vector(ImVector<T> &dst, const uint8_t *data, uint32_t count) {
+        dst.resize((int) count);
+        if (count > 0)
+            memcpy(dst.Data, data, count * sizeof(T));
+    }
+
+    bool drawDataDecoder::decode(const uint8_t *frame, size_t size, bool inPlace) {
+        releaseAliases();
+        const uint8_t *end = frame + size;
+        const uint8_t *src = frame;
+        frameHeader header;
+        if (size < sizeof(header)) {
+            m_valid = false;
+            return false;
+        }
+        memcpy(&header, src, sizeof(header));
+        src += align(sizeof(header));
+
+        // Every list takes at least its header, a bogus count must not grow m_lists
+        if (header.listCount > (size_t) (end - src) / align(sizeof(listHeader))) {
+            fprintf(stderr, "[drawcodec] Dropped a malformed frame\n");
+            m_valid = false;
+            return false;
+        }
+
+        const int previousCount = m_valid ? m_listCount : 0;
+        while (m_lists.Size < (int) header.listCount) {
+            m_lists.push_back(IM_NEW(ImDrawList)(nullptr));
+            m_aliased.push_back(false);
+            m_owned.push_back(false);
+            m_commands.emplace_back();
+        }
+
+        bool valid = true;
+        for (int n = 0; n < (int) header.listCount && valid; n++) {
+            ImDrawList *list = m_lists[n];
+            listHeader lh;
+            if (end - src < (ptrdiff_t) sizeof(lh)) {
+                valid = false;
+                break;
+            }
+            memcpy(&lh, src, sizeof(lh));
+            src += align(sizeof(lh));
+            // A list that was decoded in place lost its buffers with releaseAliases()
+            if (lh.flags & listReused) {
+                valid = n < previousCount && m_owned[n];
+                continue;
+            }
+
+            size_t commandBytes = lh.cmdCount * sizeof(drawCommand);
+            size_t vtxBytes = (size_t) lh.vtxCount * sizeof(ImDrawVert);
+            size_t idxBytes = (size_t) lh.idxCount * sizeof(ImDrawIdx);
+            if ((size_t) (end - src) < align(commandBytes) + align(vtxBytes) + align(idxBytes)) {
+                valid = false;
+                break;
+            }
+            std::vector<drawCommand> &commands = m_commands[n];
+            commands.resize(lh.cmdCount);
+            if (commandBytes > 0)
+                memcpy(commands.data(), src, commandBytes);
+            src += align(commandBytes);
+            // Renderers trust the offsets and indices, a command outside its list would read past the buffers
+            const auto *indices = (const ImDrawIdx *) (src + align(vtxBytes));
+            for (const drawCommand &command: commands) {
+                valid = (uint64_t) command.idxOffset + command.elemCount <= lh.idxCount;
+                for (uint32_t i = 0; valid && i < command.elemCount; i++)
+                    valid = (uint64_t) command.vtxOffset + indices[command.idxOffset + i] < lh.vtxCount;
+                if (!valid)
+                    break;
+            }
+            if (!valid) {
+                commands.clear();
+                m_owned[n] = false;
+                break;
+            }
+            if (inPlace) {
+                alias_vector(list->VtxBuffer, src, lh.vtxCount);
+                alias_vector(list->IdxBuffer, src + align(vtxBytes), lh.idxCount);
+                m_aliased[n] = true;
+                m_owned[n] = false;
+            } else {
+                copy_vector(list->VtxBuffer, src, lh.vtxCount);
+                copy_vector(list->IdxBuffer, src + align(vtxBytes), lh.idxCount);
+                m_owned[n] = true;
+            }
+            src += align(vtxBytes) + align(idxBytes);
+        }
+        if (!valid) {
+            fprintf(stderr, "[drawcodec] Dropped a malformed frame\n");
+            releaseAliases();
+            m_valid = false;
+            return false;
+        }
+
+        // Texture ids are translated on every frame, a reused list may refer to a texture that was replaced
+        for (int n = 0; n < (int) header.listCount; n++) {
+            ImDrawList *list = m_lists[n];
+            list->CmdBuffer.resize(0);
+            for (const drawCommand &command: m_commands[n]) {
+                auto texture = m_textures.find(command.texture);
+                if (texture == m_textures.end())
+                    continue;
+                ImDrawCmd cmd;
+                cmd.ClipRect = ImVec4(command.clipRect[0], command.clipRect[1], command.clipRect[2],
+                                      command.clipRect[3]);
+                cmd.TextureId = texture->second;
+                cmd.VtxOffset = command.vtxOffset;
+                cmd.IdxOffset = command.idxOffset;
+                cmd.ElemCount = command.elemCount;
+                list->CmdBuffer.push_back(cmd);
+            }
+        }
+
+        // The totals size the renderers' vertex and index buffers, so they come from the lists, not the wire
+        m_listCount = (int) header.listCount;
+        m_data.Valid = true;
+        m_data.CmdListsCount = m_listCount;
+        m_data.TotalVtxCount = 0;
+        m_data.TotalIdxCount = 0;
+        for (int n = 0; n < m_listCount; n++) {
+            m_data.TotalVtxCount += m_lists[n]->VtxBuffer.Size;
+            m_data.TotalIdxCount += m_lists[n]->IdxBuffer.Size;
+        }
+#if IMGUI_VERSION_NUM >= 18980
+        m_data.CmdLists.resize(0);
+        for (int n = 0; n < m_listCount; n++)
+            m_data.CmdLists.push_back(m_lists[n]);
+#else
+        m_data.CmdLists = m_lists.Data;
+#endif
+        m_data.DisplayPos = ImVec2(header.displayPos[0], header.displayPos[1]);
+        m_data.DisplaySize = ImVec2(header.displaySize[0], header.displaySize[1]);
+        m_data.FramebufferScale = ImVec2(header.framebufferScale[0], header.framebufferScale[1]);
+        m_data.OwnerViewport = nullptr;
+        m_frameNumber = header.frameNumber;
+        m_valid = true;
+        return true;
+    }
+
+} // engine
@@ -0,0 +1,156 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_DRAWCODEC_H
+#define EASYGRAPHICSLIB_DRAWCODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "imgui.h"
+
+namespace engine {
+
+    /**
+     * @brief Serialized ImDrawData, used by remote rendering and captures. Only readable by a build with the
+     * same ImDrawVert and ImDrawIdx, which the containers check
+     */
+    namespace draw_format {
+        constexpr size_t align(size_t size) { return (size + 7) & ~(size_t) 7; }
+
+        struct frameHeader {
+            uint64_t frameNumber;
+            float displayPos[2];
+            float displaySize[2];
+            float framebufferScale[2];
+            uint32_t listCount;
+            uint32_t totalVtxCount;
+            uint32_t totalIdxCount;
+            uint32_t padding;
+        };
+
+        constexpr uint32_t listReused = 1;
+
+        // Followed by the commands, vertices and indices unless the list is reused, each padded to 8 bytes
+        struct listHeader {
+            uint32_t flags;
+            uint32_t cmdCount;
+            uint32_t vtxCount;
+            uint32_t idxCount;
+        };
+
+        struct drawCommand {
+            float clipRect[4];
+            uint64_t texture;
+            uint32_t vtxOffset;
+            uint32_t idxOffset;
+            uint32_t elemCount;
+            uint32_t padding;
+        };
+    }
+
+    /**
+     * @brief Writes ImDrawData in draw_format. Draw callbacks cannot be serialized and are left out.
+     *
+     * Encoding takes two passes, measure() and write(), so the frame can go straight into a socket buffer or
+     * a mapped file. With delta encoding a list that hashes the same as the list in the same slot of the last
+     * committed frame is only sent as a reused marker, the reader keeps its copy from then.
+     */
+    class drawDataEncoder {
+
+    public:
+        /**
+         * @brief Size of the encoded frame. Decides which lists are reused, so write() has to follow
+         */
+        size_t measure(const ImDrawData *drawData, bool delta = false);
+
+        /**
+         * @param dst measure() bytes
+         * @param toOrigin Moves vertices and clip rectangles so DisplayPos becomes 0,0, which makes the frame
+         * independent of where the window was on screen
+         */
+        void write(const ImDrawData *drawData, uint64_t frameNumber, uint8_t *dst, bool toOrigin = false);
+
+        /**
+         * @brief The frame that was written reached the reader, later frames may reuse its lists
+         */
+        void commit() { m_committedHashes = m_listHashes; }
+
+        /**
+         * @brief The reader starts over, nothing can be reused
+         */
+        void reset() { m_committedHashes.clear(); }
+
+        [[nodiscard]] uint64_t listsWritten() const { return m_listsWritten; }
+
+        [[nodiscard]] uint64_t listsReused() const { return m_listsReused; }
+
+    private:
+        std::vector<uint64_t> m_committedHashes;
+        std::vector<uint64_t> m_listHashes;
+        std::vector<bool> m_reuse;
+        uint64_t m_listsWritten = 0;
+        uint64_t m_listsReused = 0;
+    };
+
+    /**
+     * @brief Turns draw_format frames back into an ImDrawData.
+     *
+     * In place decoding points the vertex and index buffers of the lists straight at the encoded frame, which
+     * then has to outlive data(), otherwise they are copied. Texture ids are translated with the table filled
+     * by setTexture(), draw commands with unknown textures are dropped.
+     */
+    class drawDataDecoder {
+
+    public:
+        drawDataDecoder() = default;
+
+        drawDataDecoder(const drawDataDecoder &) = delete;
+
+        drawDataDecoder &operator=(const drawDataDecoder &) = delete;
+
+        ~drawDataDecoder() { clear(); }
+
+        /**
+         * @return false if the frame is malformed or reuses lists that were never decoded, data() is empty then
+         */
+        bool decode(const uint8_t *frame, size_t size, bool inPlace);
+
+        /**
+         * @brief Forgets the lists, the next frame has to be complete. The texture table is kept
+         */
+        void clear();
+
+        /**
+         * @brief Detaches lists decoded in place from the memory they point to
+         */
+        void releaseAliases();
+
+        void setTexture(uint64_t encoded, ImTextureID local) { m_textures[encoded] = local; }
+
+        void clearTextures() { m_textures.clear(); }
+
+        /**
+         * @brief Newest frame, nullptr before the first one or after a malformed one
+         */
+        [[nodiscard]] const ImDrawData *data() const { return m_valid ? &m_data : nullptr; }
+
+        [[nodiscard]] uint64_t frameNumber() const { return m_frameNumber; }
+
+    private:
+        std::unordered_map<uint64_t, ImTextureID> m_textures;
+        ImDrawData m_data;
+        ImVector<ImDrawList *> m_lists;     // Only grows, a reused list is whatever its slot held last frame
+        std::vector<bool> m_aliased;
+        std::vector<bool> m_owned;          // The slot holds a copy of its list, so a later frame may reuse it
+        std::vector<std::vector<draw_format::drawCommand>> m_commands;  // As encoded, per list slot
+        int m_listCount = 0;
+        bool m_valid = false;
+        uint64_t m_frameNumber = 0;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_DRAWCODEC_H
@@ -0,0 +1,97 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <algorithm>
+#include <chrono>
+#include "framering.h"
+#include "vkutils.h"
+
+namespace engine {
+
+    void frameRing::create(VkDevice device, uint32_t queueFamily, const VkAllocationCallbacks *allocator,
+                           uint32_t count) {
+        m_device = device;
+        m_allocator = allocator;
+        m_contexts.resize(std::clamp(count, 1u, maxFramesInFlight));
+        // The first next() moves to context 0
+        m_index = (uint32_t) m_contexts.size() - 1;
+        VkResult err;
+        for (frameContext &context: m_contexts) {
+            {
+                VkCommandPoolCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+                info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+                info.queueFamilyIndex = queueFamily;
+                err = vkCreateCommandPool(m_device, &info, m_allocator, &context.commandPool);
+                check_vk_result(err);
+            }
+            {
+                VkCommandBufferAllocateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+                info.commandPool = context.commandPool;
+                info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+                info.commandBufferCount = 1;
+                err = vkAllocateCommandBuffers(m_device, &info, &context.commandBuffer);
+                check_vk_result(err);
+            }
+            // Created signaled so the first next() does not block
+            {
+                VkFenceCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+                info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+                err = vkCreateFence(m_device, &info, m_allocator, &context.fence);
+                check_vk_result(err);
+            }
+            {
+                VkSemaphoreCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+                err = vkCreateSemaphore(m_device, &info, m_allocator, &context.imageAcquired);
+                check_vk_result(err);
+            }
+        }
+    }
+
+    void frameRing::destroy() {
+        for (frameContext &context: m_contexts) {
+            vkDestroySemaphore(m_device, context.imageAcquired, m_allocator);
+            vkDestroyFence(m_device, context.fence, m_allocator);
+            vkDestroyCommandPool(m_device, context.commandPool, m_allocator);
+            // Everything submitted completed, the device is idle
+            complete(context.frame);
+        }
+        m_contexts.clear();
+        m_index = 0;
+    }
+
+    void frameRing::complete(uint64_t frame) {
+        if (frame > m_completedFrame.load(std::memory_order_relaxed))
+            m_completedFrame.store(frame, std::memory_order_release);
+    }
+
+    double frameRing::next() {
+        m_index = (m_index + 1) % (uint32_t) m_contexts.size();
+        frameContext &context = m_contexts[m_index];
+        auto start = std::chrono::steady_clock::now();
+        VkResult err = vkWaitForFences(m_device, 1, &context.fence, VK_TRUE, UINT64_MAX);
+        check_vk_result(err);
+        auto waited = std::chrono::steady_clock::now() - start;
+        // Frames complete in submission order, so everything up to the last frame of this context did
+        complete(context.frame);
+        return std::chrono::duration<double, std::milli>(waited).count();
+    }
+
+    VkCommandBuffer frameRing::begin() {
+        frameContext &context = m_contexts[m_index];
+        VkResult err = vkResetFences(m_device, 1, &context.fence);
+        check_vk_result(err);
+        err = vkResetCommandPool(m_device, context.commandPool, 0);
+        check_vk_result(err);
+        VkCommandBufferBeginInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        info.flags |= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        err = vkBeginCommandBuffer(context.commandBuffer, &info);
+        check_vk_result(err);
+        return context.commandBuffer;
+    }
+
+} // engine
@@ -0,0 +1,82 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_FRAMERING_H
+#define EASYGRAPHICSLIB_FRAMERING_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "vulkan/vulkan.h"
+
+namespace engine {
+
+    /**
+     * @brief Everything one frame in flight records and submits with
+     */
+    struct frameContext {
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+        VkSemaphore imageAcquired = VK_NULL_HANDLE;
+        uint64_t frame = 0;         // Frame number + 1 last submitted with the context, 0 if none
+    };
+
+    /**
+     * @brief Ring of frame contexts, its size is the number of frames the CPU may run ahead of the GPU.
+     *
+     * Independent of the number of swapchain images: the renderer waits for the fence of the next context
+     * before it acquires an image, so one frame in flight trades throughput for the lowest latency and more
+     * frames keep the GPU busy while the CPU builds the next one. Render complete semaphores stay per
+     * swapchain image, a context is reused before the present of its last frame is known to be done.
+     */
+    class frameRing {
+
+    public:
+        static constexpr uint32_t maxFramesInFlight = 4;
+
+        void create(VkDevice device, uint32_t queueFamily, const VkAllocationCallbacks *allocator, uint32_t count);
+
+        /**
+         * @brief Destroys the contexts, the device has to be idle
+         */
+        void destroy();
+
+        /**
+         * @brief Advances to the next context and waits until its last frame completed. The fence stays
+         * signaled until begin() resets it, so a frame that is given up after next() leaves nothing behind
+         * @return Time spent waiting for the fence in milliseconds
+         */
+        double next();
+
+        /**
+         * @brief Resets the fence and the command pool of the current context and begins its command buffer
+         */
+        VkCommandBuffer begin();
+
+        [[nodiscard]] frameContext &current() { return m_contexts[m_index]; }
+
+        [[nodiscard]] uint32_t currentSlot() const { return m_index; }
+
+        [[nodiscard]] uint32_t size() const { return (uint32_t) m_contexts.size(); }
+
+        /**
+         * @brief Frame number + 1 of the newest frame known to be complete, see frameContext::frame. May be
+         * read by another thread than the one rendering
+         */
+        [[nodiscard]] uint64_t completedFrame() const { return m_completedFrame.load(std::memory_order_acquire); }
+
+    private:
+        void complete(uint64_t frame);
+
+        VkDevice m_device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks *m_allocator = nullptr;
+        std::vector<frameContext> m_contexts;
+        uint32_t m_index = 0;
+        std::atomic<uint64_t> m_completedFrame{0};
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_FRAMERING_H
@@ -0,0 +1,707 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <algorithm>
+#include <cstring>
+#include "heatmap.h"
+#include "imgui_impl_vulkan.h"
+#include "vkutils.h"
+
+namespace engine {
+
+    // SPIR-V generated from shaders/ by glslc at build time
+    static const uint32_t heatmap_comp_spv[] =
+#include "shaders/heatmap.comp.h"
+    ;
+
+    // Colormap control points, evenly spaced from 0 to 1 and interpolated linearly
+    static const ImU32 viridis_points[] = {
+            IM_COL32(68, 1, 84, 255), IM_COL32(71, 44, 122, 255), IM_COL32(59, 81, 139, 255),
+            IM_COL32(44, 113, 142, 255), IM_COL32(33, 144, 141, 255), IM_COL32(39, 173, 129, 255),
+            IM_COL32(92, 200, 99, 255), IM_COL32(170, 220, 50, 255), IM_COL32(253, 231, 37, 255)};
+    static const ImU32 inferno_points[] = {
+            IM_COL32(0, 0, 4, 255), IM_COL32(31, 12, 72, 255), IM_COL32(85, 15, 109, 255),
+            IM_COL32(136, 34, 106, 255), IM_COL32(186, 54, 85, 255), IM_COL32(227, 89, 51, 255),
+            IM_COL32(249, 140, 10, 255), IM_COL32(249, 201, 50, 255), IM_COL32(252, 255, 164, 255)};
+    static const ImU32 turbo_points[] = {
+            IM_COL32(48, 18, 59, 255), IM_COL32(70, 107, 227, 255), IM_COL32(40, 187, 236, 255),
+            IM_COL32(50, 242, 152, 255), IM_COL32(164, 252, 60, 255), IM_COL32(237, 208, 58, 255),
+            IM_COL32(251, 128, 34, 255), IM_COL32(208, 47, 5, 255), IM_COL32(122, 4, 3, 255)};
+    static const ImU32 grayscale_points[] = {IM_COL32(0, 0, 0, 255), IM_COL32(255, 255, 255, 255)};
+
+    static const uint32_t heatmap_group_size = 16;
+
+    // The staging ring starts this large and doubles whenever a frame stages more than fits
+    static const VkDeviceSize min_staging_size = 1ull << 20;
+
+    // Copy offsets have to be a multiple of the texel size, 16 also suits transfer queues
+    static const VkDeviceSize staging_alignment = 16;
+
+    static VkDeviceSize staging_size(VkDeviceSize size) {
+        return (size + staging_alignment - 1) / staging_alignment * staging_alignment;
+    }
+
+    static void create_image(deviceAllocator &memory, VkDevice device, const VkAllocationCallbacks *allocator,
+                             VkFormat format, VkImageUsageFlags usage, uint32_t width, uint32_t height,
+                             VkImage &image, deviceAllocation &allocation, VkImageView &view) {
+        VkResult err;
+        VkImageCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        info.imageType = VK_IMAGE_TYPE_2D;
+        info.format = format;
+        info.extent.width = width;
+        info.extent.height = height;
+        info.extent.depth = 1;
+        info.mipLevels = 1;
+        info.arrayLayers = 1;
+        info.samples = VK_SAMPLE_COUNT_1_BIT;
+        info.tiling = VK_IMAGE_TILING_OPTIMAL;
+        info.usage = usage;
+        info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        err = memory.createImage(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, image, allocation);
+        check_vk_result(err);
+
+        VkImageViewCreateInfo view_info = {};
+        view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        view_info.image = image;
+        view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        view_info.format = format;
+        view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        view_info.subresourceRange.levelCount = 1;
+        view_info.subresourceRange.layerCount = 1;
+        err = vkCreateImageView(device, &view_info, allocator, &view);
+        check_vk_result(err);
+    }
+
+    static VkImageMemoryBarrier image_barrier(VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout,
+                                              VkAccessFlags srcAccess, VkAccessFlags dstAccess) {
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.layerCount = 1;
+        return barrier;
+    }
+
+    static VkBufferMemoryBarrier buffer_barrier(VkBuffer buffer, VkAccessFlags srcAccess, VkAccessFlags dstAccess) {
+        VkBufferMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = buffer;
+        barrier.size = VK_WHOLE_SIZE;
+        return barrier;
+    }
+
+    heatmap::heatmap(heatmapRenderer &renderer, uint32_t width, uint32_t height, heatmapFormat format) :
+            m_renderer(renderer), m_width(width), m_height(height), m_format(format),
+            m_texelSize(format == heatmapFormat::uint16 ? sizeof(uint16_t) : sizeof(float)) {
+        VkDevice device = renderer.m_device;
+        const VkAllocationCallbacks *allocator = renderer.m_allocator;
+        VkResult err;
+
+        create_image(*renderer.m_memory, device, allocator,
+                     format == heatmapFormat::uint16 ? VK_FORMAT_R16_UNORM : VK_FORMAT_R32_SFLOAT,
+                     VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, width, height,
+                     m_valueImage, m_valueAllocation, m_valueView);
+        create_image(*renderer.m_memory, device, allocator, VK_FORMAT_R8G8B8A8_UNORM,
+                     VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, width, height,
+                     m_colorImage, m_colorAllocation, m_colorView);
+
+        // The colormap is small enough to be updated inline in the frame command buffer
+        {
+            VkBufferCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+            info.size = colormapSize * sizeof(ImU32);
+            info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+            info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            err = renderer.m_memory->createBuffer(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, m_colormapBuffer,
+                                                  m_colormapAllocation);
+            check_vk_result(err);
+        }
+
+        // Compute descriptors
+        {
+            VkDescriptorSetAllocateInfo alloc_info = {};
+            alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            alloc_info.descriptorPool = renderer.m_descriptorPool;
+            alloc_info.descriptorSetCount = 1;
+            alloc_info.pSetLayouts = &renderer.m_setLayout;
+            err = vkAllocateDescriptorSets(device, &alloc_info, &m_computeSet);
+            check_vk_result(err);
+
+            VkDescriptorImageInfo value_info = {};
+            value_info.sampler = renderer.m_sampler;
+            value_info.imageView = m_valueView;
+            value_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            VkDescriptorImageInfo color_info = {};
+            color_info.imageView = m_colorView;
+            color_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+            VkDescriptorBufferInfo colormap_info = {};
+            colormap_info.buffer = m_colormapBuffer;
+            colormap_info.range = VK_WHOLE_SIZE;
+
+            VkWriteDescriptorSet writes[3] = {};
+            for (uint32_t i = 0; i < 3; i++) {
+                writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                writes[i].dstSet = m_computeSet;
+                writes[i].dstBinding = i;
+                writes[i].descriptorCount = 1;
+            }
+            writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            writes[0].pImageInfo = &value_info;
+            writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            writes[1].pImageInfo = &color_info;
+            writes[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[2].pBufferInfo = &colormap_info;
+            vkUpdateDescriptorSets(device, 3, writes, 0, nullptr);
+        }
+        m_textureSet = ImGui_ImplVulkan_AddTexture(renderer.m_sampler, m_colorView,
+                                                   VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+        // The first recorded frame clears the values to zero, nothing has to be staged for it
+        setColormap(colormap::viridis);
+    }
+
+    heatmap::~heatmap() {
+        VkDevice device = m_renderer.m_device;
+        const VkAllocationCallbacks *allocator = m_renderer.m_allocator;
+        ImGui_ImplVulkan_RemoveTexture(m_textureSet);
+        vkFreeDescriptorSets(device, m_renderer.m_descriptorPool, 1, &m_computeSet);
+        deviceAllocator &memory = *m_renderer.m_memory;
+        memory.destroyBuffer(m_colormapBuffer, m_colormapAllocation);
+        vkDestroyImageView(device, m_colorView, allocator);
+        memory.destroyImage(m_colorImage, m_colorAllocation);
+        vkDestroyImageView(device, m_valueView, allocator);
+        memory.destroyImage(m_valueImage, m_valueAllocation);
+    }
+
+    void heatmap::update(const float *rows, uint32_t firstRow, uint32_t rowCount, size_t rowStride) {
+        IM_ASSERT(m_format == heatmapFormat::float32);
+        writeRows(rows, sizeof(float), firstRow, rowCount, rowStride);
+    }
+
+    void heatmap::update(const uint16_t *rows, uint32_t firstRow, uint32_t rowCount, size_t rowStride) {
+        IM_ASSERT(m_format == heatmapFormat::uint16);
+        writeRows(rows, sizeof(uint16_t), firstRow, rowCount, rowStride);
+    }
+
+    void heatmap::writeRows(const void *rows, size_t texelSize, uint32_t firstRow, uint32_t rowCount,
+                            size_t rowStride) {
+        if (firstRow >= m_height)
+            return;
+        rowCount = std::min(rowCount, m_height - firstRow);
+        if (rowCount == 0)
+            return;
+        if (rowStride == 0)
+            rowStride = m_width;
+
+        size_t row_bytes = m_width * texelSize;
+        stagedRows staged = {VK_NULL_HANDLE, 0, 0, firstRow, firstRow + rowCount};
+        uint8_t *dst = m_renderer.stage((VkDeviceSize) rowCount * row_bytes, staged);
+        const auto *src = (const uint8_t *) rows;
+        if (rowStride == m_width) {
+            memcpy(dst, src, rowCount * row_bytes);
+        } else {
+            for (uint32_t r = 0; r < rowCount; r++)
+                memcpy(dst + r * row_bytes, src + r * rowStride * texelSize, row_bytes);
+        }
+
+        // Pending rows the new ones overwrite would only be copied to be overwritten, so they are trimmed or dropped
+        for (stagedRows &pending: m_dirtyRows) {
+            if (pending.end <= staged.first || staged.end <= pending.first)
+                continue;
+            if (staged.first <= pending.first && pending.end > staged.end) {
+                VkDeviceSize skipped = (VkDeviceSize) (staged.end - pending.first) * row_bytes;
+                pending.offset += skipped;
+                pending.position += skipped;
+                pending.first = staged.end;
+            } else if (pending.first < staged.first && staged.end >= pending.end) {
+                pending.end = staged.first;
+            }
+        }
+        std::erase_if(m_dirtyRows, [&](const stagedRows &pending) {
+            return pending.first >= staged.first && pending.end <= staged.end;
+        });
+        m_dirtyRows.push_back(staged);
+    }
+
+    bool heatmap::latch() {
+        if (m_dirtyRows.empty() && !m_recolor && !m_colormapDirty)
+            return false;
+        m_latchedRows.insert(m_latchedRows.end(), m_dirtyRows.begin(), m_dirtyRows.end());
+        m_dirtyRows.clear();
+        if (m_colormapDirty) {
+            m_latchedColormap = m_colormap;
+            m_latchedColormapDirty = true;
+        }
+        m_latchedRecolor |= m_recolor;
+        m_latchedRangeMin = m_rangeMin;
+        m_latchedRangeMax = m_rangeMax;
+        m_recolor = false;
+        m_colormapDirty = false;
+        return true;
+    }
+
+    void heatmap::setRange(float min, float max) {
+        if (min == m_rangeMin && max == m_rangeMax)
+            return;
+        m_rangeMin = min;
+        m_rangeMax = max;
+        m_recolor = true;
+    }
+
+    void heatmap::setColormap(colormap map) {
+        switch (map) {
+            case colormap::grayscale:
+                setColormap(grayscale_points, IM_ARRAYSIZE(grayscale_points));
+                break;
+            case colormap::viridis:
+                setColormap(viridis_points, IM_ARRAYSIZE(viridis_points));
+                break;
+            case colormap::inferno:
+                setColormap(inferno_points, IM_ARRAYSIZE(inferno_points));
+                break;
+            case colormap::turbo:
+                setColormap(turbo_points, IM_ARRAYSIZE(turbo_points));
+                break;
+        }
+    }
+
+    void heatmap::setColormap(const ImU32 *colors, size_t count) {
+        if (count == 0)
+            return;
+        for (size_t i = 0; i < colormapSize; i++) {
+            float t = count > 1 ? (float) i / (float) (colormapSize - 1) * (float) (count - 1) : 0.0f;
+            size_t lo = std::min((size_t) t, count - 1);
+            size_t hi = std::min(lo + 1, count - 1);
+            ImVec4 a = ImGui::ColorConvertU32ToFloat4(colors[lo]);
+            ImVec4 b = ImGui::ColorConvertU32ToFloat4(colors[hi]);
+            float f = t - (float) lo;
+            m_colormap[i] = ImGui::ColorConvertFloat4ToU32(ImVec4(a.x + (b.x - a.x) * f, a.y + (b.y - a.y) * f,
+                                                                  a.z + (b.z - a.z) * f, a.w + (b.w - a.w) * f));
+        }
+        m_colormapDirty = true;
+    }
+
+    void heatmap::requeue() {
+        // Latched rows are older than the pending ones, so they are copied first
+        m_dirtyRows.insert(m_dirtyRows.begin(), m_latchedRows.begin(), m_latchedRows.end());
+        m_latchedRows.clear();
+        m_recolor |= m_latchedRecolor;
+        m_colormapDirty |= m_latchedColormapDirty;
+        m_latchedRecolor = false;
+        m_latchedColormapDirty = false;
+        m_latched = false;
+    }
+
+    uint8_t *heatmapRenderer::stage(VkDeviceSize size, heatmap::stagedRows &staged) {
+        VkDeviceSize aligned = staging_size(size);
+        auto reserve = [&](VkDeviceSize limit) {
+            // An empty ring restarts at the beginning of a lap
+            if (m_stagingHead == m_stagingTail)
+                m_stagingHead = m_stagingTail = (m_stagingHead + m_stagingSize - 1) / m_stagingSize * m_stagingSize;
+            // Rows never straddle the end of the ring, the rest of the lap is skipped instead
+            VkDeviceSize position = m_stagingHead % m_stagingSize;
+            VkDeviceSize padding = position + aligned > m_stagingSize ? m_stagingSize - position : 0;
+            if (m_stagingHead + padding + aligned - m_stagingTail > limit)
+                return false;
+            m_stagingHead += padding;
+            return true;
+        };
+        bool reserved = m_stagingSize > 0 && reserve(m_stagingSize);
+        if (!reserved && m_stagingSize > 0) {
+            // E.g. while no frames are rendered, updates only replace rows. A ring that stays more than half full
+            // grows anyway, so it is not compacted again on every update
+            compactStaging();
+            reserved = reserve(m_stagingSize / 2);
+        }
+        if (!reserved)
+            growStaging(aligned);
+        staged.buffer = m_stagingBuffer;
+        staged.offset = m_stagingHead % m_stagingSize;
+        staged.position = m_stagingHead;
+        m_stagingHead += aligned;
+        return m_stagingMapped + staged.offset;
+    }
+
+    void heatmapRenderer::compactStaging() {
+        // The ring may have restarted at a new lap since the last endFrame()
+        const uint64_t start = std::max(m_frameStart, m_stagingTail);
+        m_compacting.clear();
+        for (auto &h: m_heatmaps) {
+            const VkDeviceSize row_bytes = (VkDeviceSize) h->m_width * h->m_texelSize;
+            for (heatmap::stagedRows &staged: h->m_dirtyRows) {
+                if (staged.buffer == m_stagingBuffer && staged.position >= start)
+                    m_compacting.emplace_back(&staged, (staged.end - staged.first) * row_bytes);
+            }
+        }
+        std::sort(m_compacting.begin(), m_compacting.end(), [](const auto &a, const auto &b) {
+            return a.first->position < b.first->position;
+        });
+
+        // Every row moves towards the start, never past the rows after it
+        uint64_t head = start;
+        for (auto &[staged, bytes]: m_compacting) {
+            VkDeviceSize aligned = staging_size(bytes);
+            VkDeviceSize position = head % m_stagingSize;
+            if (position + aligned > m_stagingSize)
+                head += m_stagingSize - position;
+            VkDeviceSize offset = head % m_stagingSize;
+            memmove(m_stagingMapped + offset, m_stagingMapped + staged->offset, bytes);
+            staged->offset = offset;
+            staged->position = head;
+            head += aligned;
+        }
+        m_stagingHead = head;
+    }
+
+    /**
+     * @brief Replaces the ring with an empty one that has room for at least size bytes. The old ring is kept
+     * until the frames that staged into it completed
+     */
+    void heatmapRenderer::growStaging(VkDeviceSize size) {
+        VkDeviceSize capacity = std::max({min_staging_size, m_stagingSize * 2, size * 2});
+        if (m_stagingBuffer != VK_NULL_HANDLE)
+            m_retiredStaging.push_back({m_stagingBuffer, m_stagingAllocation, m_slots});
+
+        VkBufferCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        info.size = capacity;
+        info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        VkResult err = m_memory->createBuffer(info, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 0, m_stagingBuffer,
+                                              m_stagingAllocation);
+        check_vk_result(err);
+        m_stagingMapped = (uint8_t *) m_stagingAllocation.mapped;
+        m_stagingSize = capacity;
+        m_stagingHead = 0;
+        m_stagingTail = 0;
+        m_frameStart = 0;
+        std::fill(m_slotEnds.begin(), m_slotEnds.end(), 0);
+    }
+
+    void heatmapRenderer::destroyStaging() {
+        for (retiredStaging &retired: m_retiredStaging)
+            m_memory->destroyBuffer(retired.buffer, retired.allocation);
+        m_retiredStaging.clear();
+        if (m_stagingBuffer != VK_NULL_HANDLE)
+            m_memory->destroyBuffer(m_stagingBuffer, m_stagingAllocation);
+        m_stagingBuffer = VK_NULL_HANDLE;
+        m_stagingMapped = nullptr;
+        m_stagingSize = 0;
+        m_stagingHead = 0;
+        m_stagingTail = 0;
+        m_frameStart = 0;
+    }
+
+    void heatmapRenderer::create(VkDevice device, deviceAllocator &memory, VkDescriptorPool descriptorPool,
+                                 VkPipelineCache pipelineCache, const VkAllocationCallbacks *allocator,
+                                 uint32_t frameCount) {
+        m_device = device;
+        m_memory = &memory;
+        m_descriptorPool = descriptorPool;
+        m_allocator = allocator;
+        m_slots = frameCount + 1;
+        m_slot = 0;
+        m_slotEnds.assign(m_slots, 0);
+        VkResult err;
+
+        // Nearest filtering keeps the grid cells sharp when the image is scaled up
+        {
+            VkSamplerCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+            info.magFilter = VK_FILTER_NEAREST;
+            info.minFilter = VK_FILTER_NEAREST;
+            info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+            info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+            info.maxLod = 0.0f;
+            err = vkCreateSampler(m_device, &info, m_allocator, &m_sampler);
+            check_vk_result(err);
+        }
+        {
+            VkDescriptorSetLayoutBinding bindings[3] = {};
+            bindings[0].binding = 0;
+            bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            bindings[1].binding = 1;
+            bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            bindings[2].binding = 2;
+            bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            for (auto &binding: bindings) {
+                binding.descriptorCount = 1;
+                binding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            }
+            VkDescriptorSetLayoutCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            info.bindingCount = 3;
+            info.pBindings = bindings;
+            err = vkCreateDescriptorSetLayout(m_device, &info, m_allocator, &m_setLayout);
+            check_vk_result(err);
+        }
+        {
+            VkPushConstantRange push_constants = {};
+            push_constants.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            push_constants.offset = 0;
+            push_constants.size = sizeof(pushConstants);
+            VkPipelineLayoutCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+            info.setLayoutCount = 1;
+            info.pSetLayouts = &m_setLayout;
+            info.pushConstantRangeCount = 1;
+            info.pPushConstantRanges = &push_constants;
+            err = vkCreatePipelineLayout(m_device, &info, m_allocator, &m_pipelineLayout);
+            check_vk_result(err);
+        }
+        {
+            VkShaderModule module;
+            VkShaderModuleCreateInfo module_info = {};
+            module_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+            module_info.codeSize = sizeof(heatmap_comp_spv);
+            module_info.pCode = heatmap_comp_spv;
+            err = vkCreateShaderModule(m_device, &module_info, m_allocator, &module);
+            check_vk_result(err);
+
+            VkComputePipelineCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+            info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+            info.stage.module = module;
+            info.stage.pName = "main";
+            info.layout = m_pipelineLayout;
+            err = vkCreateComputePipelines(m_device, pipelineCache, 1, &info, m_allocator, &m_pipeline);
+            check_vk_result(err);
+            vkDestroyShaderModule(m_device, module, m_allocator);
+        }
+    }
+
+    void heatmapRenderer::destroy() {
+        if (m_device == VK_NULL_HANDLE)
+            return;
+        m_latched.clear();
+        m_heatmaps.clear();
+        destroyStaging();
+        vkDestroyPipeline(m_device, m_pipeline, m_allocator);
+        vkDestroyPipelineLayout(m_device, m_pipelineLayout, m_allocator);
+        vkDestroyDescriptorSetLayout(m_device, m_setLayout, m_allocator);
+        vkDestroySampler(m_device, m_sampler, m_allocator);
+        m_pipeline = VK_NULL_HANDLE;
+        m_pipelineLayout = VK_NULL_HANDLE;
+        m_setLayout = VK_NULL_HANDLE;
+        m_sampler = VK_NULL_HANDLE;
+        m_device = VK_NULL_HANDLE;
+    }
+
+    void heatmapRenderer::setFrameCount(uint32_t frameCount) {
+        if (m_device == VK_NULL_HANDLE || frameCount + 1 == m_slots)
+            return;
+        for (auto &h: m_heatmaps)
+            h->requeue();
+        m_latched.clear();
+        m_latchedWork = false;
+        m_recorded.store(false, std::memory_order_relaxed);
+        m_slots = frameCount + 1;
+        m_slot = 0;
+        // The requeued rows keep their space, it is released with the first frame of slot 0
+        m_slotEnds.assign(m_slots, m_stagingTail);
+        for (retiredStaging &retired: m_retiredStaging)
+            retired.frames = m_slots;
+    }
+
+    heatmap *heatmapRenderer::createHeatmap(uint32_t width, uint32_t height, heatmapFormat format) {
+        IM_ASSERT(m_device != VK_NULL_HANDLE && width > 0 && height > 0);
+        m_heatmaps.push_back(std::unique_ptr<heatmap>(new heatmap(*this, width, height, format)));
+        return m_heatmaps.back().get();
+    }
+
+    void heatmapRenderer::endFrame() {
+        if (m_slots == 0)
+            return;
+        // Heatmaps still latched from a frame that was never recorded keep their older rows as well
+        for (auto &h: m_heatmaps) {
+            if (h->latch() && !h->m_latched) {
+                h->m_latched = true;
+                m_latched.push_back(h.get());
+            }
+        }
+        m_latchedWork = !m_latched.empty();
+        m_frameStart = m_stagingHead;
+
+        // A frame that was not recorded after all, e.g. while the swapchain was out of date, completes nothing.
+        // Its rows stay latched, so their space belongs to the next frame that gets recorded
+        if (!m_recorded.exchange(false, std::memory_order_acquire))
+            return;
+        m_slotEnds[m_slot] = m_stagingHead;
+        m_slot = (m_slot + 1) % m_slots;
+        // The frame that last used the new slot completed, and with it everything staged before it ended
+        m_stagingTail = std::max(m_stagingTail, m_slotEnds[m_slot]);
+        std::erase_if(m_retiredStaging, [this](retiredStaging &retired) {
+            if (--retired.frames > 0)
+                return false;
+            m_memory->destroyBuffer(retired.buffer, retired.allocation);
+            return true;
+        });
+    }
+
+    VkDeviceSize heatmapRenderer::stagingBytes() const {
+        VkDeviceSize bytes = m_stagingSize;
+        for (const retiredStaging &retired: m_retiredStaging)
+            bytes += retired.allocation.size;
+        return bytes;
+    }
+
+    bool heatmapRenderer::hasPendingWork() const {
+        if (m_latchedWork && !m_recorded.load(std::memory_order_acquire))
+            return true;
+        for (auto &h: m_heatmaps)
+            if (!h->m_dirtyRows.empty() || h->m_recolor || h->m_colormapDirty)
+                return true;
+        return false;
+    }
+
+    void heatmapRenderer::record(VkCommandBuffer commandBuffer) {
+        m_recorded.store(true, std::memory_order_release);
+        if (m_latched.empty())
+            return;
+
+        // Release the images from last frame's readers and prepare the transfers
+        m_imageBarriers.clear();
+        m_bufferBarriers.clear();
+        for (heatmap *h: m_latched) {
+            VkImageLayout old_layout = h->m_initialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+                                                        : VK_IMAGE_LAYOUT_UNDEFINED;
+            if (!h->m_latchedRows.empty() || !h->m_initialized)
+                m_imageBarriers.push_back(image_barrier(h->m_valueImage, old_layout,
+                                                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0,
+                                                        VK_ACCESS_TRANSFER_WRITE_BIT));
+            if (h->m_latchedColormapDirty)
+                m_bufferBarriers.push_back(buffer_barrier(h->m_colormapBuffer, 0, VK_ACCESS_TRANSFER_WRITE_BIT));
+            m_imageBarriers.push_back(image_barrier(h->m_colorImage, old_layout, VK_IMAGE_LAYOUT_GENERAL, 0,
+                                                    VK_ACCESS_SHADER_WRITE_BIT));
+        }
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr,
+                             (uint32_t) m_bufferBarriers.size(), m_bufferBarriers.data(),
+                             (uint32_t) m_imageBarriers.size(), m_imageBarriers.data());
+
+        // Upload only the staged rows, in the order they were written
+        m_imageBarriers.clear();
+        m_bufferBarriers.clear();
+        for (heatmap *h: m_latched) {
+            if (!h->m_latchedRows.empty() || !h->m_initialized) {
+                m_writtenRows.clear();
+                if (!h->m_initialized) {
+                    VkClearColorValue zero = {};
+                    VkImageSubresourceRange range = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+                    vkCmdClearColorImage(commandBuffer, h->m_valueImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &zero,
+                                         1, &range);
+                    m_writtenRows.emplace_back(0, h->m_height);
+                }
+                VkBuffer batch_buffer = VK_NULL_HANDLE;
+                auto flush = [&]() {
+                    if (!m_copies.empty())
+                        vkCmdCopyBufferToImage(commandBuffer, batch_buffer, h->m_valueImage,
+                                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32_t) m_copies.size(),
+                                               m_copies.data());
+                    m_copies.clear();
+                };
+                for (const heatmap::stagedRows &staged: h->m_latchedRows) {
+                    // Rows written again since the last barrier must wait, copies of one batch must not overlap
+                    bool overlaps = std::any_of(m_writtenRows.begin(), m_writtenRows.end(), [&](const auto &rows) {
+                        return staged.first < rows.second && rows.first < staged.end;
+                    });
+                    if (overlaps) {
+                        flush();
+                        VkImageMemoryBarrier barrier = image_barrier(h->m_valueImage,
+                                                                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                                     VK_ACCESS_TRANSFER_WRITE_BIT,
+                                                                     VK_ACCESS_TRANSFER_WRITE_BIT);
+                        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                             VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+                        m_writtenRows.clear();
+                    } else if (staged.buffer != batch_buffer) {
+                        // Rows staged before the ring grew are in the old one
+                        flush();
+                    }
+                    batch_buffer = staged.buffer;
+                    VkBufferImageCopy copy = {};
+                    copy.bufferOffset = staged.offset;
+                    copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                    copy.imageSubresource.layerCount = 1;
+                    copy.imageOffset.y = (int32_t) staged.first;
+                    copy.imageExtent.width = h->m_width;
+                    copy.imageExtent.height = staged.end - staged.first;
+                    copy.imageExtent.depth = 1;
+                    m_copies.push_back(copy);
+                    m_writtenRows.emplace_back(staged.first, staged.end);
+                }
+                flush();
+                m_imageBarriers.push_back(image_barrier(h->m_valueImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                                        VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT));
+            }
+            if (h->m_latchedColormapDirty) {
+                vkCmdUpdateBuffer(commandBuffer, h->m_colormapBuffer, 0, sizeof(h->m_latchedColormap),
+                                  h->m_latchedColormap.data());
+                m_bufferBarriers.push_back(buffer_barrier(h->m_colormapBuffer, VK_ACCESS_TRANSFER_WRITE_BIT,
+                                                          VK_ACCESS_SHADER_READ_BIT));
+            }
+        }
+        if (!m_imageBarriers.empty() || !m_bufferBarriers.empty())
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                 0, 0, nullptr, (uint32_t) m_bufferBarriers.size(), m_bufferBarriers.data(),
+                                 (uint32_t) m_imageBarriers.size(), m_imageBarriers.data());
+
+        // Recolor the rows that changed, or everything if the mapping changed
+        m_imageBarriers.clear();
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+        for (heatmap *h: m_latched) {
+            bool remap = h->m_latchedColormapDirty || h->m_latchedRecolor;
+            uint32_t first_row = h->m_height, end_row = 0;
+            for (const heatmap::stagedRows &staged: h->m_latchedRows) {
+                first_row = std::min(first_row, staged.first);
+                end_row = std::max(end_row, staged.end);
+            }
+            pushConstants pc = {};
+            float span = h->m_latchedRangeMax > h->m_latchedRangeMin ? h->m_latchedRangeMax - h->m_latchedRangeMin
+                                                                     : 1.0f;
+            // UNORM samples arrive in the shader scaled to [0, 1]
+            float unit = h->m_format == heatmapFormat::uint16 ? 65535.0f : 1.0f;
+            pc.scale = unit / span;
+            pc.bias = -h->m_latchedRangeMin / span;
+            pc.firstRow = remap ? 0 : first_row;
+            pc.rowCount = (remap ? h->m_height : end_row) - pc.firstRow;
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1,
+                                    &h->m_computeSet, 0, nullptr);
+            vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pc), &pc);
+            vkCmdDispatch(commandBuffer, (h->m_width + heatmap_group_size - 1) / heatmap_group_size,
+                          (pc.rowCount + heatmap_group_size - 1) / heatmap_group_size, 1);
+            m_imageBarriers.push_back(image_barrier(h->m_colorImage, VK_IMAGE_LAYOUT_GENERAL,
+                                                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                                    VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT));
+
+            h->m_latchedRows.clear();
+            h->m_latchedColormapDirty = false;
+            h->m_latchedRecolor = false;
+            h->m_latched = false;
+            h->m_initialized = true;
+        }
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                             0, 0, nullptr, 0, nullptr, (uint32_t) m_imageBarriers.size(), m_imageBarriers.data());
+        m_latched.clear();
+    }
+
+} // engine
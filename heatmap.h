@@ -0,0 +1,283 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_HEATMAP_H
+#define EASYGRAPHICSLIB_HEATMAP_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "allocator.h"
+#include "imgui.h"
+#include "vulkan/vulkan.h"
+
+namespace engine {
+
+    class heatmapRenderer;
+
+    enum class heatmapFormat {
+        float32,
+        uint16
+    };
+
+    enum class colormap {
+        grayscale,
+        viridis,
+        inferno,
+        turbo
+    };
+
+    /**
+     * @brief A 2D grid of raw values that is colormapped on the GPU and shown as an ImGui image.
+     *
+     * update() copies rows into the staging ring of the renderer, only those rows are uploaded and recolored
+     * when the window records the frame. Values are mapped linearly from the range onto the
+     * colormap, NaN cells stay transparent. Only use from the thread that drives the window, e.g. from a
+     * channel drain callback.
+     */
+    class heatmap {
+
+    public:
+        static constexpr size_t colormapSize = 256;
+
+        heatmap(const heatmap &) = delete;
+
+        heatmap &operator=(const heatmap &) = delete;
+
+        ~heatmap();
+
+        /**
+         * @brief Replaces rowCount rows starting at firstRow. Rows are rowStride elements apart, 0 means width()
+         */
+        void update(const float *rows, uint32_t firstRow, uint32_t rowCount, size_t rowStride = 0);
+
+        void update(const uint16_t *rows, uint32_t firstRow, uint32_t rowCount, size_t rowStride = 0);
+
+        /**
+         * @brief Replaces the whole grid with width() * height() tightly packed values
+         */
+        void update(const float *data) { update(data, 0, m_height); }
+
+        void update(const uint16_t *data) { update(data, 0, m_height); }
+
+        /**
+         * @brief Values mapped onto the first and last colormap entry, in the units of the uploaded data
+         */
+        void setRange(float min, float max);
+
+        void setColormap(colormap map);
+
+        /**
+         * @brief Custom colormap, resampled to colormapSize entries
+         */
+        void setColormap(const ImU32 *colors, size_t count);
+
+        [[nodiscard]] ImTextureID textureId() const { return (ImTextureID) (ImU64) m_textureSet; }
+
+        [[nodiscard]] uint32_t width() const { return m_width; }
+
+        [[nodiscard]] uint32_t height() const { return m_height; }
+
+        [[nodiscard]] heatmapFormat format() const { return m_format; }
+
+        [[nodiscard]] float rangeMin() const { return m_rangeMin; }
+
+        [[nodiscard]] float rangeMax() const { return m_rangeMax; }
+
+    private:
+        friend class heatmapRenderer;
+
+        heatmap(heatmapRenderer &renderer, uint32_t width, uint32_t height, heatmapFormat format);
+
+        /**
+         * @brief Rows [first, end) staged at offset of buffer, tightly packed. Position is where the ring head
+         * was, offset the same position within the buffer
+         */
+        struct stagedRows {
+            VkBuffer buffer;
+            VkDeviceSize offset;
+            uint64_t position;
+            uint32_t first, end;
+        };
+
+        void writeRows(const void *rows, size_t texelSize, uint32_t firstRow, uint32_t rowCount, size_t rowStride);
+
+        /**
+         * @brief Hands the pending work to record(). Returns false if there was none
+         */
+        bool latch();
+
+        /**
+         * @brief Makes latched work that was not recorded pending again
+         */
+        void requeue();
+
+        heatmapRenderer &m_renderer;
+        uint32_t m_width, m_height;
+        heatmapFormat m_format;
+        size_t m_texelSize;
+
+        // Raw values and the colormapped result
+        VkImage m_valueImage = VK_NULL_HANDLE;
+        deviceAllocation m_valueAllocation;
+        VkImageView m_valueView = VK_NULL_HANDLE;
+        VkImage m_colorImage = VK_NULL_HANDLE;
+        deviceAllocation m_colorAllocation;
+        VkImageView m_colorView = VK_NULL_HANDLE;
+        VkBuffer m_colormapBuffer = VK_NULL_HANDLE;
+        deviceAllocation m_colormapAllocation;
+        VkDescriptorSet m_computeSet = VK_NULL_HANDLE;
+        VkDescriptorSet m_textureSet = VK_NULL_HANDLE;
+        bool m_initialized = false;
+
+        // Pending work for the next recorded frame. Staged rows are copied in order, an update trims the rows
+        // it overwrites
+        std::vector<stagedRows> m_dirtyRows;
+        bool m_recolor = true;
+        bool m_colormapDirty = true;
+        float m_rangeMin = 0.0f, m_rangeMax = 1.0f;
+        std::array<ImU32, colormapSize> m_colormap{};
+
+        // Work latched for record(), which may run on a render thread. Rows of frames that were latched but
+        // never recorded come first
+        std::vector<stagedRows> m_latchedRows;
+        bool m_latched = false;
+        bool m_latchedRecolor = false;
+        bool m_latchedColormapDirty = false;
+        float m_latchedRangeMin = 0.0f, m_latchedRangeMax = 1.0f;
+        std::array<ImU32, colormapSize> m_latchedColormap{};
+    };
+
+    /**
+     * @brief Owns the colormap compute pipeline and all heatmaps of a window.
+     *
+     * endFrame() hands the work of the frame over to record(), so the next frame can be built while a render
+     * thread records the previous one. record() has to be called outside of a render pass, before the ImGui
+     * draw data that shows the heatmaps is recorded into the same command buffer. The window does both for
+     * every frame it renders.
+     */
+    class heatmapRenderer {
+
+    public:
+        /**
+         * @param memory Allocator for the images and buffers, has to outlive the renderer
+         * @param descriptorPool Pool the ImGui backend was initialized with, the textures are allocated from it
+         * @param frameCount Maximum number of frames in flight, staged rows are kept that many frames
+         */
+        void create(VkDevice device, deviceAllocator &memory, VkDescriptorPool descriptorPool,
+                    VkPipelineCache pipelineCache, const VkAllocationCallbacks *allocator, uint32_t frameCount);
+
+        void destroy();
+
+        /**
+         * @brief Adapts the staging ring to a new number of frames in flight. The GPU and record() must be idle
+         */
+        void setFrameCount(uint32_t frameCount);
+
+        /**
+         * @brief Creates a heatmap owned by the renderer, valid until destroy(). Values start at zero
+         */
+        heatmap *createHeatmap(uint32_t width, uint32_t height, heatmapFormat format = heatmapFormat::float32);
+
+        /**
+         * @brief Latches the pending work of all heatmaps for record(). If the previous frame was recorded, the
+         * staging space of the frame that completed is released. Call once the frame is final, never while
+         * record() runs. A frame that is not recorded after all keeps its work latched for the next one
+         */
+        void endFrame();
+
+        /**
+         * @brief Whether any heatmap got new values, range or colormap since the last endFrame(), or latched work
+         * was not recorded yet. Can be asked while record() runs
+         */
+        [[nodiscard]] bool hasPendingWork() const;
+
+        /**
+         * @brief Uploads the latched rows of all heatmaps and recolors them
+         */
+        void record(VkCommandBuffer commandBuffer);
+
+        /**
+         * @brief Sets taken from the descriptor pool, a compute set and an ImGui texture per heatmap
+         */
+        [[nodiscard]] uint32_t descriptorSets() const { return (uint32_t) m_heatmaps.size() * 2; }
+
+        /**
+         * @brief Size of the staging ring, including rings that were replaced but are still read by the GPU
+         */
+        [[nodiscard]] VkDeviceSize stagingBytes() const;
+
+    private:
+        friend class heatmap;
+
+        /**
+         * @brief Reserves size bytes of the staging ring for the current frame, growing the ring if it is full
+         * @return Where to write, buffer and offset receive the location for the copy
+         */
+        uint8_t *stage(VkDeviceSize size, heatmap::stagedRows &staged);
+
+        /**
+         * @brief Moves the rows staged since the last endFrame() that are still pending together, dropping the
+         * space of rows that later updates replaced. Nothing reads them before the next frame is recorded
+         */
+        void compactStaging();
+
+        void growStaging(VkDeviceSize size);
+
+        void destroyStaging();
+
+        struct pushConstants {
+            float scale;
+            float bias;
+            uint32_t firstRow;
+            uint32_t rowCount;
+        };
+
+        VkDevice m_device = VK_NULL_HANDLE;
+        deviceAllocator *m_memory = nullptr;
+        VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
+        const VkAllocationCallbacks *m_allocator = nullptr;
+        VkSampler m_sampler = VK_NULL_HANDLE;
+        VkDescriptorSetLayout m_setLayout = VK_NULL_HANDLE;
+        VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+        VkPipeline m_pipeline = VK_NULL_HANDLE;
+        std::vector<std::unique_ptr<heatmap>> m_heatmaps;
+
+        uint32_t m_slots = 0;                   // Frames in flight plus the one being built
+        uint32_t m_slot = 0;
+        std::vector<heatmap *> m_latched;       // Heatmaps with work for record()
+        bool m_latchedWork = false;             // Whether the last endFrame() latched anything
+        std::atomic<bool> m_recorded{false};    // record() ran since the last endFrame()
+
+        // Staging ring shared by all heatmaps, head and tail count bytes ever allocated so they never wrap. What a
+        // frame staged is free again once its slot comes around, the GPU has finished that frame by then
+        struct retiredStaging {
+            VkBuffer buffer;
+            deviceAllocation allocation;
+            uint32_t frames;                    // Until the frames that may read it completed
+        };
+        VkBuffer m_stagingBuffer = VK_NULL_HANDLE;
+        deviceAllocation m_stagingAllocation;
+        uint8_t *m_stagingMapped = nullptr;
+        VkDeviceSize m_stagingSize = 0;
+        uint64_t m_stagingHead = 0;
+        uint64_t m_stagingTail = 0;
+        uint64_t m_frameStart = 0;              // Head at the last endFrame(), later rows are not latched yet
+        std::vector<uint64_t> m_slotEnds;       // Head at the end of the frame that last used the slot
+        std::vector<retiredStaging> m_retiredStaging;
+
+        // Barrier batches reused by record()
+        std::vector<VkImageMemoryBarrier> m_imageBarriers;
+        std::vector<VkBufferMemoryBarrier> m_bufferBarriers;
+        std::vector<VkBufferImageCopy> m_copies;
+        std::vector<std::pair<uint32_t, uint32_t>> m_writtenRows;
+        std::vector<std::pair<heatmap::stagedRows *, VkDeviceSize>> m_compacting;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_HEATMAP_H
@@ -0,0 +1,129 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+#include "imagewriter.h"
+
+namespace engine {
+
+    static uint32_t crc32(const uint8_t *data, size_t size, uint32_t crc = 0) {
+        // Initialised once and thread safe, readbacks may be written from several threads at the same time
+        static const std::array<uint32_t, 256> table = []() {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t n = 0; n < 256; n++) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; k++)
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[n] = c;
+            }
+            return t;
+        }();
+        crc = ~crc;
+        for (size_t i = 0; i < size; i++)
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    static void putBigEndian(std::vector<uint8_t> &out, uint32_t v) {
+        out.push_back((uint8_t) (v >> 24));
+        out.push_back((uint8_t) (v >> 16));
+        out.push_back((uint8_t) (v >> 8));
+        out.push_back((uint8_t) v);
+    }
+
+    static void putChunk(FILE *file, const char *type, const std::vector<uint8_t> &data) {
+        std::vector<uint8_t> chunk;
+        chunk.reserve(data.size() + 12);
+        putBigEndian(chunk, (uint32_t) data.size());
+        chunk.insert(chunk.end(), type, type + 4);
+        chunk.insert(chunk.end(), data.begin(), data.end());
+        putBigEndian(chunk, crc32(chunk.data() + 4, data.size() + 4));
+        fwrite(chunk.data(), 1, chunk.size(), file);
+    }
+
+    bool writePPM(const std::string &path, const uint8_t *rgba, uint32_t width, uint32_t height) {
+        FILE *file = fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            return false;
+        fprintf(file, "P6\n%u %u\n255\n", width, height);
+        std::vector<uint8_t> row(width * 3);
+        for (uint32_t y = 0; y < height; y++) {
+            const uint8_t *src = rgba + (size_t) y * width * 4;
+            for (uint32_t x = 0; x < width; x++) {
+                row[x * 3 + 0] = src[x * 4 + 0];
+                row[x * 3 + 1] = src[x * 4 + 1];
+                row[x * 3 + 2] = src[x * 4 + 2];
+            }
+            fwrite(row.data(), 1, row.size(), file);
+        }
+        return fclose(file) == 0;
+    }
+
+    bool writePNG(const std::string &path, const uint8_t *rgba, uint32_t width, uint32_t height) {
+        FILE *file = fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            return false;
+
+        static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        fwrite(signature, 1, sizeof(signature), file);
+
+        std::vector<uint8_t> header;
+        putBigEndian(header, width);
+        putBigEndian(header, height);
+        header.push_back(8); // bit depth
+        header.push_back(6); // color type RGBA
+        header.push_back(0); // compression
+        header.push_back(0); // filter
+        header.push_back(0); // interlace
+        putChunk(file, "IHDR", header);
+
+        // Raw scanlines, each prefixed with filter type 0
+        const size_t stride = (size_t) width * 4;
+        std::vector<uint8_t> raw;
+        raw.reserve((stride + 1) * height);
+        for (uint32_t y = 0; y < height; y++) {
+            raw.push_back(0);
+            raw.insert(raw.end(), rgba + y * stride, rgba + (y + 1) * stride);
+        }
+
+        // zlib stream made of stored deflate blocks (max 65535 bytes each)
+        std::vector<uint8_t> zlib;
+        zlib.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+        zlib.push_back(0x78);
+        zlib.push_back(0x01);
+        size_t offset = 0;
+        do {
+            size_t len = std::min<size_t>(65535, raw.size() - offset);
+            bool last = offset + len == raw.size();
+            zlib.push_back(last ? 1 : 0);
+            zlib.push_back((uint8_t) len);
+            zlib.push_back((uint8_t) (len >> 8));
+            zlib.push_back((uint8_t) ~len);
+            zlib.push_back((uint8_t) (~len >> 8));
+            zlib.insert(zlib.end(), raw.begin() + (ptrdiff_t) offset, raw.begin() + (ptrdiff_t) (offset + len));
+            offset += len;
+        } while (offset < raw.size());
+
+        uint32_t a = 1, b = 0;
+        for (uint8_t v: raw) {
+            a = (a + v) % 65521;
+            b = (b + a) % 65521;
+        }
+        putBigEndian(zlib, (b << 16) | a);
+        putChunk(file, "IDAT", zlib);
+        putChunk(file, "IEND", {});
+
+        return fclose(file) == 0;
+    }
+
+    bool writeImage(const std::string &path, const uint8_t *rgba, uint32_t width, uint32_t height) {
+        if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".png") == 0)
+            return writePNG(path, rgba, width, height);
+        return writePPM(path, rgba, width, height);
+    }
+
+} // engine
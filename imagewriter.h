@@ -0,0 +1,33 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_IMAGEWRITER_H
+#define EASYGRAPHICSLIB_IMAGEWRITER_H
+
+#include <cstdint>
+#include <string>
+
+namespace engine {
+
+    /**
+     * @brief Writes tightly packed RGBA8 pixels as binary PPM (alpha is dropped)
+     * @return true on success
+     */
+    bool writePPM(const std::string &path, const uint8_t *rgba, uint32_t width, uint32_t height);
+
+    /**
+     * @brief Writes tightly packed RGBA8 pixels as PNG. Uses stored (uncompressed) deflate blocks,
+     * which keeps the writer dependency free and fast at the cost of file size
+     * @return true on success
+     */
+    bool writePNG(const std::string &path, const uint8_t *rgba, uint32_t width, uint32_t height);
+
+    /**
+     * @brief Picks writePNG or writePPM from the file extension, defaulting to PPM
+     */
+    bool writeImage(const std::string &path, const uint8_t *rgba, uint32_t width, uint32_t height);
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_IMAGEWRITER_H
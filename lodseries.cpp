@@ -0,0 +1,244 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include "lodseries.h"
+
+#if defined(__AVX2__)
+#define LODSERIES_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LODSERIES_SSE
+#include <emmintrin.h>
+#endif
+
+namespace engine {
+
+#if defined(LODSERIES_AVX2) || defined(LODSERIES_SSE)
+    static inline float horizontal_min(__m128 v) {
+        v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_cvtss_f32(v);
+    }
+
+    static inline float horizontal_max(__m128 v) {
+        v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_cvtss_f32(v);
+    }
+#endif
+
+    /**
+     * @brief Folds count entries into yMin/yMax. For raw samples mins and maxs point to the same data
+     */
+    static void min_max_accumulate(const float *mins, const float *maxs, size_t count, float &yMin, float &yMax) {
+        size_t i = 0;
+#if defined(LODSERIES_AVX2)
+        if (count >= 8) {
+            __m256 vmin = _mm256_loadu_ps(mins);
+            __m256 vmax = _mm256_loadu_ps(maxs);
+            for (i = 8; i + 8 <= count; i += 8) {
+                vmin = _mm256_min_ps(vmin, _mm256_loadu_ps(mins + i));
+                vmax = _mm256_max_ps(vmax, _mm256_loadu_ps(maxs + i));
+            }
+            yMin = std::min(yMin, horizontal_min(_mm_min_ps(_mm256_castps256_ps128(vmin),
+                                                            _mm256_extractf128_ps(vmin, 1))));
+            yMax = std::max(yMax, horizontal_max(_mm_max_ps(_mm256_castps256_ps128(vmax),
+                                                            _mm256_extractf128_ps(vmax, 1))));
+        }
+#elif defined(LODSERIES_SSE)
+        if (count >= 4) {
+            __m128 vmin = _mm_loadu_ps(mins);
+            __m128 vmax = _mm_loadu_ps(maxs);
+            for (i = 4; i + 4 <= count; i += 4) {
+                vmin = _mm_min_ps(vmin, _mm_loadu_ps(mins + i));
+                vmax = _mm_max_ps(vmax, _mm_loadu_ps(maxs + i));
+            }
+            yMin = std::min(yMin, horizontal_min(vmin));
+            yMax = std::max(yMax, horizontal_max(vmax));
+        }
+#endif
+        for (; i < count; i++) {
+            yMin = std::min(yMin, mins[i]);
+            yMax = std::max(yMax, maxs[i]);
+        }
+    }
+
+    lodSeries::lodSeries(size_t retention, double x0, double dx) : m_x0(x0), m_dx(dx > 0.0 ? dx : 1.0) {
+        retention = std::max(retention, fanout);
+
+        // Stack levels while the level above would still hold at least fanout blocks
+        size_t levels = 1;
+        size_t top_block = 1;
+        while (retention / (top_block * fanout) >= fanout) {
+            top_block *= fanout;
+            levels++;
+        }
+
+        // A multiple of the top block size keeps every block group contiguous in its ring
+        retention = (retention + top_block - 1) / top_block * top_block;
+        m_samples.resize(retention);
+        size_t block = 1;
+        for (size_t k = 1; k < levels; k++) {
+            block *= fanout;
+            level lv;
+            lv.min.resize(retention / block);
+            lv.max.resize(retention / block);
+            m_levels.push_back(std::move(lv));
+        }
+    }
+
+    void lodSeries::append(float y) {
+        append(&y, 1);
+    }
+
+    void lodSeries::append(const float *y, size_t count) {
+        while (count > 0) {
+            // Copy up to the end of the ring, then update the pyramid before anything gets overwritten
+            size_t slot = (size_t) (m_total % m_samples.size());
+            size_t chunk = std::min(count, m_samples.size() - slot);
+            memcpy(m_samples.data() + slot, y, chunk * sizeof(float));
+            uint64_t old_total = m_total;
+            m_total += chunk;
+            buildLevels(old_total, m_total);
+            y += chunk;
+            count -= chunk;
+        }
+    }
+
+    void lodSeries::clear() {
+        m_cleared = m_total;
+    }
+
+    uint64_t lodSeries::oldest() const {
+        uint64_t retained_from = m_total > m_samples.size() ? m_total - m_samples.size() : 0;
+        return std::max(m_cleared, retained_from);
+    }
+
+    /**
+     * @brief Index of the first sample at or after x, clamped to the retained samples
+     */
+    uint64_t lodSeries::sampleIndex(double x) const {
+        double index = std::ceil((x - m_x0) / m_dx);
+        if (!(index > (double) oldest()))
+            return oldest();
+        if (index >= (double) m_total)
+            return m_total;
+        return (uint64_t) index;
+    }
+
+    void lodSeries::buildLevels(uint64_t oldTotal, uint64_t newTotal) {
+        uint64_t from = oldTotal, to = newTotal;
+        for (size_t k = 1; k < levelCount(); k++) {
+            // Entries of level k that just became complete
+            uint64_t first = from / fanout, last = to / fanout;
+            if (first == last)
+                break;
+
+            const float *src_min = k == 1 ? m_samples.data() : m_levels[k - 2].min.data();
+            const float *src_max = k == 1 ? m_samples.data() : m_levels[k - 2].max.data();
+            size_t src_capacity = k == 1 ? m_samples.size() : m_levels[k - 2].min.size();
+            level &dst = m_levels[k - 1];
+            for (uint64_t j = first; j < last; j++) {
+                auto src = (size_t) ((j * fanout) % src_capacity);
+                auto slot = (size_t) (j % dst.min.size());
+                float y_min = FLT_MAX, y_max = -FLT_MAX;
+                min_max_accumulate(src_min + src, src_max + src, fanout, y_min, y_max);
+                dst.min[slot] = y_min;
+                dst.max[slot] = y_max;
+            }
+            from = first;
+            to = last;
+        }
+    }
+
+    void lodSeries::scanLevel(size_t level, uint64_t begin, uint64_t end, float &yMin, float &yMax) const {
+        if (begin >= end)
+            return;
+        const float *mins = level == 0 ? m_samples.data() : m_levels[level - 1].min.data();
+        const float *maxs = level == 0 ? m_samples.data() : m_levels[level - 1].max.data();
+        size_t capacity = level == 0 ? m_samples.size() : m_levels[level - 1].min.size();
+
+        // The range may wrap around the end of the ring
+        auto start = (size_t) (begin % capacity);
+        auto count = (size_t) (end - begin);
+        size_t first_part = std::min(count, capacity - start);
+        min_max_accumulate(mins + start, maxs + start, first_part, yMin, yMax);
+        if (count > first_part)
+            min_max_accumulate(mins, maxs, count - first_part, yMin, yMax);
+    }
+
+    /**
+     * @brief Min/max of the samples [begin, end): partial blocks at both ends are scanned on the current
+     * level, the complete blocks in between are handed up to the next coarser level
+     */
+    void lodSeries::rangeMinMax(uint64_t begin, uint64_t end, float &yMin, float &yMax) const {
+        yMin = FLT_MAX;
+        yMax = -FLT_MAX;
+        uint64_t lo = begin, hi = end;
+        for (size_t k = 0; lo < hi; k++) {
+            uint64_t lo_up = (lo + fanout - 1) / fanout * fanout;
+            uint64_t hi_down = hi / fanout * fanout;
+            if (k + 1 == levelCount() || lo_up >= hi_down) {
+                scanLevel(k, lo, hi, yMin, yMax);
+                break;
+            }
+            scanLevel(k, lo, lo_up, yMin, yMax);
+            scanLevel(k, hi_down, hi, yMin, yMax);
+            lo = lo_up / fanout;
+            hi = hi_down / fanout;
+        }
+    }
+
+    bool lodSeries::range(double xMin, double xMax, float &yMin, float &yMax) const {
+        uint64_t begin = sampleIndex(xMin), end = sampleIndex(xMax);
+        if (begin >= end)
+            return false;
+        rangeMinMax(begin, end, yMin, yMax);
+        return true;
+    }
+
+    size_t lodSeries::query(double xMin, double xMax, size_t pixels, double originX, std::vector<float> &out) const {
+        if (pixels == 0 || !(xMax > xMin) || size() == 0)
+            return 0;
+
+        double samples_per_pixel = (xMax - xMin) / m_dx / (double) pixels;
+        if (samples_per_pixel <= 2.0) {
+            // Zoomed in: the raw samples, plus one beyond each edge so lines leave the view
+            uint64_t begin = sampleIndex(xMin), end = sampleIndex(xMax);
+            if (begin > oldest())
+                begin--;
+            if (end < m_total)
+                end++;
+            for (uint64_t i = begin; i < end; i++) {
+                out.push_back((float) (m_x0 + (double) i * m_dx - originX));
+                out.push_back(m_samples[(size_t) (i % m_samples.size())]);
+            }
+            return (size_t) (end - begin);
+        }
+
+        // One min/max pair per pixel column
+        size_t points = 0;
+        double column_width = (xMax - xMin) / (double) pixels;
+        uint64_t begin = sampleIndex(xMin);
+        for (size_t c = 0; c < pixels; c++) {
+            uint64_t end = sampleIndex(xMin + (double) (c + 1) * column_width);
+            if (end > begin) {
+                float y_min, y_max;
+                rangeMinMax(begin, end, y_min, y_max);
+                auto x = (float) (xMin + (double) c * column_width - originX);
+                out.push_back(x);
+                out.push_back(y_min);
+                out.push_back(x);
+                out.push_back(y_max);
+                points += 2;
+            }
+            begin = end;
+        }
+        return points;
+    }
+
+} // engine
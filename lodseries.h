@@ -0,0 +1,100 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_LODSERIES_H
+#define EASYGRAPHICSLIB_LODSERIES_H
+
+#include <cstdint>
+#include <vector>
+#include "imgui.h"
+#include "plot.h"
+
+namespace engine {
+
+    /**
+     * @brief Uniformly sampled series with an incrementally built min/max pyramid.
+     *
+     * Level 0 holds the raw samples, every level above stores min and max of fanout entries of the
+     * level below. All levels are rings sized from the retention window, so memory stays bounded no matter
+     * how many samples are appended. Queries decompose a sample range into complete pyramid blocks,
+     * which makes decimating a view to about two points per pixel independent of the number of samples.
+     * Not thread safe, feed it from the render thread (e.g. a channel drain callback).
+     */
+    class lodSeries {
+
+    public:
+        static constexpr size_t fanout = 16;
+
+        /**
+         * @param retention Number of most recent samples kept, rounded up to a multiple of the top block size
+         * @param x0 X value of the first sample
+         * @param dx Distance between two samples on the x axis
+         */
+        explicit lodSeries(size_t retention, double x0 = 0.0, double dx = 1.0);
+
+        void append(float y);
+
+        void append(const float *y, size_t count);
+
+        /**
+         * @brief Drops all retained samples, x keeps counting from where it was
+         */
+        void clear();
+
+        [[nodiscard]] size_t size() const { return (size_t) (m_total - oldest()); }
+
+        [[nodiscard]] size_t retention() const { return m_samples.size(); }
+
+        [[nodiscard]] uint64_t totalAppended() const { return m_total; }
+
+        [[nodiscard]] size_t levelCount() const { return m_levels.size() + 1; }
+
+        [[nodiscard]] double firstX() const { return m_x0 + (double) oldest() * m_dx; }
+
+        [[nodiscard]] double lastX() const { return m_x0 + (double) (m_total > 0 ? m_total - 1 : 0) * m_dx; }
+
+        [[nodiscard]] double sampleInterval() const { return m_dx; }
+
+        /**
+         * @brief Minimum and maximum of the samples in [xMin, xMax)
+         * @return false if the range holds no retained sample
+         */
+        bool range(double xMin, double xMax, float &yMin, float &yMax) const;
+
+        /**
+         * @brief Decimates [xMin, xMax) to a min/max pair per pixel column, or returns the raw samples when
+         * zoomed in that far. Appends interleaved x/y floats to out, x relative to originX
+         * @return Number of points appended
+         */
+        size_t query(double xMin, double xMax, size_t pixels, double originX, std::vector<float> &out) const;
+
+        ImU32 color = IM_COL32(255, 200, 0, 255);
+        plotStyle style = plotStyle::line;
+
+    private:
+        struct level {
+            std::vector<float> min;
+            std::vector<float> max;
+        };
+
+        [[nodiscard]] uint64_t oldest() const;
+
+        [[nodiscard]] uint64_t sampleIndex(double x) const;
+
+        void buildLevels(uint64_t oldTotal, uint64_t newTotal);
+
+        void rangeMinMax(uint64_t begin, uint64_t end, float &yMin, float &yMax) const;
+
+        void scanLevel(size_t level, uint64_t begin, uint64_t end, float &yMin, float &yMax) const;
+
+        std::vector<float> m_samples;
+        std::vector<level> m_levels; // Level 1 and up
+        uint64_t m_total = 0;
+        uint64_t m_cleared = 0;
+        double m_x0, m_dx;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_LODSERIES_H
@@ -0,0 +1,418 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <algorithm>
+#include <cfloat>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include "logconsole.h"
+
+#if defined(__AVX2__)
+#define LOGCONSOLE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LOGCONSOLE_SSE
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace engine {
+
+    static const uint32_t all_levels = (1u << (uint32_t) logLevel::count) - 1;
+
+    // Per line cost of the filter scan on top of its text, so empty lines count against the budget too
+    static const size_t line_scan_cost = sizeof(uint64_t) * 2;
+
+    const char *logLevelName(logLevel level) {
+        switch (level) {
+            case logLevel::trace:
+                return "trace";
+            case logLevel::debug:
+                return "debug";
+            case logLevel::info:
+                return "info";
+            case logLevel::warning:
+                return "warning";
+            case logLevel::error:
+                return "error";
+            default:
+                return "?";
+        }
+    }
+
+    static inline char fold_case(char c) {
+        return c >= 'A' && c <= 'Z' ? (char) (c + ('a' - 'A')) : c;
+    }
+
+    static inline bool is_letter(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    static bool equal_at(const char *text, const char *needle, size_t length, bool fold) {
+        if (!fold)
+            return memcmp(text, needle, length) == 0;
+        for (size_t i = 0; i < length; i++) {
+            if (fold_case(text[i]) != needle[i])
+                return false;
+        }
+        return true;
+    }
+
+#if defined(LOGCONSOLE_AVX2) || defined(LOGCONSOLE_SSE)
+    static inline int lowest_bit(uint32_t mask) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return (int) index;
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+#endif
+
+    /**
+     * @brief Whether needle occurs in text. Candidates are positions where the first and the last byte of the
+     * needle match, tested a register width at a time and then compared in full. With fold the needle is
+     * lower case and ASCII letters in text match either case: OR-ing 0x20 maps both cases of a letter to
+     * the lower one, the few other bytes it maps onto a letter are ruled out by the full comparison
+     */
+    static bool contains(const char *text, size_t length, const std::string &needle, bool fold) {
+        const size_t m = needle.size();
+        if (m == 0)
+            return true;
+        if (m > length)
+            return false;
+        const char first = needle[0];
+        const char last = needle[m - 1];
+        const char firstFold = fold && is_letter(first) ? 0x20 : 0;
+        const char lastFold = fold && is_letter(last) ? 0x20 : 0;
+        const size_t positions = length - m + 1;
+        size_t i = 0;
+#if defined(LOGCONSOLE_AVX2)
+        const __m256i vFirst256 = _mm256_set1_epi8(first), vLast256 = _mm256_set1_epi8(last);
+        const __m256i vFirstFold256 = _mm256_set1_epi8(firstFold), vLastFold256 = _mm256_set1_epi8(lastFold);
+        for (; i + 32 <= positions; i += 32) {
+            __m256i blockFirst = _mm256_or_si256(_mm256_loadu_si256((const __m256i *) (text + i)), vFirstFold256);
+            __m256i blockLast = _mm256_or_si256(_mm256_loadu_si256((const __m256i *) (text + i + m - 1)),
+                                                vLastFold256);
+            auto mask = (uint32_t) _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, vFirst256),
+                                                                         _mm256_cmpeq_epi8(blockLast, vLast256)));
+            while (mask != 0) {
+                if (equal_at(text + i + lowest_bit(mask), needle.data(), m, fold))
+                    return true;
+                mask &= mask - 1;
+            }
+        }
+#endif
+#if defined(LOGCONSOLE_AVX2) || defined(LOGCONSOLE_SSE)
+        // Log lines are short, with AVX2 the rest still goes 16 positions at a time
+        const __m128i vFirst = _mm_set1_epi8(first), vLast = _mm_set1_epi8(last);
+        const __m128i vFirstFold = _mm_set1_epi8(firstFold), vLastFold = _mm_set1_epi8(lastFold);
+        for (; i + 16 <= positions; i += 16) {
+            __m128i blockFirst = _mm_or_si128(_mm_loadu_si128((const __m128i *) (text + i)), vFirstFold);
+            __m128i blockLast = _mm_or_si128(_mm_loadu_si128((const __m128i *) (text + i + m - 1)), vLastFold);
+            auto mask = (uint32_t) _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, vFirst),
+                                                                   _mm_cmpeq_epi8(blockLast, vLast)));
+            while (mask != 0) {
+                if (equal_at(text + i + lowest_bit(mask), needle.data(), m, fold))
+                    return true;
+                mask &= mask - 1;
+            }
+        }
+#endif
+        for (; i < positions; i++) {
+            if ((char) (text[i] | firstFold) == first && (char) (text[i + m - 1] | lastFold) == last &&
+                equal_at(text + i, needle.data(), m, fold))
+                return true;
+        }
+        return false;
+    }
+
+    logConsole::logConsole(size_t capacity) : m_maxChunks(std::max<size_t>(1, capacity / chunkSize)) {}
+
+    void logConsole::append(logLevel level, std::string_view text) {
+        if (!text.empty() && text.back() == '\n')
+            text.remove_suffix(1);
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        for (;;) {
+            size_t end = std::min(text.find('\n'), text.size());
+            std::string_view line = text.substr(0, end);
+            if (!line.empty() && line.back() == '\r')
+                line.remove_suffix(1);
+            line = line.substr(0, chunkSize);
+            m_pendingText.append(line);
+            m_pendingLines.push_back({(uint32_t) line.size(), level});
+            if (end == text.size())
+                break;
+            text.remove_prefix(end + 1);
+        }
+    }
+
+    void logConsole::appendf(logLevel level, const char *fmt, ...) {
+        char buffer[1024];
+        va_list args;
+        va_start(args, fmt);
+        int length = vsnprintf(buffer, sizeof(buffer), fmt, args);
+        va_end(args);
+        if (length < 0)
+            return;
+        if ((size_t) length < sizeof(buffer)) {
+            append(level, std::string_view(buffer, (size_t) length));
+            return;
+        }
+        std::string text((size_t) length, '\0');
+        va_start(args, fmt);
+        vsnprintf(text.data(), text.size() + 1, fmt, args);
+        va_end(args);
+        append(level, text);
+    }
+
+    void logConsole::clear() {
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            m_pendingText.clear();
+            m_pendingLines.clear();
+        }
+        m_lineBase += m_lines.size();
+        m_lines.clear();
+        m_chunkBase += (uint32_t) m_chunks.size();
+        m_chunks.clear();
+        m_chunkUsed = chunkSize;
+        m_filtered.clear();
+        m_candidates.clear();
+        m_scanned = m_lineBase;
+        m_shownCount = 0;
+    }
+
+    bool logConsole::filtering() const {
+        return !m_needle.empty() || (m_levelMask & all_levels) != all_levels;
+    }
+
+    std::string_view logConsole::text(const lineEntry &entry) const {
+        return {m_chunks[entry.chunk - m_chunkBase].get() + entry.offset, entry.length};
+    }
+
+    std::string_view logConsole::line(size_t i) const {
+        return text(m_lines[i]);
+    }
+
+    bool logConsole::matches(const lineEntry &entry) const {
+        if ((m_levelMask & (1u << entry.level)) == 0)
+            return false;
+        std::string_view t = text(entry);
+        return contains(t.data(), t.size(), m_needle, !m_matchCase);
+    }
+
+    void logConsole::setFilter(std::string_view filterText, bool matchCase) {
+        std::string needle(filterText);
+        if (!matchCase)
+            std::transform(needle.begin(), needle.end(), needle.begin(), fold_case);
+        if (needle == m_needle && matchCase == m_matchCase)
+            return;
+        // Every line containing the new needle also contains the old one
+        bool narrow = filtering() && matchCase == m_matchCase && needle.find(m_needle) != std::string::npos;
+        m_needle = std::move(needle);
+        m_matchCase = matchCase;
+        size_t length = std::min(filterText.size(), sizeof(m_filterInput) - 1);
+        memcpy(m_filterInput, filterText.data(), length);
+        m_filterInput[length] = '\0';
+        m_matchCaseInput = matchCase;
+        restartFilter(narrow);
+    }
+
+    void logConsole::setLevelMask(uint32_t mask) {
+        mask &= all_levels;
+        if (mask == m_levelMask)
+            return;
+        bool narrow = filtering() && (mask & ~m_levelMask) == 0;
+        m_levelMask = mask;
+        for (uint32_t l = 0; l < (uint32_t) logLevel::count; l++)
+            m_levelEnabled[l] = (mask & (1u << l)) != 0;
+        restartFilter(narrow);
+    }
+
+    void logConsole::restartFilter(bool narrow) {
+        if (!filtering()) {
+            // Unfiltered rows map straight to lines, the index is not maintained
+            m_filtered.clear();
+            m_candidates.clear();
+            m_scanned = m_lineBase;
+            return;
+        }
+        if (narrow) {
+            // Only the previous matches are tested again, by scan() within its budget. The candidates a
+            // narrowing still in progress did not get to come after its matches, so the order holds
+            m_filtered.insert(m_filtered.end(), m_candidates.begin(), m_candidates.end());
+            m_candidates.swap(m_filtered);
+            m_filtered.clear();
+            m_stats.narrowings++;
+        } else {
+            m_filtered.clear();
+            m_candidates.clear();
+            m_scanned = m_lineBase;
+            m_stats.rescans++;
+        }
+    }
+
+    void logConsole::store(logLevel level, std::string_view line) {
+        if (m_chunkUsed + line.size() > chunkSize) {
+            // The oldest chunk is reused once the capacity is reached
+            std::unique_ptr<char[]> chunk;
+            if (m_chunks.size() >= m_maxChunks) {
+                chunk = std::move(m_chunks.front());
+                evict();
+            } else {
+                chunk.reset(new char[chunkSize]);
+            }
+            m_chunks.push_back(std::move(chunk));
+            m_chunkUsed = 0;
+        }
+        auto chunk = (uint32_t) (m_chunkBase + m_chunks.size() - 1);
+        if (!line.empty())
+            memcpy(m_chunks.back().get() + m_chunkUsed, line.data(), line.size());
+        m_lines.push_back({chunk, (uint32_t) m_chunkUsed, (uint32_t) line.size(), (uint8_t) level});
+        m_chunkUsed += line.size();
+        m_stats.lines++;
+    }
+
+    void logConsole::evict() {
+        while (!m_lines.empty() && m_lines.front().chunk == m_chunkBase) {
+            m_lines.pop_front();
+            m_lineBase++;
+            m_stats.droppedLines++;
+        }
+        m_chunks.pop_front();
+        m_chunkBase++;
+        while (!m_filtered.empty() && m_filtered.front() < m_lineBase)
+            m_filtered.pop_front();
+        while (!m_candidates.empty() && m_candidates.front() < m_lineBase)
+            m_candidates.pop_front();
+        m_scanned = std::max(m_scanned, m_lineBase);
+    }
+
+    void logConsole::scan() {
+        const uint64_t end = m_lineBase + m_lines.size();
+        size_t budget = scanBudget;
+        // The candidates of a narrowed filter are all before m_scanned, so they go first
+        while (!m_candidates.empty()) {
+            const uint64_t n = m_candidates.front();
+            m_candidates.pop_front();
+            const lineEntry &entry = m_lines[n - m_lineBase];
+            if (matches(entry))
+                m_filtered.push_back(n);
+            m_stats.scannedBytes += entry.length;
+            size_t cost = entry.length + line_scan_cost;
+            if (cost >= budget)
+                return;
+            budget -= cost;
+        }
+        while (m_scanned < end) {
+            const lineEntry &entry = m_lines[m_scanned - m_lineBase];
+            if (matches(entry))
+                m_filtered.push_back(m_scanned);
+            m_scanned++;
+            m_stats.scannedBytes += entry.length;
+            size_t cost = entry.length + line_scan_cost;
+            if (cost >= budget)
+                break;
+            budget -= cost;
+        }
+    }
+
+    void logConsole::update() {
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            m_flushText.swap(m_pendingText);
+            m_flushLines.swap(m_pendingLines);
+        }
+        size_t offset = 0;
+        for (const pendingLine &pending: m_flushLines) {
+            store(pending.level, std::string_view(m_flushText.data() + offset, pending.length));
+            offset += pending.length;
+        }
+        m_flushText.clear();
+        m_flushLines.clear();
+        if (filtering())
+            scan();
+    }
+
+    void logConsole::draw(const char *title, bool *open) {
+        update();
+        ImGui::SetNextWindowSize(ImVec2(640, 360), ImGuiCond_FirstUseEver);
+        if (!ImGui::Begin(title, open)) {
+            ImGui::End();
+            return;
+        }
+
+        if (ImGui::SmallButton("Clear"))
+            clear();
+        bool levelsChanged = false;
+        for (size_t l = 0; l < (size_t) logLevel::count; l++) {
+            ImGui::SameLine();
+            levelsChanged |= ImGui::Checkbox(logLevelName((logLevel) l), &m_levelEnabled[l]);
+        }
+        if (levelsChanged) {
+            uint32_t mask = 0;
+            for (size_t l = 0; l < (size_t) logLevel::count; l++)
+                mask |= m_levelEnabled[l] ? 1u << l : 0u;
+            setLevelMask(mask);
+        }
+        ImGui::SameLine();
+        bool filterChanged = ImGui::Checkbox("Aa", &m_matchCaseInput);
+        ImGui::SameLine();
+        ImGui::Checkbox("Follow", &autoScroll);
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(-FLT_MIN);
+        filterChanged |= ImGui::InputTextWithHint("##filter", "Filter", m_filterInput, sizeof(m_filterInput));
+        if (filterChanged)
+            setFilter(m_filterInput, m_matchCaseInput);
+        ImGui::TextDisabled("%zu of %zu lines%s", filteredCount(), lineCount(),
+                            filterPending() ? ", filtering..." : "");
+        ImGui::Separator();
+
+        ImGui::BeginChild("##lines", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
+        // Follows new lines only while scrolled to the bottom, so reading older ones is not interrupted
+        const bool follow = autoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY();
+        const size_t count = filteredCount();
+        const bool filtered = filtering();
+        ImGuiListClipper clipper;
+        clipper.Begin((int) count, ImGui::GetTextLineHeightWithSpacing());
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                size_t i = filtered ? (size_t) (m_filtered[(size_t) row] - m_lineBase) : (size_t) row;
+                const lineEntry &entry = m_lines[i];
+                std::string_view t = text(entry);
+                ImU32 color = 0;
+                switch ((logLevel) entry.level) {
+                    case logLevel::trace:
+                    case logLevel::debug:
+                        color = ImGui::GetColorU32(ImGuiCol_TextDisabled);
+                        break;
+                    case logLevel::warning:
+                        color = IM_COL32(230, 190, 60, 255);
+                        break;
+                    case logLevel::error:
+                        color = IM_COL32(240, 80, 70, 255);
+                        break;
+                    default:
+                        break;
+                }
+                if (color != 0)
+                    ImGui::PushStyleColor(ImGuiCol_Text, color);
+                ImGui::TextUnformatted(t.data(), t.data() + t.size());
+                if (color != 0)
+                    ImGui::PopStyleColor();
+            }
+        }
+        if (follow && count != m_shownCount)
+            ImGui::SetScrollHereY(1.0f);
+        m_shownCount = count;
+        ImGui::EndChild();
+        ImGui::End();
+    }
+
+} // engine
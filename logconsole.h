@@ -0,0 +1,181 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_LOGCONSOLE_H
+#define EASYGRAPHICSLIB_LOGCONSOLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "imgui.h"
+
+namespace engine {
+
+    enum class logLevel : uint8_t {
+        trace,
+        debug,
+        info,
+        warning,
+        error,
+        count
+    };
+
+    const char *logLevelName(logLevel level);
+
+    struct logStatistics {
+        uint64_t lines = 0;             // Appended since the console was created
+        uint64_t droppedLines = 0;      // Evicted to stay within the capacity
+        uint64_t scannedBytes = 0;      // Text the filter looked at
+        uint64_t rescans = 0;           // Filter changes that had to start over
+        uint64_t narrowings = 0;        // ... and those that only narrowed the previous matches
+    };
+
+    /**
+     * @brief Log view for millions of lines.
+     *
+     * Text goes into an append-only arena of fixed size chunks, lines are offsets into it, nothing is
+     * allocated per line. When the capacity is reached the oldest chunk is dropped with its lines. Only the
+     * visible rows are drawn. The filter index is updated incrementally: new lines are tested as they
+     * arrive, a filter that refines the previous one only narrows the matches, and any other change rescans
+     * in steps of scanBudget bytes per frame, so the frame rate holds while it catches up.
+     *
+     * append() may be called from any thread, everything else only from the main thread.
+     */
+    class logConsole {
+
+    public:
+        static constexpr size_t chunkSize = 1u << 20;
+
+        /**
+         * @param capacity Bytes of text kept, at least one chunk
+         */
+        explicit logConsole(size_t capacity = 64u << 20);
+
+        logConsole(const logConsole &) = delete;
+
+        logConsole &operator=(const logConsole &) = delete;
+
+        /**
+         * @brief Appends text, one line per '\n'. Lines longer than a chunk are cut
+         */
+        void append(logLevel level, std::string_view text);
+
+        void appendf(logLevel level, const char *fmt, ...) IM_FMTARGS(3);
+
+        void clear();
+
+        /**
+         * @brief Shows only lines containing text, ASCII case-insensitive unless matchCase
+         */
+        void setFilter(std::string_view text, bool matchCase = false);
+
+        /**
+         * @brief Shows only lines of the levels whose bit is set, bit n is logLevel n
+         */
+        void setLevelMask(uint32_t mask);
+
+        /**
+         * @brief Moves lines appended by other threads into the arena and advances the filter. Called by
+         * draw(), while the console is not drawn call it once per frame, until then appended lines pile up
+         */
+        void update();
+
+        /**
+         * @brief Draws the console as its own window
+         */
+        void draw(const char *title, bool *open = nullptr);
+
+        [[nodiscard]] size_t lineCount() const { return m_lines.size(); }
+
+        /**
+         * @brief Lines matching the filter so far, see filterPending()
+         */
+        [[nodiscard]] size_t filteredCount() const { return filtering() ? m_filtered.size() : m_lines.size(); }
+
+        /**
+         * @brief Whether the filter has not looked at every line yet
+         */
+        [[nodiscard]] bool filterPending() const {
+            return filtering() && (!m_candidates.empty() || m_scanned < m_lineBase + m_lines.size());
+        }
+
+        [[nodiscard]] std::string_view line(size_t i) const;
+
+        [[nodiscard]] logLevel level(size_t i) const { return (logLevel) m_lines[i].level; }
+
+        [[nodiscard]] const logStatistics &stats() const { return m_stats; }
+
+        size_t scanBudget = 32u << 20;  // Bytes the filter tests per update()
+        bool autoScroll = true;
+
+    private:
+        struct lineEntry {
+            uint32_t chunk;         // Absolute chunk number
+            uint32_t offset;
+            uint32_t length;
+            uint8_t level;
+        };
+
+        struct pendingLine {
+            uint32_t length;
+            logLevel level;
+        };
+
+        [[nodiscard]] bool filtering() const;
+
+        [[nodiscard]] bool matches(const lineEntry &entry) const;
+
+        [[nodiscard]] std::string_view text(const lineEntry &entry) const;
+
+        void store(logLevel level, std::string_view text);
+
+        void evict();
+
+        void scan();
+
+        void restartFilter(bool narrow);
+
+        // Arena, chunk n is m_chunks[n - m_chunkBase]
+        std::deque<std::unique_ptr<char[]>> m_chunks;
+        uint32_t m_chunkBase = 0;
+        size_t m_chunkUsed = chunkSize;
+        size_t m_maxChunks;
+
+        // Line n is m_lines[n - m_lineBase]
+        std::deque<lineEntry> m_lines;
+        uint64_t m_lineBase = 0;
+
+        // Filter, m_filtered holds line numbers of the matches among the lines before m_scanned. While a
+        // narrowed filter catches up, the matches of the previous one it has not tested yet are in m_candidates
+        std::string m_needle;       // Lower case unless m_matchCase
+        bool m_matchCase = false;
+        uint32_t m_levelMask = (1u << (uint32_t) logLevel::count) - 1;
+        std::deque<uint64_t> m_filtered;
+        std::deque<uint64_t> m_candidates;
+        uint64_t m_scanned = 0;
+
+        // Appended by other threads, moved into the arena by update()
+        std::mutex m_pendingMutex;
+        std::string m_pendingText;
+        std::vector<pendingLine> m_pendingLines;
+        std::string m_flushText;
+        std::vector<pendingLine> m_flushLines;
+
+        // Toolbar
+        char m_filterInput[256] = {};
+        bool m_levelEnabled[(size_t) logLevel::count] = {true, true, true, true, true};
+        bool m_matchCaseInput = false;
+        size_t m_shownCount = 0;
+
+        logStatistics m_stats;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_LOGCONSOLE_H
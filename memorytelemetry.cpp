@@ -0,0 +1,224 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+#include "imgui.h"
+#include "devicecontext.h"
+#include "memorytelemetry.h"
+
+namespace engine {
+
+    // Leaving the pressure state needs some headroom, so a heap right at the threshold does not toggle it
+    static const float pressure_hysteresis = 0.05f;
+
+    static double to_mib(VkDeviceSize bytes) {
+        return (double) bytes / (1024.0 * 1024.0);
+    }
+
+    void memoryTelemetry::create(deviceContext *context) {
+        m_context = context;
+        m_report = memoryReport();
+        m_lastSample = std::chrono::steady_clock::time_point();
+    }
+
+    void memoryTelemetry::destroy() {
+        if (m_report.underPressure && m_context != nullptr)
+            m_context->endMemoryPressure();
+        m_report.underPressure = false;
+        m_context = nullptr;
+    }
+
+    void memoryTelemetry::update(VkDeviceSize stagingBytes, uint32_t descriptorSets) {
+        if (m_context == nullptr)
+            return;
+        auto now = std::chrono::steady_clock::now();
+        if (m_report.sample > 0 && std::chrono::duration<double>(now - m_lastSample).count() < m_interval)
+            return;
+        sample(stagingBytes, descriptorSets);
+
+        if (m_dumpInterval > 0.0 &&
+            std::chrono::duration<double>(now - m_lastDump).count() >= m_dumpInterval) {
+            m_lastDump = now;
+            if (!dump(m_dumpPath, m_dumpFormat))
+                fprintf(stderr, "Failed to write memory dump to %s\n", m_dumpPath.c_str());
+        }
+    }
+
+    void memoryTelemetry::sample(VkDeviceSize stagingBytes, uint32_t descriptorSets) {
+        if (m_context == nullptr)
+            return;
+        m_lastSample = std::chrono::steady_clock::now();
+        deviceAllocator &device_memory = m_context->deviceMemory();
+        const VkPhysicalDeviceMemoryProperties &properties = device_memory.memoryProperties();
+        std::vector<deviceHeapStatistics> library = device_memory.heapStats();
+
+        m_report.sample++;
+        m_report.budgetExtension = m_context->queryMemoryBudget(m_budget, m_usage);
+        m_report.heaps.resize(properties.memoryHeapCount);
+        for (uint32_t i = 0; i < properties.memoryHeapCount; i++) {
+            heapReport &heap = m_report.heaps[i];
+            heap.size = properties.memoryHeaps[i].size;
+            heap.deviceLocal = (properties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+            heap.library = i < library.size() ? library[i] : deviceHeapStatistics();
+            if (m_report.budgetExtension) {
+                heap.budget = m_budget[i];
+                heap.usage = m_usage[i];
+            } else {
+                // Without the driver's numbers only our own allocations are known, other processes are not
+                heap.budget = heap.size / 10 * 8;
+                heap.usage = heap.library.reservedBytes;
+            }
+        }
+        m_report.device = device_memory.stats();
+        m_report.host = m_context->hostMemory().stats();
+        m_report.stagingBytes = stagingBytes;
+        m_report.descriptorSets = descriptorSets;
+        m_report.descriptorPoolSets = m_context->descriptorPoolSets();
+        throttle();
+    }
+
+    void memoryTelemetry::setThrottling(bool enabled, float threshold) {
+        m_throttling = enabled;
+        m_threshold = threshold;
+        if (!enabled && m_report.underPressure && m_context != nullptr) {
+            m_context->endMemoryPressure();
+            m_report.underPressure = false;
+            if (m_onPressure)
+                m_onPressure(false, m_report);
+        }
+    }
+
+    void memoryTelemetry::throttle() {
+        if (!m_throttling)
+            return;
+        float pressure = 0.0f;
+        for (const heapReport &heap: m_report.heaps)
+            pressure = std::max(pressure, heap.pressure());
+
+        deviceAllocator &device_memory = m_context->deviceMemory();
+        const bool was_under_pressure = m_report.underPressure;
+        if (!was_under_pressure && pressure >= m_threshold) {
+            m_report.underPressure = true;
+            m_context->beginMemoryPressure();
+        } else if (was_under_pressure && pressure < m_threshold - pressure_hysteresis) {
+            m_report.underPressure = false;
+            m_context->endMemoryPressure();
+        }
+        // Blocks freed by allocations of other windows may have become empty since the last sample
+        if (m_report.underPressure)
+            m_report.trimmedBytes += device_memory.trim();
+        if (m_report.underPressure != was_under_pressure && m_onPressure)
+            m_onPressure(m_report.underPressure, m_report);
+    }
+
+    void memoryTelemetry::drawPanel(bool *open) const {
+        ImGui::SetNextWindowSize(ImVec2(520, 300), ImGuiCond_FirstUseEver);
+        if (!ImGui::Begin("Memory", open)) {
+            ImGui::End();
+            return;
+        }
+        if (m_report.sample == 0) {
+            ImGui::TextDisabled("No sample yet");
+            ImGui::End();
+            return;
+        }
+        if (!m_report.budgetExtension)
+            ImGui::TextDisabled("VK_EXT_memory_budget unavailable, usage covers the engine's own allocations only");
+        if (m_report.underPressure)
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.3f, 1.0f), "Under memory pressure, empty blocks are freed");
+
+        if (ImGui::BeginTable("heaps", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+            ImGui::TableSetupColumn("Heap");
+            ImGui::TableSetupColumn("Usage / budget (MiB)", ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableSetupColumn("Reserved");
+            ImGui::TableSetupColumn("Buffers");
+            ImGui::TableSetupColumn("Images");
+            ImGui::TableSetupColumn("Empty");
+            ImGui::TableHeadersRow();
+            for (size_t i = 0; i < m_report.heaps.size(); i++) {
+                const heapReport &heap = m_report.heaps[i];
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu %s", i, heap.deviceLocal ? "device" : "host");
+                ImGui::TableNextColumn();
+                char overlay[64];
+                snprintf(overlay, sizeof(overlay), "%.1f / %.1f", to_mib(heap.usage), to_mib(heap.budget));
+                ImGui::ProgressBar(std::min(heap.pressure(), 1.0f), ImVec2(-FLT_MIN, 0), overlay);
+                for (VkDeviceSize v: {heap.library.reservedBytes, heap.library.bufferBytes, heap.library.imageBytes,
+                                      heap.library.emptyBlockBytes}) {
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.1f", to_mib(v));
+                }
+            }
+            ImGui::EndTable();
+        }
+
+        ImGui::Text("Allocator: %llu allocations in %llu blocks, %llu dedicated, %.1f%% fragmented",
+                    (unsigned long long) m_report.device.allocations, (unsigned long long) m_report.device.blocks,
+                    (unsigned long long) m_report.device.dedicatedAllocations,
+                    m_report.device.fragmentation * 100.0f);
+        ImGui::Text("Staging: %.1f MiB   Trimmed: %.1f MiB", to_mib(m_report.stagingBytes),
+                    to_mib(m_report.trimmedBytes));
+        ImGui::Text("Descriptor sets: %u of %u", m_report.descriptorSets, m_report.descriptorPoolSets);
+        ImGui::Text("Host: %.2f MiB, peak %.2f MiB, driver internal %.2f MiB", to_mib(m_report.host.currentBytes),
+                    to_mib(m_report.host.peakBytes), to_mib(m_report.host.internalBytes));
+        ImGui::End();
+    }
+
+    void memoryTelemetry::setDump(const std::string &path, double intervalSeconds, dumpFormat format) {
+        m_dumpPath = path;
+        m_dumpInterval = intervalSeconds;
+        m_dumpFormat = format;
+        m_lastDump = std::chrono::steady_clock::now();
+    }
+
+    bool memoryTelemetry::dump(const std::string &path, dumpFormat format) const {
+        FILE *file = fopen(path.c_str(), "w");
+        if (file == nullptr)
+            return false;
+
+        const memoryReport &r = m_report;
+        if (format == dumpFormat::csv) {
+            fprintf(file, "heap,deviceLocal,size,budget,usage,reserved,buffers,images,emptyBlocks\n");
+            for (size_t i = 0; i < r.heaps.size(); i++) {
+                const heapReport &h = r.heaps[i];
+                fprintf(file, "%zu,%d,%llu,%llu,%llu,%llu,%llu,%llu,%llu\n", i, h.deviceLocal ? 1 : 0,
+                        (unsigned long long) h.size, (unsigned long long) h.budget, (unsigned long long) h.usage,
+                        (unsigned long long) h.library.reservedBytes, (unsigned long long) h.library.bufferBytes,
+                        (unsigned long long) h.library.imageBytes, (unsigned long long) h.library.emptyBlockBytes);
+            }
+        } else {
+            fprintf(file, "{\n  \"sample\": %llu,\n  \"budgetExtension\": %s,\n  \"underPressure\": %s,\n",
+                    (unsigned long long) r.sample, r.budgetExtension ? "true" : "false",
+                    r.underPressure ? "true" : "false");
+            fprintf(file, "  \"heaps\": [\n");
+            for (size_t i = 0; i < r.heaps.size(); i++) {
+                const heapReport &h = r.heaps[i];
+                fprintf(file, "    {\"deviceLocal\": %s, \"size\": %llu, \"budget\": %llu, \"usage\": %llu, "
+                              "\"reserved\": %llu, \"buffers\": %llu, \"images\": %llu, \"emptyBlocks\": %llu}%s\n",
+                        h.deviceLocal ? "true" : "false", (unsigned long long) h.size,
+                        (unsigned long long) h.budget, (unsigned long long) h.usage,
+                        (unsigned long long) h.library.reservedBytes, (unsigned long long) h.library.bufferBytes,
+                        (unsigned long long) h.library.imageBytes, (unsigned long long) h.library.emptyBlockBytes,
+                        i + 1 == r.heaps.size() ? "" : ",");
+            }
+            fprintf(file, "  ],\n");
+            fprintf(file, "  \"device\": {\"blocks\": %llu, \"dedicatedAllocations\": %llu, \"allocations\": %llu, "
+                          "\"reserved\": %llu, \"used\": %llu, \"peakUsed\": %llu, \"fragmentation\": %.4f},\n",
+                    (unsigned long long) r.device.blocks, (unsigned long long) r.device.dedicatedAllocations,
+                    (unsigned long long) r.device.allocations, (unsigned long long) r.device.reservedBytes,
+                    (unsigned long long) r.device.usedBytes, (unsigned long long) r.device.peakUsedBytes,
+                    r.device.fragmentation);
+            fprintf(file, "  \"host\": {\"current\": %llu, \"peak\": %llu, \"pools\": %llu, \"internal\": %llu},\n",
+                    (unsigned long long) r.host.currentBytes, (unsigned long long) r.host.peakBytes,
+                    (unsigned long long) r.host.poolBytes, (unsigned long long) r.host.internalBytes);
+            fprintf(file, "  \"staging\": %llu,\n  \"descriptorSets\": %u,\n  \"descriptorPoolSets\": %u,\n"
+                          "  \"trimmed\": %llu\n}\n", (unsigned long long) r.stagingBytes, r.descriptorSets,
+                    r.descriptorPoolSets, (unsigned long long) r.trimmedBytes);
+        }
+        return fclose(file) == 0;
+    }
+
+} // engine
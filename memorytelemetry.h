@@ -0,0 +1,137 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_MEMORYTELEMETRY_H
+#define EASYGRAPHICSLIB_MEMORYTELEMETRY_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "vulkan/vulkan.h"
+#include "allocator.h"
+#include "profiler.h"
+
+namespace engine {
+
+    class deviceContext;
+
+    /**
+     * @brief Budget and usage of one memory heap
+     */
+    struct heapReport {
+        VkDeviceSize size = 0;
+        VkDeviceSize budget = 0;        // From the driver, without VK_EXT_memory_budget 80% of size
+        VkDeviceSize usage = 0;         // Whole process from the driver, without it library.reservedBytes
+        bool deviceLocal = false;
+        deviceHeapStatistics library;   // What deviceAllocator holds in the heap
+
+        [[nodiscard]] float pressure() const { return budget > 0 ? (float) ((double) usage / (double) budget) : 0.0f; }
+    };
+
+    struct memoryReport {
+        uint64_t sample = 0;            // Counts the samples taken, 0 before the first
+        bool budgetExtension = false;   // Budget and usage come from VK_EXT_memory_budget
+        std::vector<heapReport> heaps;
+        deviceMemoryStatistics device;
+        hostMemoryStatistics host;
+        VkDeviceSize stagingBytes = 0;  // Upload arena and heatmap staging ring of the window
+        uint32_t descriptorSets = 0;    // Allocated by the window from the shared pool
+        uint32_t descriptorPoolSets = 0;
+        bool underPressure = false;
+        VkDeviceSize trimmedBytes = 0;  // Given back to the device by throttling so far
+    };
+
+    /**
+     * @brief Samples heap budgets and the engine's own memory usage at a fixed interval.
+     *
+     * Sampling queries the driver, so update() only does it once the interval elapsed and report() returns the
+     * last sample in between. With throttling on, a heap whose usage reaches the threshold of its budget puts
+     * the window under pressure until every heap is a few percent below the threshold again. While any window
+     * sharing the deviceContext is under pressure, the deviceAllocator frees empty blocks instead of keeping
+     * them for reuse. The pressure callback lets the application drop
+     * caches of its own at the same time.
+     */
+    class memoryTelemetry {
+
+    public:
+        /**
+         * @brief Invoked from update() when the pressure state changes
+         */
+        using pressureCallback = std::function<void(bool underPressure, const memoryReport &report)>;
+
+        static constexpr double defaultInterval = 0.5;
+        static constexpr float defaultThreshold = 0.9f;
+
+        void create(deviceContext *context);
+
+        /**
+         * @brief Leaves the pressure state, so the shared allocator does not stay throttled for this window
+         */
+        void destroy();
+
+        /**
+         * @brief Takes a sample if the interval elapsed, then throttles and dumps as configured
+         * @param stagingBytes Staging memory of the window, allocated per window rather than shared
+         * @param descriptorSets Sets the window allocated from the shared descriptor pool
+         */
+        void update(VkDeviceSize stagingBytes, uint32_t descriptorSets);
+
+        /**
+         * @brief Takes a sample right away
+         */
+        void sample(VkDeviceSize stagingBytes, uint32_t descriptorSets);
+
+        [[nodiscard]] const memoryReport &report() const { return m_report; }
+
+        /**
+         * @brief Seconds between two samples, <= 0 samples every update()
+         */
+        void setInterval(double seconds) { m_interval = seconds; }
+
+        /**
+         * @brief Off by default
+         * @param threshold Usage relative to the budget of a heap at which the caches are trimmed
+         */
+        void setThrottling(bool enabled, float threshold = defaultThreshold);
+
+        void setPressureCallback(const pressureCallback &cb) { m_onPressure = cb; }
+
+        /**
+         * @brief Draws an ImGui window with usage and budget per heap
+         */
+        void drawPanel(bool *open = nullptr) const;
+
+        /**
+         * @brief Periodically writes the latest report to a file, an interval <= 0 disables dumping
+         */
+        void setDump(const std::string &path, double intervalSeconds, dumpFormat format = dumpFormat::json);
+
+        bool dump(const std::string &path, dumpFormat format) const;
+
+    private:
+        void throttle();
+
+        deviceContext *m_context = nullptr;
+        memoryReport m_report;
+        double m_interval = defaultInterval;
+        std::chrono::steady_clock::time_point m_lastSample;
+        std::vector<VkDeviceSize> m_budget, m_usage;
+
+        // Throttling
+        bool m_throttling = false;
+        float m_threshold = defaultThreshold;
+        pressureCallback m_onPressure = nullptr;
+
+        // Dump
+        std::string m_dumpPath;
+        double m_dumpInterval = 0.0;
+        dumpFormat m_dumpFormat = dumpFormat::json;
+        std::chrono::steady_clock::time_point m_lastDump;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_MEMORYTELEMETRY_H
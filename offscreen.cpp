@@ -0,0 +1,305 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <chrono>
+#include "imgui.h"
+#include "offscreen.h"
+#include "vkutils.h"
+
+namespace engine {
+
+    void offscreenTarget::create(VkPhysicalDevice physicalDevice, VkDevice device, uint32_t queueFamily,
+                                 const VkAllocationCallbacks *allocator, uint32_t width, uint32_t height,
+                                 uint32_t frameCount) {
+        m_physicalDevice = physicalDevice;
+        m_device = device;
+        m_allocator = allocator;
+        m_width = width;
+        m_height = height;
+        VkResult err;
+
+        // Create the Render Pass, leaving the image ready to be copied out
+        {
+            VkAttachmentDescription attachment = {};
+            attachment.format = m_format;
+            attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+            attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+            attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            attachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            VkAttachmentReference color_attachment = {};
+            color_attachment.attachment = 0;
+            color_attachment.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            VkSubpassDescription subpass = {};
+            subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+            subpass.colorAttachmentCount = 1;
+            subpass.pColorAttachments = &color_attachment;
+            VkSubpassDependency dependencies[2] = {};
+            dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+            dependencies[0].dstSubpass = 0;
+            dependencies[0].srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            dependencies[0].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            dependencies[1].srcSubpass = 0;
+            dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+            dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            VkRenderPassCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+            info.attachmentCount = 1;
+            info.pAttachments = &attachment;
+            info.subpassCount = 1;
+            info.pSubpasses = &subpass;
+            info.dependencyCount = 2;
+            info.pDependencies = dependencies;
+            err = vkCreateRenderPass(m_device, &info, m_allocator, &m_renderPass);
+            check_vk_result(err);
+        }
+
+        m_frames.resize(frameCount);
+        for (frame &fd: m_frames) {
+            // Color image
+            {
+                VkImageCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+                info.imageType = VK_IMAGE_TYPE_2D;
+                info.format = m_format;
+                info.extent = {m_width, m_height, 1};
+                info.mipLevels = 1;
+                info.arrayLayers = 1;
+                info.samples = VK_SAMPLE_COUNT_1_BIT;
+                info.tiling = VK_IMAGE_TILING_OPTIMAL;
+                info.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+                info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+                info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                err = vkCreateImage(m_device, &info, m_allocator, &fd.image);
+                check_vk_result(err);
+
+                VkMemoryRequirements req;
+                vkGetImageMemoryRequirements(m_device, fd.image, &req);
+                VkMemoryAllocateInfo alloc_info = {};
+                alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+                alloc_info.allocationSize = req.size;
+                alloc_info.memoryTypeIndex = findMemoryType(m_physicalDevice, req.memoryTypeBits,
+                                                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+                IM_ASSERT(alloc_info.memoryTypeIndex != (uint32_t) -1);
+                err = vkAllocateMemory(m_device, &alloc_info, m_allocator, &fd.imageMemory);
+                check_vk_result(err);
+                err = vkBindImageMemory(m_device, fd.image, fd.imageMemory, 0);
+                check_vk_result(err);
+            }
+            {
+                VkImageViewCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+                info.image = fd.image;
+                info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+                info.format = m_format;
+                info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                info.subresourceRange.levelCount = 1;
+                info.subresourceRange.layerCount = 1;
+                err = vkCreateImageView(m_device, &info, m_allocator, &fd.imageView);
+                check_vk_result(err);
+            }
+            {
+                VkFramebufferCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+                info.renderPass = m_renderPass;
+                info.attachmentCount = 1;
+                info.pAttachments = &fd.imageView;
+                info.width = m_width;
+                info.height = m_height;
+                info.layers = 1;
+                err = vkCreateFramebuffer(m_device, &info, m_allocator, &fd.framebuffer);
+                check_vk_result(err);
+            }
+
+            // Command buffer and fence (created signaled so the first beginFrame does not block)
+            {
+                VkCommandPoolCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+                info.flags = 0;
+                info.queueFamilyIndex = queueFamily;
+                err = vkCreateCommandPool(m_device, &info, m_allocator, &fd.commandPool);
+                check_vk_result(err);
+            }
+            {
+                VkCommandBufferAllocateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+                info.commandPool = fd.commandPool;
+                info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+                info.commandBufferCount = 1;
+                err = vkAllocateCommandBuffers(m_device, &info, &fd.commandBuffer);
+                check_vk_result(err);
+            }
+            {
+                VkFenceCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+                info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+                err = vkCreateFence(m_device, &info, m_allocator, &fd.fence);
+                check_vk_result(err);
+            }
+
+            // Readback buffer, preferably cached since the CPU reads every byte of it
+            {
+                VkBufferCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+                info.size = (VkDeviceSize) m_width * m_height * 4;
+                info.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+                info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+                err = vkCreateBuffer(m_device, &info, m_allocator, &fd.readbackBuffer);
+                check_vk_result(err);
+
+                VkMemoryRequirements req;
+                vkGetBufferMemoryRequirements(m_device, fd.readbackBuffer, &req);
+                VkMemoryAllocateInfo alloc_info = {};
+                alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+                alloc_info.allocationSize = req.size;
+                alloc_info.memoryTypeIndex = findMemoryType(m_physicalDevice, req.memoryTypeBits,
+                                                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT |
+                                                            VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+                if (alloc_info.memoryTypeIndex == (uint32_t) -1)
+                    alloc_info.memoryTypeIndex = findMemoryType(m_physicalDevice, req.memoryTypeBits,
+                                                                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+                IM_ASSERT(alloc_info.memoryTypeIndex != (uint32_t) -1);
+                err = vkAllocateMemory(m_device, &alloc_info, m_allocator, &fd.readbackMemory);
+                check_vk_result(err);
+                err = vkBindBufferMemory(m_device, fd.readbackBuffer, fd.readbackMemory, 0);
+                check_vk_result(err);
+                err = vkMapMemory(m_device, fd.readbackMemory, 0, VK_WHOLE_SIZE, 0, &fd.readbackMapped);
+                check_vk_result(err);
+            }
+        }
+        m_frameIndex = 0;
+    }
+
+    void offscreenTarget::destroy() {
+        if (m_device == VK_NULL_HANDLE)
+            return;
+        flush();
+        for (frame &fd: m_frames) {
+            vkUnmapMemory(m_device, fd.readbackMemory);
+            vkDestroyBuffer(m_device, fd.readbackBuffer, m_allocator);
+            vkFreeMemory(m_device, fd.readbackMemory, m_allocator);
+            vkDestroyFence(m_device, fd.fence, m_allocator);
+            vkFreeCommandBuffers(m_device, fd.commandPool, 1, &fd.commandBuffer);
+            vkDestroyCommandPool(m_device, fd.commandPool, m_allocator);
+            vkDestroyFramebuffer(m_device, fd.framebuffer, m_allocator);
+            vkDestroyImageView(m_device, fd.imageView, m_allocator);
+            vkDestroyImage(m_device, fd.image, m_allocator);
+            vkFreeMemory(m_device, fd.imageMemory, m_allocator);
+        }
+        m_frames.clear();
+        vkDestroyRenderPass(m_device, m_renderPass, m_allocator);
+        m_renderPass = VK_NULL_HANDLE;
+        m_device = VK_NULL_HANDLE;
+    }
+
+    VkCommandBuffer offscreenTarget::beginFrame() {
+        m_frameIndex = (m_frameIndex + 1) % (uint32_t) m_frames.size();
+        frame &fd = m_frames[m_frameIndex];
+        VkResult err;
+        {
+            auto start = std::chrono::steady_clock::now();
+            err = vkWaitForFences(m_device, 1, &fd.fence, VK_TRUE, UINT64_MAX);
+            check_vk_result(err);
+            m_lastFenceWaitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            deliverReadback(fd);
+
+            err = vkResetFences(m_device, 1, &fd.fence);
+            check_vk_result(err);
+        }
+        {
+            err = vkResetCommandPool(m_device, fd.commandPool, 0);
+            check_vk_result(err);
+            VkCommandBufferBeginInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            info.flags |= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            err = vkBeginCommandBuffer(fd.commandBuffer, &info);
+            check_vk_result(err);
+        }
+        fd.frameNumber = m_frameNumber++;
+        return fd.commandBuffer;
+    }
+
+    void offscreenTarget::beginRenderPass(const VkClearValue &clearValue) {
+        frame &fd = m_frames[m_frameIndex];
+        VkRenderPassBeginInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        info.renderPass = m_renderPass;
+        info.framebuffer = fd.framebuffer;
+        info.renderArea.extent.width = m_width;
+        info.renderArea.extent.height = m_height;
+        info.clearValueCount = 1;
+        info.pClearValues = &clearValue;
+        vkCmdBeginRenderPass(fd.commandBuffer, &info, VK_SUBPASS_CONTENTS_INLINE);
+    }
+
+    void offscreenTarget::endRenderPass() {
+        vkCmdEndRenderPass(m_frames[m_frameIndex].commandBuffer);
+    }
+
+    void offscreenTarget::endFrame(VkQueue queue, bool readback, std::mutex *queueMutex) {
+        frame &fd = m_frames[m_frameIndex];
+        if (readback) {
+            // The render pass already moved the image to TRANSFER_SRC_OPTIMAL
+            VkBufferImageCopy region = {};
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.layerCount = 1;
+            region.imageExtent = {m_width, m_height, 1};
+            vkCmdCopyImageToBuffer(fd.commandBuffer, fd.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                   fd.readbackBuffer, 1, &region);
+
+            VkBufferMemoryBarrier barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.buffer = fd.readbackBuffer;
+            barrier.size = VK_WHOLE_SIZE;
+            vkCmdPipelineBarrier(fd.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0,
+                                 0, nullptr, 1, &barrier, 0, nullptr);
+        }
+        fd.readbackPending = readback;
+
+        VkSubmitInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        info.commandBufferCount = 1;
+        info.pCommandBuffers = &fd.commandBuffer;
+        VkResult err = vkEndCommandBuffer(fd.commandBuffer);
+        check_vk_result(err);
+        if (queueMutex != nullptr) {
+            std::lock_guard<std::mutex> lock(*queueMutex);
+            err = vkQueueSubmit(queue, 1, &info, fd.fence);
+        } else {
+            err = vkQueueSubmit(queue, 1, &info, fd.fence);
+        }
+        check_vk_result(err);
+    }
+
+    void offscreenTarget::flush() {
+        // Deliver in submission order, starting with the oldest slot
+        for (size_t i = 1; i <= m_frames.size(); i++) {
+            frame &fd = m_frames[(m_frameIndex + i) % m_frames.size()];
+            VkResult err = vkWaitForFences(m_device, 1, &fd.fence, VK_TRUE, UINT64_MAX);
+            check_vk_result(err);
+            deliverReadback(fd);
+        }
+    }
+
+    void offscreenTarget::deliverReadback(frame &fd) {
+        if (!fd.readbackPending)
+            return;
+        fd.readbackPending = false;
+        if (m_onReadback != nullptr)
+            m_onReadback((const uint8_t *) fd.readbackMapped, m_width, m_height, fd.frameNumber);
+    }
+
+} // engine
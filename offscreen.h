@@ -0,0 +1,109 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_OFFSCREEN_H
+#define EASYGRAPHICSLIB_OFFSCREEN_H
+
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "vulkan/vulkan.h"
+
+namespace engine {
+
+    /**
+     * @brief Render target used instead of a swapchain in headless mode.
+     *
+     * Every frame slot owns its own color image, framebuffer, command buffer, fence and a host visible
+     * readback buffer, so a readback never stalls the frame that is currently being recorded. Finished
+     * readbacks are handed to the callback the next time their slot comes around, or on flush().
+     */
+    class offscreenTarget {
+
+    public:
+        using readbackCallback = std::function<void(const uint8_t *rgba, uint32_t width, uint32_t height,
+                                                    uint64_t frameNumber)>;
+
+        void create(VkPhysicalDevice physicalDevice, VkDevice device, uint32_t queueFamily,
+                    const VkAllocationCallbacks *allocator, uint32_t width, uint32_t height, uint32_t frameCount = 2);
+
+        void destroy();
+
+        /**
+         * @brief Waits for the next frame slot, delivers its readback if any and begins its command buffer
+         */
+        VkCommandBuffer beginFrame();
+
+        void beginRenderPass(const VkClearValue &clearValue);
+
+        void endRenderPass();
+
+        /**
+         * @brief Optionally records the copy into the readback buffer and submits the frame
+         * @param queueMutex Held around the submission if the queue is shared with another thread
+         */
+        void endFrame(VkQueue queue, bool readback, std::mutex *queueMutex = nullptr);
+
+        /**
+         * @brief Waits for all submitted frames and delivers every outstanding readback
+         */
+        void flush();
+
+        void setReadbackCallback(const readbackCallback &cb) { m_onReadback = cb; }
+
+        [[nodiscard]] VkRenderPass renderPass() const { return m_renderPass; }
+
+        [[nodiscard]] uint32_t frameCount() const { return (uint32_t) m_frames.size(); }
+
+        [[nodiscard]] uint32_t width() const { return m_width; }
+
+        [[nodiscard]] uint32_t height() const { return m_height; }
+
+        [[nodiscard]] uint32_t currentSlot() const { return m_frameIndex; }
+
+        /**
+         * @brief Time the last beginFrame() waited for the fence of its slot, in milliseconds
+         */
+        [[nodiscard]] double lastFenceWait() const { return m_lastFenceWaitMs; }
+
+        [[nodiscard]] uint64_t currentFrameNumber() const { return m_frames[m_frameIndex].frameNumber; }
+
+        [[nodiscard]] VkCommandPool currentCommandPool() const { return m_frames[m_frameIndex].commandPool; }
+
+        [[nodiscard]] VkCommandBuffer currentCommandBuffer() const { return m_frames[m_frameIndex].commandBuffer; }
+
+    private:
+        struct frame {
+            VkImage image = VK_NULL_HANDLE;
+            VkDeviceMemory imageMemory = VK_NULL_HANDLE;
+            VkImageView imageView = VK_NULL_HANDLE;
+            VkFramebuffer framebuffer = VK_NULL_HANDLE;
+            VkCommandPool commandPool = VK_NULL_HANDLE;
+            VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+            VkFence fence = VK_NULL_HANDLE;
+            VkBuffer readbackBuffer = VK_NULL_HANDLE;
+            VkDeviceMemory readbackMemory = VK_NULL_HANDLE;
+            void *readbackMapped = nullptr;
+            bool readbackPending = false;
+            uint64_t frameNumber = 0;
+        };
+
+        void deliverReadback(frame &fd);
+
+        VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
+        VkDevice m_device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks *m_allocator = nullptr;
+        VkRenderPass m_renderPass = VK_NULL_HANDLE;
+        VkFormat m_format = VK_FORMAT_R8G8B8A8_UNORM;
+        uint32_t m_width = 0, m_height = 0;
+        std::vector<frame> m_frames;
+        uint32_t m_frameIndex = 0;
+        uint64_t m_frameNumber = 0;
+        double m_lastFenceWaitMs = 0.0;
+        readbackCallback m_onReadback = nullptr;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_OFFSCREEN_H
@@ -0,0 +1,169 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+#include "pipelinecache.h"
+#include "vkutils.h"
+
+namespace engine {
+
+    static const char pipeline_cache_magic[8] = {'E', 'G', 'L', 'P', 'C', 'A', 'C', 'H'};
+    static const uint32_t pipeline_cache_version = 1;
+
+    struct pipelineCacheFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t dataSize;
+        uint64_t dataHash;
+    };
+
+    static long process_id() {
+#ifdef _WIN32
+        return (long) _getpid();
+#else
+        return (long) getpid();
+#endif
+    }
+
+    // FNV-1a, only guards against truncated and corrupt files
+    static uint64_t hash_bytes(const uint8_t *data, size_t size) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= data[i];
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    void pipelineCache::create(VkPhysicalDevice physicalDevice, VkDevice device,
+                               const VkAllocationCallbacks *allocator, const std::string &path) {
+        m_physicalDevice = physicalDevice;
+        m_device = device;
+        m_allocator = allocator;
+        m_path = path;
+        m_loadedBytes = 0;
+        m_loadedHash = 0;
+
+        std::vector<uint8_t> data;
+        FILE *file = m_path.empty() ? nullptr : fopen(m_path.c_str(), "rb");
+        if (file != nullptr) {
+            pipelineCacheFileHeader header = {};
+            if (fread(&header, sizeof(header), 1, file) == 1 &&
+                memcmp(header.magic, pipeline_cache_magic, sizeof(header.magic)) == 0 &&
+                header.version == pipeline_cache_version && header.dataSize < (1ull << 31)) {
+                data.resize((size_t) header.dataSize);
+                if (fread(data.data(), 1, data.size(), file) != data.size() ||
+                    hash_bytes(data.data(), data.size()) != header.dataHash || !validate(data.data(), data.size()))
+                    data.clear();
+            }
+            fclose(file);
+        }
+
+        VkPipelineCacheCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        info.initialDataSize = data.size();
+        info.pInitialData = data.empty() ? nullptr : data.data();
+        VkResult err = vkCreatePipelineCache(m_device, &info, m_allocator, &m_cache);
+        if (err != VK_SUCCESS && !data.empty()) {
+            // Some drivers reject data they consider stale, starting empty is always fine
+            info.initialDataSize = 0;
+            info.pInitialData = nullptr;
+            data.clear();
+            err = vkCreatePipelineCache(m_device, &info, m_allocator, &m_cache);
+        }
+        check_vk_result(err);
+        m_loadedBytes = data.size();
+        m_loadedHash = data.empty() ? 0 : hash_bytes(data.data(), data.size());
+    }
+
+    /**
+     * @brief Checks the VkPipelineCacheHeaderVersionOne at the start of the data against the current device
+     */
+    bool pipelineCache::validate(const uint8_t *data, size_t size) const {
+        struct {
+            uint32_t headerSize;
+            uint32_t headerVersion;
+            uint32_t vendorID;
+            uint32_t deviceID;
+            uint8_t uuid[VK_UUID_SIZE];
+        } header = {};
+        if (size < sizeof(header))
+            return false;
+        memcpy(&header, data, sizeof(header));
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+        return header.headerSize >= sizeof(header) && header.headerSize <= size &&
+               header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+               header.vendorID == properties.vendorID && header.deviceID == properties.deviceID &&
+               memcmp(header.uuid, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    }
+
+    bool pipelineCache::save() {
+        if (m_cache == VK_NULL_HANDLE || m_path.empty())
+            return true;
+        size_t size = 0;
+        VkResult err = vkGetPipelineCacheData(m_device, m_cache, &size, nullptr);
+        check_vk_result(err);
+        std::vector<uint8_t> data(size);
+        err = vkGetPipelineCacheData(m_device, m_cache, &size, data.data());
+        check_vk_result(err);
+        data.resize(size);
+        if (data.empty())
+            return true;
+
+        pipelineCacheFileHeader header = {};
+        memcpy(header.magic, pipeline_cache_magic, sizeof(header.magic));
+        header.version = pipeline_cache_version;
+        header.dataSize = data.size();
+        header.dataHash = hash_bytes(data.data(), data.size());
+        if (data.size() == m_loadedBytes && header.dataHash == m_loadedHash)
+            return true;
+
+        // Write next to the target and rename, so a crash never leaves a half written cache behind
+        std::error_code ec;
+        std::filesystem::path target(m_path);
+        if (target.has_parent_path())
+            std::filesystem::create_directories(target.parent_path(), ec);
+        // Unique per process, so two applications saving at once do not write into the same file. Opened
+        // exclusively, an existing file or link with that name is never written through
+        std::string temp_path = m_path + "." + std::to_string(process_id()) + ".tmp";
+        FILE *file = fopen(temp_path.c_str(), "wbx");
+        if (file == nullptr) {
+            // Left behind by a crashed process that had the same id
+            std::filesystem::remove(temp_path, ec);
+            file = fopen(temp_path.c_str(), "wbx");
+        }
+        if (file == nullptr)
+            return false;
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  fwrite(data.data(), 1, data.size(), file) == data.size();
+        ok = fclose(file) == 0 && ok;
+        if (ok)
+            std::filesystem::rename(temp_path, target, ec);
+        if (!ok || ec) {
+            std::filesystem::remove(temp_path, ec);
+            return false;
+        }
+        m_loadedBytes = data.size();
+        m_loadedHash = header.dataHash;
+        return true;
+    }
+
+    void pipelineCache::destroy() {
+        if (m_cache == VK_NULL_HANDLE)
+            return;
+        vkDestroyPipelineCache(m_device, m_cache, m_allocator);
+        m_cache = VK_NULL_HANDLE;
+    }
+
+} // engine
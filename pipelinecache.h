@@ -0,0 +1,59 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_PIPELINECACHE_H
+#define EASYGRAPHICSLIB_PIPELINECACHE_H
+
+#include <cstdint>
+#include <string>
+#include "vulkan/vulkan.h"
+
+namespace engine {
+
+    /**
+     * @brief VkPipelineCache that survives restarts.
+     *
+     * The cache data is stored behind a small file header with its size and a hash, so truncated or corrupt
+     * files are never handed to the driver. The Vulkan cache header is checked against the vendor, device and
+     * pipelineCacheUUID of the current device, a cache written by another GPU or driver version is ignored.
+     */
+    class pipelineCache {
+
+    public:
+        /**
+         * @param path File the cache is loaded from and saved to, empty keeps the cache in memory only
+         */
+        void create(VkPhysicalDevice physicalDevice, VkDevice device, const VkAllocationCallbacks *allocator,
+                    const std::string &path);
+
+        /**
+         * @brief Writes the cache to disk if it changed since it was loaded
+         * @return false if writing failed
+         */
+        bool save();
+
+        void destroy();
+
+        [[nodiscard]] VkPipelineCache handle() const { return m_cache; }
+
+        /**
+         * @brief Size of the cache data loaded from disk, 0 if the file was missing or rejected
+         */
+        [[nodiscard]] size_t loadedBytes() const { return m_loadedBytes; }
+
+    private:
+        bool validate(const uint8_t *data, size_t size) const;
+
+        VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
+        VkDevice m_device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks *m_allocator = nullptr;
+        VkPipelineCache m_cache = VK_NULL_HANDLE;
+        std::string m_path;
+        size_t m_loadedBytes = 0;
+        uint64_t m_loadedHash = 0;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_PIPELINECACHE_H
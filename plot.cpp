@@ -0,0 +1,481 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "allocator.h"
+#include "lodseries.h"
+#include "plot.h"
+#include "vkutils.h"
+
+namespace engine {
+
+    // SPIR-V generated from shaders/ by glslc at build time
+    static const uint32_t plot_vert_spv[] =
+#include "shaders/plot.vert.h"
+    ;
+    static const uint32_t plot_frag_spv[] =
+#include "shaders/plot.frag.h"
+    ;
+
+    // Zoom factor per mouse wheel notch
+    static const float plot_zoom_step = 1.2f;
+
+    /**
+     * @brief Creates a persistently mapped vertex buffer, preferring device local memory the CPU can write
+     * to directly and falling back to plain host memory
+     */
+    static float *create_mapped_vertex_buffer(deviceAllocator &memory, VkDeviceSize size, VkBuffer &buffer,
+                                              deviceAllocation &allocation) {
+        VkBufferCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        info.size = size;
+        info.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+        info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        VkResult err = memory.createBuffer(info, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                 VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, allocation);
+        check_vk_result(err);
+        return (float *) allocation.mapped;
+    }
+
+    plotSeries::plotSeries(deviceAllocator &memory, size_t capacity, size_t headroom) :
+            m_memory(&memory), m_capacity(capacity), m_ringSize(capacity + headroom) {
+        // One extra vertex mirrors the first one, so a wrapped ring can be drawn as a continuous strip
+        m_mapped = create_mapped_vertex_buffer(memory, (VkDeviceSize) (m_ringSize + 1) * 2 * sizeof(float),
+                                               m_buffer, m_allocation);
+    }
+
+    plotSeries::~plotSeries() {
+        m_memory->destroyBuffer(m_buffer, m_allocation);
+    }
+
+    void plotSeries::append(double x, double y) {
+        if (m_head == m_cleared)
+            m_originX = x;
+        write(m_head++, (float) (x - m_originX), (float) y);
+        m_lastX = x;
+    }
+
+    void plotSeries::append(const double *x, const double *y, size_t count) {
+        for (size_t i = 0; i < count; i++)
+            append(x[i], y[i]);
+    }
+
+    void plotSeries::clear() {
+        m_cleared = m_head;
+    }
+
+    size_t plotSeries::size() const {
+        return (size_t) std::min<uint64_t>(m_head - m_cleared, m_capacity);
+    }
+
+    double plotSeries::firstX() const {
+        if (size() == 0)
+            return 0.0;
+        return m_originX + m_mapped[((m_head - size()) % m_ringSize) * 2];
+    }
+
+    void plotSeries::write(uint64_t index, float x, float y) {
+        size_t slot = (size_t) (index % m_ringSize);
+        m_mapped[slot * 2] = x;
+        m_mapped[slot * 2 + 1] = y;
+        if (slot == 0) {
+            m_mapped[m_ringSize * 2] = x;
+            m_mapped[m_ringSize * 2 + 1] = y;
+        }
+    }
+
+    void plotRenderer::create(VkDevice device, deviceAllocator &memory, VkRenderPass renderPass,
+                              VkPipelineCache pipelineCache, const VkAllocationCallbacks *allocator,
+                              uint32_t frameCount) {
+        m_device = device;
+        m_memory = &memory;
+        m_allocator = allocator;
+        VkResult err;
+
+        VkShaderModule vert_module, frag_module;
+        {
+            VkShaderModuleCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+            info.codeSize = sizeof(plot_vert_spv);
+            info.pCode = plot_vert_spv;
+            err = vkCreateShaderModule(m_device, &info, m_allocator, &vert_module);
+            check_vk_result(err);
+            info.codeSize = sizeof(plot_frag_spv);
+            info.pCode = plot_frag_spv;
+            err = vkCreateShaderModule(m_device, &info, m_allocator, &frag_module);
+            check_vk_result(err);
+        }
+        {
+            VkPushConstantRange push_constants = {};
+            push_constants.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+            push_constants.offset = 0;
+            push_constants.size = sizeof(pushConstants);
+            VkPipelineLayoutCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+            info.pushConstantRangeCount = 1;
+            info.pPushConstantRanges = &push_constants;
+            err = vkCreatePipelineLayout(m_device, &info, m_allocator, &m_pipelineLayout);
+            check_vk_result(err);
+        }
+
+        VkPipelineShaderStageCreateInfo stages[2] = {};
+        stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        stages[0].module = vert_module;
+        stages[0].pName = "main";
+        stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        stages[1].module = frag_module;
+        stages[1].pName = "main";
+
+        VkVertexInputBindingDescription binding_desc = {};
+        binding_desc.stride = 2 * sizeof(float);
+        binding_desc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+        VkVertexInputAttributeDescription attribute_desc = {};
+        attribute_desc.location = 0;
+        attribute_desc.binding = binding_desc.binding;
+        attribute_desc.format = VK_FORMAT_R32G32_SFLOAT;
+        attribute_desc.offset = 0;
+
+        VkPipelineVertexInputStateCreateInfo vertex_info = {};
+        vertex_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertex_info.vertexBindingDescriptionCount = 1;
+        vertex_info.pVertexBindingDescriptions = &binding_desc;
+        vertex_info.vertexAttributeDescriptionCount = 1;
+        vertex_info.pVertexAttributeDescriptions = &attribute_desc;
+
+        VkPipelineInputAssemblyStateCreateInfo ia_info = {};
+        ia_info.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+
+        VkPipelineViewportStateCreateInfo viewport_info = {};
+        viewport_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewport_info.viewportCount = 1;
+        viewport_info.scissorCount = 1;
+
+        VkPipelineRasterizationStateCreateInfo raster_info = {};
+        raster_info.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        raster_info.polygonMode = VK_POLYGON_MODE_FILL;
+        raster_info.cullMode = VK_CULL_MODE_NONE;
+        raster_info.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        raster_info.lineWidth = 1.0f;
+
+        VkPipelineMultisampleStateCreateInfo ms_info = {};
+        ms_info.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        ms_info.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkPipelineColorBlendAttachmentState color_attachment = {};
+        color_attachment.blendEnable = VK_TRUE;
+        color_attachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        color_attachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        color_attachment.colorBlendOp = VK_BLEND_OP_ADD;
+        color_attachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        color_attachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        color_attachment.alphaBlendOp = VK_BLEND_OP_ADD;
+        color_attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                          VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+        VkPipelineDepthStencilStateCreateInfo depth_info = {};
+        depth_info.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+
+        VkPipelineColorBlendStateCreateInfo blend_info = {};
+        blend_info.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        blend_info.attachmentCount = 1;
+        blend_info.pAttachments = &color_attachment;
+
+        VkDynamicState dynamic_states[2] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+        VkPipelineDynamicStateCreateInfo dynamic_state = {};
+        dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamic_state.dynamicStateCount = (uint32_t) IM_ARRAYSIZE(dynamic_states);
+        dynamic_state.pDynamicStates = dynamic_states;
+
+        VkGraphicsPipelineCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        info.stageCount = 2;
+        info.pStages = stages;
+        info.pVertexInputState = &vertex_info;
+        info.pInputAssemblyState = &ia_info;
+        info.pViewportState = &viewport_info;
+        info.pRasterizationState = &raster_info;
+        info.pMultisampleState = &ms_info;
+        info.pDepthStencilState = &depth_info;
+        info.pColorBlendState = &blend_info;
+        info.pDynamicState = &dynamic_state;
+        info.layout = m_pipelineLayout;
+        info.renderPass = renderPass;
+        info.subpass = 0;
+
+        ia_info.topology = VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
+        err = vkCreateGraphicsPipelines(m_device, pipelineCache, 1, &info, m_allocator, &m_linePipeline);
+        check_vk_result(err);
+        ia_info.topology = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+        err = vkCreateGraphicsPipelines(m_device, pipelineCache, 1, &info, m_allocator, &m_pointPipeline);
+        check_vk_result(err);
+
+        vkDestroyShaderModule(m_device, vert_module, m_allocator);
+        vkDestroyShaderModule(m_device, frag_module, m_allocator);
+
+        createStreamBuffer(frameCount + 1);
+    }
+
+    void plotRenderer::destroy() {
+        if (m_device == VK_NULL_HANDLE)
+            return;
+        m_records[0].clear();
+        m_records[1].clear();
+        m_series.clear();
+        destroyStreamBuffer();
+        vkDestroyPipeline(m_device, m_linePipeline, m_allocator);
+        vkDestroyPipeline(m_device, m_pointPipeline, m_allocator);
+        vkDestroyPipelineLayout(m_device, m_pipelineLayout, m_allocator);
+        m_linePipeline = m_pointPipeline = VK_NULL_HANDLE;
+        m_pipelineLayout = VK_NULL_HANDLE;
+        m_device = VK_NULL_HANDLE;
+    }
+
+    plotSeries *plotRenderer::createSeries(size_t capacity, size_t headroom) {
+        IM_ASSERT(m_device != VK_NULL_HANDLE && capacity > 0);
+        if (headroom == 0)
+            headroom = std::max<size_t>(capacity / 4, 1);
+        m_series.push_back(std::unique_ptr<plotSeries>(
+                new plotSeries(*m_memory, capacity, headroom)));
+        return m_series.back().get();
+    }
+
+    void plotRenderer::setFrameCount(uint32_t frameCount) {
+        if (m_device == VK_NULL_HANDLE || frameCount + 1 == m_streamRegions)
+            return;
+        destroyStreamBuffer();
+        createStreamBuffer(frameCount + 1);
+    }
+
+    void plotRenderer::createStreamBuffer(uint32_t regions) {
+        m_streamMapped = create_mapped_vertex_buffer(*m_memory,
+                                                     (VkDeviceSize) regions * streamRegionVertices * 2 * sizeof(float),
+                                                     m_streamBuffer, m_streamAllocation);
+        m_streamRegions = regions;
+        m_streamRegion = 0;
+        m_streamUsed = 0;
+    }
+
+    void plotRenderer::destroyStreamBuffer() {
+        if (m_streamBuffer == VK_NULL_HANDLE)
+            return;
+        m_memory->destroyBuffer(m_streamBuffer, m_streamAllocation);
+        m_streamMapped = nullptr;
+        m_streamRegions = 0;
+    }
+
+    bool plotRenderer::plot(const char *label, const ImVec2 &size, plotView &view, plotSeries *const *series,
+                            size_t count) {
+        bool changed = beginPlot(label, size, view);
+        for (size_t i = 0; m_plotVisible && i < count; i++) {
+            const plotSeries *s = series[i];
+            size_t visible = s->size();
+            if (visible < 2 && !(visible == 1 && s->style == plotStyle::points))
+                continue;
+
+            // Split the visible part of the ring into at most two contiguous ranges
+            drawRecord &rec = addRecord(s->m_buffer, s->m_originX, s->color, s->style);
+            auto first = (uint32_t) ((s->m_head - visible) % s->m_ringSize);
+            auto end = (uint32_t) (s->m_head % s->m_ringSize);
+            rec.firstVertex[0] = first;
+            if (first < end) {
+                rec.vertexCount[0] = end - first;
+            } else {
+                // The mirrored vertex at m_ringSize continues the strip into the start of the ring
+                rec.vertexCount[0] = (uint32_t) s->m_ringSize - first + (end > 0 ? 1 : 0);
+                rec.firstVertex[1] = 0;
+                rec.vertexCount[1] = end;
+            }
+        }
+        endPlot();
+        return changed;
+    }
+
+    bool plotRenderer::plot(const char *label, const ImVec2 &size, plotView &view, const lodSeries *const *series,
+                            size_t count) {
+        bool changed = beginPlot(label, size, view);
+        auto pixels = (size_t) std::ceil((m_plotMax.x - m_plotMin.x) * ImGui::GetIO().DisplayFramebufferScale.x);
+        for (size_t i = 0; m_plotVisible && i < count; i++) {
+            const lodSeries *s = series[i];
+
+            // Relative to the view, so the float vertices keep their precision at any zoom level
+            m_streamScratch.clear();
+            size_t points = s->query(m_plotView.xMin, m_plotView.xMax, pixels, m_plotView.xMin, m_streamScratch);
+            if (points == 0 || m_streamUsed + points > streamRegionVertices)
+                continue;
+            uint32_t first = m_streamRegion * streamRegionVertices + m_streamUsed;
+            memcpy(m_streamMapped + (size_t) first * 2, m_streamScratch.data(), points * 2 * sizeof(float));
+            m_streamUsed += (uint32_t) points;
+
+            drawRecord &rec = addRecord(m_streamBuffer, m_plotView.xMin, s->color, s->style);
+            rec.firstVertex[0] = first;
+            rec.vertexCount[0] = (uint32_t) points;
+        }
+        endPlot();
+        return changed;
+    }
+
+    /**
+     * @brief Lays out the plot frame, applies pan and zoom and opens the clip rectangle for the series
+     */
+    bool plotRenderer::beginPlot(const char *label, const ImVec2 &size, plotView &view) {
+        ImGui::PushID(label);
+        ImVec2 avail = ImGui::GetContentRegionAvail();
+        ImVec2 frame_size(size.x > 0.0f ? size.x : std::max(avail.x, 1.0f),
+                          size.y > 0.0f ? size.y : std::max(avail.y, 1.0f));
+        m_plotMin = ImGui::GetCursorScreenPos();
+        m_plotMax = ImVec2(m_plotMin.x + frame_size.x, m_plotMin.y + frame_size.y);
+        ImGui::InvisibleButton("##plot", frame_size);
+
+        // Drag pans both axes, the wheel zooms x around the cursor
+        bool changed = false;
+        double x_range = view.xMax - view.xMin;
+        double y_range = view.yMax - view.yMin;
+        if (ImGui::IsItemActive() && ImGui::IsMouseDragging(0, 0.0f)) {
+            ImVec2 delta = ImGui::GetMouseDragDelta(0, 0.0f);
+            ImGui::ResetMouseDragDelta(0);
+            double dx = delta.x / frame_size.x * x_range;
+            double dy = delta.y / frame_size.y * y_range;
+            view.xMin -= dx;
+            view.xMax -= dx;
+            view.yMin += dy;
+            view.yMax += dy;
+            changed = true;
+        }
+        float wheel = ImGui::GetIO().MouseWheel;
+        if (ImGui::IsItemHovered() && wheel != 0.0f) {
+            double t = (ImGui::GetIO().MousePos.x - m_plotMin.x) / frame_size.x;
+            double anchor = view.xMin + t * x_range;
+            double factor = std::pow(plot_zoom_step, -wheel);
+            view.xMin = anchor - (anchor - view.xMin) * factor;
+            view.xMax = anchor + (view.xMax - anchor) * factor;
+            changed = true;
+        }
+        m_plotView = view;
+
+        ImDrawList *draw_list = ImGui::GetWindowDrawList();
+        draw_list->AddRectFilled(m_plotMin, m_plotMax, ImGui::GetColorU32(ImGuiCol_FrameBg));
+        m_plotVisible = view.xMax > view.xMin && view.yMax > view.yMin;
+        if (m_plotVisible)
+            draw_list->PushClipRect(m_plotMin, m_plotMax, true);
+        return changed;
+    }
+
+    void plotRenderer::endPlot() {
+        ImDrawList *draw_list = ImGui::GetWindowDrawList();
+        if (m_plotVisible) {
+            draw_list->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+            draw_list->PopClipRect();
+        }
+        draw_list->AddRect(m_plotMin, m_plotMax, ImGui::GetColorU32(ImGuiCol_Border));
+        m_plotVisible = false;
+        ImGui::PopID();
+    }
+
+    plotRenderer::drawRecord &plotRenderer::addRecord(VkBuffer buffer, double originX, ImU32 color, plotStyle style) {
+        drawRecord rec = {};
+        rec.renderer = this;
+        rec.buffer = buffer;
+        rec.originX = originX;
+        rec.color = color;
+        rec.style = style;
+        rec.rectMin = m_plotMin;
+        rec.rectMax = m_plotMax;
+        rec.view = m_plotView;
+        std::deque<drawRecord> &records = m_records[m_recordSet];
+        records.push_back(rec);
+        ImGui::GetWindowDrawList()->AddCallback(drawCallback, &records.back());
+        return records.back();
+    }
+
+    void plotRenderer::newFrame() {
+        m_recordSet ^= 1;
+        m_records[m_recordSet].clear();
+        if (m_streamRegions > 0)
+            m_streamRegion = (m_streamRegion + 1) % m_streamRegions;
+        m_streamUsed = 0;
+    }
+
+    void plotRenderer::beginRecording(VkCommandBuffer commandBuffer, const ImDrawData *drawData) {
+        m_commandBuffer = commandBuffer;
+        m_displayPos = drawData->DisplayPos;
+        m_framebufferScale = drawData->FramebufferScale;
+        m_framebufferWidth = drawData->DisplaySize.x * drawData->FramebufferScale.x;
+        m_framebufferHeight = drawData->DisplaySize.y * drawData->FramebufferScale.y;
+        m_recordingData.store(drawData, std::memory_order_release);
+    }
+
+    void plotRenderer::endRecording() {
+        m_recordingData.store(nullptr, std::memory_order_release);
+        m_commandBuffer = VK_NULL_HANDLE;
+    }
+
+    void plotRenderer::drawCallback(const ImDrawList *parentList, const ImDrawCmd *cmd) {
+        const auto *rec = (const drawRecord *) cmd->UserCallbackData;
+        // Secondary platform windows are recorded by the backend or the viewport renderer, without access to their
+        // command buffers. With a render thread they are rendered while the main viewport is being recorded
+        const ImDrawData *data = rec->renderer->m_recordingData.load(std::memory_order_acquire);
+        if (data == nullptr)
+            return;
+        for (int n = 0; n < data->CmdListsCount; n++) {
+            if (data->CmdLists[n] == parentList) {
+                rec->renderer->record(*rec, cmd->ClipRect);
+                return;
+            }
+        }
+    }
+
+    void plotRenderer::record(const drawRecord &rec, const ImVec4 &clipRect) {
+        // Scissor from the ImGui clip rectangle, in framebuffer pixels
+        float clip_min_x = std::max((clipRect.x - m_displayPos.x) * m_framebufferScale.x, 0.0f);
+        float clip_min_y = std::max((clipRect.y - m_displayPos.y) * m_framebufferScale.y, 0.0f);
+        float clip_max_x = std::min((clipRect.z - m_displayPos.x) * m_framebufferScale.x, m_framebufferWidth);
+        float clip_max_y = std::min((clipRect.w - m_displayPos.y) * m_framebufferScale.y, m_framebufferHeight);
+        if (clip_max_x <= clip_min_x || clip_max_y <= clip_min_y)
+            return;
+
+        VkCommandBuffer cmd = m_commandBuffer;
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          rec.style == plotStyle::points ? m_pointPipeline : m_linePipeline);
+        VkDeviceSize offset = 0;
+        vkCmdBindVertexBuffers(cmd, 0, 1, &rec.buffer, &offset);
+
+        VkViewport viewport = {0.0f, 0.0f, m_framebufferWidth, m_framebufferHeight, 0.0f, 1.0f};
+        vkCmdSetViewport(cmd, 0, 1, &viewport);
+        VkRect2D scissor;
+        scissor.offset.x = (int32_t) clip_min_x;
+        scissor.offset.y = (int32_t) clip_min_y;
+        scissor.extent.width = (uint32_t) (clip_max_x - clip_min_x);
+        scissor.extent.height = (uint32_t) (clip_max_y - clip_min_y);
+        vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+        // Data -> screen pixels -> clip space, composed in double precision around the vertex origin
+        double to_clip_x = 2.0 * m_framebufferScale.x / m_framebufferWidth;
+        double to_clip_y = 2.0 * m_framebufferScale.y / m_framebufferHeight;
+        double px_per_x = (rec.rectMax.x - rec.rectMin.x) / (rec.view.xMax - rec.view.xMin);
+        double px_per_y = (rec.rectMax.y - rec.rectMin.y) / (rec.view.yMax - rec.view.yMin);
+        pushConstants pc = {};
+        pc.scale[0] = (float) (px_per_x * to_clip_x);
+        pc.scale[1] = (float) (-px_per_y * to_clip_y);
+        pc.offset[0] = (float) ((rec.rectMin.x - m_displayPos.x + (rec.originX - rec.view.xMin) * px_per_x) *
+                                to_clip_x - 1.0);
+        pc.offset[1] = (float) ((rec.rectMax.y - m_displayPos.y + rec.view.yMin * px_per_y) * to_clip_y - 1.0);
+        ImVec4 color = ImGui::ColorConvertU32ToFloat4(rec.color);
+        pc.color[0] = color.x;
+        pc.color[1] = color.y;
+        pc.color[2] = color.z;
+        pc.color[3] = color.w;
+        vkCmdPushConstants(cmd, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pc), &pc);
+
+        for (int i = 0; i < 2; i++) {
+            if (rec.vertexCount[i] > 0)
+                vkCmdDraw(cmd, rec.vertexCount[i], 1, rec.firstVertex[i], 0);
+        }
+    }
+
+} // engine
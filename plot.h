@@ -0,0 +1,231 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_PLOT_H
+#define EASYGRAPHICSLIB_PLOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "allocator.h"
+#include "imgui.h"
+#include "vulkan/vulkan.h"
+
+namespace engine {
+
+    class plotRenderer;
+
+    class lodSeries;
+
+    /**
+     * @brief Visible data range of a plot
+     */
+    struct plotView {
+        double xMin = 0.0;
+        double xMax = 1.0;
+        double yMin = 0.0;
+        double yMax = 1.0;
+    };
+
+    enum class plotStyle {
+        line,
+        points
+    };
+
+    /**
+     * @brief Sample storage of one plotted series: a persistently mapped vertex buffer used as a ring.
+     *
+     * Appending writes a single vertex straight into GPU visible memory, nothing is regenerated per frame.
+     * Only use from the render thread, e.g. from a channel drain callback. X values are stored as floats
+     * relative to the first sample, so keep an eye on the precision for very long running series.
+     */
+    class plotSeries {
+
+    public:
+        plotSeries(const plotSeries &) = delete;
+
+        plotSeries &operator=(const plotSeries &) = delete;
+
+        ~plotSeries();
+
+        void append(double x, double y);
+
+        void append(const double *x, const double *y, size_t count);
+
+        /**
+         * @brief Drops all samples, the next append sets a new x origin
+         */
+        void clear();
+
+        /**
+         * @brief Number of samples that get drawn, at most capacity()
+         */
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] size_t capacity() const { return m_capacity; }
+
+        [[nodiscard]] uint64_t totalAppended() const { return m_head; }
+
+        [[nodiscard]] double firstX() const;
+
+        [[nodiscard]] double lastX() const { return m_lastX; }
+
+        ImU32 color = IM_COL32(255, 200, 0, 255);
+        plotStyle style = plotStyle::line;
+
+    private:
+        friend class plotRenderer;
+
+        plotSeries(deviceAllocator &memory, size_t capacity, size_t headroom);
+
+        void write(uint64_t index, float x, float y);
+
+        deviceAllocator *m_memory = nullptr;
+        VkBuffer m_buffer = VK_NULL_HANDLE;
+        deviceAllocation m_allocation;
+        float *m_mapped = nullptr;
+
+        size_t m_capacity = 0;
+        size_t m_ringSize = 0;
+        uint64_t m_head = 0;
+        uint64_t m_cleared = 0;
+        double m_originX = 0.0;
+        double m_lastX = 0.0;
+    };
+
+    /**
+     * @brief Draws plot series with a dedicated line/point pipeline from inside the ImGui render pass.
+     *
+     * plot() reserves the space in the current ImGui window and adds a draw callback. When the window
+     * records the main viewport, the callback binds the plot pipeline and draws the series ring buffers
+     * directly, then ImGui restores its own render state. Decimated lodSeries points are streamed through
+     * a per-frame region of a mapped vertex buffer instead. Plots in secondary platform windows are not
+     * drawn, since their command buffers are owned by the ImGui backend or the viewportRenderer.
+     */
+    class plotRenderer {
+
+    public:
+        static constexpr uint32_t streamRegionVertices = 1 << 18;
+
+        /**
+         * @brief Creates the pipelines. renderPass only has to be compatible with the one used for drawing
+         * @param memory Allocator for the series and streaming buffers, has to outlive the renderer
+         * @param frameCount Maximum number of frames in flight, sizes the streaming buffer
+         */
+        void create(VkDevice device, deviceAllocator &memory, VkRenderPass renderPass,
+                    VkPipelineCache pipelineCache, const VkAllocationCallbacks *allocator, uint32_t frameCount);
+
+        void destroy();
+
+        /**
+         * @brief Resizes the streaming buffer for a new number of frames in flight. The GPU must be idle
+         */
+        void setFrameCount(uint32_t frameCount);
+
+        /**
+         * @brief Creates a series owned by the renderer, valid until destroy()
+         * @param capacity Number of most recent samples that are drawn
+         * @param headroom Extra ring space for samples appended while older frames are still in flight.
+         * 0 picks a quarter of the capacity
+         */
+        plotSeries *createSeries(size_t capacity, size_t headroom = 0);
+
+        /**
+         * @brief Plot widget: draws the series into a frame inside the current ImGui window.
+         * Dragging pans, the mouse wheel zooms the x axis around the cursor
+         * @return true if the view was changed by user interaction
+         */
+        bool plot(const char *label, const ImVec2 &size, plotView &view, plotSeries *const *series, size_t count);
+
+        /**
+         * @brief Plot widget for pyramid series: only about two points per pixel column are streamed to the GPU
+         */
+        bool plot(const char *label, const ImVec2 &size, plotView &view, const lodSeries *const *series,
+                  size_t count);
+
+        /**
+         * @brief Releases the draw records of the frame before the previous one, the previous frame may still be
+         * recording on the render thread. Called by the window before the update callback
+         */
+        void newFrame();
+
+        /**
+         * @brief Sets the command buffer the draw callbacks record into, until endRecording()
+         */
+        void beginRecording(VkCommandBuffer commandBuffer, const ImDrawData *drawData);
+
+        void endRecording();
+
+    private:
+        struct drawRecord {
+            plotRenderer *renderer;
+            VkBuffer buffer;
+            double originX;
+            ImU32 color;
+            plotStyle style;
+            ImVec2 rectMin, rectMax;
+            plotView view;
+            uint32_t firstVertex[2];
+            uint32_t vertexCount[2];
+        };
+
+        struct pushConstants {
+            float scale[2];
+            float offset[2];
+            float color[4];
+        };
+
+        bool beginPlot(const char *label, const ImVec2 &size, plotView &view);
+
+        void endPlot();
+
+        drawRecord &addRecord(VkBuffer buffer, double originX, ImU32 color, plotStyle style);
+
+        void createStreamBuffer(uint32_t regions);
+
+        void destroyStreamBuffer();
+
+        static void drawCallback(const ImDrawList *parentList, const ImDrawCmd *cmd);
+
+        void record(const drawRecord &rec, const ImVec4 &clipRect);
+
+        VkDevice m_device = VK_NULL_HANDLE;
+        deviceAllocator *m_memory = nullptr;
+        const VkAllocationCallbacks *m_allocator = nullptr;
+        VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+        VkPipeline m_linePipeline = VK_NULL_HANDLE;
+        VkPipeline m_pointPipeline = VK_NULL_HANDLE;
+        std::vector<std::unique_ptr<plotSeries>> m_series;
+
+        // A deque keeps the records at a stable address for ImDrawCmd::UserCallbackData. Two sets, so a
+        // render thread can still record the previous frame while the next one adds its plots
+        std::deque<drawRecord> m_records[2];
+        uint32_t m_recordSet = 0;
+
+        // Current plot widget
+        ImVec2 m_plotMin, m_plotMax;
+        plotView m_plotView;
+        bool m_plotVisible = false;
+
+        // Streamed vertices, one region per frame in flight plus the one being recorded
+        VkBuffer m_streamBuffer = VK_NULL_HANDLE;
+        deviceAllocation m_streamAllocation;
+        float *m_streamMapped = nullptr;
+        uint32_t m_streamRegions = 0;
+        uint32_t m_streamRegion = 0;
+        uint32_t m_streamUsed = 0;
+        std::vector<float> m_streamScratch;
+
+        // Recording state. The draw data is published last, draw callbacks of other draw data are skipped
+        std::atomic<const ImDrawData *> m_recordingData{nullptr};
+        VkCommandBuffer m_commandBuffer = VK_NULL_HANDLE;
+        ImVec2 m_displayPos, m_framebufferScale;
+        float m_framebufferWidth = 0.0f, m_framebufferHeight = 0.0f;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_PLOT_H
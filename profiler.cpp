@@ -0,0 +1,322 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+#include <utility>
+#include "imgui.h"
+#include "profiler.h"
+#include "vkutils.h"
+
+namespace engine {
+
+    const char *framePhaseName(framePhase phase) {
+        switch (phase) {
+            case framePhase::pollEvents:
+                return "pollEvents";
+            case framePhase::newFrame:
+                return "newFrame";
+            case framePhase::channels:
+                return "channels";
+            case framePhase::updateCallback:
+                return "updateCallback";
+            case framePhase::render:
+                return "render";
+            case framePhase::frameRender:
+                return "frameRender";
+            case framePhase::renderPlatformWindows:
+                return "renderPlatformWindows";
+            case framePhase::framePresent:
+                return "framePresent";
+            case framePhase::renderWait:
+                return "renderWait";
+            case framePhase::fenceWait:
+                return "fenceWait";
+            default:
+                return "unknown";
+        }
+    }
+
+    void frameProfiler::beginFrame(uint64_t frameNumber) {
+        if (!m_enabled) {
+            m_current = nullptr;
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_historyMutex);
+            m_current = &m_history[frameNumber % historySize];
+            *m_current = frameTiming{};
+            m_current->frameNumber = frameNumber;
+        }
+        m_frameStart = std::chrono::steady_clock::now();
+    }
+
+    void frameProfiler::endFrame() {
+        if (m_current == nullptr)
+            return;
+        auto now = std::chrono::steady_clock::now();
+        m_current->cpuTotal = std::chrono::duration<double, std::milli>(now - m_frameStart).count();
+        m_lastFrame = m_current->frameNumber;
+        m_current = nullptr;
+
+        if (m_dumpInterval > 0.0 &&
+            std::chrono::duration<double>(now - m_lastDump).count() >= m_dumpInterval) {
+            m_lastDump = now;
+            if (!dump(m_dumpPath, m_dumpFormat))
+                fprintf(stderr, "Failed to write profiler dump to %s\n", m_dumpPath.c_str());
+        }
+    }
+
+    void frameProfiler::addPhaseTime(uint64_t frameNumber, framePhase phase, double milliseconds) {
+        if (!m_enabled)
+            return;
+        std::lock_guard<std::mutex> lock(m_historyMutex);
+        frameTiming &entry = m_history[frameNumber % historySize];
+        if (entry.frameNumber == frameNumber)
+            entry.cpu[(size_t) phase] += milliseconds;
+    }
+
+    void frameProfiler::createGpuQueries(VkPhysicalDevice physicalDevice, VkDevice device, uint32_t queueFamily,
+                                         const VkAllocationCallbacks *allocator) {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+        uint32_t count;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &count, nullptr);
+        std::vector<VkQueueFamilyProperties> queues(count);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &count, queues.data());
+        uint32_t valid_bits = queues[queueFamily].timestampValidBits;
+        if (valid_bits == 0) {
+            // Timestamps not supported on this queue, only CPU timings are available
+            return;
+        }
+
+        m_device = device;
+        m_allocator = allocator;
+        m_timestampPeriod = properties.limits.timestampPeriod;
+        m_timestampMask = valid_bits >= 64 ? ~0ull : (1ull << valid_bits) - 1;
+
+        VkQueryPoolCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        info.queryCount = maxGpuSlots * 2;
+        VkResult err = vkCreateQueryPool(m_device, &info, m_allocator, &m_queryPool);
+        check_vk_result(err);
+    }
+
+    void frameProfiler::destroyGpuQueries() {
+        if (m_queryPool == VK_NULL_HANDLE)
+            return;
+        vkDestroyQueryPool(m_device, m_queryPool, m_allocator);
+        m_queryPool = VK_NULL_HANDLE;
+        m_slotPending.fill(false);
+    }
+
+    void frameProfiler::writeGpuBegin(VkCommandBuffer commandBuffer, uint32_t slot, uint64_t frameNumber) {
+        if (!m_enabled || m_queryPool == VK_NULL_HANDLE || slot >= maxGpuSlots)
+            return;
+        vkCmdResetQueryPool(commandBuffer, m_queryPool, slot * 2, 2);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_queryPool, slot * 2);
+        m_slotFrame[slot] = frameNumber;
+        m_slotPending[slot] = true;
+    }
+
+    void frameProfiler::writeGpuEnd(VkCommandBuffer commandBuffer, uint32_t slot) {
+        // Paired with writeGpuBegin even if profiling got disabled in between
+        if (slot >= maxGpuSlots || !m_slotPending[slot])
+            return;
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, slot * 2 + 1);
+    }
+
+    void frameProfiler::collectGpu(uint32_t slot) {
+        if (slot >= maxGpuSlots || !m_slotPending[slot])
+            return;
+        m_slotPending[slot] = false;
+
+        uint64_t timestamps[2] = {};
+        VkResult err = vkGetQueryPoolResults(m_device, m_queryPool, slot * 2, 2, sizeof(timestamps), timestamps,
+                                             sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+        if (err != VK_SUCCESS)
+            return;
+
+        // The frame may already have been overwritten in the ring if the history is shorter than the latency
+        std::lock_guard<std::mutex> lock(m_historyMutex);
+        frameTiming &entry = m_history[m_slotFrame[slot] % historySize];
+        if (entry.frameNumber == m_slotFrame[slot])
+            entry.gpu = (double) ((timestamps[1] - timestamps[0]) & m_timestampMask) * m_timestampPeriod / 1e6;
+    }
+
+    const frameTiming *frameProfiler::latest() const {
+        if (m_lastFrame == UINT64_MAX)
+            return nullptr;
+        return &m_history[m_lastFrame % historySize];
+    }
+
+    void frameProfiler::history(std::vector<frameTiming> &out) const {
+        out.clear();
+        if (m_lastFrame == UINT64_MAX)
+            return;
+        std::lock_guard<std::mutex> lock(m_historyMutex);
+        uint64_t first = m_lastFrame >= historySize ? m_lastFrame - historySize + 1 : 0;
+        for (uint64_t frame = first; frame <= m_lastFrame; frame++) {
+            const frameTiming &entry = m_history[frame % historySize];
+            if (entry.frameNumber == frame)
+                out.push_back(entry);
+        }
+    }
+
+    timingStats computeTimingStats(std::vector<double> values) {
+        timingStats stats;
+        stats.samples = values.size();
+        if (values.empty())
+            return stats;
+        std::sort(values.begin(), values.end());
+        double sum = 0.0;
+        for (double v: values)
+            sum += v;
+        auto percentile = [&](double p) {
+            return values[std::min(values.size() - 1, (size_t) (p * (double) (values.size() - 1) + 0.5))];
+        };
+        stats.mean = sum / (double) values.size();
+        stats.p50 = percentile(0.50);
+        stats.p90 = percentile(0.90);
+        stats.p99 = percentile(0.99);
+        stats.max = values.back();
+        return stats;
+    }
+
+    template<typename Getter>
+    timingStats frameProfiler::computeStats(Getter getter) const {
+        std::vector<double> values;
+        values.reserve(historySize);
+        std::lock_guard<std::mutex> lock(m_historyMutex);
+        for (const frameTiming &entry: m_history) {
+            if (entry.frameNumber == UINT64_MAX || entry.frameNumber > m_lastFrame)
+                continue;
+            double v = getter(entry);
+            if (v >= 0.0)
+                values.push_back(v);
+        }
+        return computeTimingStats(std::move(values));
+    }
+
+    timingStats frameProfiler::phaseStats(framePhase phase) const {
+        return computeStats([phase](const frameTiming &t) { return t.cpu[(size_t) phase]; });
+    }
+
+    timingStats frameProfiler::totalStats() const {
+        return computeStats([](const frameTiming &t) { return t.cpuTotal; });
+    }
+
+    timingStats frameProfiler::gpuStats() const {
+        return computeStats([](const frameTiming &t) { return t.gpu; });
+    }
+
+    void frameProfiler::drawOverlay(bool *open) const {
+        ImGui::SetNextWindowSize(ImVec2(460, 320), ImGuiCond_FirstUseEver);
+        if (!ImGui::Begin("Frame profiler", open)) {
+            ImGui::End();
+            return;
+        }
+        if (!m_enabled)
+            ImGui::TextDisabled("Profiling is disabled");
+
+        if (ImGui::BeginTable("phases", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+            ImGui::TableSetupColumn("Phase (ms)");
+            ImGui::TableSetupColumn("mean");
+            ImGui::TableSetupColumn("p50");
+            ImGui::TableSetupColumn("p90");
+            ImGui::TableSetupColumn("p99");
+            ImGui::TableSetupColumn("max");
+            ImGui::TableHeadersRow();
+            auto row = [](const char *name, const timingStats &s) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(name);
+                for (double v: {s.mean, s.p50, s.p90, s.p99, s.max}) {
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", v);
+                }
+            };
+            for (size_t i = 0; i < framePhaseCount; i++)
+                row(framePhaseName((framePhase) i), phaseStats((framePhase) i));
+            row("cpu total", totalStats());
+            row("gpu render pass", gpuStats());
+            ImGui::EndTable();
+        }
+
+        if (!m_startupSteps.empty() && ImGui::CollapsingHeader("Startup")) {
+            for (const auto &step: m_startupSteps)
+                ImGui::Text("%-22s %8.2f ms%s", step.name, step.milliseconds, step.background ? "  (background)" : "");
+            ImGui::Text("%-22s %8.2f ms", "total", m_startupTotal);
+        }
+
+        std::vector<frameTiming> frames;
+        history(frames);
+        std::vector<float> totals(frames.size());
+        for (size_t i = 0; i < frames.size(); i++)
+            totals[i] = (float) frames[i].cpuTotal;
+        if (!totals.empty())
+            ImGui::PlotLines("cpu total", totals.data(), (int) totals.size(), 0, nullptr, 0.0f, FLT_MAX,
+                             ImVec2(0, 80));
+        ImGui::End();
+    }
+
+    void frameProfiler::printStartup(FILE *file) const {
+        fprintf(file, "Startup: %.2f ms\n", m_startupTotal);
+        for (const auto &step: m_startupSteps)
+            fprintf(file, "  %-22s %8.2f ms%s\n", step.name, step.milliseconds, step.background ? "  (background)" : "");
+    }
+
+    void frameProfiler::setDump(const std::string &path, double intervalSeconds, dumpFormat format) {
+        m_dumpPath = path;
+        m_dumpInterval = intervalSeconds;
+        m_dumpFormat = format;
+        m_lastDump = std::chrono::steady_clock::now();
+    }
+
+    bool frameProfiler::dump(const std::string &path, dumpFormat format) const {
+        FILE *file = fopen(path.c_str(), "w");
+        if (file == nullptr)
+            return false;
+
+        std::vector<frameTiming> frames;
+        history(frames);
+        if (format == dumpFormat::csv) {
+            fprintf(file, "frame");
+            for (size_t i = 0; i < framePhaseCount; i++)
+                fprintf(file, ",%s", framePhaseName((framePhase) i));
+            fprintf(file, ",cpuTotal,gpu\n");
+            for (const frameTiming &t: frames) {
+                fprintf(file, "%llu", (unsigned long long) t.frameNumber);
+                for (double v: t.cpu)
+                    fprintf(file, ",%.6f", v);
+                fprintf(file, ",%.6f,%.6f\n", t.cpuTotal, t.gpu);
+            }
+        } else {
+            auto stats = [file](const char *name, const timingStats &s, bool last) {
+                fprintf(file, "    \"%s\": {\"mean\": %.6f, \"p50\": %.6f, \"p90\": %.6f, \"p99\": %.6f, "
+                              "\"max\": %.6f, \"samples\": %zu}%s\n", name, s.mean, s.p50, s.p90, s.p99, s.max,
+                        s.samples, last ? "" : ",");
+            };
+            fprintf(file, "{\n  \"stats\": {\n");
+            for (size_t i = 0; i < framePhaseCount; i++)
+                stats(framePhaseName((framePhase) i), phaseStats((framePhase) i), false);
+            stats("cpuTotal", totalStats(), false);
+            stats("gpu", gpuStats(), true);
+            fprintf(file, "  },\n  \"frames\": [\n");
+            for (size_t f = 0; f < frames.size(); f++) {
+                const frameTiming &t = frames[f];
+                fprintf(file, "    {\"frame\": %llu", (unsigned long long) t.frameNumber);
+                for (size_t i = 0; i < framePhaseCount; i++)
+                    fprintf(file, ", \"%s\": %.6f", framePhaseName((framePhase) i), t.cpu[i]);
+                fprintf(file, ", \"cpuTotal\": %.6f, \"gpu\": %.6f}%s\n", t.cpuTotal, t.gpu,
+                        f + 1 == frames.size() ? "" : ",");
+            }
+            fprintf(file, "  ]\n}\n");
+        }
+        return fclose(file) == 0;
+    }
+
+} // engine
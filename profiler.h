@@ -0,0 +1,232 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_PROFILER_H
+#define EASYGRAPHICSLIB_PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "vulkan/vulkan.h"
+
+namespace engine {
+
+    /**
+     * @brief The phases of window::updateFrame() that get their own CPU timer
+     */
+    enum class framePhase : uint8_t {
+        pollEvents,
+        newFrame,
+        channels,
+        updateCallback,
+        render,
+        frameRender,
+        renderPlatformWindows,
+        framePresent,
+        renderWait,     // Main thread waiting for the render thread to finish the previous frame
+        fenceWait,      // Waiting for the frame in flight whose context is reused, part of frameRender
+        count
+    };
+
+    constexpr size_t framePhaseCount = (size_t) framePhase::count;
+
+    const char *framePhaseName(framePhase phase);
+
+    /**
+     * @brief Timings of one frame, all values in milliseconds. gpu is negative until the GPU result arrived
+     */
+    struct frameTiming {
+        uint64_t frameNumber = UINT64_MAX;
+        std::array<double, framePhaseCount> cpu{};
+        double cpuTotal = 0.0;
+        double gpu = -1.0;
+    };
+
+    struct timingStats {
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p90 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+        size_t samples = 0;
+    };
+
+    /**
+     * @brief Mean, percentiles and maximum of a set of samples
+     */
+    timingStats computeTimingStats(std::vector<double> values);
+
+    /**
+     * @brief Duration of one window::create() step. Background steps ran on a worker thread and overlap the others
+     */
+    struct startupStep {
+        const char *name;
+        double milliseconds;
+        bool background;
+    };
+
+    enum class dumpFormat {
+        csv,
+        json
+    };
+
+    /**
+     * @brief Collects per-phase CPU timings and render pass GPU timestamps into a fixed size ring history.
+     *
+     * While disabled every entry point returns after a single branch, so the instrumentation can stay
+     * compiled into release builds. The GPU entry points may be called from a render thread, everything
+     * else belongs to the thread that drives the window.
+     */
+    class frameProfiler {
+
+    public:
+        static constexpr size_t historySize = 512;
+        static constexpr uint32_t maxGpuSlots = 16;
+
+        void setEnabled(bool enabled) { m_enabled = enabled; }
+
+        [[nodiscard]] bool enabled() const { return m_enabled; }
+
+        void beginFrame(uint64_t frameNumber);
+
+        void endFrame();
+
+        void addPhaseTime(framePhase phase, double milliseconds) {
+            if (m_current != nullptr)
+                m_current->cpu[(size_t) phase] += milliseconds;
+        }
+
+        /**
+         * @brief Adds to a frame that may already have ended, e.g. the render thread's share of it
+         */
+        void addPhaseTime(uint64_t frameNumber, framePhase phase, double milliseconds);
+
+        // GPU timestamps, one begin/end pair per frame slot
+        void createGpuQueries(VkPhysicalDevice physicalDevice, VkDevice device, uint32_t queueFamily,
+                              const VkAllocationCallbacks *allocator);
+
+        void destroyGpuQueries();
+
+        /**
+         * @brief Resets the slot's queries and writes the begin timestamp. Must be recorded outside a render pass
+         * @param frameNumber Frame the GPU time is added to once collected
+         */
+        void writeGpuBegin(VkCommandBuffer commandBuffer, uint32_t slot, uint64_t frameNumber);
+
+        void writeGpuEnd(VkCommandBuffer commandBuffer, uint32_t slot);
+
+        /**
+         * @brief Reads back the slot's timestamps. Call after the slot's fence has been waited on
+         */
+        void collectGpu(uint32_t slot);
+
+        // Queries
+        [[nodiscard]] const frameTiming *latest() const;
+
+        /**
+         * @brief Copies the recorded frames, oldest first
+         */
+        void history(std::vector<frameTiming> &out) const;
+
+        [[nodiscard]] timingStats phaseStats(framePhase phase) const;
+
+        [[nodiscard]] timingStats totalStats() const;
+
+        [[nodiscard]] timingStats gpuStats() const;
+
+        // Startup, recorded once by window::create() independent of enabled()
+        void addStartupStep(const char *name, double milliseconds, bool background = false) {
+            m_startupSteps.push_back({name, milliseconds, background});
+        }
+
+        void setStartupTotal(double milliseconds) { m_startupTotal = milliseconds; }
+
+        [[nodiscard]] const std::vector<startupStep> &startupSteps() const { return m_startupSteps; }
+
+        [[nodiscard]] double startupTotal() const { return m_startupTotal; }
+
+        /**
+         * @brief Prints the startup steps and the wall clock total
+         */
+        void printStartup(FILE *file) const;
+
+        /**
+         * @brief Draws an ImGui window with percentiles per phase and a frame time graph
+         */
+        void drawOverlay(bool *open = nullptr) const;
+
+        /**
+         * @brief Periodically writes the history to a file, an interval <= 0 disables dumping
+         */
+        void setDump(const std::string &path, double intervalSeconds, dumpFormat format = dumpFormat::csv);
+
+        bool dump(const std::string &path, dumpFormat format) const;
+
+    private:
+        template<typename Getter>
+        timingStats computeStats(Getter getter) const;
+
+        std::atomic<bool> m_enabled{false};
+        mutable std::mutex m_historyMutex;     // Guards entries against collectGpu() on a render thread
+        std::array<frameTiming, historySize> m_history{};
+        frameTiming *m_current = nullptr;
+        uint64_t m_lastFrame = UINT64_MAX;
+        std::chrono::steady_clock::time_point m_frameStart;
+
+        // GPU
+        VkDevice m_device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks *m_allocator = nullptr;
+        VkQueryPool m_queryPool = VK_NULL_HANDLE;
+        double m_timestampPeriod = 1.0;
+        uint64_t m_timestampMask = ~0ull;
+        std::array<uint64_t, maxGpuSlots> m_slotFrame{};
+        std::array<bool, maxGpuSlots> m_slotPending{};
+
+        // Startup
+        std::vector<startupStep> m_startupSteps;
+        double m_startupTotal = 0.0;
+
+        // Dump
+        std::string m_dumpPath;
+        double m_dumpInterval = 0.0;
+        dumpFormat m_dumpFormat = dumpFormat::csv;
+        std::chrono::steady_clock::time_point m_lastDump;
+    };
+
+    /**
+     * @brief Adds the lifetime of the object to a phase of the current frame
+     */
+    class scopedPhaseTimer {
+
+    public:
+        scopedPhaseTimer(frameProfiler &profiler, framePhase phase) :
+                m_profiler(profiler.enabled() ? &profiler : nullptr), m_phase(phase) {
+            if (m_profiler != nullptr)
+                m_start = std::chrono::steady_clock::now();
+        }
+
+        ~scopedPhaseTimer() {
+            if (m_profiler != nullptr)
+                m_profiler->addPhaseTime(m_phase, std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - m_start).count());
+        }
+
+        scopedPhaseTimer(const scopedPhaseTimer &) = delete;
+
+        scopedPhaseTimer &operator=(const scopedPhaseTimer &) = delete;
+
+    private:
+        frameProfiler *m_profiler;
+        framePhase m_phase;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_PROFILER_H
@@ -0,0 +1,633 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "remote.h"
+
+namespace engine {
+
+    using namespace remote_protocol;
+
+    static const size_t header_size = sizeof(messageHeader);
+
+    static inline size_t message_size(size_t payload) {
+        return header_size + align(payload);
+    }
+
+    static bool socket_address(const std::string &path, sockaddr_un &address) {
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+            fprintf(stderr, "[remote] Invalid socket path '%s'\n", path.c_str());
+            return false;
+        }
+        memcpy(address.sun_path, path.c_str(), path.size());
+        return true;
+    }
+
+    static void set_non_blocking(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+
+    /**
+     * @brief Reads everything available without blocking
+     * @return false if the other side closed the connection
+     */
+    static bool receive_available(int fd, std::vector<uint8_t> &buffer) {
+        uint8_t chunk[64 * 1024];
+        while (true) {
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n > 0) {
+                buffer.insert(buffer.end(), chunk, chunk + n);
+                continue;
+            }
+            if (n == 0)
+                return false;
+            if (errno == EINTR)
+                continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+    }
+
+    bool remoteSharedRing::create(const std::string &name, size_t ringSize) {
+        close();
+        ringSize = align(ringSize);
+        shm_unlink(name.c_str());
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            fprintf(stderr, "[remote] Could not create shared memory '%s': %s\n", name.c_str(), strerror(errno));
+            return false;
+        }
+        size_t size = ringOffset + ringSize;
+        void *mapping = MAP_FAILED;
+        if (ftruncate(fd, (off_t) size) == 0)
+            mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            fprintf(stderr, "[remote] Could not map shared memory '%s': %s\n", name.c_str(), strerror(errno));
+            shm_unlink(name.c_str());
+            return false;
+        }
+
+        // The segment starts zeroed, which is a valid state for every atomic in the header
+        m_name = name;
+        m_owner = true;
+        m_mapping = mapping;
+        m_mappingSize = size;
+        m_header = (sharedHeader *) mapping;
+        m_ring = (uint8_t *) mapping + ringOffset;
+        m_ringSize = ringSize;
+        m_header->ringSize = ringSize;
+        m_header->vertexSize = sizeof(ImDrawVert);
+        m_header->indexSize = sizeof(ImDrawIdx);
+        m_header->version = version;
+        std::atomic_thread_fence(std::memory_order_release);
+        m_header->magic = magic;
+        return true;
+    }
+
+    bool remoteSharedRing::open(const std::string &name) {
+        close();
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0)
+            return false;
+        struct stat info = {};
+        void *mapping = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && (size_t) info.st_size > ringOffset)
+            mapping = mmap(nullptr, (size_t) info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+            return false;
+
+        auto *header = (sharedHeader *) mapping;
+        if (header->magic != magic || header->version != version || header->vertexSize != sizeof(ImDrawVert) ||
+            header->indexSize != sizeof(ImDrawIdx) || ringOffset + header->ringSize > (size_t) info.st_size) {
+            fprintf(stderr, "[remote] Shared memory '%s' was created by an incompatible producer\n", name.c_str());
+            munmap(mapping, (size_t) info.st_size);
+            return false;
+        }
+        m_name = name;
+        m_owner = false;
+        m_mapping = mapping;
+        m_mappingSize = (size_t) info.st_size;
+        m_header = header;
+        m_ring = (uint8_t *) mapping + ringOffset;
+        m_ringSize = header->ringSize;
+        return true;
+    }
+
+    void remoteSharedRing::close() {
+        if (m_mapping != nullptr)
+            munmap(m_mapping, m_mappingSize);
+        if (m_owner)
+            shm_unlink(m_name.c_str());
+        m_mapping = nullptr;
+        m_mappingSize = 0;
+        m_header = nullptr;
+        m_ring = nullptr;
+        m_ringSize = 0;
+        m_owner = false;
+    }
+
+    remoteProducer::remoteProducer(int width, int height) : m_width(width), m_height(height) {}
+
+    int remoteProducer::create(const remoteSettings &settings) {
+        m_settings = settings;
+
+        if (m_settings.transport == remoteTransport::sharedMemory) {
+            if (!m_ring.create(m_settings.path, m_settings.ringSize))
+                return 1;
+        } else {
+            sockaddr_un address = {};
+            if (!socket_address(m_settings.path, address))
+                return 1;
+            m_listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+            unlink(m_settings.path.c_str());
+            if (m_listenSocket < 0 || bind(m_listenSocket, (sockaddr *) &address, sizeof(address)) != 0 ||
+                listen(m_listenSocket, 1) != 0) {
+                fprintf(stderr, "[remote] Could not listen on '%s': %s\n", m_settings.path.c_str(), strerror(errno));
+                cleanup();
+                return 1;
+            }
+            set_non_blocking(m_listenSocket);
+        }
+
+        IMGUI_CHECKVERSION();
+        m_imguiContext = ImGui::CreateContext();
+        ImGui::SetCurrentContext(m_imguiContext);
+        ImGuiIO &io = ImGui::GetIO();
+        io.BackendRendererName = "easygraphicslib_remote";
+        io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;   // The viewer draws with vertex offsets
+        io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+        io.DisplaySize = ImVec2((float) m_width, (float) m_height);
+        ImGui::StyleColorsDark();
+
+        // The font atlas goes to the viewer like any other texture
+        unsigned char *pixels;
+        int width, height;
+        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+        texture &font = m_textures[fontTexture];
+        font.width = (uint32_t) width;
+        font.height = (uint32_t) height;
+        font.rgba.assign(pixels, pixels + (size_t) width * height * 4);
+        io.Fonts->SetTexID((ImTextureID) fontTexture);
+        return 0;
+    }
+
+    void remoteProducer::cleanup() {
+        disconnect();
+        if (m_listenSocket >= 0) {
+            close(m_listenSocket);
+            m_listenSocket = -1;
+            unlink(m_settings.path.c_str());
+        }
+        m_ring.close();
+        if (m_imguiContext != nullptr) {
+            ImGui::DestroyContext(m_imguiContext);
+            m_imguiContext = nullptr;
+        }
+        m_textures.clear();
+    }
+
+    void remoteProducer::registerOnUpdateCallback(const std::function<void()> &cb) {
+        m_onUpdateCallback = cb;
+    }
+
+    void remoteProducer::setTexture(ImTextureID id, const uint8_t *rgba, uint32_t width, uint32_t height) {
+        IM_ASSERT((uint64_t) id > fontTexture);
+        texture &tex = m_textures[(uint64_t) id];
+        tex.width = width;
+        tex.height = height;
+        tex.rgba.assign(rgba, rgba + (size_t) width * height * 4);
+        tex.dirty = true;
+    }
+
+    bool remoteProducer::viewerAttached() const {
+        if (m_settings.transport == remoteTransport::sharedMemory)
+            return m_ring.valid() && m_ring.header().viewerAttached.load(std::memory_order_acquire) != 0;
+        return m_socket >= 0;
+    }
+
+    void remoteProducer::disconnect() {
+        if (m_socket >= 0) {
+            close(m_socket);
+            m_socket = -1;
+        }
+        m_outgoing.clear();
+        m_outgoingSent = 0;
+        m_incoming.clear();
+    }
+
+    void remoteProducer::acceptViewer() {
+        bool attached = false;
+        if (m_settings.transport == remoteTransport::sharedMemory) {
+            uint32_t generation = m_ring.header().viewerGeneration.load(std::memory_order_acquire);
+            attached = generation != m_viewerGeneration;
+            m_viewerGeneration = generation;
+        } else if (m_listenSocket >= 0) {
+            // The newest viewer wins, an old connection that was not closed cleanly would block it otherwise
+            int fd = accept(m_listenSocket, nullptr, nullptr);
+            if (fd >= 0) {
+                disconnect();
+                set_non_blocking(fd);
+                m_socket = fd;
+                attached = true;
+                helloMessage hello = {magic, version, sizeof(ImDrawVert), sizeof(ImDrawIdx)};
+                uint8_t *dst = beginMessage(remote_protocol::hello, sizeof(hello));
+                memcpy(dst, &hello, sizeof(hello));
+                endMessage();
+            }
+        }
+        if (!attached)
+            return;
+
+        // A new viewer has none of the textures and none of the draw lists
+        m_stats.connections++;
+        for (auto &[id, tex]: m_textures)
+            tex.dirty = true;
+        m_encoder.reset();
+        applyInput(remoteInput());
+    }
+
+    void remoteProducer::readInput() {
+        if (m_settings.transport == remoteTransport::sharedMemory) {
+            sharedHeader &header = m_ring.header();
+            remoteInput input;
+            input.displayWidth = header.displayWidth.load(std::memory_order_relaxed);
+            input.displayHeight = header.displayHeight.load(std::memory_order_relaxed);
+            input.mouseX = header.mouseX.load(std::memory_order_relaxed);
+            input.mouseY = header.mouseY.load(std::memory_order_relaxed);
+            input.mouseButtons = header.mouseButtons.load(std::memory_order_relaxed);
+            input.wheelX = header.wheelX.load(std::memory_order_relaxed);
+            input.wheelY = header.wheelY.load(std::memory_order_relaxed);
+            input.focused = header.focused.load(std::memory_order_relaxed);
+            applyInput(input);
+            return;
+        }
+
+        if (m_socket < 0)
+            return;
+        if (!receive_available(m_socket, m_incoming)) {
+            disconnect();
+            return;
+        }
+        size_t pos = 0;
+        while (m_incoming.size() - pos >= header_size) {
+            messageHeader header;
+            memcpy(&header, m_incoming.data() + pos, header_size);
+            if (m_incoming.size() - pos < message_size(header.size))
+                break;
+            if (header.type == remote_protocol::input && header.size >= sizeof(remoteInput)) {
+                remoteInput input;
+                memcpy(&input, m_incoming.data() + pos + header_size, sizeof(input));
+                applyInput(input);
+            }
+            pos += message_size(header.size);
+        }
+        m_incoming.erase(m_incoming.begin(), m_incoming.begin() + (ptrdiff_t) pos);
+    }
+
+    void remoteProducer::applyInput(const remoteInput &input) {
+        if (m_imguiContext == nullptr)
+            return;
+        ImGuiContext *previous = ImGui::GetCurrentContext();
+        ImGui::SetCurrentContext(m_imguiContext);
+        ImGuiIO &io = ImGui::GetIO();
+        if (input.displayWidth > 0.0f && input.displayHeight > 0.0f)
+            io.DisplaySize = ImVec2(input.displayWidth, input.displayHeight);
+        if (input.mouseX != m_input.mouseX || input.mouseY != m_input.mouseY)
+            io.AddMousePosEvent(input.mouseX, input.mouseY);
+        for (int button = 0; button < ImGuiMouseButton_COUNT; button++) {
+            bool down = (input.mouseButtons >> button) & 1;
+            if (down != (bool) ((m_input.mouseButtons >> button) & 1))
+                io.AddMouseButtonEvent(button, down);
+        }
+        // The wheel is a running total, so a lost message does not lose the scrolling
+        if (input.wheelX != m_input.wheelX || input.wheelY != m_input.wheelY)
+            io.AddMouseWheelEvent(input.wheelX - m_input.wheelX, input.wheelY - m_input.wheelY);
+        if (input.focused != m_input.focused)
+            io.AddFocusEvent(input.focused != 0);
+        m_input = input;
+        ImGui::SetCurrentContext(previous);
+    }
+
+    bool remoteProducer::flushSocket() {
+        while (m_outgoingSent < m_outgoing.size()) {
+            ssize_t n = send(m_socket, m_outgoing.data() + m_outgoingSent, m_outgoing.size() - m_outgoingSent,
+                             MSG_NOSIGNAL);
+            if (n > 0) {
+                m_outgoingSent += (size_t) n;
+                continue;
+            }
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                return false;
+            disconnect();
+            return false;
+        }
+        m_outgoing.clear();
+        m_outgoingSent = 0;
+        return true;
+    }
+
+    uint8_t *remoteProducer::beginMessage(uint32_t type, size_t size) {
+        messageHeader header = {type, (uint32_t) size};
+        size_t total = message_size(size);
+
+        if (m_settings.transport == remoteTransport::socket) {
+            size_t offset = m_outgoing.size();
+            m_outgoing.resize(offset + total);
+            memcpy(m_outgoing.data() + offset, &header, header_size);
+            m_stats.bytesSent += total;
+            return m_outgoing.data() + offset + header_size;
+        }
+
+        // Messages are never split, one that does not fit before the end of the ring starts over at the front
+        sharedHeader &shared = m_ring.header();
+        uint64_t capacity = m_ring.ringSize();
+        uint64_t head = shared.head.load(std::memory_order_relaxed);
+        uint64_t tail = shared.tail.load(std::memory_order_acquire);
+        uint64_t offset = head % capacity;
+        uint64_t skip = capacity - offset < total ? capacity - offset : 0;
+        if (total > capacity || head + skip + total - tail > capacity)
+            return nullptr;
+        if (skip > 0) {
+            messageHeader wrap_header = {wrap, (uint32_t) (skip - header_size)};
+            memcpy(m_ring.ring() + offset, &wrap_header, header_size);
+            head += skip;
+            offset = 0;
+        }
+        memcpy(m_ring.ring() + offset, &header, header_size);
+        m_messageEnd = head + total;
+        m_stats.bytesSent += total;
+        return m_ring.ring() + offset + header_size;
+    }
+
+    void remoteProducer::endMessage() {
+        if (m_settings.transport == remoteTransport::sharedMemory)
+            m_ring.header().head.store(m_messageEnd, std::memory_order_release);
+    }
+
+    void remoteProducer::updateFrame() {
+        if (m_imguiContext == nullptr)
+            return;
+        acceptViewer();
+        readInput();
+        if (!viewerAttached()) {
+            // Nobody would see the frame, so it is not even built
+            m_lastTime = 0.0;
+            return;
+        }
+
+        if (m_settings.transport == remoteTransport::socket && !flushSocket()) {
+            // The viewer has not read the previous frames yet, building another one would only queue up latency
+            if (m_socket >= 0)
+                m_stats.framesDropped++;
+            return;
+        }
+
+        // Textures go first, the frame that uses them may only arrive afterwards
+        for (auto &[id, tex]: m_textures) {
+            if (!tex.dirty)
+                continue;
+            textureHeader header = {id, tex.width, tex.height};
+            uint8_t *dst = beginMessage(remote_protocol::texture, sizeof(header) + tex.rgba.size());
+            if (dst == nullptr)
+                break;
+            memcpy(dst, &header, sizeof(header));
+            memcpy(dst + sizeof(header), tex.rgba.data(), tex.rgba.size());
+            endMessage();
+            tex.dirty = false;
+            m_stats.texturesSent++;
+        }
+
+        ImGui::SetCurrentContext(m_imguiContext);
+        ImGuiIO &io = ImGui::GetIO();
+        double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        io.DeltaTime = m_lastTime > 0.0 && now > m_lastTime ? (float) (now - m_lastTime) : 1.0f / 60.0f;
+        m_lastTime = now;
+
+        ImGui::NewFrame();
+        if (m_onUpdateCallback != nullptr)
+            m_onUpdateCallback();
+        ImGui::Render();
+        const ImDrawData *drawData = ImGui::GetDrawData();
+
+        // Only over a socket, the viewer points its lists into the ring and cannot keep them
+        size_t size = m_encoder.measure(drawData, m_settings.transport == remoteTransport::socket);
+        uint8_t *dst = beginMessage(remote_protocol::frame, size);
+        if (dst == nullptr) {
+            m_stats.framesDropped++;
+            return;
+        }
+        m_encoder.write(drawData, m_frameCount, dst);
+        endMessage();
+        m_encoder.commit();
+        m_stats.framesSent++;
+        m_stats.listsSent = m_encoder.listsWritten();
+        m_stats.listsReused = m_encoder.listsReused();
+        m_frameCount++;
+        if (m_settings.transport == remoteTransport::socket)
+            flushSocket();
+    }
+
+    bool remoteReceiver::open(const remoteSettings &settings) {
+        close();
+        m_settings = settings;
+
+        if (m_settings.transport == remoteTransport::sharedMemory) {
+            if (!m_ring.open(m_settings.path))
+                return false;
+            // Whatever is in the ring was meant for a previous viewer
+            sharedHeader &header = m_ring.header();
+            m_readPos = header.head.load(std::memory_order_acquire);
+            m_framePos = m_readPos;
+            header.tail.store(m_readPos, std::memory_order_release);
+            header.viewerGeneration.fetch_add(1, std::memory_order_acq_rel);
+            header.viewerAttached.store(1, std::memory_order_release);
+            return true;
+        }
+
+        sockaddr_un address = {};
+        if (!socket_address(m_settings.path, address))
+            return false;
+        m_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (m_socket < 0 || connect(m_socket, (sockaddr *) &address, sizeof(address)) != 0) {
+            close();
+            return false;
+        }
+        set_non_blocking(m_socket);
+        return true;
+    }
+
+    void remoteReceiver::close() {
+        m_decoder.releaseAliases();
+        if (m_ring.valid())
+            m_ring.header().viewerAttached.store(0, std::memory_order_release);
+        m_ring.close();
+        if (m_socket >= 0) {
+            ::close(m_socket);
+            m_socket = -1;
+        }
+        m_incoming.clear();
+        m_incomingRead = 0;
+        m_helloReceived = false;
+        m_decoder.clear();
+        m_decoder.clearTextures();
+    }
+
+    bool remoteReceiver::connected() const {
+        return m_ring.valid() || m_socket >= 0;
+    }
+
+    void remoteReceiver::sendInput(const remoteInput &input) {
+        if (m_ring.valid()) {
+            sharedHeader &header = m_ring.header();
+            header.displayWidth.store(input.displayWidth, std::memory_order_relaxed);
+            header.displayHeight.store(input.displayHeight, std::memory_order_relaxed);
+            header.mouseX.store(input.mouseX, std::memory_order_relaxed);
+            header.mouseY.store(input.mouseY, std::memory_order_relaxed);
+            header.mouseButtons.store(input.mouseButtons, std::memory_order_relaxed);
+            header.wheelX.store(input.wheelX, std::memory_order_relaxed);
+            header.wheelY.store(input.wheelY, std::memory_order_relaxed);
+            header.focused.store(input.focused, std::memory_order_relaxed);
+            return;
+        }
+        if (m_socket < 0)
+            return;
+        // Small enough to never be split in practice, a message that does not go out is replaced by the next one
+        uint8_t message[header_size + align(sizeof(remoteInput))] = {};
+        messageHeader header = {remote_protocol::input, sizeof(remoteInput)};
+        memcpy(message, &header, header_size);
+        memcpy(message + header_size, &input, sizeof(input));
+        ssize_t n = send(m_socket, message, sizeof(message), MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n >= 0 && n < (ssize_t) sizeof(message)) {
+            // A partial message would corrupt the stream
+            close();
+        } else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            close();
+        }
+    }
+
+    bool remoteReceiver::poll() {
+        bool newFrame = false;
+
+        if (m_ring.valid()) {
+            // Only the newest frame is decoded, everything before it is released right away
+            sharedHeader &header = m_ring.header();
+            const uint64_t capacity = m_ring.ringSize();
+            const uint64_t head = header.head.load(std::memory_order_acquire);
+            uint64_t framePos = 0;
+            const uint8_t *framePayload = nullptr;
+            size_t frameSize = 0;
+            while (m_readPos < head) {
+                uint64_t offset = m_readPos % capacity;
+                messageHeader message;
+                if (capacity - offset < header_size) {
+                    fprintf(stderr, "[remote] Malformed message in shared memory '%s'\n", m_settings.path.c_str());
+                    close();
+                    return false;
+                }
+                memcpy(&message, m_ring.ring() + offset, header_size);
+                if (message.type == wrap) {
+                    m_readPos += capacity - offset;
+                    continue;
+                }
+                // Messages never wrap, a size past the ring end or the head comes from a broken producer
+                if (message_size(message.size) > capacity - offset || message_size(message.size) > head - m_readPos) {
+                    fprintf(stderr, "[remote] Malformed message in shared memory '%s'\n", m_settings.path.c_str());
+                    close();
+                    return false;
+                }
+                const uint8_t *payload = m_ring.ring() + offset + header_size;
+                if (message.type == remote_protocol::frame) {
+                    framePos = m_readPos;
+                    framePayload = payload;
+                    frameSize = message.size;
+                } else {
+                    handleMessage(message.type, payload, message.size);
+                }
+                m_readPos += message_size(message.size);
+            }
+            if (framePayload != nullptr) {
+                newFrame = decodeFrame(framePayload, frameSize, true);
+                m_framePos = framePos;
+            }
+            // The frame in use stays in the ring until the next one replaced it
+            header.tail.store(data() != nullptr ? m_framePos : m_readPos, std::memory_order_release);
+            return newFrame;
+        }
+
+        if (m_socket < 0)
+            return false;
+        bool alive = receive_available(m_socket, m_incoming);
+        // Every frame is decoded, the next one may reuse lists of it
+        while (m_incoming.size() - m_incomingRead >= header_size) {
+            messageHeader message;
+            memcpy(&message, m_incoming.data() + m_incomingRead, header_size);
+            if (m_incoming.size() - m_incomingRead < message_size(message.size))
+                break;
+            const uint8_t *payload = m_incoming.data() + m_incomingRead + header_size;
+            if (message.type == remote_protocol::frame)
+                newFrame |= decodeFrame(payload, message.size, false);
+            else
+                handleMessage(message.type, payload, message.size);
+            m_incomingRead += message_size(message.size);
+            if (m_socket < 0)
+                return false;
+        }
+        m_incoming.erase(m_incoming.begin(), m_incoming.begin() + (ptrdiff_t) m_incomingRead);
+        m_incomingRead = 0;
+        if (!alive)
+            close();
+        return newFrame;
+    }
+
+    void remoteReceiver::handleMessage(uint32_t type, const uint8_t *payload, size_t size) {
+        if (type == remote_protocol::hello) {
+            helloMessage hello = {};
+            if (size >= sizeof(hello))
+                memcpy(&hello, payload, sizeof(hello));
+            if (hello.magic != magic || hello.version != version || hello.vertexSize != sizeof(ImDrawVert) ||
+                hello.indexSize != sizeof(ImDrawIdx)) {
+                fprintf(stderr, "[remote] The producer on '%s' is incompatible\n", m_settings.path.c_str());
+                close();
+                return;
+            }
+            m_helloReceived = true;
+        } else if (type == remote_protocol::texture) {
+            decodeTexture(payload, size);
+        }
+    }
+
+    void remoteReceiver::decodeTexture(const uint8_t *payload, size_t size) {
+        textureHeader header;
+        if (size < sizeof(header))
+            return;
+        memcpy(&header, payload, sizeof(header));
+        if (size < sizeof(header) + (size_t) header.width * header.height * 4 || m_onTexture == nullptr)
+            return;
+        m_decoder.setTexture(header.id, m_onTexture(header.id, payload + sizeof(header), header.width, header.height));
+    }
+
+    bool remoteReceiver::decodeFrame(const uint8_t *payload, size_t size, bool inPlace) {
+        if (!inPlace && !m_helloReceived)
+            return false;
+        if (!m_decoder.decode(payload, size, inPlace))
+            return false;
+        m_framesReceived++;
+        return true;
+    }
+
+} // engine
@@ -0,0 +1,335 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_REMOTE_H
+#define EASYGRAPHICSLIB_REMOTE_H
+
+#include <atomic>
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "drawcodec.h"
+#include "imgui.h"
+
+namespace engine {
+
+    enum class remoteTransport {
+        socket,         // Unix stream socket, unchanged draw lists are not sent again
+        sharedMemory    // POSIX shared memory ring, complete frames the viewer draws in place
+    };
+
+    struct remoteSettings {
+        remoteTransport transport = remoteTransport::socket;
+        std::string path = "/tmp/easygraphicslib.sock"; // Socket path, or shared memory name like "/easygraphicslib"
+        size_t ringSize = 64u << 20;                      // Shared memory only
+    };
+
+    /**
+     * @brief Viewer state sent back to the producer: display size and mouse
+     */
+    struct remoteInput {
+        float displayWidth = 0.0f;
+        float displayHeight = 0.0f;
+        float mouseX = -FLT_MAX;
+        float mouseY = -FLT_MAX;
+        uint32_t mouseButtons = 0;  // Bit n is ImGuiMouseButton n
+        float wheelX = 0.0f;        // Summed up since the viewer attached
+        float wheelY = 0.0f;
+        uint32_t focused = 0;
+    };
+
+    struct remoteStatistics {
+        uint64_t framesSent = 0;
+        uint64_t framesDropped = 0;     // The viewer had not caught up with the previous frames yet
+        uint64_t listsSent = 0;
+        uint64_t listsReused = 0;       // Draw lists the viewer still had from the previous frame
+        uint64_t texturesSent = 0;
+        uint64_t bytesSent = 0;
+        uint64_t connections = 0;
+    };
+
+    /**
+     * @brief Wire format shared by producer and viewer. Both have to run on the same machine with the same
+     * ImGui configuration, which the hello message and the shared memory header check
+     */
+    namespace remote_protocol {
+        constexpr uint32_t magic = 0x45474c52; // "EGLR"
+        constexpr uint32_t version = 1;
+        constexpr uint64_t fontTexture = 1;
+
+        enum messageType : uint32_t {
+            hello = 1,
+            frame = 2,
+            texture = 3,
+            input = 4,
+            wrap = 5        // Shared memory only, the rest of the ring is unused
+        };
+
+        struct messageHeader {
+            uint32_t type;
+            uint32_t size;  // Payload bytes, the next message starts 8 byte aligned
+        };
+
+        struct helloMessage {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t vertexSize;
+            uint32_t indexSize;
+        };
+
+        // A frame message is a draw_format frame
+
+        // Followed by width * height RGBA pixels
+        struct textureHeader {
+            uint64_t id;
+            uint32_t width;
+            uint32_t height;
+        };
+
+        // Start of the shared memory segment, the ring follows at ringOffset
+        struct sharedHeader {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t vertexSize;
+            uint32_t indexSize;
+            uint64_t ringSize;
+            std::atomic<uint64_t> head;             // Bytes written by the producer, never wraps
+            std::atomic<uint64_t> tail;             // Bytes released by the viewer
+            std::atomic<uint32_t> viewerGeneration; // Bumped on every attach, the producer resends its textures
+            std::atomic<uint32_t> viewerAttached;
+            // Input, field by field. A torn update only mixes two consecutive mouse states
+            std::atomic<float> displayWidth, displayHeight;
+            std::atomic<float> mouseX, mouseY;
+            std::atomic<uint32_t> mouseButtons;
+            std::atomic<float> wheelX, wheelY;
+            std::atomic<uint32_t> focused;
+        };
+
+        constexpr size_t ringOffset = (sizeof(sharedHeader) + 63) & ~(size_t) 63;
+
+        using draw_format::align;
+    }
+
+    /**
+     * @brief Shared memory segment with the frame ring, mapped by both sides
+     */
+    class remoteSharedRing {
+
+    public:
+        remoteSharedRing() = default;
+
+        remoteSharedRing(const remoteSharedRing &) = delete;
+
+        remoteSharedRing &operator=(const remoteSharedRing &) = delete;
+
+        ~remoteSharedRing() { close(); }
+
+        /**
+         * @brief Creates the segment, replacing a stale one of the same name
+         */
+        bool create(const std::string &name, size_t ringSize);
+
+        /**
+         * @brief Maps an existing segment, fails if it was made for another ImGui configuration
+         */
+        bool open(const std::string &name);
+
+        void close();
+
+        [[nodiscard]] bool valid() const { return m_header != nullptr; }
+
+        [[nodiscard]] remote_protocol::sharedHeader &header() { return *m_header; }
+
+        [[nodiscard]] const remote_protocol::sharedHeader &header() const { return *m_header; }
+
+        [[nodiscard]] uint8_t *ring() { return m_ring; }
+
+        [[nodiscard]] uint64_t ringSize() const { return m_ringSize; }
+
+    private:
+        std::string m_name;
+        bool m_owner = false;
+        void *m_mapping = nullptr;
+        size_t m_mappingSize = 0;
+        remote_protocol::sharedHeader *m_header = nullptr;
+        uint8_t *m_ring = nullptr;
+        uint64_t m_ringSize = 0;
+    };
+
+    /**
+     * @brief Runs ImGui without any graphics API and streams the draw data of every frame to a viewer process.
+     *
+     * Meant for services that expose debug panels without linking Vulkan or GLFW: the producer only needs the
+     * ImGui core. Frames are only built while a viewer is attached, display size and mouse input come from
+     * the viewer. Over a socket only the draw lists that changed since the previous frame are sent, frames are
+     * dropped while the viewer has not read the previous ones. Through shared memory every frame is complete,
+     * so the viewer can point its draw lists straight at the ring, and a frame is dropped if the ring is full.
+     * Draw callbacks cannot cross process boundaries and are left out. Only use from one thread.
+     */
+    class remoteProducer {
+
+    public:
+        explicit remoteProducer(int width = 1280, int height = 720);
+
+        remoteProducer(const remoteProducer &) = delete;
+
+        remoteProducer &operator=(const remoteProducer &) = delete;
+
+        ~remoteProducer() { cleanup(); }
+
+        [[nodiscard]] int create(const remoteSettings &settings);
+
+        void cleanup();
+
+        void registerOnUpdateCallback(const std::function<void()> &cb);
+
+        /**
+         * @brief Accepts a viewer and applies its input, then builds and sends one frame if a viewer is attached
+         */
+        void updateFrame();
+
+        /**
+         * @brief Adds or replaces a texture, which is used with ImGui::Image(id, ...). Ids 0 and 1 are reserved
+         */
+        void setTexture(ImTextureID id, const uint8_t *rgba, uint32_t width, uint32_t height);
+
+        [[nodiscard]] bool viewerAttached() const;
+
+        [[nodiscard]] const remoteStatistics &stats() const { return m_stats; }
+
+        [[nodiscard]] ImGuiContext *imguiContext() const { return m_imguiContext; }
+
+    private:
+        struct texture {
+            uint32_t width = 0, height = 0;
+            std::vector<uint8_t> rgba;
+            bool dirty = true;
+        };
+
+        void acceptViewer();
+
+        void readInput();
+
+        void applyInput(const remoteInput &input);
+
+        /**
+         * @brief Reserves size bytes in the socket buffer or the ring, nullptr if the viewer is too far behind
+         */
+        uint8_t *beginMessage(uint32_t type, size_t size);
+
+        void endMessage();
+
+        bool flushSocket();
+
+        void disconnect();
+
+        ImGuiContext *m_imguiContext = nullptr;
+        int m_width, m_height;
+        remoteSettings m_settings;
+        std::function<void()> m_onUpdateCallback = nullptr;
+        uint64_t m_frameCount = 0;
+        double m_lastTime = 0.0;
+        remoteStatistics m_stats;
+        std::unordered_map<uint64_t, texture> m_textures;
+
+        drawDataEncoder m_encoder;
+
+        // Socket
+        int m_listenSocket = -1;
+        int m_socket = -1;
+        std::vector<uint8_t> m_outgoing;
+        size_t m_outgoingSent = 0;
+        std::vector<uint8_t> m_incoming;
+
+        // Shared memory
+        remoteSharedRing m_ring;
+        uint32_t m_viewerGeneration = 0;
+        uint64_t m_messageEnd = 0;
+        remoteInput m_input;
+    };
+
+    /**
+     * @brief Viewer side of remoteProducer: receives frames and textures and sends input back.
+     *
+     * data() is the newest complete frame. With shared memory its vertices and indices point into the ring,
+     * which the producer does not overwrite before the next poll(), so it can be uploaded without a copy.
+     * Texture ids are translated with the texture callback, commands with unknown textures are dropped.
+     */
+    class remoteReceiver {
+
+    public:
+        /**
+         * @brief Creates the viewer side texture for a remote one and returns its id. Called again with the same
+         * remote id when the texture changed, the previous local texture is not used after that
+         */
+        using textureCallback = std::function<ImTextureID(uint64_t id, const uint8_t *rgba, uint32_t width,
+                                                          uint32_t height)>;
+
+        remoteReceiver() = default;
+
+        remoteReceiver(const remoteReceiver &) = delete;
+
+        remoteReceiver &operator=(const remoteReceiver &) = delete;
+
+        ~remoteReceiver() { close(); }
+
+        /**
+         * @brief Connects to the producer, false if it is not running
+         */
+        bool open(const remoteSettings &settings);
+
+        void close();
+
+        [[nodiscard]] bool connected() const;
+
+        void setTextureCallback(const textureCallback &cb) { m_onTexture = cb; }
+
+        /**
+         * @brief Processes everything the producer sent so far and releases the previous frame
+         * @return true if there is a new frame
+         */
+        bool poll();
+
+        void sendInput(const remoteInput &input);
+
+        /**
+         * @brief Newest frame, nullptr before the first one. Valid until the next poll()
+         */
+        [[nodiscard]] const ImDrawData *data() const { return m_decoder.data(); }
+
+        [[nodiscard]] uint64_t frameNumber() const { return m_decoder.frameNumber(); }
+
+        [[nodiscard]] uint64_t framesReceived() const { return m_framesReceived; }
+
+    private:
+        void handleMessage(uint32_t type, const uint8_t *payload, size_t size);
+
+        bool decodeFrame(const uint8_t *payload, size_t size, bool inPlace);
+
+        void decodeTexture(const uint8_t *payload, size_t size);
+
+        remoteSettings m_settings;
+        textureCallback m_onTexture = nullptr;
+        drawDataDecoder m_decoder;
+        uint64_t m_framesReceived = 0;
+
+        // Socket
+        int m_socket = -1;
+        bool m_helloReceived = false;
+        std::vector<uint8_t> m_incoming;
+        size_t m_incomingRead = 0;
+
+        // Shared memory
+        remoteSharedRing m_ring;
+        uint64_t m_readPos = 0;
+        uint64_t m_framePos = 0;    // Start of the frame in use, the ring is released up to here
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_REMOTE_H
@@ -0,0 +1,175 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <cstring>
+#include "renderthread.h"
+
+namespace engine {
+
+    // Resizes without the free that ImVector::operator= does first, so the capacity is kept
+    template<typename T>
+    static void copy_vector(ImVector<T> &dst, const ImVector<T> &src) {
+        dst.resize(src.Size);
+        if (src.Size > 0)
+            memcpy(dst.Data, src.Data, (size_t) src.Size * sizeof(T));
+    }
+
+    static inline uint64_t rotate_left(uint64_t value, int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    /**
+     * @brief Hashes 32 bytes per step in four independent lanes, so the multiplies overlap. Not meant to resist
+     * anything but accidental collisions
+     */
+    static uint64_t hash_bytes(const void *data, size_t size, uint64_t seed) {
+        const uint64_t prime1 = 0x9e3779b185ebca87ull;
+        const uint64_t prime2 = 0xc2b2ae3d27d4eb4full;
+        const auto *bytes = (const uint8_t *) data;
+        uint64_t lanes[4] = {seed + prime1, seed ^ prime2, seed, seed - prime1};
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            for (int l = 0; l < 4; l++) {
+                uint64_t word;
+                memcpy(&word, bytes + i + l * 8, sizeof(word));
+                lanes[l] = rotate_left(lanes[l] + word * prime2, 31) * prime1;
+            }
+        }
+        uint64_t hash = rotate_left(lanes[0], 1) + rotate_left(lanes[1], 7) + rotate_left(lanes[2], 12) +
+                        rotate_left(lanes[3], 18) + size;
+        for (; i < size; i++)
+            hash = rotate_left(hash ^ (bytes[i] * prime1), 11) * prime2;
+        hash ^= hash >> 33;
+        hash *= prime2;
+        hash ^= hash >> 29;
+        return hash;
+    }
+
+    uint64_t hashDrawList(const ImDrawList *list, uint64_t seed, bool *hasCallbacks, uint64_t *hashedBytes) {
+        size_t vtx_size = (size_t) list->VtxBuffer.Size * sizeof(ImDrawVert);
+        size_t idx_size = (size_t) list->IdxBuffer.Size * sizeof(ImDrawIdx);
+        uint64_t hash = hash_bytes(list->VtxBuffer.Data, vtx_size, seed);
+        hash = hash_bytes(list->IdxBuffer.Data, idx_size, hash);
+        uint64_t bytes = vtx_size + idx_size;
+        bool callbacks = false;
+        // Field by field, ImDrawCmd has padding
+        for (const ImDrawCmd &cmd: list->CmdBuffer) {
+            struct {
+                ImVec4 clipRect;
+                ImU64 texture;
+                uint32_t vtxOffset, idxOffset, elemCount, callback;
+            } fields = {cmd.ClipRect, (ImU64) cmd.GetTexID(), cmd.VtxOffset, cmd.IdxOffset, cmd.ElemCount,
+                        cmd.UserCallback != nullptr};
+            hash = hash_bytes(&fields, sizeof(fields), hash);
+            bytes += sizeof(fields);
+            if (cmd.UserCallback != nullptr && cmd.UserCallback != ImDrawCallback_ResetRenderState)
+                callbacks = true;
+        }
+        if (hasCallbacks != nullptr && callbacks)
+            *hasCallbacks = true;
+        if (hashedBytes != nullptr)
+            *hashedBytes += bytes;
+        return hash;
+    }
+
+    uint64_t hashDrawData(const ImDrawData *drawData, bool *hasCallbacks, uint64_t *hashedBytes) {
+        const float display[6] = {drawData->DisplayPos.x, drawData->DisplayPos.y, drawData->DisplaySize.x,
+                                  drawData->DisplaySize.y, drawData->FramebufferScale.x, drawData->FramebufferScale.y};
+        uint64_t hash = hash_bytes(display, sizeof(display), (uint64_t) drawData->CmdListsCount);
+        uint64_t bytes = sizeof(display);
+        bool callbacks = false;
+        for (int n = 0; n < drawData->CmdListsCount; n++)
+            hash = hashDrawList(drawData->CmdLists[n], hash, &callbacks, &bytes);
+        if (hasCallbacks != nullptr)
+            *hasCallbacks = callbacks;
+        if (hashedBytes != nullptr)
+            *hashedBytes += bytes;
+        return hash;
+    }
+
+    drawDataSnapshot::~drawDataSnapshot() {
+        for (ImDrawList *list: m_lists)
+            IM_DELETE(list);
+    }
+
+    void drawDataSnapshot::capture(const ImDrawData *drawData) {
+        while (m_lists.Size < drawData->CmdListsCount)
+            m_lists.push_back(IM_NEW(ImDrawList)(drawData->CmdLists[m_lists.Size]->_Data));
+        for (int n = 0; n < drawData->CmdListsCount; n++) {
+            const ImDrawList *src = drawData->CmdLists[n];
+            ImDrawList *dst = m_lists[n];
+            copy_vector(dst->CmdBuffer, src->CmdBuffer);
+            copy_vector(dst->IdxBuffer, src->IdxBuffer);
+            copy_vector(dst->VtxBuffer, src->VtxBuffer);
+            dst->Flags = src->Flags;
+        }
+
+        m_data.Valid = drawData->Valid;
+        m_data.CmdListsCount = drawData->CmdListsCount;
+        m_data.TotalIdxCount = drawData->TotalIdxCount;
+        m_data.TotalVtxCount = drawData->TotalVtxCount;
+#if IMGUI_VERSION_NUM >= 18980
+        copy_vector(m_data.CmdLists, m_lists);
+        m_data.CmdLists.resize(drawData->CmdListsCount);
+#else
+        m_data.CmdLists = m_lists.Data;
+#endif
+        m_data.DisplayPos = drawData->DisplayPos;
+        m_data.DisplaySize = drawData->DisplaySize;
+        m_data.FramebufferScale = drawData->FramebufferScale;
+        m_data.OwnerViewport = drawData->OwnerViewport;
+    }
+
+    void renderThread::start(std::function<void()> job) {
+        if (running())
+            return;
+        m_job = std::move(job);
+        m_busy = false;
+        m_stop = false;
+        m_thread = std::thread(&renderThread::run, this);
+    }
+
+    void renderThread::stop() {
+        if (!running())
+            return;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_idle.wait(lock, [this] { return !m_busy; });
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+        m_job = nullptr;
+    }
+
+    void renderThread::submit() {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_idle.wait(lock, [this] { return !m_busy; });
+            m_busy = true;
+        }
+        m_wake.notify_one();
+    }
+
+    void renderThread::waitIdle() {
+        if (!running())
+            return;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this] { return !m_busy; });
+    }
+
+    void renderThread::run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_wake.wait(lock, [this] { return m_busy || m_stop; });
+            if (m_stop)
+                return;
+            lock.unlock();
+            m_job();
+            lock.lock();
+            m_busy = false;
+            m_idle.notify_all();
+        }
+    }
+
+} // engine
@@ -0,0 +1,111 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_RENDERTHREAD_H
+#define EASYGRAPHICSLIB_RENDERTHREAD_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "imgui.h"
+
+namespace engine {
+
+    /**
+     * @brief Deep copy of an ImDrawData, so a frame can be recorded while ImGui builds the next one.
+     *
+     * The copied draw lists are kept between captures and only grow, so after a few frames a capture is a
+     * handful of memcpy calls without allocations. Texture ids and draw callbacks are copied as they are,
+     * whatever they point to has to stay valid until the snapshot was recorded.
+     */
+    class drawDataSnapshot {
+
+    public:
+        drawDataSnapshot() = default;
+
+        drawDataSnapshot(const drawDataSnapshot &) = delete;
+
+        drawDataSnapshot &operator=(const drawDataSnapshot &) = delete;
+
+        ~drawDataSnapshot();
+
+        void capture(const ImDrawData *drawData);
+
+        [[nodiscard]] ImDrawData *data() { return &m_data; }
+
+    private:
+        ImDrawData m_data;
+        ImVector<ImDrawList *> m_lists;
+    };
+
+    /**
+     * @brief 64 bit hash of everything in the draw data that ends up on screen: display rectangle, vertices,
+     * indices and draw commands. Texture contents are not part of it
+     * @param hasCallbacks Set if any draw command is a user callback, whatever it draws is not covered either
+     * @param hashedBytes Incremented by the number of bytes hashed
+     */
+    uint64_t hashDrawData(const ImDrawData *drawData, bool *hasCallbacks = nullptr, uint64_t *hashedBytes = nullptr);
+
+    /**
+     * @brief Hash of a single draw list as it goes into hashDrawData()
+     */
+    uint64_t hashDrawList(const ImDrawList *list, uint64_t seed, bool *hasCallbacks = nullptr,
+                          uint64_t *hashedBytes = nullptr);
+
+    /**
+     * @brief A thread that runs one frame job at a time, handed over by the thread that builds the frames.
+     *
+     * submit() waits until the previous frame finished, so at most one frame is recorded while the next one
+     * is built and everything the job reads may be changed again once submit() or waitIdle() returned.
+     */
+    class renderThread {
+
+    public:
+        renderThread() = default;
+
+        renderThread(const renderThread &) = delete;
+
+        renderThread &operator=(const renderThread &) = delete;
+
+        ~renderThread() { stop(); }
+
+        /**
+         * @param job Records and presents one frame, called on the render thread for every submit()
+         */
+        void start(std::function<void()> job);
+
+        /**
+         * @brief Finishes the frame in progress and joins the thread
+         */
+        void stop();
+
+        /**
+         * @brief Waits for the previous frame, then hands the next one to the thread
+         */
+        void submit();
+
+        /**
+         * @brief Blocks until no frame is in progress
+         */
+        void waitIdle();
+
+        [[nodiscard]] bool running() const { return m_thread.joinable(); }
+
+    private:
+        void run();
+
+        std::thread m_thread;
+        std::function<void()> m_job;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_idle;
+        bool m_busy = false;
+        bool m_stop = false;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_RENDERTHREAD_H
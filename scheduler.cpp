@@ -0,0 +1,254 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <algorithm>
+#include "imgui.h"
+#include "scheduler.h"
+
+namespace engine {
+
+    static const double cost_smoothing = 0.1;
+
+    static const unsigned max_workers = 4;
+
+    /**
+     * @brief Next time a periodic callback is due. Runs that were missed are skipped instead of caught up
+     */
+    template<typename TimePoint, typename Duration>
+    static TimePoint next_due(TimePoint due, Duration period, TimePoint now) {
+        TimePoint next = due + period;
+        return next <= now ? now + period : next;
+    }
+
+    void frameScheduler::add(const std::string &name, std::function<void()> callback, const callbackOptions &options) {
+        remove(name);
+        auto e = std::make_unique<entry>();
+        e->name = name;
+        e->callback = std::move(callback);
+        e->options = options;
+        e->due = clock::now();
+        // After every callback of the same priority, so those run in the order they were added
+        auto position = std::upper_bound(m_entries.begin(), m_entries.end(), e, [](const auto &a, const auto &b) {
+            return a->options.priority > b->options.priority;
+        });
+        m_entries.insert(position, std::move(e));
+    }
+
+    bool frameScheduler::remove(const std::string &name) {
+        auto it = std::find_if(m_entries.begin(), m_entries.end(), [&](const auto &e) { return e->name == name; });
+        if (it == m_entries.end())
+            return false;
+        // Kept alive while run() or a worker may still use it
+        (*it)->removed = true;
+        m_retired.push_back(std::move(*it));
+        m_entries.erase(it);
+        return true;
+    }
+
+    const callbackStatistics *frameScheduler::stats(const std::string &name) const {
+        for (const auto &e: m_entries) {
+            if (e->name == name)
+                return &e->stats;
+        }
+        return nullptr;
+    }
+
+    double frameScheduler::timeUntilDue() const {
+        const clock::time_point now = clock::now();
+        double earliest = -1.0;
+        for (const auto &e: m_entries) {
+            // A running worker wakes the window itself, every frame callbacks run whenever there is a frame
+            if (e->options.worker ? e->running : e->options.rate <= 0.0)
+                continue;
+            double seconds = std::max(0.0, std::chrono::duration<double>(e->due - now).count());
+            if (earliest < 0.0 || seconds < earliest)
+                earliest = seconds;
+        }
+        return earliest;
+    }
+
+    void frameScheduler::record(entry &e, double milliseconds) {
+        callbackStatistics &s = e.stats;
+        s.runs++;
+        s.lastMs = milliseconds;
+        s.meanMs = s.runs == 1 ? milliseconds : s.meanMs + (milliseconds - s.meanMs) * cost_smoothing;
+        s.maxMs = std::max(s.maxMs, milliseconds);
+    }
+
+    void frameScheduler::submit(entry &e) {
+        if (m_workers.empty()) {
+            unsigned count = std::clamp(std::thread::hardware_concurrency() / 2, 1u, max_workers);
+            for (unsigned i = 0; i < count; i++)
+                m_workers.emplace_back(&frameScheduler::workerLoop, this);
+        }
+        e.running = true;
+        m_pendingJobs.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_queue.push_back(&e);
+        }
+        m_queueCondition.notify_one();
+    }
+
+    void frameScheduler::workerLoop() {
+        for (;;) {
+            entry *e;
+            {
+                std::unique_lock<std::mutex> lock(m_queueMutex);
+                m_queueCondition.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+                // Queued runs still happen when stopping, so every running entry gets finished
+                if (m_queue.empty())
+                    return;
+                e = m_queue.front();
+                m_queue.pop_front();
+            }
+            auto start = clock::now();
+            e->callback();
+            e->workerMs = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+            e->finished.store(true, std::memory_order_release);
+            m_pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+            if (m_wake != nullptr)
+                m_wake();
+        }
+    }
+
+    void frameScheduler::collectWorkers() {
+        for (auto &e: m_entries) {
+            if (!e->running || !e->finished.exchange(false, std::memory_order_acquire))
+                continue;
+            e->running = false;
+            record(*e, e->workerMs);
+            if (e->options.onComplete != nullptr)
+                e->options.onComplete();
+        }
+        for (auto &e: m_retired) {
+            if (e->running && e->finished.exchange(false, std::memory_order_acquire))
+                e->running = false;
+        }
+        std::erase_if(m_retired, [](const auto &e) { return !e->running; });
+    }
+
+    void frameScheduler::run() {
+        const clock::time_point now = clock::now();
+        if (m_lastRun != clock::time_point()) {
+            double seconds = std::chrono::duration<double>(now - m_lastRun).count();
+            if (seconds > 0.0)
+                m_frameRate += (1.0 / seconds - m_frameRate) * cost_smoothing;
+        }
+        m_lastRun = now;
+        collectWorkers();
+
+        // Callbacks may add or remove callbacks, removed ones stay alive in m_retired until the next frame
+        m_runList.clear();
+        for (auto &e: m_entries)
+            m_runList.push_back(e.get());
+
+        double used = 0.0;
+        for (entry *e: m_runList) {
+            if (e->removed)
+                continue;
+            const bool periodic = e->options.rate > 0.0;
+            const auto period = std::chrono::duration_cast<clock::duration>(
+                    std::chrono::duration<double>(periodic ? 1.0 / e->options.rate : 0.0));
+            if (e->options.worker) {
+                if (!e->running && now >= e->due) {
+                    e->due = next_due(e->due, period, now);
+                    submit(*e);
+                }
+                continue;
+            }
+            if (periodic && now < e->due)
+                continue;
+            // Every frame callbacks always run, periodic ones wait for budget, but not for longer than a period
+            if (periodic && m_budgetMs > 0.0 && used + e->stats.meanMs > m_budgetMs && now - e->due < period) {
+                e->stats.deferred++;
+                continue;
+            }
+            auto start = clock::now();
+            e->callback();
+            double milliseconds = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+            used += milliseconds;
+            record(*e, milliseconds);
+            if (periodic)
+                e->due = next_due(e->due, period, now);
+        }
+
+        for (auto &e: m_entries) {
+            double runsPerFrame = e->options.rate > 0.0 ? std::min(1.0, e->options.rate / m_frameRate) : 1.0;
+            e->stats.shareOfBudget = m_budgetMs > 0.0 && !e->options.worker
+                                     ? e->stats.meanMs * runsPerFrame / m_budgetMs : 0.0;
+        }
+        m_stats.usedMs = used;
+        m_stats.frames++;
+        if (m_budgetMs > 0.0 && used > m_budgetMs)
+            m_stats.overBudgetFrames++;
+        m_stats.workerJobs = m_pendingJobs.load(std::memory_order_relaxed);
+    }
+
+    void frameScheduler::stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_stopping = true;
+        }
+        m_queueCondition.notify_all();
+        for (auto &worker: m_workers)
+            worker.join();
+        m_workers.clear();
+        m_stopping = false;
+        // Nothing is published any more, the window is going away
+        for (auto &e: m_entries) {
+            e->running = false;
+            e->finished.store(false, std::memory_order_relaxed);
+        }
+        m_retired.clear();
+    }
+
+    void frameScheduler::drawOverlay(bool *open) const {
+        ImGui::SetNextWindowSize(ImVec2(560, 220), ImGuiCond_FirstUseEver);
+        if (!ImGui::Begin("Update callbacks", open)) {
+            ImGui::End();
+            return;
+        }
+        if (m_budgetMs > 0.0)
+            ImGui::Text("%.3f of %.3f ms, over budget in %llu of %llu frames", m_stats.usedMs, m_budgetMs,
+                        (unsigned long long) m_stats.overBudgetFrames, (unsigned long long) m_stats.frames);
+        else
+            ImGui::Text("%.3f ms, no budget", m_stats.usedMs);
+
+        if (ImGui::BeginTable("callbacks", 8, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+            ImGui::TableSetupColumn("Callback");
+            ImGui::TableSetupColumn("Hz");
+            ImGui::TableSetupColumn("runs");
+            ImGui::TableSetupColumn("deferred");
+            ImGui::TableSetupColumn("last ms");
+            ImGui::TableSetupColumn("mean ms");
+            ImGui::TableSetupColumn("max ms");
+            ImGui::TableSetupColumn("budget");
+            ImGui::TableHeadersRow();
+            for (const auto &e: m_entries) {
+                const callbackStatistics &s = e->stats;
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%s%s", e->name.c_str(), e->options.worker ? " (worker)" : "");
+                ImGui::TableNextColumn();
+                if (e->options.rate > 0.0)
+                    ImGui::Text("%.1f", e->options.rate);
+                else
+                    ImGui::TextUnformatted("frame");
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", (unsigned long long) s.runs);
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", (unsigned long long) s.deferred);
+                for (double v: {s.lastMs, s.meanMs, s.maxMs}) {
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", v);
+                }
+                ImGui::TableNextColumn();
+                ImGui::Text("%.0f%%", s.shareOfBudget * 100.0);
+            }
+            ImGui::EndTable();
+        }
+        ImGui::End();
+    }
+
+} // engine
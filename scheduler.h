@@ -0,0 +1,164 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_SCHEDULER_H
+#define EASYGRAPHICSLIB_SCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace engine {
+
+    struct callbackOptions {
+        double rate = 0.0;          // Runs per second, 0 runs every frame
+        int priority = 0;           // Higher runs first and gets the frame budget first
+        bool worker = false;        // Runs on the worker pool, must not call ImGui. Needs a rate, 0 means as
+                                    // often as the previous run finished
+        std::function<void()> onComplete = nullptr; // Worker only, runs on the main thread once a run finished,
+                                                    // before the other callbacks of that frame
+    };
+
+    struct callbackStatistics {
+        uint64_t runs = 0;
+        uint64_t deferred = 0;      // Frames the callback was due but waited for budget
+        double lastMs = 0.0;
+        double meanMs = 0.0;        // Exponential moving average
+        double maxMs = 0.0;
+        double shareOfBudget = 0.0; // meanMs times runs per frame, relative to the budget
+    };
+
+    struct schedulerStatistics {
+        double usedMs = 0.0;        // Main thread time of the callbacks in the last frame
+        uint64_t frames = 0;
+        uint64_t overBudgetFrames = 0;
+        size_t workerJobs = 0;      // Running or queued
+    };
+
+    /**
+     * @brief Runs the named update callbacks of a window once per frame.
+     *
+     * Callbacks without a rate run every frame in priority order, they typically draw ImGui windows, which
+     * would disappear in frames they were skipped. Callbacks with a rate run when due; if the frame budget is
+     * already spent they wait for a later frame, highest priority first, but never longer than one period.
+     * Worker callbacks run on a small thread pool instead, one run per callback at a time, and hand their
+     * results to the main thread in onComplete. Everything but the worker callbacks themselves runs on the
+     * main thread.
+     */
+    class frameScheduler {
+
+    public:
+        frameScheduler() = default;
+
+        frameScheduler(const frameScheduler &) = delete;
+
+        frameScheduler &operator=(const frameScheduler &) = delete;
+
+        ~frameScheduler() { stop(); }
+
+        /**
+         * @brief Adds a callback, replacing one with the same name
+         */
+        void add(const std::string &name, std::function<void()> callback, const callbackOptions &options = {});
+
+        /**
+         * @return false if there is no callback with that name
+         */
+        bool remove(const std::string &name);
+
+        /**
+         * @param milliseconds Main thread time per frame for the callbacks, 0 for no limit
+         */
+        void setBudget(double milliseconds) { m_budgetMs = milliseconds; }
+
+        [[nodiscard]] double budget() const { return m_budgetMs; }
+
+        /**
+         * @brief Runs whatever is due, called by the window once per frame
+         */
+        void run();
+
+        /**
+         * @brief Waits for the running worker callbacks and stops the pool
+         */
+        void stop();
+
+        [[nodiscard]] bool empty() const { return m_entries.empty(); }
+
+        /**
+         * @brief Seconds until the next callback with a rate or worker run is due, 0 if one is due already and
+         * negative if only every-frame callbacks and running workers are left
+         */
+        [[nodiscard]] double timeUntilDue() const;
+
+        /**
+         * @brief Invoked on the worker thread once a worker callback finished, its onComplete runs in the next
+         * run(). Has to be set before the first worker callback is added
+         */
+        void setWakeCallback(std::function<void()> wake) { m_wake = std::move(wake); }
+
+        /**
+         * @return nullptr if there is no callback with that name
+         */
+        [[nodiscard]] const callbackStatistics *stats(const std::string &name) const;
+
+        [[nodiscard]] const schedulerStatistics &stats() const { return m_stats; }
+
+        /**
+         * @brief Table of the per-callback costs, to find the one that blows the budget
+         */
+        void drawOverlay(bool *open = nullptr) const;
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        struct entry {
+            std::string name;
+            std::function<void()> callback;
+            callbackOptions options;
+            clock::time_point due;
+            callbackStatistics stats;
+            bool removed = false;
+            bool running = false;   // Submitted to the pool and not collected yet
+            std::atomic<bool> finished{false};
+            double workerMs = 0.0;  // Written by the worker before finished
+        };
+
+        static void record(entry &e, double milliseconds);
+
+        void submit(entry &e);
+
+        void collectWorkers();
+
+        void workerLoop();
+
+        std::vector<std::unique_ptr<entry>> m_entries;  // Sorted by priority, then order of registration
+        std::vector<std::unique_ptr<entry>> m_retired;  // Removed, alive while run() or a worker may use them
+        std::vector<entry *> m_runList;
+        double m_budgetMs = 0.0;
+        double m_frameRate = 60.0;  // Estimated, to turn per-run costs into per-frame costs
+        clock::time_point m_lastRun;
+        schedulerStatistics m_stats;
+
+        // Worker pool, started with the first worker callback
+        std::vector<std::thread> m_workers;
+        std::mutex m_queueMutex;
+        std::condition_variable m_queueCondition;
+        std::deque<entry *> m_queue;
+        bool m_stopping = false;
+        std::atomic<size_t> m_pendingJobs{0};
+        std::function<void()> m_wake = nullptr;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_SCHEDULER_H
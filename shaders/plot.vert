@@ -0,0 +1,18 @@
+#version 450
+
+// Plot samples are stored relative to the series origin, the push constants map them to clip space
+layout(location = 0) in vec2 inPosition;
+
+layout(push_constant) uniform PushConstants {
+    vec2 scale;
+    vec2 offset;
+    vec4 color;
+} pc;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    gl_Position = vec4(inPosition * pc.scale + pc.offset, 0.0, 1.0);
+    gl_PointSize = 1.0;
+    outColor = pc.color;
+}
@@ -0,0 +1,20 @@
+#version 450
+
+// Same interface as the ImGui backend shaders, so descriptor sets made by ImGui_ImplVulkan_AddTexture can be bound
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec2 inUV;
+layout(location = 2) in vec4 inColor;
+
+layout(push_constant) uniform PushConstants {
+    vec2 scale;
+    vec2 translate;
+} pc;
+
+layout(location = 0) out vec4 outColor;
+layout(location = 1) out vec2 outUV;
+
+void main() {
+    gl_Position = vec4(inPosition * pc.scale + pc.translate, 0.0, 1.0);
+    outColor = inColor;
+    outUV = inUV;
+}
@@ -0,0 +1,220 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "imgui.h"
+#include "swapchain.h"
+#include "vkutils.h"
+
+namespace engine {
+
+    void deletionQueue::push(uint64_t frame, std::function<void()> destroy) {
+        m_entries.push_back({frame, std::move(destroy)});
+    }
+
+    void deletionQueue::collect(uint64_t completedFrame) {
+        while (!m_entries.empty() && m_entries.front().frame <= completedFrame) {
+            // Popped first, a destroy function may push again
+            std::function<void()> destroy = std::move(m_entries.front().destroy);
+            m_entries.pop_front();
+            destroy();
+        }
+    }
+
+    void deletionQueue::flush() {
+        collect(UINT64_MAX);
+    }
+
+    void deletionQueue::transfer(uint64_t completed, deletionQueue &next, uint64_t frame) {
+        while (!m_entries.empty() && m_entries.front().frame <= completed) {
+            next.push(frame, std::move(m_entries.front().destroy));
+            m_entries.pop_front();
+        }
+    }
+
+    /**
+     * @brief Command pool, command buffer and a signaled fence for a slot that did not exist before
+     */
+    static void create_frame_commands(VkDevice device, uint32_t queueFamily, const VkAllocationCallbacks *allocator,
+                                      ImGui_ImplVulkanH_Frame &fd) {
+        VkResult err;
+        {
+            VkCommandPoolCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            info.flags = 0;
+            info.queueFamilyIndex = queueFamily;
+            err = vkCreateCommandPool(device, &info, allocator, &fd.CommandPool);
+            check_vk_result(err);
+        }
+        {
+            VkCommandBufferAllocateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            info.commandPool = fd.CommandPool;
+            info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            info.commandBufferCount = 1;
+            err = vkAllocateCommandBuffers(device, &info, &fd.CommandBuffer);
+            check_vk_result(err);
+        }
+        {
+            VkFenceCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+            err = vkCreateFence(device, &info, allocator, &fd.Fence);
+            check_vk_result(err);
+        }
+    }
+
+    bool resizeSwapchain(VkPhysicalDevice physicalDevice, VkDevice device, ImGui_ImplVulkanH_Window *wd,
+                         uint32_t queueFamily, const VkAllocationCallbacks *allocator, int width, int height,
+                         uint32_t minImageCount, deletionQueue &deletions, uint64_t retireFrame,
+                         deletionQueue &presentDeletions, uint64_t acquireCount) {
+        VkResult err;
+        VkSurfaceCapabilitiesKHR cap;
+        err = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, wd->Surface, &cap);
+        check_vk_result(err);
+
+        // The surface decides the extent unless it leaves it to the swapchain
+        VkExtent2D extent;
+        if (cap.currentExtent.width == 0xffffffff) {
+            extent.width = (uint32_t) std::max(width, 0);
+            extent.height = (uint32_t) std::max(height, 0);
+        } else {
+            extent = cap.currentExtent;
+        }
+        if (extent.width == 0 || extent.height == 0)
+            return false;
+
+        if (minImageCount == 0)
+            minImageCount = (uint32_t) ImGui_ImplVulkanH_GetMinImageCountFromPresentMode(wd->PresentMode);
+        minImageCount = std::max(minImageCount, cap.minImageCount);
+        if (cap.maxImageCount != 0)
+            minImageCount = std::min(minImageCount, cap.maxImageCount);
+
+        VkSwapchainKHR old_swapchain = wd->Swapchain;
+        VkSwapchainKHR swapchain;
+        {
+            VkSwapchainCreateInfoKHR info = {};
+            info.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+            info.surface = wd->Surface;
+            info.minImageCount = minImageCount;
+            info.imageFormat = wd->SurfaceFormat.format;
+            info.imageColorSpace = wd->SurfaceFormat.colorSpace;
+            info.imageExtent = extent;
+            info.imageArrayLayers = 1;
+            info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+            info.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            info.preTransform = (cap.supportedTransforms & VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR)
+                                ? VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR : cap.currentTransform;
+            info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+            info.presentMode = wd->PresentMode;
+            info.clipped = VK_TRUE;
+            info.oldSwapchain = old_swapchain;
+            err = vkCreateSwapchainKHR(device, &info, allocator, &swapchain);
+            check_vk_result(err);
+        }
+        uint32_t image_count = 0;
+        err = vkGetSwapchainImagesKHR(device, swapchain, &image_count, nullptr);
+        check_vk_result(err);
+        std::vector<VkImage> images(image_count);
+        err = vkGetSwapchainImagesKHR(device, swapchain, &image_count, images.data());
+        check_vk_result(err);
+
+        // Everything the frames in flight may still use goes to the deletion queue in one entry, what the
+        // presents still wait on in another
+        const uint32_t old_count = wd->ImageCount;
+        const uint32_t kept = std::min(old_count, image_count);
+        std::vector<ImGui_ImplVulkanH_Frame> old_frames(wd->Frames, wd->Frames + old_count);
+        std::vector<ImGui_ImplVulkanH_FrameSemaphores> old_semaphores(wd->FrameSemaphores,
+                                                                      wd->FrameSemaphores + old_count);
+        deletions.push(retireFrame, [=, frames = std::move(old_frames), semaphores = std::move(old_semaphores)]() {
+            for (uint32_t i = 0; i < (uint32_t) frames.size(); i++) {
+                const ImGui_ImplVulkanH_Frame &fd = frames[i];
+                vkDestroyFramebuffer(device, fd.Framebuffer, allocator);
+                vkDestroyImageView(device, fd.BackbufferView, allocator);
+                if (i >= kept) {
+                    vkDestroyFence(device, fd.Fence, allocator);
+                    vkDestroyCommandPool(device, fd.CommandPool, allocator);
+                }
+            }
+            for (const ImGui_ImplVulkanH_FrameSemaphores &fsd: semaphores)
+                vkDestroySemaphore(device, fsd.ImageAcquiredSemaphore, allocator);
+        });
+        std::vector<VkSemaphore> render_complete(old_count);
+        for (uint32_t i = 0; i < old_count; i++)
+            render_complete[i] = wd->FrameSemaphores[i].RenderCompleteSemaphore;
+        presentDeletions.push(acquireCount + image_count + 1, [=, semaphores = std::move(render_complete)]() {
+            for (VkSemaphore semaphore: semaphores)
+                vkDestroySemaphore(device, semaphore, allocator);
+            vkDestroySwapchainKHR(device, old_swapchain, allocator);
+        });
+
+        // Allocated the way the ImGui helpers do, so ImGui_ImplVulkanH_DestroyWindow() can free them
+        auto *frames = (ImGui_ImplVulkanH_Frame *) IM_ALLOC(sizeof(ImGui_ImplVulkanH_Frame) * image_count);
+        auto *semaphores = (ImGui_ImplVulkanH_FrameSemaphores *) IM_ALLOC(
+                sizeof(ImGui_ImplVulkanH_FrameSemaphores) * image_count);
+        memset((void *) frames, 0, sizeof(frames[0]) * image_count);
+        memset((void *) semaphores, 0, sizeof(semaphores[0]) * image_count);
+        for (uint32_t i = 0; i < image_count; i++) {
+            ImGui_ImplVulkanH_Frame &fd = frames[i];
+            if (i < kept) {
+                fd.CommandPool = wd->Frames[i].CommandPool;
+                fd.CommandBuffer = wd->Frames[i].CommandBuffer;
+                fd.Fence = wd->Frames[i].Fence;
+            } else {
+                create_frame_commands(device, queueFamily, allocator, fd);
+            }
+            fd.Backbuffer = images[i];
+            {
+                VkImageViewCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+                info.image = fd.Backbuffer;
+                info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+                info.format = wd->SurfaceFormat.format;
+                info.components.r = VK_COMPONENT_SWIZZLE_R;
+                info.components.g = VK_COMPONENT_SWIZZLE_G;
+                info.components.b = VK_COMPONENT_SWIZZLE_B;
+                info.components.a = VK_COMPONENT_SWIZZLE_A;
+                info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                info.subresourceRange.levelCount = 1;
+                info.subresourceRange.layerCount = 1;
+                err = vkCreateImageView(device, &info, allocator, &fd.BackbufferView);
+                check_vk_result(err);
+            }
+            {
+                VkFramebufferCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+                info.renderPass = wd->RenderPass;
+                info.attachmentCount = 1;
+                info.pAttachments = &fd.BackbufferView;
+                info.width = extent.width;
+                info.height = extent.height;
+                info.layers = 1;
+                err = vkCreateFramebuffer(device, &info, allocator, &fd.Framebuffer);
+                check_vk_result(err);
+            }
+            // An old semaphore may still be waited on by a present, so every slot gets new ones
+            {
+                VkSemaphoreCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+                err = vkCreateSemaphore(device, &info, allocator, &semaphores[i].ImageAcquiredSemaphore);
+                check_vk_result(err);
+                err = vkCreateSemaphore(device, &info, allocator, &semaphores[i].RenderCompleteSemaphore);
+                check_vk_result(err);
+            }
+        }
+        IM_FREE(wd->Frames);
+        IM_FREE(wd->FrameSemaphores);
+        wd->Frames = frames;
+        wd->FrameSemaphores = semaphores;
+        wd->Swapchain = swapchain;
+        wd->ImageCount = image_count;
+        wd->Width = (int) extent.width;
+        wd->Height = (int) extent.height;
+        wd->FrameIndex = 0;
+        wd->SemaphoreIndex = 0;
+        return true;
+    }
+
+} // engine
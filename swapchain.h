@@ -0,0 +1,90 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_SWAPCHAIN_H
+#define EASYGRAPHICSLIB_SWAPCHAIN_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include "imgui_impl_vulkan.h"
+#include "vulkan/vulkan.h"
+
+namespace engine {
+
+    /**
+     * @brief Destroys Vulkan objects once the GPU is done with them, without waiting for the device.
+     *
+     * Every entry is tagged with a frame, or batch, number, collect() destroys the entries whose frame
+     * completed. Numbers are expected to grow, like the frames submitted to one queue do. Only use from one
+     * thread.
+     */
+    class deletionQueue {
+
+    public:
+        deletionQueue() = default;
+
+        deletionQueue(const deletionQueue &) = delete;
+
+        deletionQueue &operator=(const deletionQueue &) = delete;
+
+        /**
+         * @param frame First frame submitted after the objects were last used, they are destroyed once it completed
+         */
+        void push(uint64_t frame, std::function<void()> destroy);
+
+        /**
+         * @brief Destroys everything tagged with a frame up to and including completedFrame
+         */
+        void collect(uint64_t completedFrame);
+
+        /**
+         * @brief Destroys everything, once the device is idle
+         */
+        void flush();
+
+        /**
+         * @brief Moves the entries tagged up to completed to next, tagged with frame there. Lets an object wait
+         * for two different counters, e.g. for an acquire first and the frame that recorded it afterwards
+         */
+        void transfer(uint64_t completed, deletionQueue &next, uint64_t frame);
+
+        [[nodiscard]] size_t size() const { return m_entries.size(); }
+
+    private:
+        struct entry {
+            uint64_t frame;
+            std::function<void()> destroy;
+        };
+
+        std::deque<entry> m_entries;
+    };
+
+    /**
+     * @brief Recreates the swapchain of wd in place of ImGui_ImplVulkanH_CreateOrResizeWindow(), which waits
+     * for the device to go idle.
+     *
+     * The new swapchain is created with the old one as oldSwapchain, so frames in flight keep presenting. The
+     * old image views, framebuffers and image acquired semaphores are handed to deletions with the tag
+     * retireFrame. Command pools, command buffers and fences stay with their frame slot, since the renderer waits
+     * for the fence of a slot before it reuses it. Slots beyond the new image count are retired as well. The
+     * render pass is kept, the surface format does not change.
+     *
+     * A fence does not tell when a present finished, so the render complete semaphores and the old swapchain
+     * go to presentDeletions instead, tagged with the acquire count at which one image of the new swapchain has
+     * been acquired a second time. Presents complete in queue order, so every present of the old swapchain is
+     * done by then. wd has to be created with
+     * ImGui_ImplVulkanH_CreateOrResizeWindow() first, it is destroyed as usual with ImGui_ImplVulkanH_DestroyWindow().
+     *
+     * @param acquireCount Images acquired from the swapchains of wd so far, presentDeletions is keyed by it
+     * @return false if the surface has no area at the moment, e.g. while minimized, wd is unchanged then
+     */
+    bool resizeSwapchain(VkPhysicalDevice physicalDevice, VkDevice device, ImGui_ImplVulkanH_Window *wd,
+                         uint32_t queueFamily, const VkAllocationCallbacks *allocator, int width, int height,
+                         uint32_t minImageCount, deletionQueue &deletions, uint64_t retireFrame,
+                         deletionQueue &presentDeletions, uint64_t acquireCount);
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_SWAPCHAIN_H
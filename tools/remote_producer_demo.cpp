@@ -0,0 +1,67 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+// A process without Vulkan or GLFW that shows a few ImGui panels through RemoteViewer.
+//
+// Usage: RemoteProducerDemo [--socket path | --shm name]
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include "imgui.h"
+#include "remote.h"
+
+int main(int argc, char **argv) {
+    engine::remoteSettings settings;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            settings.transport = engine::remoteTransport::socket;
+            settings.path = argv[++i];
+        } else if (strcmp(argv[i], "--shm") == 0 && i + 1 < argc) {
+            settings.transport = engine::remoteTransport::sharedMemory;
+            settings.path = argv[++i];
+        } else {
+            printf("Usage: RemoteProducerDemo [--socket path | --shm name]\n");
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    engine::remoteProducer producer;
+    float values[256] = {};
+    int counter = 0;
+    uint64_t frame = 0;
+    producer.registerOnUpdateCallback([&]() {
+        for (int i = 0; i < IM_ARRAYSIZE(values); i++)
+            values[i] = sinf((float) (frame + i) * 0.05f);
+        frame++;
+
+        ImGui::Begin("Service");
+        ImGui::Text("Frame %llu", (unsigned long long) frame);
+        if (ImGui::Button("Count"))
+            counter++;
+        ImGui::SameLine();
+        ImGui::Text("%d", counter);
+        ImGui::PlotLines("Signal", values, IM_ARRAYSIZE(values), 0, nullptr, -1.0f, 1.0f, ImVec2(0, 80));
+        ImGui::End();
+
+        const engine::remoteStatistics &stats = producer.stats();
+        ImGui::Begin("Remote");
+        ImGui::Text("Frames sent %llu, dropped %llu", (unsigned long long) stats.framesSent,
+                    (unsigned long long) stats.framesDropped);
+        ImGui::Text("Lists sent %llu, reused %llu", (unsigned long long) stats.listsSent,
+                    (unsigned long long) stats.listsReused);
+        ImGui::Text("%.1f MiB sent", (double) stats.bytesSent / (1024.0 * 1024.0));
+        ImGui::End();
+    });
+
+    if (producer.create(settings) != 0)
+        return 1;
+    printf("Waiting for RemoteViewer on %s\n", settings.path.c_str());
+    while (true) {
+        producer.updateFrame();
+        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+    }
+}
@@ -0,0 +1,221 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+// Shows the ImGui frames of a process that runs engine::remoteProducer and sends mouse input back to it.
+// Reconnects whenever the producer restarts.
+//
+// Usage: RemoteViewer [--socket path | --shm name] [--width N] [--height N]
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include "imgui.h"
+#include "imgui_impl_vulkan.h"
+#include "devicecontext.h"
+#include "remote.h"
+#include "vkutils.h"
+#include "window.h"
+
+namespace {
+
+    struct remoteTexture {
+        VkImage image = VK_NULL_HANDLE;
+        engine::deviceAllocation allocation;
+        VkImageView view = VK_NULL_HANDLE;
+        VkDescriptorSet set = VK_NULL_HANDLE;
+    };
+
+    /**
+     * @brief Viewer side textures of the producer, replaced ones are destroyed once the device is idle
+     */
+    class textureCache {
+
+    public:
+        explicit textureCache(engine::window &window) : m_window(window) {}
+
+        void create() {
+            VkSamplerCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+            info.magFilter = VK_FILTER_LINEAR;
+            info.minFilter = VK_FILTER_LINEAR;
+            info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+            info.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+            info.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+            info.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+            info.minLod = -1000;
+            info.maxLod = 1000;
+            info.maxAnisotropy = 1.0f;
+            VkResult err = vkCreateSampler(device(), &info, allocator(), &m_sampler);
+            engine::check_vk_result(err);
+        }
+
+        void destroy() {
+            {
+                std::lock_guard<std::mutex> lock(m_window.context()->queueMutex());
+                vkDeviceWaitIdle(device());
+            }
+            for (auto &[id, texture]: m_textures)
+                release(texture);
+            m_textures.clear();
+            vkDestroySampler(device(), m_sampler, allocator());
+            m_sampler = VK_NULL_HANDLE;
+        }
+
+        ImTextureID update(uint64_t id, const uint8_t *rgba, uint32_t width, uint32_t height) {
+            auto existing = m_textures.find(id);
+            if (existing != m_textures.end()) {
+                // Only on reconnects and when the producer changes an image, not worth tracking the frames
+                {
+                    std::lock_guard<std::mutex> lock(m_window.context()->queueMutex());
+                    vkDeviceWaitIdle(device());
+                }
+                release(existing->second);
+                m_textures.erase(existing);
+            }
+
+            remoteTexture &texture = m_textures[id];
+            VkImageCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            info.imageType = VK_IMAGE_TYPE_2D;
+            info.format = VK_FORMAT_R8G8B8A8_UNORM;
+            info.extent.width = width;
+            info.extent.height = height;
+            info.extent.depth = 1;
+            info.mipLevels = 1;
+            info.arrayLayers = 1;
+            info.samples = VK_SAMPLE_COUNT_1_BIT;
+            info.tiling = VK_IMAGE_TILING_OPTIMAL;
+            info.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+            info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            VkResult err = m_window.deviceMemory().createImage(info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0,
+                                                                texture.image, texture.allocation);
+            engine::check_vk_result(err);
+
+            VkImageViewCreateInfo view_info = {};
+            view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            view_info.image = texture.image;
+            view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            view_info.format = info.format;
+            view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            view_info.subresourceRange.levelCount = 1;
+            view_info.subresourceRange.layerCount = 1;
+            err = vkCreateImageView(device(), &view_info, allocator(), &texture.view);
+            engine::check_vk_result(err);
+
+            // The frame that uses the texture is recorded right after this callback
+            engine::uploadHandle handle = m_window.uploads().uploadImage(
+                    texture.image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, width, height, rgba,
+                    (VkDeviceSize) width * height * 4);
+            m_window.uploads().wait(handle);
+
+            texture.set = ImGui_ImplVulkan_AddTexture(m_sampler, texture.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            return (ImTextureID) texture.set;
+        }
+
+    private:
+        [[nodiscard]] VkDevice device() const { return m_window.context()->device(); }
+
+        [[nodiscard]] const VkAllocationCallbacks *allocator() const { return m_window.context()->allocator(); }
+
+        void release(remoteTexture &texture) {
+            ImGui_ImplVulkan_RemoveTexture(texture.set);
+            vkDestroyImageView(device(), texture.view, allocator());
+            m_window.deviceMemory().destroyImage(texture.image, texture.allocation);
+        }
+
+        engine::window &m_window;
+        VkSampler m_sampler = VK_NULL_HANDLE;
+        std::unordered_map<uint64_t, remoteTexture> m_textures;
+    };
+
+    void printUsage() {
+        printf("Usage: RemoteViewer [--socket path | --shm name] [--width N] [--height N]\n");
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    engine::remoteSettings settings;
+    int width = 1280, height = 720;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--socket") == 0 && hasValue) {
+            settings.transport = engine::remoteTransport::socket;
+            settings.path = argv[++i];
+        } else if (strcmp(arg, "--shm") == 0 && hasValue) {
+            settings.transport = engine::remoteTransport::sharedMemory;
+            settings.path = argv[++i];
+        } else if (strcmp(arg, "--width") == 0 && hasValue) {
+            width = atoi(argv[++i]);
+        } else if (strcmp(arg, "--height") == 0 && hasValue) {
+            height = atoi(argv[++i]);
+        } else {
+            printUsage();
+            return strcmp(arg, "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    engine::window viewer(width, height);
+    // The remote vertices are in the coordinates of a main viewport at 0,0
+    viewer.setPlatformWindowsEnabled(false);
+
+    engine::remoteReceiver receiver;
+    textureCache textures(viewer);
+    receiver.setTextureCallback([&textures](uint64_t id, const uint8_t *rgba, uint32_t w, uint32_t h) {
+        return textures.update(id, rgba, w, h);
+    });
+
+    auto lastAttempt = std::chrono::steady_clock::time_point();
+    engine::remoteInput input;
+    viewer.registerOnUpdateCallback([&]() {
+        ImGuiIO &io = ImGui::GetIO();
+        auto now = std::chrono::steady_clock::now();
+        if (!receiver.connected() && now - lastAttempt > std::chrono::milliseconds(500)) {
+            lastAttempt = now;
+            if (receiver.open(settings))
+                input = engine::remoteInput();
+        }
+
+        if (receiver.connected()) {
+            input.displayWidth = io.DisplaySize.x;
+            input.displayHeight = io.DisplaySize.y;
+            input.mouseX = io.MousePos.x;
+            input.mouseY = io.MousePos.y;
+            input.mouseButtons = 0;
+            for (int button = 0; button < 5; button++)
+                input.mouseButtons |= io.MouseDown[button] ? 1u << button : 0u;
+            input.wheelX += io.MouseWheelH;
+            input.wheelY += io.MouseWheel;
+            input.focused = 1;
+            receiver.sendInput(input);
+            if (receiver.poll())
+                viewer.markDirty();
+        }
+
+        if (!receiver.connected()) {
+            ImGui::SetNextWindowPos(ImVec2(10, 10));
+            ImGui::Begin("Remote", nullptr, ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize |
+                                            ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoCollapse |
+                                            ImGuiWindowFlags_AlwaysAutoResize);
+            ImGui::Text("Waiting for a producer on %s", settings.path.c_str());
+            ImGui::End();
+        }
+        viewer.setExternalDrawData(receiver.connected() ? receiver.data() : nullptr);
+    });
+
+    int result = viewer.create();
+    if (result == 0) {
+        textures.create();
+        viewer.update();
+        receiver.close();
+        textures.destroy();
+    }
+    viewer.cleanup();
+    return result;
+}
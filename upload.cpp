@@ -0,0 +1,396 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <algorithm>
+#include <cstring>
+#include "imgui.h"
+#include "upload.h"
+#include "vkutils.h"
+
+namespace engine {
+
+    // Keeps every arena offset valid for buffer copies and for image copies of all non 3-byte formats
+    static const VkDeviceSize upload_alignment = 16;
+
+    // Everything the graphics queue may read an uploaded resource with
+    static const VkAccessFlags upload_read_access = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                                    VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT |
+                                                    VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+
+    void uploadManager::create(VkPhysicalDevice physicalDevice, VkDevice device, uint32_t graphicsFamily,
+                               VkQueue graphicsQueue, uint32_t transferFamily, VkQueue transferQueue,
+                               const VkAllocationCallbacks *allocator, VkDeviceSize arenaSize,
+                               std::mutex *queueMutex) {
+        m_physicalDevice = physicalDevice;
+        m_device = device;
+        m_allocator = allocator;
+        m_queueMutex = queueMutex;
+
+        createStream(m_graphics, graphicsFamily, graphicsQueue);
+        if (transferFamily != (uint32_t) -1 && transferFamily != graphicsFamily)
+            createStream(m_copy, transferFamily, transferQueue);
+        else
+            createStream(m_copy, graphicsFamily, graphicsQueue);
+
+        m_arenaSize = arenaSize;
+        m_arenaHead = m_arenaTail = 0;
+        void *mapped;
+        createStagingBuffer(m_arenaSize, m_arenaBuffer, m_arenaMemory, mapped);
+        m_arenaMapped = (uint8_t *) mapped;
+    }
+
+    void uploadManager::destroy() {
+        if (m_device == VK_NULL_HANDLE)
+            return;
+        flush();
+        retire(m_copy, UINT64_MAX);
+        retire(m_graphics, UINT64_MAX);
+        m_pendingBufferAcquires.clear();
+        m_pendingImageAcquires.clear();
+        destroyStream(m_copy);
+        destroyStream(m_graphics);
+
+        vkUnmapMemory(m_device, m_arenaMemory);
+        vkDestroyBuffer(m_device, m_arenaBuffer, m_allocator);
+        vkFreeMemory(m_device, m_arenaMemory, m_allocator);
+        m_arenaBuffer = VK_NULL_HANDLE;
+        m_arenaMemory = VK_NULL_HANDLE;
+        m_arenaMapped = nullptr;
+        m_device = VK_NULL_HANDLE;
+    }
+
+    uploadHandle uploadManager::uploadBuffer(VkBuffer dst, VkDeviceSize dstOffset, const void *data,
+                                             VkDeviceSize size) {
+        if (size == 0)
+            return {};
+        VkBuffer src;
+        VkDeviceSize src_offset;
+        batch &b = stage(data, size, src, src_offset);
+        VkBufferCopy region = {};
+        region.srcOffset = src_offset;
+        region.dstOffset = dstOffset;
+        region.size = size;
+        vkCmdCopyBuffer(b.commandBuffer, src, dst, 1, &region);
+
+        VkBufferMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = dst;
+        barrier.offset = dstOffset;
+        barrier.size = size;
+        if (dedicatedTransfer()) {
+            // Release to the graphics family, the matching acquire is recorded there once the batch finished
+            barrier.srcQueueFamilyIndex = m_copy.family;
+            barrier.dstQueueFamilyIndex = m_graphics.family;
+            vkCmdPipelineBarrier(b.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                 0, 0, nullptr, 1, &barrier, 0, nullptr);
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = upload_read_access;
+            b.bufferAcquires.push_back(barrier);
+        } else {
+            barrier.dstAccessMask = upload_read_access;
+            vkCmdPipelineBarrier(b.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                 0, 0, nullptr, 1, &barrier, 0, nullptr);
+        }
+        m_stats.bytesUploaded += size;
+        return {b.serial, false};
+    }
+
+    uploadHandle uploadManager::uploadImage(VkImage dst, VkImageLayout finalLayout, uint32_t width, uint32_t height,
+                                            const void *data, VkDeviceSize size, VkImageAspectFlags aspect) {
+        if (size == 0)
+            return {};
+        VkBuffer src;
+        VkDeviceSize src_offset;
+        batch &b = stage(data, size, src, src_offset);
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = dst;
+        barrier.subresourceRange.aspectMask = aspect;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.layerCount = 1;
+        vkCmdPipelineBarrier(b.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                             0, nullptr, 0, nullptr, 1, &barrier);
+
+        VkBufferImageCopy region = {};
+        region.bufferOffset = src_offset;
+        region.imageSubresource.aspectMask = aspect;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent.width = width;
+        region.imageExtent.height = height;
+        region.imageExtent.depth = 1;
+        vkCmdCopyBufferToImage(b.commandBuffer, src, dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = finalLayout;
+        if (dedicatedTransfer()) {
+            // The layout transition happens as part of the ownership transfer
+            barrier.dstAccessMask = 0;
+            barrier.srcQueueFamilyIndex = m_copy.family;
+            barrier.dstQueueFamilyIndex = m_graphics.family;
+            vkCmdPipelineBarrier(b.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                 0, 0, nullptr, 0, nullptr, 1, &barrier);
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = upload_read_access;
+            b.imageAcquires.push_back(barrier);
+        } else {
+            barrier.dstAccessMask = upload_read_access;
+            vkCmdPipelineBarrier(b.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        }
+        m_stats.bytesUploaded += size;
+        return {b.serial, false};
+    }
+
+    /**
+     * @brief Copies data into the arena, or a temporary buffer if it does not fit, and opens the copy batch
+     */
+    uploadManager::batch &uploadManager::stage(const void *data, VkDeviceSize size, VkBuffer &src,
+                                               VkDeviceSize &srcOffset) {
+        src = m_arenaBuffer;
+        srcOffset = 0;
+        if (allocate(size, srcOffset)) {
+            memcpy(m_arenaMapped + srcOffset, data, (size_t) size);
+            return openBatch(m_copy);
+        }
+        VkDeviceMemory memory;
+        void *mapped;
+        createStagingBuffer(size, src, memory, mapped);
+        memcpy(mapped, data, (size_t) size);
+        batch &b = openBatch(m_copy);
+        b.temporaryStaging.emplace_back(src, memory);
+        m_stats.oversizedUploads++;
+        return b;
+    }
+
+    uploadHandle uploadManager::recordGraphics(const std::function<void(VkCommandBuffer)> &record,
+                                               std::function<void()> onComplete) {
+        batch &b = openBatch(m_graphics);
+        record(b.commandBuffer);
+        if (onComplete != nullptr)
+            b.onComplete.push_back(std::move(onComplete));
+        return {b.serial, true};
+    }
+
+    void uploadManager::flush() {
+        submit(m_copy);
+        submit(m_graphics);
+    }
+
+    void uploadManager::collect() {
+        retire(m_copy, 0);
+        retire(m_graphics, 0);
+    }
+
+    bool uploadManager::isComplete(uploadHandle handle) const {
+        return !handle.valid() || handle.serial <= (handle.graphics ? m_graphics : m_copy).completed;
+    }
+
+    void uploadManager::wait(uploadHandle handle) {
+        if (isComplete(handle))
+            return;
+        stream &s = handle.graphics ? m_graphics : m_copy;
+        if (s.recording && s.open.serial <= handle.serial)
+            submit(s);
+        retire(s, handle.serial);
+    }
+
+    void uploadManager::recordAcquires(VkCommandBuffer commandBuffer) {
+        std::lock_guard<std::mutex> lock(m_acquireMutex);
+        if (m_pendingBufferAcquires.empty() && m_pendingImageAcquires.empty())
+            return;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+                             0, nullptr, (uint32_t) m_pendingBufferAcquires.size(), m_pendingBufferAcquires.data(),
+                             (uint32_t) m_pendingImageAcquires.size(), m_pendingImageAcquires.data());
+        m_pendingBufferAcquires.clear();
+        m_pendingImageAcquires.clear();
+    }
+
+    void uploadManager::createStream(stream &s, uint32_t family, VkQueue queue) {
+        s.family = family;
+        s.queue = queue;
+        s.nextSerial = 1;
+        s.completed = 0;
+        VkCommandPoolCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        info.queueFamilyIndex = family;
+        VkResult err = vkCreateCommandPool(m_device, &info, m_allocator, &s.commandPool);
+        check_vk_result(err);
+    }
+
+    void uploadManager::destroyStream(stream &s) {
+        if (s.recording) {
+            vkEndCommandBuffer(s.open.commandBuffer);
+            s.spare.push_back(std::move(s.open));
+            s.recording = false;
+        }
+        for (auto &b: s.spare)
+            vkDestroyFence(m_device, b.fence, m_allocator);
+        s.spare.clear();
+        vkDestroyCommandPool(m_device, s.commandPool, m_allocator);
+        s.commandPool = VK_NULL_HANDLE;
+    }
+
+    uploadManager::batch &uploadManager::openBatch(stream &s) {
+        if (s.recording)
+            return s.open;
+        VkResult err;
+
+        batch b;
+        if (!s.spare.empty()) {
+            b = std::move(s.spare.back());
+            s.spare.pop_back();
+        } else {
+            VkCommandBufferAllocateInfo alloc_info = {};
+            alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            alloc_info.commandPool = s.commandPool;
+            alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            alloc_info.commandBufferCount = 1;
+            err = vkAllocateCommandBuffers(m_device, &alloc_info, &b.commandBuffer);
+            check_vk_result(err);
+            VkFenceCreateInfo fence_info = {};
+            fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            err = vkCreateFence(m_device, &fence_info, m_allocator, &b.fence);
+            check_vk_result(err);
+        }
+        b.serial = s.nextSerial++;
+
+        VkCommandBufferBeginInfo begin_info = {};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        err = vkBeginCommandBuffer(b.commandBuffer, &begin_info);
+        check_vk_result(err);
+        s.open = std::move(b);
+        s.recording = true;
+        return s.open;
+    }
+
+    void uploadManager::submit(stream &s) {
+        if (!s.recording)
+            return;
+        VkResult err = vkEndCommandBuffer(s.open.commandBuffer);
+        check_vk_result(err);
+        VkSubmitInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        info.commandBufferCount = 1;
+        info.pCommandBuffers = &s.open.commandBuffer;
+        if (m_queueMutex != nullptr) {
+            std::lock_guard<std::mutex> lock(*m_queueMutex);
+            err = vkQueueSubmit(s.queue, 1, &info, s.open.fence);
+        } else {
+            err = vkQueueSubmit(s.queue, 1, &info, s.open.fence);
+        }
+        check_vk_result(err);
+
+        // Only the copy stream allocates from the arena, everything up to the head belongs to this batch
+        s.open.arenaEnd = &s == &m_copy ? m_arenaHead : 0;
+        s.inFlight.push_back(std::move(s.open));
+        s.recording = false;
+        m_stats.batchesSubmitted++;
+    }
+
+    void uploadManager::retire(stream &s, uint64_t waitFor) {
+        VkResult err;
+        while (!s.inFlight.empty()) {
+            batch &b = s.inFlight.front();
+            if (b.serial <= waitFor) {
+                err = vkWaitForFences(m_device, 1, &b.fence, VK_TRUE, UINT64_MAX);
+                check_vk_result(err);
+            } else if (vkGetFenceStatus(m_device, b.fence) != VK_SUCCESS) {
+                break;
+            }
+            err = vkResetFences(m_device, 1, &b.fence);
+            check_vk_result(err);
+
+            for (auto &staging: b.temporaryStaging) {
+                vkDestroyBuffer(m_device, staging.first, m_allocator);
+                vkFreeMemory(m_device, staging.second, m_allocator);
+            }
+            if (!b.bufferAcquires.empty() || !b.imageAcquires.empty()) {
+                std::lock_guard<std::mutex> lock(m_acquireMutex);
+                m_pendingBufferAcquires.insert(m_pendingBufferAcquires.end(), b.bufferAcquires.begin(),
+                                               b.bufferAcquires.end());
+                m_pendingImageAcquires.insert(m_pendingImageAcquires.end(), b.imageAcquires.begin(),
+                                              b.imageAcquires.end());
+            }
+            if (&s == &m_copy)
+                m_arenaTail = std::max(m_arenaTail, b.arenaEnd);
+            s.completed = b.serial;
+            m_stats.batchesRetired++;
+            for (auto &cb: b.onComplete)
+                cb();
+
+            b.temporaryStaging.clear();
+            b.bufferAcquires.clear();
+            b.imageAcquires.clear();
+            b.onComplete.clear();
+            s.spare.push_back(std::move(b));
+            s.inFlight.pop_front();
+        }
+    }
+
+    bool uploadManager::allocate(VkDeviceSize size, VkDeviceSize &offset) {
+        VkDeviceSize aligned = (size + upload_alignment - 1) / upload_alignment * upload_alignment;
+        if (aligned > m_arenaSize)
+            return false;
+        for (;;) {
+            // An empty arena restarts at the beginning of a lap
+            if (m_arenaHead == m_arenaTail)
+                m_arenaHead = m_arenaTail = (m_arenaHead + m_arenaSize - 1) / m_arenaSize * m_arenaSize;
+
+            // Allocations never straddle the end of the ring, the rest of the lap is skipped instead
+            VkDeviceSize position = m_arenaHead % m_arenaSize;
+            VkDeviceSize padding = position + aligned > m_arenaSize ? m_arenaSize - position : 0;
+            if (m_arenaHead + padding + aligned - m_arenaTail <= m_arenaSize) {
+                m_arenaHead += padding;
+                offset = m_arenaHead % m_arenaSize;
+                m_arenaHead += aligned;
+                return true;
+            }
+
+            // Full: wait for the oldest batch that holds arena space, never for the whole device
+            submit(m_copy);
+            IM_ASSERT(!m_copy.inFlight.empty());
+            m_stats.arenaWaits++;
+            retire(m_copy, m_copy.inFlight.front().serial);
+        }
+    }
+
+    void uploadManager::createStagingBuffer(VkDeviceSize size, VkBuffer &buffer, VkDeviceMemory &memory,
+                                            void *&mapped) {
+        VkResult err;
+        VkBufferCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        info.size = size;
+        info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        err = vkCreateBuffer(m_device, &info, m_allocator, &buffer);
+        check_vk_result(err);
+
+        VkMemoryRequirements req;
+        vkGetBufferMemoryRequirements(m_device, buffer, &req);
+        VkMemoryAllocateInfo alloc_info = {};
+        alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        alloc_info.allocationSize = req.size;
+        alloc_info.memoryTypeIndex = findMemoryType(m_physicalDevice, req.memoryTypeBits,
+                                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        IM_ASSERT(alloc_info.memoryTypeIndex != (uint32_t) -1);
+        err = vkAllocateMemory(m_device, &alloc_info, m_allocator, &memory);
+        check_vk_result(err);
+        err = vkBindBufferMemory(m_device, buffer, memory, 0);
+        check_vk_result(err);
+        err = vkMapMemory(m_device, memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+        check_vk_result(err);
+    }
+
+} // engine
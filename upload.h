@@ -0,0 +1,180 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_UPLOAD_H
+#define EASYGRAPHICSLIB_UPLOAD_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "vulkan/vulkan.h"
+
+namespace engine {
+
+    /**
+     * @brief Identifies the batch an upload was recorded into. A default constructed handle counts as complete
+     */
+    struct uploadHandle {
+        uint64_t serial = 0;
+        bool graphics = false;
+
+        [[nodiscard]] bool valid() const { return serial != 0; }
+    };
+
+    struct uploadStatistics {
+        uint64_t bytesUploaded = 0;
+        uint64_t batchesSubmitted = 0;
+        uint64_t batchesRetired = 0;    // Finished on the GPU, their resources may show up from now on
+        uint64_t arenaWaits = 0;        // Uploads that had to wait for an older batch to free arena space
+        uint64_t oversizedUploads = 0;  // Uploads larger than the arena, staged through a temporary buffer
+    };
+
+    /**
+     * @brief Uploads buffer and image data without stalling the device.
+     *
+     * Data is copied into a persistently mapped ring buffer arena and the copy commands are batched into one
+     * command buffer until flush() submits them with a fence. collect() retires finished batches, which frees
+     * their arena space and completes their handles, so uploads overlap with rendering and only ever wait on
+     * their own batch. If the device has a transfer-only queue family the copies run there, and ownership of
+     * exclusive resources is handed to the graphics family by recordAcquires(). Only use from the thread that
+     * drives the window, except for recordAcquires(), which may run on a render thread.
+     */
+    class uploadManager {
+
+    public:
+        static constexpr VkDeviceSize defaultArenaSize = 32ull << 20;
+
+        /**
+         * @param transferFamily Dedicated transfer queue family, or (uint32_t)-1 to copy on the graphics queue
+         * @param queueMutex Held around every submission if the queues are shared with another thread
+         */
+        void create(VkPhysicalDevice physicalDevice, VkDevice device, uint32_t graphicsFamily, VkQueue graphicsQueue,
+                    uint32_t transferFamily, VkQueue transferQueue, const VkAllocationCallbacks *allocator,
+                    VkDeviceSize arenaSize = defaultArenaSize, std::mutex *queueMutex = nullptr);
+
+        /**
+         * @brief Waits for the outstanding batches and runs their completion callbacks
+         */
+        void destroy();
+
+        uploadHandle uploadBuffer(VkBuffer dst, VkDeviceSize dstOffset, const void *data, VkDeviceSize size);
+
+        /**
+         * @brief Fills mip level 0, layer 0 of an image. The previous contents are discarded and the image ends
+         * up in finalLayout
+         */
+        uploadHandle uploadImage(VkImage dst, VkImageLayout finalLayout, uint32_t width, uint32_t height,
+                                 const void *data, VkDeviceSize size,
+                                 VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT);
+
+        /**
+         * @brief Records arbitrary commands into a batch on the graphics queue, e.g. the ImGui font upload
+         * @param onComplete Invoked from collect() once the GPU finished the batch
+         */
+        uploadHandle recordGraphics(const std::function<void(VkCommandBuffer)> &record,
+                                    std::function<void()> onComplete = nullptr);
+
+        /**
+         * @brief Submits the batches recorded since the last flush
+         */
+        void flush();
+
+        /**
+         * @brief Retires finished batches without blocking
+         */
+        void collect();
+
+        [[nodiscard]] bool isComplete(uploadHandle handle) const;
+
+        /**
+         * @brief Blocks until the batch of handle finished, submitting it first if needed
+         */
+        void wait(uploadHandle handle);
+
+        /**
+         * @brief Records the queue family ownership acquires of completed transfers. The window calls this
+         * at the start of every frame command buffer, before anything uses the uploaded resources
+         */
+        void recordAcquires(VkCommandBuffer commandBuffer);
+
+        [[nodiscard]] bool dedicatedTransfer() const { return m_copy.family != m_graphics.family; }
+
+        [[nodiscard]] VkDeviceSize arenaSize() const { return m_arenaSize; }
+
+        [[nodiscard]] VkDeviceSize arenaUsed() const { return (VkDeviceSize) (m_arenaHead - m_arenaTail); }
+
+        [[nodiscard]] const uploadStatistics &stats() const { return m_stats; }
+
+    private:
+        struct batch {
+            VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+            VkFence fence = VK_NULL_HANDLE;
+            uint64_t serial = 0;
+            uint64_t arenaEnd = 0;
+            std::vector<std::pair<VkBuffer, VkDeviceMemory>> temporaryStaging;
+            std::vector<VkBufferMemoryBarrier> bufferAcquires;
+            std::vector<VkImageMemoryBarrier> imageAcquires;
+            std::vector<std::function<void()>> onComplete;
+        };
+
+        struct stream {
+            uint32_t family = (uint32_t) -1;
+            VkQueue queue = VK_NULL_HANDLE;
+            VkCommandPool commandPool = VK_NULL_HANDLE;
+            std::deque<batch> inFlight;
+            std::vector<batch> spare;
+            batch open;
+            bool recording = false;
+            uint64_t nextSerial = 1;
+            uint64_t completed = 0;
+        };
+
+        void createStream(stream &s, uint32_t family, VkQueue queue);
+
+        void destroyStream(stream &s);
+
+        batch &openBatch(stream &s);
+
+        batch &stage(const void *data, VkDeviceSize size, VkBuffer &src, VkDeviceSize &srcOffset);
+
+        void submit(stream &s);
+
+        /**
+         * @brief Retires finished batches in submission order, blocking on those with a serial up to waitFor
+         */
+        void retire(stream &s, uint64_t waitFor);
+
+        /**
+         * @brief Reserves arena space for size bytes. Returns false if the data has to go through a temporary buffer
+         */
+        bool allocate(VkDeviceSize size, VkDeviceSize &offset);
+
+        void createStagingBuffer(VkDeviceSize size, VkBuffer &buffer, VkDeviceMemory &memory, void *&mapped);
+
+        VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
+        VkDevice m_device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks *m_allocator = nullptr;
+        std::mutex *m_queueMutex = nullptr;
+        stream m_copy;
+        stream m_graphics;
+
+        // Staging arena, head and tail count bytes ever allocated/released so they never wrap
+        VkBuffer m_arenaBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory m_arenaMemory = VK_NULL_HANDLE;
+        uint8_t *m_arenaMapped = nullptr;
+        VkDeviceSize m_arenaSize = 0;
+        uint64_t m_arenaHead = 0;
+        uint64_t m_arenaTail = 0;
+
+        std::mutex m_acquireMutex;              // Guards the pending acquires against recordAcquires()
+        std::vector<VkBufferMemoryBarrier> m_pendingBufferAcquires;
+        std::vector<VkImageMemoryBarrier> m_pendingImageAcquires;
+        uploadStatistics m_stats;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_UPLOAD_H
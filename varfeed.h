@@ -0,0 +1,285 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+// Header-only writer for variable feeds, the shared memory segments engine::variableFeed reads once per
+// frame. Plain C99 plus the GCC/Clang __atomic builtins, so C services and simulators can publish debug
+// variables by including this file and linking -lrt, without linking EasyGraphicsLib.
+//
+//     egl_varfeed_var vars[] = {{"rpm", "1/min", EGL_VARFEED_F64, 1}, {"state", "", EGL_VARFEED_TEXT, 32}};
+//     egl_varfeed feed;
+//     if (egl_varfeed_create(&feed, "/mysim", vars, 2) == 0) {
+//         egl_varfeed_set_f64(&feed, 0, 1234.5);
+//         egl_varfeed_set_text(&feed, 1, "running");
+//         ...
+//         egl_varfeed_close(&feed);
+//     }
+//
+// Every variable has its own seqlock: the sequence is odd while a writer copies the value. Writers never
+// block. Any number of threads or processes may write, even to the same variable; a write that finds the
+// variable busy is dropped, the concurrent write is just as recent.
+//
+
+#ifndef EASYGRAPHICSLIB_VARFEED_H
+#define EASYGRAPHICSLIB_VARFEED_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#define EGL_VARFEED_MAGIC 0x56474c45u   /* "EGLV" */
+#define EGL_VARFEED_VERSION 1u
+#define EGL_VARFEED_NAME_SIZE 48
+#define EGL_VARFEED_UNIT_SIZE 16
+#define EGL_VARFEED_ALIGN 64            /* Values start on their own cache line, writers don't share lines */
+
+enum egl_varfeed_type {
+    EGL_VARFEED_F64 = 1,
+    EGL_VARFEED_I64 = 2,
+    EGL_VARFEED_U64 = 3,
+    EGL_VARFEED_TEXT = 4                /* count bytes, NUL terminated if shorter */
+};
+
+/* Start of the segment. The schema is fixed once magic is set */
+typedef struct egl_varfeed_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t variable_count;
+    uint32_t descriptor_size;
+    uint64_t size;                      /* Of the whole segment */
+    uint64_t created_ns;                /* CLOCK_MONOTONIC, tells a recreated feed from the old one */
+    uint32_t writer_pid;
+    uint32_t padding;
+} egl_varfeed_header;
+
+/* variable_count of these follow the header */
+typedef struct egl_varfeed_descriptor {
+    char name[EGL_VARFEED_NAME_SIZE];
+    char unit[EGL_VARFEED_UNIT_SIZE];
+    uint32_t type;
+    uint32_t count;                     /* Elements, bytes for text */
+    uint64_t offset;                    /* Of the value record */
+} egl_varfeed_descriptor;
+
+/* Value record, followed by the payload */
+typedef struct egl_varfeed_value {
+    uint64_t sequence;                  /* Odd while a writer copies the payload, writes = sequence / 2 */
+    uint64_t timestamp_ns;              /* CLOCK_MONOTONIC of the last write */
+} egl_varfeed_value;
+
+/* Schema entry for egl_varfeed_create */
+typedef struct egl_varfeed_var {
+    const char *name;
+    const char *unit;
+    uint32_t type;
+    uint32_t count;
+} egl_varfeed_var;
+
+typedef struct egl_varfeed {
+    void *mapping;
+    size_t size;
+    egl_varfeed_header *header;
+    int owner;
+    char name[256];
+} egl_varfeed;
+
+static inline size_t egl_varfeed_align(size_t size) {
+    return (size + EGL_VARFEED_ALIGN - 1) & ~(size_t) (EGL_VARFEED_ALIGN - 1);
+}
+
+static inline size_t egl_varfeed_element_size(uint32_t type) {
+    return type == EGL_VARFEED_TEXT ? 1 : 8;
+}
+
+/* The layout above builds everywhere, the writer needs POSIX shared memory */
+#ifndef _WIN32
+
+static inline uint64_t egl_varfeed_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static inline egl_varfeed_descriptor *egl_varfeed_descriptors(const egl_varfeed *feed) {
+    return (egl_varfeed_descriptor *) ((uint8_t *) feed->mapping + egl_varfeed_align(sizeof(egl_varfeed_header)));
+}
+
+/* Creates the feed, replacing one with the same name. Returns 0, or -1 with errno set */
+static inline int egl_varfeed_create(egl_varfeed *feed, const char *name, const egl_varfeed_var *vars,
+                                     uint32_t count) {
+    size_t size = egl_varfeed_align(sizeof(egl_varfeed_header)) +
+                  egl_varfeed_align(count * sizeof(egl_varfeed_descriptor));
+    size_t values = size;
+    uint32_t i;
+    int fd;
+    void *mapping;
+    egl_varfeed_descriptor *descriptors;
+
+    memset(feed, 0, sizeof(*feed));
+    if (strlen(name) >= sizeof(feed->name)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    for (i = 0; i < count; i++) {
+        if (vars[i].count == 0 || vars[i].type < EGL_VARFEED_F64 || vars[i].type > EGL_VARFEED_TEXT) {
+            errno = EINVAL;
+            return -1;
+        }
+        size += egl_varfeed_align(sizeof(egl_varfeed_value) + vars[i].count * egl_varfeed_element_size(vars[i].type));
+    }
+
+    shm_unlink(name);
+    fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+        return -1;
+    mapping = MAP_FAILED;
+    if (ftruncate(fd, (off_t) size) == 0)
+        mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        shm_unlink(name);
+        return -1;
+    }
+
+    /* The segment starts zeroed: every sequence is even and no reader accepts it before magic is set */
+    feed->mapping = mapping;
+    feed->size = size;
+    feed->header = (egl_varfeed_header *) mapping;
+    feed->owner = 1;
+    strcpy(feed->name, name);
+    descriptors = egl_varfeed_descriptors(feed);
+    for (i = 0; i < count; i++) {
+        strncpy(descriptors[i].name, vars[i].name, EGL_VARFEED_NAME_SIZE - 1);
+        if (vars[i].unit != NULL)
+            strncpy(descriptors[i].unit, vars[i].unit, EGL_VARFEED_UNIT_SIZE - 1);
+        descriptors[i].type = vars[i].type;
+        descriptors[i].count = vars[i].count;
+        descriptors[i].offset = values;
+        values += egl_varfeed_align(sizeof(egl_varfeed_value) + vars[i].count * egl_varfeed_element_size(vars[i].type));
+    }
+    feed->header->version = EGL_VARFEED_VERSION;
+    feed->header->variable_count = count;
+    feed->header->descriptor_size = sizeof(egl_varfeed_descriptor);
+    feed->header->size = size;
+    feed->header->created_ns = egl_varfeed_now();
+    feed->header->writer_pid = (uint32_t) getpid();
+    __atomic_store_n(&feed->header->magic, EGL_VARFEED_MAGIC, __ATOMIC_RELEASE);
+    return 0;
+}
+
+/* Attaches another writer to an existing feed. Returns 0, or -1 with errno set */
+static inline int egl_varfeed_open(egl_varfeed *feed, const char *name) {
+    struct stat info;
+    void *mapping = MAP_FAILED;
+    const egl_varfeed_header *header;
+    int fd;
+
+    memset(feed, 0, sizeof(*feed));
+    if (strlen(name) >= sizeof(feed->name)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0)
+        return -1;
+    if (fstat(fd, &info) == 0 && (size_t) info.st_size >= sizeof(egl_varfeed_header))
+        mapping = mmap(NULL, (size_t) info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return -1;
+    header = (const egl_varfeed_header *) mapping;
+    if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != EGL_VARFEED_MAGIC ||
+        header->version != EGL_VARFEED_VERSION || header->descriptor_size != sizeof(egl_varfeed_descriptor) ||
+        header->size > (uint64_t) info.st_size) {
+        munmap(mapping, (size_t) info.st_size);
+        errno = EPROTO;
+        return -1;
+    }
+    feed->mapping = mapping;
+    feed->size = (size_t) info.st_size;
+    feed->header = (egl_varfeed_header *) mapping;
+    strcpy(feed->name, name);
+    return 0;
+}
+
+/* Unmaps the feed, the creator also removes it */
+static inline void egl_varfeed_close(egl_varfeed *feed) {
+    if (feed->mapping != NULL)
+        munmap(feed->mapping, feed->size);
+    if (feed->owner)
+        shm_unlink(feed->name);
+    memset(feed, 0, sizeof(*feed));
+}
+
+/* Index of the variable with that name, -1 if there is none */
+static inline int egl_varfeed_find(const egl_varfeed *feed, const char *name) {
+    const egl_varfeed_descriptor *descriptors = egl_varfeed_descriptors(feed);
+    uint32_t i;
+    for (i = 0; i < feed->header->variable_count; i++) {
+        if (strncmp(descriptors[i].name, name, EGL_VARFEED_NAME_SIZE) == 0)
+            return (int) i;
+    }
+    return -1;
+}
+
+/*
+ * Copies bytes into the variable, at most its size; a shorter text is NUL terminated.
+ * Returns 1 if written, 0 if another writer held the variable, -1 for an unknown index
+ */
+static inline int egl_varfeed_write(egl_varfeed *feed, uint32_t index, const void *data, size_t bytes) {
+    const egl_varfeed_descriptor *descriptor;
+    egl_varfeed_value *value;
+    uint8_t *payload;
+    size_t capacity;
+    uint64_t sequence;
+
+    if (index >= feed->header->variable_count)
+        return -1;
+    descriptor = egl_varfeed_descriptors(feed) + index;
+    value = (egl_varfeed_value *) ((uint8_t *) feed->mapping + descriptor->offset);
+    payload = (uint8_t *) (value + 1);
+    capacity = descriptor->count * egl_varfeed_element_size(descriptor->type);
+    if (bytes > capacity)
+        bytes = capacity;
+
+    sequence = __atomic_load_n(&value->sequence, __ATOMIC_RELAXED);
+    if ((sequence & 1) != 0 ||
+        !__atomic_compare_exchange_n(&value->sequence, &sequence, sequence + 1, 0, __ATOMIC_ACQUIRE,
+                                     __ATOMIC_RELAXED))
+        return 0;
+    /* The odd sequence has to be visible before any byte of the payload changes */
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(payload, data, bytes);
+    if (bytes < capacity && descriptor->type == EGL_VARFEED_TEXT)
+        payload[bytes] = 0;
+    value->timestamp_ns = egl_varfeed_now();
+    __atomic_store_n(&value->sequence, sequence + 2, __ATOMIC_RELEASE);
+    return 1;
+}
+
+static inline int egl_varfeed_set_f64(egl_varfeed *feed, uint32_t index, double value) {
+    return egl_varfeed_write(feed, index, &value, sizeof(value));
+}
+
+static inline int egl_varfeed_set_i64(egl_varfeed *feed, uint32_t index, int64_t value) {
+    return egl_varfeed_write(feed, index, &value, sizeof(value));
+}
+
+static inline int egl_varfeed_set_u64(egl_varfeed *feed, uint32_t index, uint64_t value) {
+    return egl_varfeed_write(feed, index, &value, sizeof(value));
+}
+
+static inline int egl_varfeed_set_text(egl_varfeed *feed, uint32_t index, const char *text) {
+    return egl_varfeed_write(feed, index, text, strlen(text));
+}
+
+#endif /* _WIN32 */
+
+#endif //EASYGRAPHICSLIB_VARFEED_H
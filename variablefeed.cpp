@@ -0,0 +1,237 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <cstdio>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "variablefeed.h"
+
+namespace engine {
+
+    // A writer holds a value for a few nanoseconds, more attempts than this means it writes back to back
+    static const int read_attempts = 8;
+
+    static const std::chrono::seconds reopen_interval(1);
+
+    static size_t value_bytes(const egl_varfeed_descriptor &descriptor) {
+        return (size_t) descriptor.count * egl_varfeed_element_size(descriptor.type);
+    }
+
+    double feedVariable::number(uint32_t i) const {
+        if (data == nullptr || i >= count || type == feedType::text)
+            return 0.0;
+        const auto *element = (const uint8_t *) data + i * sizeof(uint64_t);
+        switch (type) {
+            case feedType::f64: {
+                double value;
+                memcpy(&value, element, sizeof(value));
+                return value;
+            }
+            case feedType::i64: {
+                int64_t value;
+                memcpy(&value, element, sizeof(value));
+                return (double) value;
+            }
+            case feedType::u64: {
+                uint64_t value;
+                memcpy(&value, element, sizeof(value));
+                return (double) value;
+            }
+            default:
+                return 0.0;
+        }
+    }
+
+    std::string_view feedVariable::text() const {
+        if (data == nullptr || type != feedType::text)
+            return {};
+        return {(const char *) data, strnlen((const char *) data, count)};
+    }
+
+    variableFeed::variableFeed(std::string name) : m_name(std::move(name)) {}
+
+#ifndef _WIN32
+    bool variableFeed::open() {
+        int fd = shm_open(m_name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+            return false;
+        struct stat info = {};
+        void *mapping = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && (size_t) info.st_size >= sizeof(egl_varfeed_header))
+            mapping = mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+            return false;
+
+        // A feed that is still being created has no magic yet, the next attempt picks it up
+        const size_t size = (size_t) info.st_size;
+        const auto *header = (const egl_varfeed_header *) mapping;
+        if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != EGL_VARFEED_MAGIC) {
+            munmap(mapping, size);
+            return false;
+        }
+        // Every field is read once into a copy, the segment may change between validating and using it
+        const size_t descriptorsOffset = egl_varfeed_align(sizeof(egl_varfeed_header));
+        const uint32_t variableCount = header->variable_count;
+        bool valid = header->version == EGL_VARFEED_VERSION &&
+                     header->descriptor_size == sizeof(egl_varfeed_descriptor) && header->size <= size &&
+                     descriptorsOffset <= size &&
+                     variableCount <= (size - descriptorsOffset) / sizeof(egl_varfeed_descriptor);
+        const auto *descriptors = (const egl_varfeed_descriptor *) ((const uint8_t *) mapping + descriptorsOffset);
+        std::vector<egl_varfeed_descriptor> copies(valid ? variableCount : 0);
+        size_t valuesSize = 0;
+        for (uint32_t i = 0; valid && i < variableCount; i++) {
+            egl_varfeed_descriptor &descriptor = copies[i];
+            memcpy(&descriptor, &descriptors[i], sizeof(descriptor));
+            valid = descriptor.type >= EGL_VARFEED_F64 && descriptor.type <= EGL_VARFEED_TEXT &&
+                    descriptor.offset % alignof(egl_varfeed_value) == 0 && descriptor.offset <= size &&
+                    sizeof(egl_varfeed_value) + value_bytes(descriptor) <= size - descriptor.offset;
+            valuesSize += 2 * ((value_bytes(descriptor) + 7) & ~(size_t) 7);
+        }
+        if (!valid) {
+            fprintf(stderr, "[feed] '%s' was written by an incompatible writer\n", m_name.c_str());
+            munmap(mapping, size);
+            return false;
+        }
+
+        m_mapping = mapping;
+        m_mappingSize = size;
+        m_header = header;
+        m_device = (uint64_t) info.st_dev;
+        m_inode = (uint64_t) info.st_ino;
+        m_values.assign(valuesSize, 0);
+        m_slots.assign(variableCount, valueSlot());
+        m_variables.resize(variableCount);
+        size_t offset = 0;
+        for (uint32_t i = 0; i < variableCount; i++) {
+            const egl_varfeed_descriptor &descriptor = copies[i];
+            const size_t bytes = value_bytes(descriptor);
+            const size_t stride = (bytes + 7) & ~(size_t) 7;
+            feedVariable &variable = m_variables[i];
+            variable = feedVariable();
+            // The name and unit arrays stay where they are, only the copy's bounded length is used
+            variable.name = {descriptors[i].name, strnlen(descriptor.name, EGL_VARFEED_NAME_SIZE)};
+            variable.unit = {descriptors[i].unit, strnlen(descriptor.unit, EGL_VARFEED_UNIT_SIZE)};
+            variable.type = (feedType) descriptor.type;
+            variable.count = descriptor.count;
+            variable.data = m_values.data() + offset;
+            valueSlot &slot = m_slots[i];
+            slot.offset = (size_t) descriptor.offset;
+            slot.bytes = bytes;
+            slot.spare = m_values.data() + offset + stride;
+            offset += 2 * stride;
+        }
+        m_stats.opens++;
+        return true;
+    }
+
+    void variableFeed::close() {
+        if (m_mapping != nullptr)
+            munmap(m_mapping, m_mappingSize);
+        m_mapping = nullptr;
+        m_mappingSize = 0;
+        m_header = nullptr;
+        m_variables.clear();
+        m_slots.clear();
+        m_values.clear();
+    }
+
+    bool variableFeed::replaced() const {
+        int fd = shm_open(m_name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+            return true;
+        struct stat info = {};
+        bool same = fstat(fd, &info) == 0 && (uint64_t) info.st_dev == m_device && (uint64_t) info.st_ino == m_inode;
+        ::close(fd);
+        return !same;
+    }
+#else
+    // Feeds live in POSIX shared memory, on other platforms they never open
+    bool variableFeed::open() {
+        return false;
+    }
+
+    void variableFeed::close() {}
+
+    bool variableFeed::replaced() const {
+        return true;
+    }
+#endif
+
+    bool variableFeed::snapshot() {
+        bool changed = false;
+        auto now = std::chrono::steady_clock::now();
+        if (now - m_lastCheck >= reopen_interval) {
+            m_lastCheck = now;
+            if (m_header != nullptr && replaced()) {
+                close();
+                changed = true;
+            }
+            if (m_header == nullptr && open())
+                changed = true;
+        }
+        if (m_header == nullptr)
+            return changed;
+
+        m_stats.snapshots++;
+        const auto *base = (const uint8_t *) m_mapping;
+        for (size_t i = 0; i < m_variables.size(); i++) {
+            feedVariable &variable = m_variables[i];
+            valueSlot &slot = m_slots[i];
+            const auto *value = (const egl_varfeed_value *) (base + slot.offset);
+            const uint8_t *payload = (const uint8_t *) (value + 1);
+            variable.changed = false;
+
+            bool done = false;
+            for (int attempt = 0; attempt < read_attempts; attempt++) {
+                uint64_t before = __atomic_load_n(&value->sequence, __ATOMIC_ACQUIRE);
+                if (before == slot.sequence) {
+                    done = true;
+                    break;
+                }
+                if ((before & 1) == 0) {
+                    // Read into the spare buffer, a torn read must not overwrite the previous value
+                    memcpy(slot.spare, payload, slot.bytes);
+                    uint64_t timestamp = value->timestamp_ns;
+                    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+                    if (__atomic_load_n(&value->sequence, __ATOMIC_RELAXED) == before) {
+                        uint8_t *published = slot.spare;
+                        slot.spare = (uint8_t *) variable.data;
+                        variable.data = published;
+                        slot.sequence = before;
+                        variable.timestamp = timestamp;
+                        variable.writes = before / 2;
+                        variable.changed = true;
+                        changed = true;
+                        m_stats.copies++;
+                        done = true;
+                        break;
+                    }
+                }
+                m_stats.retries++;
+            }
+            if (!done)
+                m_stats.stale++;
+        }
+        return changed;
+    }
+
+    const feedVariable *variableFeed::find(std::string_view name) const {
+        for (const feedVariable &variable: m_variables) {
+            if (variable.name == name)
+                return &variable;
+        }
+        return nullptr;
+    }
+
+    double variableFeed::number(std::string_view name, double fallback) const {
+        const feedVariable *variable = find(name);
+        return variable != nullptr && variable->writes > 0 ? variable->number() : fallback;
+    }
+
+} // engine
@@ -0,0 +1,133 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_VARIABLEFEED_H
+#define EASYGRAPHICSLIB_VARIABLEFEED_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "varfeed.h"
+
+namespace engine {
+
+    enum class feedType : uint32_t {
+        f64 = EGL_VARFEED_F64,
+        i64 = EGL_VARFEED_I64,
+        u64 = EGL_VARFEED_U64,
+        text = EGL_VARFEED_TEXT
+    };
+
+    /**
+     * @brief One variable of a snapshot. Name and unit point into the shared segment, data into the snapshot,
+     * valid until the next snapshot()
+     */
+    struct feedVariable {
+        std::string_view name;
+        std::string_view unit;
+        feedType type = feedType::f64;
+        uint32_t count = 0;             // Elements, bytes for text
+        const void *data = nullptr;
+        uint64_t timestamp = 0;         // CLOCK_MONOTONIC nanoseconds of the write
+        uint64_t writes = 0;            // Since the feed was created, 0 if it was never written
+        bool changed = false;           // Written since the previous snapshot
+
+        /**
+         * @brief Element i converted to double, 0 for text
+         */
+        [[nodiscard]] double number(uint32_t i = 0) const;
+
+        [[nodiscard]] std::string_view text() const;
+    };
+
+    struct variableFeedStatistics {
+        uint64_t snapshots = 0;
+        uint64_t copies = 0;            // Values copied, unchanged ones are not copied again
+        uint64_t retries = 0;           // Reads repeated because a writer was active
+        uint64_t stale = 0;             // Values kept from the previous snapshot since writers kept them busy
+        uint64_t opens = 0;             // Including reopens after the writer recreated the feed
+    };
+
+    /**
+     * @brief Reads a variable feed published with varfeed.h by another process.
+     *
+     * snapshot() takes a consistent copy of every variable once per frame. Reading never waits for a writer:
+     * a variable that stays busy keeps its previous value. The feed may be created after the reader, or
+     * recreated by a restarted writer; both are picked up within a second.
+     */
+    class variableFeed {
+
+    public:
+        explicit variableFeed(std::string name);
+
+        variableFeed(const variableFeed &) = delete;
+
+        variableFeed &operator=(const variableFeed &) = delete;
+
+        ~variableFeed() { close(); }
+
+        /**
+         * @brief Updates the snapshot
+         * @return Whether any variable changed
+         */
+        bool snapshot();
+
+        void close();
+
+        [[nodiscard]] bool isOpen() const { return m_header != nullptr; }
+
+        [[nodiscard]] const std::string &name() const { return m_name; }
+
+        /**
+         * @brief Variables of the current snapshot, empty while the feed does not exist
+         */
+        [[nodiscard]] const std::vector<feedVariable> &variables() const { return m_variables; }
+
+        /**
+         * @return nullptr if there is no such variable
+         */
+        [[nodiscard]] const feedVariable *find(std::string_view name) const;
+
+        [[nodiscard]] double number(std::string_view name, double fallback = 0.0) const;
+
+        [[nodiscard]] const variableFeedStatistics &stats() const { return m_stats; }
+
+    private:
+        /**
+         * @brief Where the value of a variable is, validated once by open(). The writer may change the
+         * descriptors afterwards, so snapshot() never reads them again
+         */
+        struct valueSlot {
+            size_t offset = 0;              // Of the egl_varfeed_value in the mapping
+            size_t bytes = 0;
+            uint64_t sequence = 0;          // Of the value in the snapshot
+            uint8_t *spare = nullptr;       // Read into, published in place of data once the read was consistent
+        };
+
+        bool open();
+
+        /**
+         * @brief Whether the name refers to a different segment than the mapped one by now
+         */
+        bool replaced() const;
+
+        std::string m_name;
+        void *m_mapping = nullptr;
+        size_t m_mappingSize = 0;
+        const egl_varfeed_header *m_header = nullptr;
+        uint64_t m_device = 0;
+        uint64_t m_inode = 0;
+        std::chrono::steady_clock::time_point m_lastCheck;
+        std::vector<feedVariable> m_variables;
+        std::vector<valueSlot> m_slots;
+        std::vector<uint8_t> m_values;      // Two buffers per variable
+        variableFeedStatistics m_stats;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_VARIABLEFEED_H
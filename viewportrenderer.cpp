@@ -0,0 +1,747 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include "devicecontext.h"
+#include "viewportrenderer.h"
+#include "vkutils.h"
+
+namespace engine {
+
+    // SPIR-V generated from shaders/ by glslc at build time
+    static const uint32_t viewport_vert_spv[] =
+#include "shaders/viewport.vert.h"
+    ;
+    static const uint32_t viewport_frag_spv[] =
+#include "shaders/viewport.frag.h"
+    ;
+
+    // The platform callbacks carry no user data, the owner of the platform windows is kept here
+    static viewportRenderer *active_renderer = nullptr;
+
+    void workerPool::start(uint32_t threads) {
+        stop();
+        m_stop = false;
+        for (uint32_t i = 0; i < threads; i++)
+            m_threads.emplace_back(&workerPool::work, this);
+    }
+
+    void workerPool::stop() {
+        if (m_threads.empty())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (std::thread &thread: m_threads)
+            thread.join();
+        m_threads.clear();
+    }
+
+    void workerPool::run(uint32_t count, const std::function<void(uint32_t)> &job) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_job = &job;
+            m_count = count;
+            m_finished = 0;
+            m_next = 0;
+            m_generation++;
+        }
+        m_wake.notify_all();
+
+        uint32_t done = 0;
+        for (uint32_t i = m_next++; i < count; i = m_next++, done++)
+            job(i);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_finished += done;
+        m_done.wait(lock, [this] { return m_finished == m_count && m_active == 0; });
+        // Workers that wake up only now must not pick up the finished job
+        m_job = nullptr;
+        m_count = 0;
+    }
+
+    void workerPool::work() {
+        uint64_t generation = 0;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_wake.wait(lock, [this, generation] { return m_stop || m_generation != generation; });
+            if (m_stop)
+                return;
+            generation = m_generation;
+            if (m_job == nullptr)
+                continue;
+            const std::function<void(uint32_t)> *job = m_job;
+            uint32_t count = m_count;
+            m_active++;
+            lock.unlock();
+
+            uint32_t done = 0;
+            for (uint32_t i = m_next++; i < count; i = m_next++, done++)
+                (*job)(i);
+
+            lock.lock();
+            m_finished += done;
+            m_active--;
+            if (m_finished == m_count && m_active == 0)
+                m_done.notify_one();
+        }
+    }
+
+    /**
+     * @brief Creates a persistently mapped buffer, preferring device local memory the CPU can write to directly
+     */
+    static void *create_mapped_buffer(deviceAllocator &memory, VkDeviceSize size, VkBufferUsageFlags usage,
+                                      VkBuffer &buffer, deviceAllocation &allocation) {
+        VkBufferCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        info.size = size;
+        info.usage = usage;
+        info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        VkResult err = memory.createBuffer(info, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                 VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, allocation);
+        check_vk_result(err);
+        return allocation.mapped;
+    }
+
+    void viewportRenderer::create(deviceContext &context, VkPipelineCache pipelineCache, uint32_t minImageCount) {
+        IM_ASSERT(active_renderer == nullptr && "Only one ImGui context can render its platform windows in parallel");
+        m_context = &context;
+        m_device = context.device();
+        m_allocator = context.allocator();
+        m_pipelineCache = pipelineCache;
+        m_minImageCount = minImageCount;
+        VkResult err;
+
+        {
+            VkShaderModuleCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+            info.codeSize = sizeof(viewport_vert_spv);
+            info.pCode = viewport_vert_spv;
+            err = vkCreateShaderModule(m_device, &info, m_allocator, &m_vertModule);
+            check_vk_result(err);
+            info.codeSize = sizeof(viewport_frag_spv);
+            info.pCode = viewport_frag_spv;
+            err = vkCreateShaderModule(m_device, &info, m_allocator, &m_fragModule);
+            check_vk_result(err);
+        }
+        {
+            // Defined identically to the backend's layout, so its texture descriptor sets can be bound
+            VkDescriptorSetLayoutBinding binding = {};
+            binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            binding.descriptorCount = 1;
+            binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+            VkDescriptorSetLayoutCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            info.bindingCount = 1;
+            info.pBindings = &binding;
+            err = vkCreateDescriptorSetLayout(m_device, &info, m_allocator, &m_descriptorSetLayout);
+            check_vk_result(err);
+        }
+        {
+            VkPushConstantRange push_constants = {};
+            push_constants.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+            push_constants.offset = 0;
+            push_constants.size = sizeof(pushConstants);
+            VkPipelineLayoutCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+            info.setLayoutCount = 1;
+            info.pSetLayouts = &m_descriptorSetLayout;
+            info.pushConstantRangeCount = 1;
+            info.pPushConstantRanges = &push_constants;
+            err = vkCreatePipelineLayout(m_device, &info, m_allocator, &m_pipelineLayout);
+            check_vk_result(err);
+        }
+        {
+            VkFenceCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+            for (VkFence &fence: m_batchFences) {
+                err = vkCreateFence(m_device, &info, m_allocator, &fence);
+                check_vk_result(err);
+            }
+        }
+        m_batches = 0;
+        m_completedBatches = 0;
+
+        // The calling thread records as well
+        uint32_t threads = std::clamp(std::thread::hardware_concurrency(), 1u, maxRecordThreads);
+        m_workers.start(threads - 1);
+
+        ImGuiPlatformIO &platform_io = ImGui::GetPlatformIO();
+        m_backendCreateWindow = platform_io.Renderer_CreateWindow;
+        m_backendDestroyWindow = platform_io.Renderer_DestroyWindow;
+        m_backendSetWindowSize = platform_io.Renderer_SetWindowSize;
+        m_backendRenderWindow = platform_io.Renderer_RenderWindow;
+        m_backendSwapBuffers = platform_io.Renderer_SwapBuffers;
+        platform_io.Renderer_CreateWindow = createWindowCallback;
+        platform_io.Renderer_DestroyWindow = destroyWindowCallback;
+        platform_io.Renderer_SetWindowSize = setWindowSizeCallback;
+        platform_io.Renderer_RenderWindow = nullptr;
+        platform_io.Renderer_SwapBuffers = nullptr;
+        active_renderer = this;
+    }
+
+    void viewportRenderer::destroy() {
+        if (m_context == nullptr)
+            return;
+        m_workers.stop();
+        VkResult err = vkDeviceWaitIdle(m_device);
+        check_vk_result(err);
+        m_deletions.flush();
+        // Normally gone already, ImGui_ImplVulkan_Shutdown() destroys the platform windows
+        for (auto &data: m_viewports)
+            destroyWindow(*data);
+        m_viewports.clear();
+        m_frame.clear();
+
+        for (VkFence &fence: m_batchFences) {
+            vkDestroyFence(m_device, fence, m_allocator);
+            fence = VK_NULL_HANDLE;
+        }
+        for (auto &pipeline: m_pipelines)
+            vkDestroyPipeline(m_device, pipeline.second, m_allocator);
+        m_pipelines.clear();
+        vkDestroyPipelineLayout(m_device, m_pipelineLayout, m_allocator);
+        vkDestroyDescriptorSetLayout(m_device, m_descriptorSetLayout, m_allocator);
+        vkDestroyShaderModule(m_device, m_vertModule, m_allocator);
+        vkDestroyShaderModule(m_device, m_fragModule, m_allocator);
+        m_pipelineLayout = VK_NULL_HANDLE;
+        m_descriptorSetLayout = VK_NULL_HANDLE;
+        m_vertModule = m_fragModule = VK_NULL_HANDLE;
+
+        // ImGui::DestroyContext() runs the destroy callback for the main viewport once more
+        ImGuiPlatformIO &platform_io = ImGui::GetPlatformIO();
+        platform_io.Renderer_CreateWindow = m_backendCreateWindow;
+        platform_io.Renderer_DestroyWindow = m_backendDestroyWindow;
+        platform_io.Renderer_SetWindowSize = m_backendSetWindowSize;
+        platform_io.Renderer_RenderWindow = m_backendRenderWindow;
+        platform_io.Renderer_SwapBuffers = m_backendSwapBuffers;
+        if (active_renderer == this)
+            active_renderer = nullptr;
+        m_context = nullptr;
+        m_device = VK_NULL_HANDLE;
+    }
+
+    void viewportRenderer::createWindowCallback(ImGuiViewport *viewport) {
+        active_renderer->createWindow(viewport);
+    }
+
+    void viewportRenderer::destroyWindowCallback(ImGuiViewport *viewport) {
+        viewportRenderer *renderer = active_renderer;
+        auto it = std::find_if(renderer->m_viewports.begin(), renderer->m_viewports.end(),
+                               [viewport](const auto &data) { return data->viewport == viewport; });
+        if (it == renderer->m_viewports.end()) {
+            // The main viewport still belongs to the backend
+            if (renderer->m_backendDestroyWindow != nullptr)
+                renderer->m_backendDestroyWindow(viewport);
+            return;
+        }
+        renderer->destroyWindow(**it);
+        renderer->m_viewports.erase(it);
+    }
+
+    void viewportRenderer::setWindowSizeCallback(ImGuiViewport *viewport, ImVec2 size) {
+        viewportRenderer *renderer = active_renderer;
+        viewportData *data = renderer->find(viewport);
+        if (data == nullptr) {
+            if (renderer->m_backendSetWindowSize != nullptr)
+                renderer->m_backendSetWindowSize(viewport, size);
+            return;
+        }
+        // Rebuilt by render(), which coalesces the sizes of a drag
+        data->rebuild = true;
+    }
+
+    void viewportRenderer::createWindow(ImGuiViewport *viewport) {
+        // Viewport::RendererUserData stays empty, the backend reads it as its own viewport data
+        auto data = std::make_unique<viewportData>();
+        data->viewport = viewport;
+        ImGui_ImplVulkanH_Window &wd = data->window;
+
+        ImGuiPlatformIO &platform_io = ImGui::GetPlatformIO();
+        VkResult err = (VkResult) platform_io.Platform_CreateVkSurface(viewport, (ImU64) m_context->instance(),
+                                                                       (const void *) m_allocator,
+                                                                       (ImU64 *) &wd.Surface);
+        check_vk_result(err);
+
+        VkBool32 supported;
+        err = vkGetPhysicalDeviceSurfaceSupportKHR(m_context->physicalDevice(), m_context->queueFamily(), wd.Surface,
+                                                   &supported);
+        check_vk_result(err);
+        IM_ASSERT(supported == VK_TRUE && "Platform window surface cannot be presented from the graphics queue");
+
+        const VkFormat request_formats[] = {VK_FORMAT_B8G8R8A8_UNORM, VK_FORMAT_R8G8B8A8_UNORM,
+                                            VK_FORMAT_B8G8R8_UNORM, VK_FORMAT_R8G8B8_UNORM};
+        wd.SurfaceFormat = ImGui_ImplVulkanH_SelectSurfaceFormat(m_context->physicalDevice(), wd.Surface,
+                                                                 request_formats, IM_ARRAYSIZE(request_formats),
+                                                                 VK_COLORSPACE_SRGB_NONLINEAR_KHR);
+        // Same as the backend, several windows presenting with vsync do not block each other in one present
+        const VkPresentModeKHR present_modes[] = {VK_PRESENT_MODE_FIFO_KHR};
+        wd.PresentMode = ImGui_ImplVulkanH_SelectPresentMode(m_context->physicalDevice(), wd.Surface, present_modes,
+                                                             IM_ARRAYSIZE(present_modes));
+        wd.ClearEnable = !(viewport->Flags & ImGuiViewportFlags_NoRendererClear);
+        wd.ClearValue.color.float32[3] = 1.0f;
+
+        resizeWindow(*data, (int) viewport->Size.x, (int) viewport->Size.y);
+        m_viewports.push_back(std::move(data));
+    }
+
+    void viewportRenderer::destroyWindow(viewportData &data) {
+        // Waits for the device, so nothing of the window can still be in flight. Its retired swapchains have to go
+        // before the surface does
+        VkResult err = vkDeviceWaitIdle(m_device);
+        check_vk_result(err);
+        m_deletions.flush();
+        data.retiredPresents.flush();
+        ImGui_ImplVulkanH_DestroyWindow(m_context->instance(), m_device, &data.window, m_allocator);
+        for (frameBuffers &buffers: data.frames)
+            destroyBuffers(buffers);
+        data.frames.clear();
+    }
+
+    void viewportRenderer::resizeWindow(viewportData &data, int width, int height) {
+        ImGui_ImplVulkanH_Window &wd = data.window;
+        if (wd.Swapchain == VK_NULL_HANDLE) {
+            ImGui_ImplVulkanH_CreateOrResizeWindow(m_context->instance(), m_context->physicalDevice(), m_device, &wd,
+                                                   m_context->queueFamily(), m_allocator, width, height,
+                                                   m_minImageCount);
+        } else if (!resizeSwapchain(m_context->physicalDevice(), m_device, &wd, m_context->queueFamily(),
+                                    m_allocator, width, height, m_minImageCount, m_deletions, m_batches + 1,
+                                    data.retiredPresents, data.acquires)) {
+            return;
+        }
+        // Buffers of the frames that are gone may still be read by a batch in flight
+        for (size_t i = wd.ImageCount; i < data.frames.size(); i++) {
+            m_deletions.push(m_batches + 1, [this, buffers = data.frames[i]]() mutable {
+                destroyBuffers(buffers);
+            });
+        }
+        // The other frames keep their batch, their command pool is reset only once it completed
+        data.frames.resize(wd.ImageCount);
+        data.semaphoreBatches.assign(wd.ImageCount, 0);
+        data.pipeline = pipelineFor(wd.SurfaceFormat.format, wd.RenderPass);
+        data.rebuild = false;
+        data.resized = std::chrono::steady_clock::now();
+    }
+
+    double viewportRenderer::pendingRebuild() const {
+        double earliest = -1.0;
+        auto now = std::chrono::steady_clock::now();
+        for (const auto &data: m_viewports) {
+            if (!data->rebuild)
+                continue;
+            double remaining = m_resizeDebounceMs / 1000.0 -
+                               std::chrono::duration<double>(now - data->resized).count();
+            if (remaining > 0.0 && (earliest < 0.0 || remaining < earliest))
+                earliest = remaining;
+        }
+        return earliest;
+    }
+
+    viewportRenderer::viewportData *viewportRenderer::find(const ImGuiViewport *viewport) {
+        for (auto &data: m_viewports)
+            if (data->viewport == viewport)
+                return data.get();
+        return nullptr;
+    }
+
+    VkPipeline viewportRenderer::pipelineFor(VkFormat format, VkRenderPass renderPass) {
+        // Render passes of the same format are compatible, whatever their load operation
+        for (auto &pipeline: m_pipelines)
+            if (pipeline.first == format)
+                return pipeline.second;
+
+        VkPipelineShaderStageCreateInfo stages[2] = {};
+        stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        stages[0].module = m_vertModule;
+        stages[0].pName = "main";
+        stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        stages[1].module = m_fragModule;
+        stages[1].pName = "main";
+
+        VkVertexInputBindingDescription binding_desc = {};
+        binding_desc.stride = sizeof(ImDrawVert);
+        binding_desc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+        VkVertexInputAttributeDescription attribute_desc[3] = {};
+        attribute_desc[0].location = 0;
+        attribute_desc[0].format = VK_FORMAT_R32G32_SFLOAT;
+        attribute_desc[0].offset = offsetof(ImDrawVert, pos);
+        attribute_desc[1].location = 1;
+        attribute_desc[1].format = VK_FORMAT_R32G32_SFLOAT;
+        attribute_desc[1].offset = offsetof(ImDrawVert, uv);
+        attribute_desc[2].location = 2;
+        attribute_desc[2].format = VK_FORMAT_R8G8B8A8_UNORM;
+        attribute_desc[2].offset = offsetof(ImDrawVert, col);
+
+        VkPipelineVertexInputStateCreateInfo vertex_info = {};
+        vertex_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertex_info.vertexBindingDescriptionCount = 1;
+        vertex_info.pVertexBindingDescriptions = &binding_desc;
+        vertex_info.vertexAttributeDescriptionCount = 3;
+        vertex_info.pVertexAttributeDescriptions = attribute_desc;
+
+        VkPipelineInputAssemblyStateCreateInfo ia_info = {};
+        ia_info.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        ia_info.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        VkPipelineViewportStateCreateInfo viewport_info = {};
+        viewport_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewport_info.viewportCount = 1;
+        viewport_info.scissorCount = 1;
+
+        VkPipelineRasterizationStateCreateInfo raster_info = {};
+        raster_info.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        raster_info.polygonMode = VK_POLYGON_MODE_FILL;
+        raster_info.cullMode = VK_CULL_MODE_NONE;
+        raster_info.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        raster_info.lineWidth = 1.0f;
+
+        VkPipelineMultisampleStateCreateInfo ms_info = {};
+        ms_info.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        ms_info.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkPipelineColorBlendAttachmentState color_attachment = {};
+        color_attachment.blendEnable = VK_TRUE;
+        color_attachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        color_attachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        color_attachment.colorBlendOp = VK_BLEND_OP_ADD;
+        color_attachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        color_attachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        color_attachment.alphaBlendOp = VK_BLEND_OP_ADD;
+        color_attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                          VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+        VkPipelineDepthStencilStateCreateInfo depth_info = {};
+        depth_info.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+
+        VkPipelineColorBlendStateCreateInfo blend_info = {};
+        blend_info.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        blend_info.attachmentCount = 1;
+        blend_info.pAttachments = &color_attachment;
+
+        VkDynamicState dynamic_states[2] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+        VkPipelineDynamicStateCreateInfo dynamic_state = {};
+        dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamic_state.dynamicStateCount = (uint32_t) IM_ARRAYSIZE(dynamic_states);
+        dynamic_state.pDynamicStates = dynamic_states;
+
+        VkGraphicsPipelineCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        info.stageCount = 2;
+        info.pStages = stages;
+        info.pVertexInputState = &vertex_info;
+        info.pInputAssemblyState = &ia_info;
+        info.pViewportState = &viewport_info;
+        info.pRasterizationState = &raster_info;
+        info.pMultisampleState = &ms_info;
+        info.pDepthStencilState = &depth_info;
+        info.pColorBlendState = &blend_info;
+        info.pDynamicState = &dynamic_state;
+        info.layout = m_pipelineLayout;
+        info.renderPass = renderPass;
+        info.subpass = 0;
+
+        VkPipeline pipeline;
+        VkResult err = vkCreateGraphicsPipelines(m_device, m_pipelineCache, 1, &info, m_allocator, &pipeline);
+        check_vk_result(err);
+        m_pipelines.emplace_back(format, pipeline);
+        return pipeline;
+    }
+
+    void viewportRenderer::waitBatch(uint64_t batch) const {
+        if (batch <= m_completedBatches)
+            return;
+        VkResult err = vkWaitForFences(m_device, 1, &m_batchFences[(batch - 1) % maxBatchesInFlight], VK_TRUE,
+                                       UINT64_MAX);
+        check_vk_result(err);
+    }
+
+    void viewportRenderer::render() {
+        m_lastSubmitted = 0;
+        m_frame.clear();
+        ImGuiPlatformIO &platform_io = ImGui::GetPlatformIO();
+        for (int i = 1; i < platform_io.Viewports.Size; i++) {
+            ImGuiViewport *viewport = platform_io.Viewports[i];
+            if (viewport->Flags & ImGuiViewportFlags_Minimized)
+                continue;
+            viewportData *data = find(viewport);
+            if (data == nullptr || viewport->DrawData == nullptr)
+                continue;
+            if (data->rebuild && std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - data->resized).count() >= m_resizeDebounceMs)
+                resizeWindow(*data, (int) viewport->Size.x, (int) viewport->Size.y);
+            data->recorded = false;
+            m_frame.push_back(data);
+        }
+        if (m_frame.empty())
+            return;
+
+        // The fence of this batch was last used maxBatchesInFlight batches ago
+        VkFence fence = m_batchFences[m_batches % maxBatchesInFlight];
+        VkResult err = vkWaitForFences(m_device, 1, &fence, VK_TRUE, UINT64_MAX);
+        check_vk_result(err);
+        if (m_batches >= maxBatchesInFlight)
+            m_completedBatches = m_batches - maxBatchesInFlight + 1;
+        m_deletions.collect(m_completedBatches);
+        err = vkResetFences(m_device, 1, &fence);
+        check_vk_result(err);
+
+        // Each platform window is acquired and recorded by one thread, with the command pool of its frame
+        if (m_frame.size() > 1 && m_workers.size() > 0) {
+            m_workers.run((uint32_t) m_frame.size(), [this](uint32_t i) {
+                m_frame[i]->recorded = recordViewport(*m_frame[i]);
+            });
+        } else {
+            for (viewportData *data: m_frame)
+                data->recorded = recordViewport(*data);
+        }
+
+        const uint64_t batch = m_batches + 1;
+        // The presents of a retired swapchain are done once an image came back twice, this batch waits for it
+        for (viewportData *data: m_frame)
+            data->retiredPresents.transfer(data->acquires, m_deletions, batch);
+        std::vector<VkSubmitInfo> submits;
+        std::vector<VkSwapchainKHR> swapchains;
+        std::vector<uint32_t> image_indices;
+        std::vector<VkSemaphore> render_complete;
+        std::vector<viewportData *> presented;
+        submits.reserve(m_frame.size());
+        const VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        for (viewportData *data: m_frame) {
+            if (!data->recorded)
+                continue;
+            ImGui_ImplVulkanH_Window &wd = data->window;
+            ImGui_ImplVulkanH_FrameSemaphores &semaphores = wd.FrameSemaphores[wd.SemaphoreIndex];
+            VkSubmitInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            info.waitSemaphoreCount = 1;
+            info.pWaitSemaphores = &semaphores.ImageAcquiredSemaphore;
+            info.pWaitDstStageMask = &wait_stage;
+            info.commandBufferCount = 1;
+            info.pCommandBuffers = &wd.Frames[wd.FrameIndex].CommandBuffer;
+            info.signalSemaphoreCount = 1;
+            info.pSignalSemaphores = &semaphores.RenderCompleteSemaphore;
+            submits.push_back(info);
+            swapchains.push_back(wd.Swapchain);
+            image_indices.push_back(wd.FrameIndex);
+            render_complete.push_back(semaphores.RenderCompleteSemaphore);
+            data->frames[wd.FrameIndex].batch = batch;
+            data->semaphoreBatches[wd.SemaphoreIndex] = batch;
+            presented.push_back(data);
+        }
+
+        std::vector<VkResult> results(presented.size(), VK_SUCCESS);
+        {
+            std::lock_guard<std::mutex> lock(m_context->queueMutex());
+            // Submitted even when empty, the fence then signals once the earlier work completed
+            err = vkQueueSubmit(m_context->queue(), (uint32_t) submits.size(), submits.data(), fence);
+            check_vk_result(err);
+            m_batches = batch;
+            if (!presented.empty()) {
+                VkPresentInfoKHR info = {};
+                info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+                info.waitSemaphoreCount = (uint32_t) render_complete.size();
+                info.pWaitSemaphores = render_complete.data();
+                info.swapchainCount = (uint32_t) swapchains.size();
+                info.pSwapchains = swapchains.data();
+                info.pImageIndices = image_indices.data();
+                info.pResults = results.data();
+                vkQueuePresentKHR(m_context->queue(), &info);
+            }
+        }
+        for (size_t i = 0; i < presented.size(); i++) {
+            viewportData *data = presented[i];
+            if (results[i] == VK_ERROR_OUT_OF_DATE_KHR || results[i] == VK_SUBOPTIMAL_KHR)
+                data->rebuild = true;
+            else
+                check_vk_result(results[i]);
+            data->window.SemaphoreIndex = (data->window.SemaphoreIndex + 1) % data->window.ImageCount;
+        }
+        m_lastSubmitted = (uint32_t) presented.size();
+    }
+
+    bool viewportRenderer::recordViewport(viewportData &data) {
+        ImGui_ImplVulkanH_Window &wd = data.window;
+        waitBatch(data.semaphoreBatches[wd.SemaphoreIndex]);
+        VkSemaphore image_acquired = wd.FrameSemaphores[wd.SemaphoreIndex].ImageAcquiredSemaphore;
+        VkResult err = vkAcquireNextImageKHR(m_device, wd.Swapchain, UINT64_MAX, image_acquired, VK_NULL_HANDLE,
+                                             &wd.FrameIndex);
+        if (err == VK_ERROR_OUT_OF_DATE_KHR) {
+            data.rebuild = true;
+            return false;
+        }
+        // A suboptimal image is still acquired, so it has to be presented before the swapchain is rebuilt
+        if (err == VK_SUBOPTIMAL_KHR)
+            data.rebuild = true;
+        else
+            check_vk_result(err);
+        data.acquires++;
+
+        frameBuffers &buffers = data.frames[wd.FrameIndex];
+        waitBatch(buffers.batch);
+        ImGui_ImplVulkanH_Frame &fd = wd.Frames[wd.FrameIndex];
+        err = vkResetCommandPool(m_device, fd.CommandPool, 0);
+        check_vk_result(err);
+        {
+            VkCommandBufferBeginInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            info.flags |= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            err = vkBeginCommandBuffer(fd.CommandBuffer, &info);
+            check_vk_result(err);
+        }
+        {
+            VkRenderPassBeginInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            info.renderPass = wd.RenderPass;
+            info.framebuffer = fd.Framebuffer;
+            info.renderArea.extent.width = wd.Width;
+            info.renderArea.extent.height = wd.Height;
+            info.clearValueCount = wd.ClearEnable ? 1 : 0;
+            info.pClearValues = wd.ClearEnable ? &wd.ClearValue : nullptr;
+            vkCmdBeginRenderPass(fd.CommandBuffer, &info, VK_SUBPASS_CONTENTS_INLINE);
+        }
+        recordDrawData(data.viewport->DrawData, fd.CommandBuffer, data.pipeline, buffers);
+        vkCmdEndRenderPass(fd.CommandBuffer);
+        err = vkEndCommandBuffer(fd.CommandBuffer);
+        check_vk_result(err);
+        return true;
+    }
+
+    void viewportRenderer::recordDrawData(const ImDrawData *drawData, VkCommandBuffer commandBuffer,
+                                          VkPipeline pipeline, frameBuffers &buffers) {
+        int fb_width = (int) (drawData->DisplaySize.x * drawData->FramebufferScale.x);
+        int fb_height = (int) (drawData->DisplaySize.y * drawData->FramebufferScale.y);
+        if (fb_width <= 0 || fb_height <= 0)
+            return;
+
+        if (drawData->TotalVtxCount > 0) {
+            // Grown only, by half again, the frame is not in flight any more
+            VkDeviceSize vertex_size = (VkDeviceSize) drawData->TotalVtxCount * sizeof(ImDrawVert);
+            VkDeviceSize index_size = (VkDeviceSize) drawData->TotalIdxCount * sizeof(ImDrawIdx);
+            if (vertex_size > buffers.vertexAllocation.size) {
+                if (buffers.vertexBuffer != VK_NULL_HANDLE)
+                    m_context->deviceMemory().destroyBuffer(buffers.vertexBuffer, buffers.vertexAllocation);
+                create_mapped_buffer(m_context->deviceMemory(), vertex_size + vertex_size / 2,
+                                     VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, buffers.vertexBuffer,
+                                     buffers.vertexAllocation);
+            }
+            if (index_size > buffers.indexAllocation.size) {
+                if (buffers.indexBuffer != VK_NULL_HANDLE)
+                    m_context->deviceMemory().destroyBuffer(buffers.indexBuffer, buffers.indexAllocation);
+                create_mapped_buffer(m_context->deviceMemory(), index_size + index_size / 2,
+                                     VK_BUFFER_USAGE_INDEX_BUFFER_BIT, buffers.indexBuffer, buffers.indexAllocation);
+            }
+
+            auto *vtx_dst = (ImDrawVert *) buffers.vertexAllocation.mapped;
+            auto *idx_dst = (ImDrawIdx *) buffers.indexAllocation.mapped;
+            for (int n = 0; n < drawData->CmdListsCount; n++) {
+                const ImDrawList *cmd_list = drawData->CmdLists[n];
+                memcpy(vtx_dst, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+                memcpy(idx_dst, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
+                vtx_dst += cmd_list->VtxBuffer.Size;
+                idx_dst += cmd_list->IdxBuffer.Size;
+            }
+        }
+
+        setupRenderState(drawData, commandBuffer, pipeline, buffers, fb_width, fb_height);
+
+        // Clip rectangles are in display space, the scissor in framebuffer pixels
+        ImVec2 clip_off = drawData->DisplayPos;
+        ImVec2 clip_scale = drawData->FramebufferScale;
+        VkDescriptorSet bound_set = VK_NULL_HANDLE;
+        int global_vtx_offset = 0;
+        int global_idx_offset = 0;
+        for (int n = 0; n < drawData->CmdListsCount; n++) {
+            const ImDrawList *cmd_list = drawData->CmdLists[n];
+            for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++) {
+                const ImDrawCmd *pcmd = &cmd_list->CmdBuffer[cmd_i];
+                if (pcmd->UserCallback != nullptr) {
+                    if (pcmd->UserCallback == ImDrawCallback_ResetRenderState) {
+                        setupRenderState(drawData, commandBuffer, pipeline, buffers, fb_width, fb_height);
+                        bound_set = VK_NULL_HANDLE;
+                    } else {
+                        pcmd->UserCallback(cmd_list, pcmd);
+                    }
+                    continue;
+                }
+
+                ImVec2 clip_min((pcmd->ClipRect.x - clip_off.x) * clip_scale.x,
+                                (pcmd->ClipRect.y - clip_off.y) * clip_scale.y);
+                ImVec2 clip_max((pcmd->ClipRect.z - clip_off.x) * clip_scale.x,
+                                (pcmd->ClipRect.w - clip_off.y) * clip_scale.y);
+                clip_min.x = std::max(clip_min.x, 0.0f);
+                clip_min.y = std::max(clip_min.y, 0.0f);
+                clip_max.x = std::min(clip_max.x, (float) fb_width);
+                clip_max.y = std::min(clip_max.y, (float) fb_height);
+                if (clip_max.x <= clip_min.x || clip_max.y <= clip_min.y)
+                    continue;
+
+                VkRect2D scissor;
+                scissor.offset.x = (int32_t) clip_min.x;
+                scissor.offset.y = (int32_t) clip_min.y;
+                scissor.extent.width = (uint32_t) (clip_max.x - clip_min.x);
+                scissor.extent.height = (uint32_t) (clip_max.y - clip_min.y);
+                vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+                auto descriptor_set = (VkDescriptorSet) pcmd->GetTexID();
+                if (descriptor_set != bound_set) {
+                    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1,
+                                            &descriptor_set, 0, nullptr);
+                    bound_set = descriptor_set;
+                }
+                vkCmdDrawIndexed(commandBuffer, pcmd->ElemCount, 1, pcmd->IdxOffset + global_idx_offset,
+                                 (int32_t) pcmd->VtxOffset + global_vtx_offset, 0);
+            }
+            global_idx_offset += cmd_list->IdxBuffer.Size;
+            global_vtx_offset += cmd_list->VtxBuffer.Size;
+        }
+    }
+
+    void viewportRenderer::setupRenderState(const ImDrawData *drawData, VkCommandBuffer commandBuffer,
+                                            VkPipeline pipeline, const frameBuffers &buffers, int framebufferWidth,
+                                            int framebufferHeight) {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        if (drawData->TotalVtxCount > 0) {
+            VkDeviceSize offset = 0;
+            vkCmdBindVertexBuffers(commandBuffer, 0, 1, &buffers.vertexBuffer, &offset);
+            vkCmdBindIndexBuffer(commandBuffer, buffers.indexBuffer, 0,
+                                 sizeof(ImDrawIdx) == 2 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32);
+        }
+
+        VkViewport viewport;
+        viewport.x = 0;
+        viewport.y = 0;
+        viewport.width = (float) framebufferWidth;
+        viewport.height = (float) framebufferHeight;
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+        // Display space to clip space
+        pushConstants constants = {};
+        constants.scale[0] = 2.0f / drawData->DisplaySize.x;
+        constants.scale[1] = 2.0f / drawData->DisplaySize.y;
+        constants.translate[0] = -1.0f - drawData->DisplayPos.x * constants.scale[0];
+        constants.translate[1] = -1.0f - drawData->DisplayPos.y * constants.scale[1];
+        vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pushConstants),
+                           &constants);
+    }
+
+    void viewportRenderer::destroyBuffers(frameBuffers &buffers) {
+        if (buffers.vertexBuffer != VK_NULL_HANDLE)
+            m_context->deviceMemory().destroyBuffer(buffers.vertexBuffer, buffers.vertexAllocation);
+        if (buffers.indexBuffer != VK_NULL_HANDLE)
+            m_context->deviceMemory().destroyBuffer(buffers.indexBuffer, buffers.indexAllocation);
+        buffers.vertexAllocation = deviceAllocation();
+        buffers.indexAllocation = deviceAllocation();
+    }
+
+} // engine
@@ -0,0 +1,218 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_VIEWPORTRENDERER_H
+#define EASYGRAPHICSLIB_VIEWPORTRENDERER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "allocator.h"
+#include "imgui.h"
+#include "imgui_impl_vulkan.h"
+#include "swapchain.h"
+#include "vulkan/vulkan.h"
+
+namespace engine {
+
+    class deviceContext;
+
+    /**
+     * @brief Fixed set of threads that run the items of one job together with the calling thread
+     */
+    class workerPool {
+
+    public:
+        workerPool() = default;
+
+        workerPool(const workerPool &) = delete;
+
+        workerPool &operator=(const workerPool &) = delete;
+
+        ~workerPool() { stop(); }
+
+        void start(uint32_t threads);
+
+        void stop();
+
+        /**
+         * @brief Calls job(i) for every i below count and returns once all calls finished
+         */
+        void run(uint32_t count, const std::function<void(uint32_t)> &job);
+
+        [[nodiscard]] uint32_t size() const { return (uint32_t) m_threads.size(); }
+
+    private:
+        void work();
+
+        std::vector<std::thread> m_threads;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        const std::function<void(uint32_t)> *m_job = nullptr;
+        uint32_t m_count = 0;
+        uint32_t m_finished = 0;
+        uint32_t m_active = 0;
+        uint64_t m_generation = 0;
+        std::atomic<uint32_t> m_next{0};
+        bool m_stop = false;
+    };
+
+    /**
+     * @brief Renders the secondary platform windows with command buffers recorded in parallel.
+     *
+     * Replaces the renderer callbacks of the ImGui Vulkan backend, so the swapchains of the platform windows
+     * are owned here. render() acquires and records every visible platform window on a worker, each window
+     * frame has its own command pool and is only ever recorded by one thread at a time. All command buffers
+     * go to the queue in a single vkQueueSubmit and all swapchains are presented with one vkQueuePresentKHR.
+     * The draw data is drawn with a pipeline compatible with the backend's, texture ids are the backend's
+     * descriptor sets. Only one ImGui context with platform windows can use the renderer at a time.
+     */
+    class viewportRenderer {
+
+    public:
+        static constexpr uint32_t maxBatchesInFlight = 4;
+        static constexpr uint32_t maxRecordThreads = 4;
+
+        /**
+         * @brief Takes over the platform windows of the current ImGui context. Has to be called after
+         * ImGui_ImplVulkan_Init() and before the first platform window is created
+         */
+        void create(deviceContext &context, VkPipelineCache pipelineCache, uint32_t minImageCount);
+
+        /**
+         * @brief Releases the pipelines and the workers. Call after ImGui_ImplVulkan_Shutdown(), which destroys
+         * the remaining platform windows through the callbacks
+         */
+        void destroy();
+
+        [[nodiscard]] bool active() const { return m_context != nullptr; }
+
+        /**
+         * @brief Used for swapchains created or resized from now on
+         */
+        void setMinImageCount(uint32_t count) { m_minImageCount = count; }
+
+        /**
+         * @brief Minimum time between two swapchain rebuilds of a platform window, see window::setResizeDebounce()
+         */
+        void setResizeDebounce(double milliseconds) { m_resizeDebounceMs = milliseconds; }
+
+        /**
+         * @brief Seconds until the earliest rebuild held back by the debounce is due, negative if there is none
+         */
+        [[nodiscard]] double pendingRebuild() const;
+
+        /**
+         * @brief Records, submits and presents all visible platform windows, in place of
+         * ImGui::RenderPlatformWindowsDefault(). Call after ImGui::UpdatePlatformWindows()
+         */
+        void render();
+
+        /**
+         * @brief Number of platform windows submitted by the last render()
+         */
+        [[nodiscard]] uint32_t lastSubmitted() const { return m_lastSubmitted; }
+
+    private:
+        struct frameBuffers {
+            VkBuffer vertexBuffer = VK_NULL_HANDLE;
+            deviceAllocation vertexAllocation;
+            VkBuffer indexBuffer = VK_NULL_HANDLE;
+            deviceAllocation indexAllocation;
+            uint64_t batch = 0;             // Last batch that used the frame, see waitBatch()
+        };
+
+        struct viewportData {
+            ImGuiViewport *viewport = nullptr;
+            ImGui_ImplVulkanH_Window window;
+            std::vector<frameBuffers> frames;   // Indexed like window.Frames
+            std::vector<uint64_t> semaphoreBatches;
+            uint64_t acquires = 0;              // Images acquired from the swapchains of window
+            deletionQueue retiredPresents;      // Keyed by acquires, then moved to m_deletions
+            VkPipeline pipeline = VK_NULL_HANDLE;
+            bool rebuild = false;
+            bool recorded = false;
+            std::chrono::steady_clock::time_point resized;
+        };
+
+        struct pushConstants {
+            float scale[2];
+            float translate[2];
+        };
+
+        static void createWindowCallback(ImGuiViewport *viewport);
+
+        static void destroyWindowCallback(ImGuiViewport *viewport);
+
+        static void setWindowSizeCallback(ImGuiViewport *viewport, ImVec2 size);
+
+        void createWindow(ImGuiViewport *viewport);
+
+        void destroyWindow(viewportData &data);
+
+        void resizeWindow(viewportData &data, int width, int height);
+
+        viewportData *find(const ImGuiViewport *viewport);
+
+        VkPipeline pipelineFor(VkFormat format, VkRenderPass renderPass);
+
+        /**
+         * @brief Blocks until the batch, given as submission number + 1, completed
+         */
+        void waitBatch(uint64_t batch) const;
+
+        bool recordViewport(viewportData &data);
+
+        void recordDrawData(const ImDrawData *drawData, VkCommandBuffer commandBuffer, VkPipeline pipeline,
+                            frameBuffers &buffers);
+
+        void setupRenderState(const ImDrawData *drawData, VkCommandBuffer commandBuffer, VkPipeline pipeline,
+                              const frameBuffers &buffers, int framebufferWidth, int framebufferHeight);
+
+        void destroyBuffers(frameBuffers &buffers);
+
+        deviceContext *m_context = nullptr;
+        VkDevice m_device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks *m_allocator = nullptr;
+        VkPipelineCache m_pipelineCache = VK_NULL_HANDLE;
+        uint32_t m_minImageCount = 2;
+        double m_resizeDebounceMs = 0.0;
+
+        VkShaderModule m_vertModule = VK_NULL_HANDLE;
+        VkShaderModule m_fragModule = VK_NULL_HANDLE;
+        VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE;
+        VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+        std::vector<std::pair<VkFormat, VkPipeline>> m_pipelines;
+
+        // Backend callbacks, still used for the main viewport and restored by destroy()
+        void (*m_backendCreateWindow)(ImGuiViewport *) = nullptr;
+        void (*m_backendDestroyWindow)(ImGuiViewport *) = nullptr;
+        void (*m_backendSetWindowSize)(ImGuiViewport *, ImVec2) = nullptr;
+        void (*m_backendRenderWindow)(ImGuiViewport *, void *) = nullptr;
+        void (*m_backendSwapBuffers)(ImGuiViewport *, void *) = nullptr;
+
+        std::vector<std::unique_ptr<viewportData>> m_viewports;
+        std::vector<viewportData *> m_frame;
+        workerPool m_workers;
+
+        // A single fence can only be attached to a whole vkQueueSubmit, so the fences belong to the batches
+        // and every frame remembers the batch it was submitted with
+        VkFence m_batchFences[maxBatchesInFlight] = {};
+        uint64_t m_batches = 0;             // Batches submitted so far
+        uint64_t m_completedBatches = 0;    // All batches below this number are known to be complete
+        deletionQueue m_deletions;          // Retired swapchains, tagged with the first batch after them
+        uint32_t m_lastSubmitted = 0;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_VIEWPORTRENDERER_H
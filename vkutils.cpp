@@ -0,0 +1,28 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <cstdio>          // fprintf
+#include <cstdlib>         // abort
+#include "vkutils.h"
+
+namespace engine {
+
+    void check_vk_result(VkResult err) {
+        if (err == 0)
+            return;
+        fprintf(stderr, "[vulkan] Error: VkResult = %d\n", err);
+        if (err < 0)
+            abort();
+    }
+
+    uint32_t findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeBits, VkMemoryPropertyFlags properties) {
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+        for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+            if ((typeBits & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+                return i;
+        }
+        return (uint32_t) -1;
+    }
+
+} // engine
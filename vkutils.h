@@ -0,0 +1,26 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_VKUTILS_H
+#define EASYGRAPHICSLIB_VKUTILS_H
+
+#include <cstdint>
+#include "vulkan/vulkan.h"
+
+namespace engine {
+
+    /**
+     * @brief Prints the error and aborts on negative results, so callers do not need to branch on every call
+     */
+    void check_vk_result(VkResult err);
+
+    /**
+     * @brief Finds a memory type matching the resource requirements and the requested properties
+     * @return Index of the memory type or (uint32_t)-1 if no type matches
+     */
+    uint32_t findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeBits, VkMemoryPropertyFlags properties);
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_VKUTILS_H
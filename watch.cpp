@@ -0,0 +1,125 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+#include <algorithm>
+#include "watch.h"
+
+namespace engine {
+
+    static const char *default_panel = "Watches";
+
+    namespace watch_detail {
+
+        void drawText(std::string_view value) {
+            ImGui::TextUnformatted(value.data(), value.data() + value.size());
+        }
+
+        void drawNumber(double value) {
+            ImGui::Text("%.6g", value);
+        }
+
+        void drawNumber(long long value) {
+            ImGui::Text("%lld", value);
+        }
+
+        void drawNumber(unsigned long long value) {
+            ImGui::Text("%llu", value);
+        }
+
+        void drawBool(bool value) {
+            ImGui::TextUnformatted(value ? "true" : "false");
+        }
+
+        bool beginRow(const char *label, bool compound, float column) {
+            bool open = false;
+            if (compound)
+                open = ImGui::TreeNodeEx(label, ImGuiTreeNodeFlags_SpanAvailWidth);
+            else
+                ImGui::TreeNodeEx(label, ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen |
+                                         ImGuiTreeNodeFlags_Bullet);
+            // Independent of the tree indentation, so values of all depths line up
+            ImGui::SameLine(column);
+            return open;
+        }
+    }
+
+    std::pair<std::string, std::string> watchRegistry::splitName(const std::string &name) {
+        size_t slash = name.find('/');
+        if (slash == std::string::npos || slash == 0 || slash + 1 == name.size())
+            return {default_panel, name};
+        return {name.substr(0, slash), name.substr(slash + 1)};
+    }
+
+    void watchRegistry::insert(const std::string &panelName, std::unique_ptr<watchBase> watch) {
+        auto p = std::find_if(m_panels.begin(), m_panels.end(), [&](const panel &candidate) {
+            return candidate.name == panelName;
+        });
+        if (p == m_panels.end()) {
+            m_panels.push_back({panelName, {}});
+            p = m_panels.end() - 1;
+        }
+        // Watching a name again replaces the watch
+        for (auto &existing: p->watches) {
+            if (existing->label() == watch->label()) {
+                existing = std::move(watch);
+                return;
+            }
+        }
+        p->watches.push_back(std::move(watch));
+    }
+
+    bool watchRegistry::remove(const std::string &name) {
+        auto [panelName, label] = splitName(name);
+        for (auto p = m_panels.begin(); p != m_panels.end(); ++p) {
+            if (p->name != panelName)
+                continue;
+            auto w = std::find_if(p->watches.begin(), p->watches.end(), [&](const auto &watch) {
+                return watch->label() == label;
+            });
+            if (w == p->watches.end())
+                return false;
+            p->watches.erase(w);
+            if (p->watches.empty())
+                m_panels.erase(p);
+            return true;
+        }
+        return false;
+    }
+
+    void watchRegistry::clear() {
+        m_panels.clear();
+    }
+
+    void watchRegistry::draw() {
+        m_stats = watchStatistics();
+        m_stats.panels = m_panels.size();
+        for (panel &p: m_panels) {
+            m_stats.watches += p.watches.size();
+            ImGui::SetNextWindowSize(ImVec2(360, 240), ImGuiCond_FirstUseEver);
+            if (!ImGui::Begin(p.name.c_str())) {
+                ImGui::End();
+                m_stats.skipped += p.watches.size();
+                continue;
+            }
+            const float column = std::max(ImGui::GetWindowContentRegionMax().x * 0.45f, 120.0f);
+            const float spacing = ImGui::GetStyle().ItemSpacing.y;
+            for (auto &watch: p.watches) {
+                // Out of view the getter is not invoked, the space of the last draw keeps the scrollbar stable
+                float height = std::max(watch->height, ImGui::GetFrameHeightWithSpacing());
+                if (!ImGui::IsRectVisible(ImVec2(ImGui::GetContentRegionAvail().x, height))) {
+                    ImGui::Dummy(ImVec2(0.0f, height - spacing));
+                    m_stats.skipped++;
+                    continue;
+                }
+                float start = ImGui::GetCursorPosY();
+                ImGui::PushID(watch.get());
+                watch->draw(column);
+                ImGui::PopID();
+                watch->height = ImGui::GetCursorPosY() - start;
+                m_stats.sampled++;
+            }
+            ImGui::End();
+        }
+    }
+
+} // engine
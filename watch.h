@@ -0,0 +1,271 @@
+//
+// Created by drook207 on 16.10.2026.
+//
+
+#ifndef EASYGRAPHICSLIB_WATCH_H
+#define EASYGRAPHICSLIB_WATCH_H
+
+#include <concepts>
+#include <cstddef>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "imgui.h"
+
+namespace engine {
+
+    /**
+     * @brief Specialise for a struct to watch it, every field gets its own row:
+     *
+     *     template<> struct engine::watchFields<body> {
+     *         template<typename F>
+     *         static void visit(const body &b, F &&field) {
+     *             field("position", b.position);
+     *             field("mass", b.mass);
+     *         }
+     *     };
+     */
+    template<typename T>
+    struct watchFields;
+
+    template<>
+    struct watchFields<ImVec2> {
+        template<typename F>
+        static void visit(const ImVec2 &v, F &&field) {
+            field("x", v.x);
+            field("y", v.y);
+        }
+    };
+
+    template<>
+    struct watchFields<ImVec4> {
+        template<typename F>
+        static void visit(const ImVec4 &v, F &&field) {
+            field("x", v.x);
+            field("y", v.y);
+            field("z", v.z);
+            field("w", v.w);
+        }
+    };
+
+    namespace watch_detail {
+
+        template<typename T>
+        concept text = std::is_convertible_v<const T &, std::string_view>;
+
+        template<typename T>
+        concept scalar = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+        template<typename T>
+        concept described = requires(const T &v) {
+            watchFields<T>::visit(v, [](const char *, const auto &) {});
+        };
+
+        template<typename T>
+        concept range = requires(const T &v) {
+            std::begin(v);
+            std::end(v);
+            std::size(v);
+        };
+
+        void drawText(std::string_view value);
+
+        void drawNumber(double value);
+
+        void drawNumber(long long value);
+
+        void drawNumber(unsigned long long value);
+
+        void drawBool(bool value);
+
+        /**
+         * @brief Draws the label and moves to the value column
+         * @return Whether a compound value is expanded, its rows then go below and need an ImGui::TreePop()
+         */
+        bool beginRow(const char *label, bool compound, float column);
+
+        template<typename T>
+        void drawValue(const char *label, const T &value, float column);
+
+        template<typename T>
+        void drawScalar(const T &value) {
+            if constexpr (std::is_same_v<T, bool>)
+                drawBool(value);
+            else if constexpr (std::is_enum_v<T>)
+                drawNumber((long long) value);
+            else if constexpr (std::is_floating_point_v<T>)
+                drawNumber((double) value);
+            else if constexpr (std::is_signed_v<T>)
+                drawNumber((long long) value);
+            else
+                drawNumber((unsigned long long) value);
+        }
+
+        template<typename T>
+        void drawRange(const T &value, float column) {
+            using element = std::remove_cvref_t<decltype(*std::begin(value))>;
+            char label[32];
+            if constexpr (scalar<element> || text<element>) {
+                // Rows of plain elements all have the same height, only the visible ones are drawn
+                auto begin = std::begin(value);
+                ImGuiListClipper clipper;
+                clipper.Begin((int) std::size(value));
+                while (clipper.Step()) {
+                    for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                        snprintf(label, sizeof(label), "[%d]", i);
+                        drawValue(label, *std::next(begin, i), column);
+                    }
+                }
+            } else {
+                int i = 0;
+                for (const auto &item: value) {
+                    snprintf(label, sizeof(label), "[%d]", i++);
+                    drawValue(label, item, column);
+                }
+            }
+        }
+
+        template<typename T>
+        void drawValue(const char *label, const T &value, float column) {
+            if constexpr (text<T>) {
+                beginRow(label, false, column);
+                drawText(std::string_view(value));
+            } else if constexpr (scalar<T>) {
+                beginRow(label, false, column);
+                drawScalar(value);
+            } else if constexpr (described<T>) {
+                bool open = beginRow(label, true, column);
+                ImGui::TextDisabled("{...}");
+                if (open) {
+                    watchFields<T>::visit(value, [column](const char *name, const auto &field) {
+                        drawValue(name, field, column);
+                    });
+                    ImGui::TreePop();
+                }
+            } else if constexpr (range<T>) {
+                bool open = beginRow(label, true, column);
+                ImGui::TextDisabled("[%zu]", (size_t) std::size(value));
+                if (open) {
+                    drawRange(value, column);
+                    ImGui::TreePop();
+                }
+            } else {
+                static_assert(sizeof(T) == 0, "Specialise engine::watchFields<T> to watch this type");
+            }
+        }
+    }
+
+    /**
+     * @brief Type erased watch, samples its value only when drawn
+     */
+    class watchBase {
+
+    public:
+        explicit watchBase(std::string label) : m_label(std::move(label)) {}
+
+        virtual ~watchBase() = default;
+
+        /**
+         * @brief Samples the value and draws its rows
+         */
+        virtual void draw(float column) = 0;
+
+        [[nodiscard]] const std::string &label() const { return m_label; }
+
+        float height = 0.0f;    // Of the rows drawn last time, what a hidden watch keeps free
+
+    private:
+        std::string m_label;
+    };
+
+    template<typename Getter>
+    class watchEntry : public watchBase {
+
+    public:
+        watchEntry(std::string label, Getter getter) : watchBase(std::move(label)), m_getter(std::move(getter)) {}
+
+        void draw(float column) override {
+            // Binds to the watched object if the getter returns a reference, nothing is copied
+            decltype(auto) value = m_getter();
+            watch_detail::drawValue(label().c_str(), value, column);
+        }
+
+    private:
+        Getter m_getter;
+    };
+
+    struct watchStatistics {
+        size_t watches = 0;
+        size_t panels = 0;
+        size_t sampled = 0;     // Getters invoked in the last frame
+        size_t skipped = 0;     // Watches in collapsed or hidden panels or scrolled out of view
+    };
+
+    /**
+     * @brief Watches values and draws them into panels, one ImGui window per panel.
+     *
+     * A watch is named "panel/label", without a panel it goes to "Watches". Getters are only invoked for
+     * watches that are on screen: nothing in a collapsed panel, nothing scrolled out of view. Widgets are
+     * chosen at compile time: numbers, bools, enums and text get a row, arrays and containers an expandable
+     * list, structs one row per field once watchFields is specialised. Only use from the main thread.
+     */
+    class watchRegistry {
+
+    public:
+        /**
+         * @param value Has to outlive the watch
+         */
+        template<typename T>
+        requires (!std::is_function_v<T>)
+        void add(const std::string &name, const T *value) {
+            add(name, [value]() -> const T & { return *value; });
+        }
+
+        /**
+         * @param getter Invoked on the main thread whenever the watch is visible, may return by value or reference
+         */
+        template<typename Getter>
+        requires std::invocable<Getter &>
+        void add(const std::string &name, Getter getter) {
+            auto [panel, label] = splitName(name);
+            insert(panel, std::make_unique<watchEntry<Getter>>(label, std::move(getter)));
+        }
+
+        /**
+         * @return false if there is no watch with that name
+         */
+        bool remove(const std::string &name);
+
+        void clear();
+
+        [[nodiscard]] bool empty() const { return m_panels.empty(); }
+
+        /**
+         * @brief Draws every panel, called by the window after the update callback
+         */
+        void draw();
+
+        [[nodiscard]] const watchStatistics &stats() const { return m_stats; }
+
+    private:
+        struct panel {
+            std::string name;
+            std::vector<std::unique_ptr<watchBase>> watches;
+        };
+
+        static std::pair<std::string, std::string> splitName(const std::string &name);
+
+        void insert(const std::string &panelName, std::unique_ptr<watchBase> watch);
+
+        std::vector<panel> m_panels;
+        watchStatistics m_stats;
+    };
+
+} // engine
+
+#endif //EASYGRAPHICSLIB_WATCH_H
@@ -2,10 +2,15 @@
 // Created by drook207 on 12.03.2023.
 //
 #include "imgui.h"
+#include "imgui_internal.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_vulkan.h"
 #include <cstdio>          // printf, fprintf
 #include <cstdlib>         // abort
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <thread>
 
 #define GLFW_INCLUDE_NONE
 #define GLFW_INCLUDE_VULKAN
@@ -13,6 +18,9 @@
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan.h>
 #include "window.h"
+#include "imagewriter.h"
+#include "profiler.h"
+#include "vkutils.h"
 
 // [Win32] Our example includes a copy of glfw3.lib pre-compiled with VS2010 to maximize ease of testing and compatibility with old VS compilers.
 // To link with VS2010-era libraries, VS2015+ requires linking with legacy_stdio_definitions.lib, which we do using this pragma.
@@ -22,176 +30,82 @@
 #endif
 
 //#define IMGUI_UNLIMITED_FRAME_RATE
-#ifdef _DEBUG
-#define IMGUI_VULKAN_DEBUG_REPORT
-#endif
 
 
 namespace engine {
 
     static const ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
 
-    static void glfw_error_callback(int error, const char *description) {
-        fprintf(stderr, "GLFW Error %d: %s\n", error, description);
-    }
-
-    static void check_vk_result(VkResult err) {
-        if (err == 0)
-            return;
-        fprintf(stderr, "[vulkan] Error: VkResult = %d\n", err);
-        if (err < 0)
-            abort();
-    }
+#ifdef IMGUI_UNLIMITED_FRAME_RATE
+    static const presentProfile default_present_profile = presentProfile::throughput;
+#else
+    static const presentProfile default_present_profile = presentProfile::powerSaving;
+#endif
 
-#ifdef IMGUI_VULKAN_DEBUG_REPORT
-    static VKAPI_ATTR VkBool32 VKAPI_CALL debug_report(VkDebugReportFlagsEXT flags, VkDebugReportObjectTypeEXT objectType, uint64_t object, size_t location, int32_t messageCode, const char* pLayerPrefix, const char* pMessage, void* pUserData)
-{
-    (void)flags; (void)object; (void)location; (void)messageCode; (void)pUserData; (void)pLayerPrefix; // Unused arguments
-    fprintf(stderr, "[vulkan] Debug report from ObjectType: %i\nMessage: %s\n\n", objectType, pMessage);
-    return VK_FALSE;
-}
-#endif // IMGUI_VULKAN_DEBUG_REPORT
+    // ImGui needs a few frames after an event until hover states and layout have settled
+    static const int idle_settle_frames = 3;
 
-    void window::setupVulkan() {
+    // A drag resize rebuilds the swapchain at most this often, the last size always gets its rebuild
+    static const double default_resize_debounce_ms = 32.0;
 
-        // Create Vulkan Instance
-        {
-            uint32_t extensions_count = 0;
-            const char **extensions = glfwGetRequiredInstanceExtensions(&extensions_count);
-
-            VkInstanceCreateInfo create_info = {};
-            create_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
-            create_info.enabledExtensionCount = extensions_count;
-            create_info.ppEnabledExtensionNames = extensions;
-#ifdef IMGUI_VULKAN_DEBUG_REPORT
-            // Enabling validation layers
-        const char* layers[] = { "VK_LAYER_KHRONOS_validation" };
-        create_info.enabledLayerCount = 1;
-        create_info.ppEnabledLayerNames = layers;
-
-        // Enable debug report extension (we need additional storage, so we duplicate the user array to add our new extension to it)
-        const char** extensions_ext = (const char**)malloc(sizeof(const char*) * (extensions_count + 1));
-        memcpy(extensions_ext, extensions, extensions_count * sizeof(const char*));
-        extensions_ext[extensions_count] = "VK_EXT_debug_report";
-        create_info.enabledExtensionCount = extensions_count + 1;
-        create_info.ppEnabledExtensionNames = extensions_ext;
-
-        // Create Vulkan Instance
-        err = vkCreateInstance(&create_info, g_Allocator, &g_Instance);
-        check_vk_result(err);
-        free(extensions_ext);
-
-        // Get the function pointer (required for any extensions)
-        auto vkCreateDebugReportCallbackEXT = (PFN_vkCreateDebugReportCallbackEXT)vkGetInstanceProcAddr(g_Instance, "vkCreateDebugReportCallbackEXT");
-        IM_ASSERT(vkCreateDebugReportCallbackEXT != NULL);
-
-        // Setup the debug report callback
-        VkDebugReportCallbackCreateInfoEXT debug_report_ci = {};
-        debug_report_ci.sType = VK_STRUCTURE_TYPE_DEBUG_REPORT_CALLBACK_CREATE_INFO_EXT;
-        debug_report_ci.flags = VK_DEBUG_REPORT_ERROR_BIT_EXT | VK_DEBUG_REPORT_WARNING_BIT_EXT | VK_DEBUG_REPORT_PERFORMANCE_WARNING_BIT_EXT;
-        debug_report_ci.pfnCallback = debug_report;
-        debug_report_ci.pUserData = NULL;
-        err = vkCreateDebugReportCallbackEXT(g_Instance, &debug_report_ci, g_Allocator, &g_DebugReport);
-        check_vk_result(err);
+    // The cache of the user, the shared temp directory would let anyone plant pipeline data for us to load
+    static std::string default_pipeline_cache_path() {
+        std::filesystem::path dir;
+#ifdef _WIN32
+        if (const char *local = getenv("LOCALAPPDATA"); local != nullptr && *local != '\0')
+            dir = local;
 #else
-            // Create Vulkan Instance without any debug feature
-            m_err = vkCreateInstance(&create_info, m_allocator, &m_instance);
-            check_vk_result(m_err);
-            IM_UNUSED(m_debugReport);
+        if (const char *xdg = getenv("XDG_CACHE_HOME"); xdg != nullptr && *xdg == '/')
+            dir = xdg;
+        else if (const char *home = getenv("HOME"); home != nullptr && *home == '/')
+            dir = std::filesystem::path(home) / ".cache";
 #endif
-        }
-
-        // Select GPU
-        {
-            uint32_t gpu_count;
-            m_err = vkEnumeratePhysicalDevices(m_instance, &gpu_count, nullptr);
-            check_vk_result(m_err);
-            IM_ASSERT(gpu_count > 0);
+        if (dir.empty())
+            return "";
+        return (dir / "EasyGraphicsLib" / "pipeline_cache.bin").string();
+    }
 
-            auto *gpus = (VkPhysicalDevice *) malloc(sizeof(VkPhysicalDevice) * gpu_count);
-            m_err = vkEnumeratePhysicalDevices(m_instance, &gpu_count, gpus);
-            check_vk_result(m_err);
+    static void glfw_error_callback(int error, const char *description) {
+        fprintf(stderr, "GLFW Error %d: %s\n", error, description);
+    }
 
-            // If a number >1 of GPUs got reported, find discrete GPU if present, or use first one available. This covers
-            // most common cases (multi-gpu/integrated+dedicated graphics). Handling more complicated setups (multiple
-            // dedicated GPUs) is out of scope of this sample.
-            int use_gpu = 0;
-            for (int i = 0; i < (int) gpu_count; i++) {
-                VkPhysicalDeviceProperties properties;
-                vkGetPhysicalDeviceProperties(gpus[i], &properties);
-                if (properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
-                    use_gpu = i;
-                    break;
-                }
-            }
+    // GLFW is initialized by the first window and terminated with the last one
+    static int glfw_users = 0;
 
-            m_physicalDevice = gpus[use_gpu];
-            free(gpus);
+    static bool glfw_acquire() {
+        if (glfw_users == 0) {
+            glfwSetErrorCallback(glfw_error_callback);
+            if (!glfwInit())
+                return false;
         }
+        glfw_users++;
+        return true;
+    }
 
-        // Select graphics queue family
-        {
-            uint32_t count;
-            vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &count, nullptr);
-            auto *queues = (VkQueueFamilyProperties *) malloc(sizeof(VkQueueFamilyProperties) * count);
-            vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &count, queues);
-            for (uint32_t i = 0; i < count; i++)
-                if (queues[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
-                    m_queueFamily = i;
-                    break;
-                }
-            free(queues);
-            IM_ASSERT(m_queueFamily != (uint32_t) -1);
-        }
+    static void glfw_release() {
+        if (--glfw_users == 0)
+            glfwTerminate();
+    }
 
-        // Create Logical Device (with 1 queue)
-        {
-            int device_extension_count = 1;
-            const char *device_extensions[] = {"VK_KHR_swapchain"};
-            const float queue_priority[] = {1.0f};
-            VkDeviceQueueCreateInfo queue_info[1] = {};
-            queue_info[0].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-            queue_info[0].queueFamilyIndex = m_queueFamily;
-            queue_info[0].queueCount = 1;
-            queue_info[0].pQueuePriorities = queue_priority;
-            VkDeviceCreateInfo create_info = {};
-            create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-            create_info.queueCreateInfoCount = sizeof(queue_info) / sizeof(queue_info[0]);
-            create_info.pQueueCreateInfos = queue_info;
-            create_info.enabledExtensionCount = device_extension_count;
-            create_info.ppEnabledExtensionNames = device_extensions;
-            m_err = vkCreateDevice(m_physicalDevice, &create_info, m_allocator, &m_device);
-            check_vk_result(m_err);
-            vkGetDeviceQueue(m_device, m_queueFamily, 0, &m_queue);
-        }
+    // The render thread records with whatever ImGui context is current, so it only runs while there is one
+    static int imgui_contexts = 0;
 
-        // Create Descriptor Pool
-        {
-            VkDescriptorPoolSize pool_sizes[] =
-                    {
-                            {VK_DESCRIPTOR_TYPE_SAMPLER,                1000},
-                            {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1000},
-                            {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,          1000},
-                            {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          1000},
-                            {VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER,   1000},
-                            {VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER,   1000},
-                            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,         1000},
-                            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         1000},
-                            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1000},
-                            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1000},
-                            {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,       1000}
-                    };
-            VkDescriptorPoolCreateInfo pool_info = {};
-            pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-            pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-            pool_info.maxSets = 1000 * IM_ARRAYSIZE(pool_sizes);
-            pool_info.poolSizeCount = (uint32_t) IM_ARRAYSIZE(pool_sizes);
-            pool_info.pPoolSizes = pool_sizes;
-            m_err = vkCreateDescriptorPool(m_device, &pool_info, m_allocator, &m_descriptorPool);
-            check_vk_result(m_err);
+    // Platform windows of several ImGui contexts would receive each other's events, only one window gets them.
+    // Their events still go through ImGui's own callbacks and reach whichever context is current while polling
+    static const void *platform_windows_owner = nullptr;
+
+    /**
+     * @brief Makes an ImGui context current until the end of the scope
+     */
+    struct imgui_context_scope {
+        ImGuiContext *previous;
+
+        explicit imgui_context_scope(ImGuiContext *context) : previous(ImGui::GetCurrentContext()) {
+            ImGui::SetCurrentContext(context);
         }
-    }
 
+        ~imgui_context_scope() { ImGui::SetCurrentContext(previous); }
+    };
 
     // All the ImGui_ImplVulkanH_XXX structures/functions are optional helpers used by the demo.
 // Your real engine/app may not use them.
@@ -216,32 +130,14 @@ namespace engine {
                                                                     requestSurfaceColorSpace);
 
         // Select Present Mode
-#ifdef IMGUI_UNLIMITED_FRAME_RATE
-        VkPresentModeKHR present_modes[] = { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_FIFO_KHR };
-#else
-        VkPresentModeKHR present_modes[] = {VK_PRESENT_MODE_FIFO_KHR};
-#endif
-        m_wd->PresentMode = ImGui_ImplVulkanH_SelectPresentMode(m_physicalDevice, m_wd->Surface, &present_modes[0],
-                                                                IM_ARRAYSIZE(present_modes));
+        m_wd->PresentMode = selectPresentMode();
         //printf("[vulkan] Selected PresentMode = %d\n", wd->PresentMode);
 
         // Create SwapChain, RenderPass, Framebuffer, etc.
         IM_ASSERT(m_minImageCount >= 2);
         ImGui_ImplVulkanH_CreateOrResizeWindow(m_instance, m_physicalDevice, m_device, m_wd, m_queueFamily, m_allocator,
                                                m_width, m_height, m_minImageCount);
-    }
-
-    void window::cleanupVulkan() {
-        vkDestroyDescriptorPool(m_device, m_descriptorPool, m_allocator);
-
-#ifdef IMGUI_VULKAN_DEBUG_REPORT
-        // Remove the debug report callback
-    auto vkDestroyDebugReportCallbackEXT = (PFN_vkDestroyDebugReportCallbackEXT)vkGetInstanceProcAddr(g_Instance, "vkDestroyDebugReportCallbackEXT");
-    vkDestroyDebugReportCallbackEXT(g_Instance, g_DebugReport, g_Allocator);
-#endif // IMGUI_VULKAN_DEBUG_REPORT
-
-        vkDestroyDevice(m_device, m_allocator);
-        vkDestroyInstance(m_instance, m_allocator);
+        m_lastSwapchainResize = std::chrono::steady_clock::now();
     }
 
     void window::cleanupVulkanWindow() {
@@ -249,36 +145,38 @@ namespace engine {
     }
 
     void window::frameRender() {
+        if (m_headless) {
+            frameRenderOffscreen();
+            return;
+        }
 
+        // The frame context decides how far the CPU runs ahead, not the number of swapchain images
+        double fence_wait = m_frameRing.next();
+        m_profiler.addPhaseTime(m_recordFrameNumber, framePhase::fenceWait, fence_wait);
+        frameContext &context = m_frameRing.current();
+        m_profiler.collectGpu(m_frameRing.currentSlot());
 
-        VkSemaphore image_acquired_semaphore = m_wd->FrameSemaphores[m_wd->SemaphoreIndex].ImageAcquiredSemaphore;
-        VkSemaphore render_complete_semaphore = m_wd->FrameSemaphores[m_wd->SemaphoreIndex].RenderCompleteSemaphore;
-        m_err = vkAcquireNextImageKHR(m_device, m_wd->Swapchain, UINT64_MAX, image_acquired_semaphore, VK_NULL_HANDLE,
+        m_err = vkAcquireNextImageKHR(m_device, m_wd->Swapchain, UINT64_MAX, context.imageAcquired, VK_NULL_HANDLE,
                                       &m_wd->FrameIndex);
-        if (m_err == VK_ERROR_OUT_OF_DATE_KHR || m_err == VK_SUBOPTIMAL_KHR) {
+        if (m_err == VK_ERROR_OUT_OF_DATE_KHR) {
             m_swapChainRebuild = true;
             return;
         }
-        check_vk_result(m_err);
-
-        ImGui_ImplVulkanH_Frame *fd = &m_wd->Frames[m_wd->FrameIndex];
-        {
-            m_err = vkWaitForFences(m_device, 1, &fd->Fence, VK_TRUE,
-                                    UINT64_MAX);    // wait indefinitely instead of periodically checking
+        // A suboptimal image is still acquired, so it has to be presented before the swapchain is rebuilt
+        if (m_err == VK_SUBOPTIMAL_KHR)
+            m_swapChainRebuild = true;
+        else
             check_vk_result(m_err);
+        m_imageAcquired = true;
+        m_acquireCount.fetch_add(1, std::memory_order_release);
 
-            m_err = vkResetFences(m_device, 1, &fd->Fence);
-            check_vk_result(m_err);
-        }
-        {
-            m_err = vkResetCommandPool(m_device, fd->CommandPool, 0);
-            check_vk_result(m_err);
-            VkCommandBufferBeginInfo info = {};
-            info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-            info.flags |= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-            m_err = vkBeginCommandBuffer(fd->CommandBuffer, &info);
-            check_vk_result(m_err);
-        }
+        // Signaled again only once the image is acquired again, after its present is done with the semaphore
+        VkSemaphore render_complete_semaphore = m_wd->FrameSemaphores[m_wd->FrameIndex].RenderCompleteSemaphore;
+        ImGui_ImplVulkanH_Frame *fd = &m_wd->Frames[m_wd->FrameIndex];
+        VkCommandBuffer command_buffer = m_frameRing.begin();
+        m_profiler.writeGpuBegin(command_buffer, m_frameRing.currentSlot(), m_recordFrameNumber);
+        m_uploads.recordAcquires(command_buffer);
+        m_heatmaps.record(command_buffer);
         {
             VkRenderPassBeginInfo info = {};
             info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -288,37 +186,105 @@ namespace engine {
             info.renderArea.extent.height = m_wd->Height;
             info.clearValueCount = 1;
             info.pClearValues = &m_wd->ClearValue;
-            vkCmdBeginRenderPass(fd->CommandBuffer, &info, VK_SUBPASS_CONTENTS_INLINE);
+            vkCmdBeginRenderPass(command_buffer, &info, VK_SUBPASS_CONTENTS_INLINE);
         }
 
         // Record dear imgui primitives into command buffer
-        ImGui_ImplVulkan_RenderDrawData(m_mainDrawData, fd->CommandBuffer);
+        m_plots.beginRecording(command_buffer, m_recordDrawData);
+        ImGui_ImplVulkan_RenderDrawData(m_recordDrawData, command_buffer);
+        m_plots.endRecording();
 
         // Submit command buffer
-        vkCmdEndRenderPass(fd->CommandBuffer);
+        vkCmdEndRenderPass(command_buffer);
+        m_profiler.writeGpuEnd(command_buffer, m_frameRing.currentSlot());
         {
             VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
             VkSubmitInfo info = {};
             info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
             info.waitSemaphoreCount = 1;
-            info.pWaitSemaphores = &image_acquired_semaphore;
+            info.pWaitSemaphores = &context.imageAcquired;
             info.pWaitDstStageMask = &wait_stage;
             info.commandBufferCount = 1;
-            info.pCommandBuffers = &fd->CommandBuffer;
+            info.pCommandBuffers = &command_buffer;
             info.signalSemaphoreCount = 1;
             info.pSignalSemaphores = &render_complete_semaphore;
 
-            m_err = vkEndCommandBuffer(fd->CommandBuffer);
+            m_err = vkEndCommandBuffer(command_buffer);
             check_vk_result(m_err);
-            m_err = vkQueueSubmit(m_queue, 1, &info, fd->Fence);
+            {
+                std::lock_guard<std::mutex> lock(m_context->queueMutex());
+                m_err = vkQueueSubmit(m_queue, 1, &info, context.fence);
+            }
             check_vk_result(m_err);
+            m_lastSubmitFence = context.fence;
+            context.frame = m_recordFrameNumber + 1;
+            recordSubmit();
+        }
+    }
+
+    /**
+     * @brief Records the same ImGui draw data into the offscreen target, optionally followed by a readback copy
+     */
+    void window::frameRenderOffscreen() {
+        VkCommandBuffer command_buffer = m_offscreen.beginFrame();
+        m_profiler.addPhaseTime(m_recordFrameNumber, framePhase::fenceWait, m_offscreen.lastFenceWait());
+        m_profiler.collectGpu(m_offscreen.currentSlot());
+        m_profiler.writeGpuBegin(command_buffer, m_offscreen.currentSlot(), m_recordFrameNumber);
+        m_uploads.recordAcquires(command_buffer);
+        m_heatmaps.record(command_buffer);
+        m_offscreen.beginRenderPass(m_clearValue);
+
+        // Record dear imgui primitives into command buffer
+        m_plots.beginRecording(command_buffer, m_recordDrawData);
+        ImGui_ImplVulkan_RenderDrawData(m_recordDrawData, command_buffer);
+        m_plots.endRecording();
+
+        m_offscreen.endRenderPass();
+        m_profiler.writeGpuEnd(command_buffer, m_offscreen.currentSlot());
+
+        bool readback = m_readbackRequested;
+        if (readback) {
+            m_readbackPaths.emplace_back(m_offscreen.currentFrameNumber(), m_readbackPath);
+            m_readbackRequested = false;
+        }
+        m_offscreen.endFrame(m_queue, readback, &m_context->queueMutex());
+        recordSubmit();
+    }
+
+    /**
+     * @brief Called by the offscreen target once the GPU finished copying a requested frame
+     */
+    void window::onReadbackComplete(const uint8_t *rgba, uint32_t width, uint32_t height, uint64_t frameNumber) {
+        std::string path;
+        while (!m_readbackPaths.empty() && m_readbackPaths.front().first <= frameNumber) {
+            if (m_readbackPaths.front().first == frameNumber)
+                path = m_readbackPaths.front().second;
+            m_readbackPaths.pop_front();
+        }
+
+        if (m_onReadback != nullptr)
+            m_onReadback(rgba, width, height, frameNumber);
+
+        if (!path.empty()) {
+            // The mapped buffer is reused by a later frame, so the writer thread gets its own copy
+            std::vector<uint8_t> pixels(rgba, rgba + (size_t) width * height * 4);
+            m_pendingWrites.erase(std::remove_if(m_pendingWrites.begin(), m_pendingWrites.end(),
+                                                 [](const std::future<void> &f) {
+                                                     return f.wait_for(std::chrono::seconds(0)) ==
+                                                            std::future_status::ready;
+                                                 }), m_pendingWrites.end());
+            m_pendingWrites.push_back(std::async(std::launch::async, [path, pixels = std::move(pixels), width, height]() {
+                if (!writeImage(path, pixels.data(), width, height))
+                    fprintf(stderr, "Failed to write readback to %s\n", path.c_str());
+            }));
         }
     }
 
     void window::framePresent() {
-        if (m_swapChainRebuild)
+        if (!m_imageAcquired)
             return;
-        VkSemaphore render_complete_semaphore = m_wd->FrameSemaphores[m_wd->SemaphoreIndex].RenderCompleteSemaphore;
+        m_imageAcquired = false;
+        VkSemaphore render_complete_semaphore = m_wd->FrameSemaphores[m_wd->FrameIndex].RenderCompleteSemaphore;
         VkPresentInfoKHR info = {};
         info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
         info.waitSemaphoreCount = 1;
@@ -326,51 +292,51 @@ namespace engine {
         info.swapchainCount = 1;
         info.pSwapchains = &m_wd->Swapchain;
         info.pImageIndices = &m_wd->FrameIndex;
-        m_err = vkQueuePresentKHR(m_queue, &info);
-        if (m_err == VK_ERROR_OUT_OF_DATE_KHR || m_err == VK_SUBOPTIMAL_KHR) {
-            m_swapChainRebuild = true;
-            return;
+        {
+            std::lock_guard<std::mutex> lock(m_context->queueMutex());
+            m_err = vkQueuePresentKHR(m_queue, &info);
         }
-        check_vk_result(m_err);
-        m_wd->SemaphoreIndex =
-                (m_wd->SemaphoreIndex + 1) % m_wd->ImageCount; // Now we can use the next set of semaphores
+        if (m_err == VK_ERROR_OUT_OF_DATE_KHR || m_err == VK_SUBOPTIMAL_KHR)
+            m_swapChainRebuild = true;
+        else
+            check_vk_result(m_err);
     }
 
     int window::create() {
-        glfwSetErrorCallback(glfw_error_callback);
-        if (!glfwInit())
-            return 1;
-
-        // Create window with Vulkan context
-        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-        m_pWindow = glfwCreateWindow(m_width, m_height, "Dear ImGui GLFW+Vulkan example", nullptr, nullptr);
-        if (!glfwVulkanSupported()) {
-            printf("GLFW: Vulkan Not Supported\n");
-            return 1;
+        auto startup_start = std::chrono::steady_clock::now();
+        auto step_start = startup_start;
+        // Adds the time since the previous main thread step to the startup report
+        auto main_step = [this, &step_start](const char *name) {
+            auto now = std::chrono::steady_clock::now();
+            m_profiler.addStartupStep(name, std::chrono::duration<double, std::milli>(now - step_start).count());
+            step_start = now;
+        };
+
+        if (!m_headless) {
+            if (!glfw_acquire())
+                return 1;
+            if (!glfwVulkanSupported()) {
+                printf("GLFW: Vulkan Not Supported\n");
+                glfw_release();
+                return 1;
+            }
+            main_step("glfw init");
         }
 
-        setupVulkan();
-
-        // Create Window Surface
-
-        m_err = glfwCreateWindowSurface(m_instance, m_pWindow, m_allocator, &m_surface);
-        check_vk_result(m_err);
-
-        // Create Framebuffers
-        int w, h;
-        glfwGetFramebufferSize(m_pWindow, &w, &h);
-        m_wd = &m_mainWindowData;
-        setupVulkanWindow();
-
-        // Setup Dear ImGui context
+        // Setup Dear ImGui context, every window has its own
         IMGUI_CHECKVERSION();
-        ImGui::CreateContext();
+        m_imguiContext = ImGui::CreateContext();
+        imgui_contexts++;
+        ImGui::SetCurrentContext(m_imguiContext);
         ImGuiIO &io = ImGui::GetIO();
         (void) io;
         io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;     // Enable Keyboard Controls
         io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
         io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;         // Enable Docking
-        io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;       // Enable Multi-Viewport / Platform Windows
+        if (!m_headless && m_platformWindows && platform_windows_owner == nullptr) {
+            platform_windows_owner = this;
+            io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;   // Enable Multi-Viewport / Platform Windows
+        }
         //io.ConfigViewportsNoAutoMerge = true;
         //io.ConfigViewportsNoTaskBarIcon = true;
 
@@ -385,24 +351,6 @@ namespace engine {
             style.Colors[ImGuiCol_WindowBg].w = 1.0f;
         }
 
-        // Setup Platform/Renderer backends
-        ImGui_ImplGlfw_InitForVulkan(m_pWindow, true);
-        ImGui_ImplVulkan_InitInfo init_info = {};
-        init_info.Instance = m_instance;
-        init_info.PhysicalDevice = m_physicalDevice;
-        init_info.Device = m_device;
-        init_info.QueueFamily = m_queueFamily;
-        init_info.Queue = m_queue;
-        init_info.PipelineCache = m_pipelineCache;
-        init_info.DescriptorPool = m_descriptorPool;
-        init_info.Subpass = 0;
-        init_info.MinImageCount = m_minImageCount;
-        init_info.ImageCount = m_wd->ImageCount;
-        init_info.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
-        init_info.Allocator = m_allocator;
-        init_info.CheckVkResultFn = check_vk_result;
-        ImGui_ImplVulkan_Init(&init_info, m_wd->RenderPass);
-
         // Load Fonts
         // - If no fonts are loaded, dear imgui will use the default font. You can also load multiple fonts and use ImGui::PushFont()/PopFont() to select them.
         // - AddFontFromFileTTF() will return the ImFont* so you can store it if you need to select the font among multiple.
@@ -419,54 +367,201 @@ namespace engine {
         //ImFont* font = io.Fonts->AddFontFromFileTTF("c:\\Windows\\Fonts\\ArialUni.ttf", 18.0f, NULL, io.Fonts->GetGlyphRangesJapanese());
         //IM_ASSERT(font != NULL);
 
-        // Upload Fonts
-        {
-            // Use any command queue
-            VkCommandPool command_pool = m_wd->Frames[m_wd->FrameIndex].CommandPool;
-            VkCommandBuffer command_buffer = m_wd->Frames[m_wd->FrameIndex].CommandBuffer;
-
-            m_err = vkResetCommandPool(m_device, command_pool, 0);
-            check_vk_result(m_err);
-            VkCommandBufferBeginInfo begin_info = {};
-            begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-            begin_info.flags |= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-            m_err = vkBeginCommandBuffer(command_buffer, &begin_info);
+        // Rasterizing the font atlas only needs the ImGui context, so it runs while the device is being created.
+        // Nothing else may touch io.Fonts until the future has been joined
+        std::future<double> font_atlas = std::async(std::launch::async, [&io]() {
+            auto start = std::chrono::steady_clock::now();
+            unsigned char *pixels;
+            int width, height;
+            io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        });
+
+        // Instance and device creation only needs the GLFW extension list, the window has to be created on the
+        // main thread. Further windows attach to the existing context
+        std::future<double> device_setup = std::async(std::launch::async, [this]() {
+            auto start = std::chrono::steady_clock::now();
+            deviceContextSettings settings;
+            settings.headless = m_headless;
+            settings.hostAllocator = m_hostMemoryEnabled;
+            settings.pipelineCachePath = m_pipelineCachePath;
+            settings.memoryBudget = m_memoryBudgetEnabled;
+            m_context = deviceContext::acquire(settings);
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        });
+        if (!m_headless) {
+            // Create window with Vulkan context
+            glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+            m_pWindow = glfwCreateWindow(m_width, m_height, "Dear ImGui GLFW+Vulkan example", nullptr, nullptr);
+            main_step("window");
+        }
+        m_profiler.addStartupStep("instance and device", device_setup.get(), true);
+        step_start = std::chrono::steady_clock::now();
+        m_allocator = m_context->allocator();
+        m_instance = m_context->instance();
+        m_physicalDevice = m_context->physicalDevice();
+        m_device = m_context->device();
+        m_queueFamily = m_context->queueFamily();
+        m_queue = m_context->queue();
+        m_transferQueueFamily = m_context->transferQueueFamily();
+        m_transferQueue = m_context->transferQueue();
+        m_descriptorPool = m_context->descriptorPool();
+        m_memory.create(m_context.get());
+
+        m_profiler.createGpuQueries(m_physicalDevice, m_device, m_queueFamily, m_allocator);
+        m_uploads.create(m_physicalDevice, m_device, m_queueFamily, m_queue, m_transferQueueFamily, m_transferQueue,
+                         m_allocator, uploadManager::defaultArenaSize, &m_context->queueMutex());
+
+        VkRenderPass render_pass;
+        uint32_t frame_count;
+        if (m_headless) {
+            // Render into offscreen images instead of a swapchain, one per frame in flight
+            m_offscreen.create(m_physicalDevice, m_device, m_queueFamily, m_allocator, m_width, m_height,
+                               m_framesInFlight);
+            m_offscreen.setReadbackCallback(
+                    [this](const uint8_t *rgba, uint32_t width, uint32_t height, uint64_t frameNumber) {
+                        onReadbackComplete(rgba, width, height, frameNumber);
+                    });
+            render_pass = m_offscreen.renderPass();
+            frame_count = m_offscreen.frameCount();
+        } else {
+            // Create Window Surface
+            m_err = glfwCreateWindowSurface(m_instance, m_pWindow, m_allocator, &m_surface);
             check_vk_result(m_err);
 
-            ImGui_ImplVulkan_CreateFontsTexture(command_buffer);
-
-            VkSubmitInfo end_info = {};
-            end_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            end_info.commandBufferCount = 1;
-            end_info.pCommandBuffers = &command_buffer;
-            m_err = vkEndCommandBuffer(command_buffer);
-            check_vk_result(m_err);
-            m_err = vkQueueSubmit(m_queue, 1, &end_info, VK_NULL_HANDLE);
-            check_vk_result(m_err);
+            // Create Framebuffers
+            m_wd = &m_mainWindowData;
+            setupVulkanWindow();
+            m_frameRing.create(m_device, m_queueFamily, m_allocator, m_framesInFlight);
+            render_pass = m_wd->RenderPass;
+            frame_count = m_frameRing.size();
+        }
+        main_step("swapchain");
+
+        // The plot and heatmap pipelines are built on workers while ImGui builds its own here, the pipeline cache
+        // is internally synchronized
+        VkPipelineCache pipeline_cache = m_context->pipelines().handle();
+        deviceAllocator &device_memory = m_context->deviceMemory();
+        std::future<double> plot_pipelines = std::async(std::launch::async, [=, this, &device_memory]() {
+            auto start = std::chrono::steady_clock::now();
+            m_plots.create(m_device, device_memory, render_pass, pipeline_cache, m_allocator, frame_count);
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        });
+        std::future<double> heatmap_pipelines = std::async(std::launch::async, [=, this, &device_memory]() {
+            auto start = std::chrono::steady_clock::now();
+            m_heatmaps.create(m_device, device_memory, m_descriptorPool, pipeline_cache, m_allocator, frame_count);
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        });
 
-            m_err = vkDeviceWaitIdle(m_device);
-            check_vk_result(m_err);
-            ImGui_ImplVulkan_DestroyFontUploadObjects();
+        // Setup Platform/Renderer backends
+        if (m_headless) {
+            // Without a platform backend we drive display size and time ourselves
+            io.DisplaySize = ImVec2((float) m_width, (float) m_height);
+            io.IniFilename = nullptr;
+        } else {
+            // Resize and expose events are not seen by ImGui, the idle mode needs them to redraw
+            glfwSetWindowUserPointer(m_pWindow, this);
+            glfwSetFramebufferSizeCallback(m_pWindow, glfwFramebufferSizeCallback);
+            glfwSetWindowRefreshCallback(m_pWindow, glfwWindowRefreshCallback);
+            glfwSetWindowFocusCallback(m_pWindow, glfwWindowFocusCallback);
+            glfwSetCursorEnterCallback(m_pWindow, glfwCursorEnterCallback);
+            glfwSetCursorPosCallback(m_pWindow, glfwCursorPosCallback);
+            glfwSetMouseButtonCallback(m_pWindow, glfwMouseButtonCallback);
+            glfwSetScrollCallback(m_pWindow, glfwScrollCallback);
+            glfwSetKeyCallback(m_pWindow, glfwKeyCallback);
+            glfwSetCharCallback(m_pWindow, glfwCharCallback);
+            ImGui_ImplGlfw_InitForVulkan(m_pWindow, false);
         }
+        ImGui_ImplVulkan_InitInfo init_info = {};
+        init_info.Instance = m_instance;
+        init_info.PhysicalDevice = m_physicalDevice;
+        init_info.Device = m_device;
+        init_info.QueueFamily = m_queueFamily;
+        init_info.Queue = m_queue;
+        init_info.PipelineCache = pipeline_cache;
+        init_info.DescriptorPool = m_descriptorPool;
+        init_info.Subpass = 0;
+        init_info.MinImageCount = m_minImageCount;
+        // The backend rotates its vertex buffers on every draw, so it gets one for the most frames in flight
+        // setFramesInFlight() may ask for later
+        init_info.ImageCount = m_headless ? frame_count : std::max(m_wd->ImageCount, frameRing::maxFramesInFlight);
+        init_info.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
+        init_info.Allocator = m_allocator;
+        init_info.CheckVkResultFn = check_vk_result;
+        ImGui_ImplVulkan_Init(&init_info, render_pass);
+        if (m_parallelViewports && (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable))
+            m_viewports.create(*m_context, pipeline_cache, (uint32_t) m_minImageCount);
+        m_viewports.setResizeDebounce(m_resizeDebounceMs);
+        main_step("imgui backend");
+        m_profiler.addStartupStep("plot pipelines", plot_pipelines.get(), true);
+        m_profiler.addStartupStep("heatmap pipelines", heatmap_pipelines.get(), true);
+        m_profiler.addStartupStep("font atlas", font_atlas.get(), true);
+        step_start = std::chrono::steady_clock::now();
 
+        // Upload Fonts
+        // The first frame is submitted to the same queue afterwards, so nothing has to wait here. The staging
+        // objects are released once the upload batch has been retired
+        m_uploads.recordGraphics([](VkCommandBuffer command_buffer) {
+            ImGui_ImplVulkan_CreateFontsTexture(command_buffer);
+        }, []() {
+            ImGui_ImplVulkan_DestroyFontUploadObjects();
+        });
+        m_uploads.flush();
+        main_step("font upload");
 
+        m_profiler.setStartupTotal(
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startup_start).count());
         return 0;
     }
 
     void window::cleanup() {
+        ImGui::SetCurrentContext(m_imguiContext);
+        m_renderThread.stop();
+        m_scheduler.stop();
+        stopCapture();
 
         // Cleanup
         m_err = vkDeviceWaitIdle(m_device);
         check_vk_result(m_err);
+        m_retiredPresents.flush();
+        m_retiredSwapchains.flush();
+        if (m_headless) {
+            // Deliver outstanding readbacks and finish writing them before the buffers go away
+            m_offscreen.flush();
+            for (auto &write: m_pendingWrites)
+                write.wait();
+            m_pendingWrites.clear();
+        }
+        m_uploads.destroy();
+        m_plots.destroy();
+        m_heatmaps.destroy();
         ImGui_ImplVulkan_Shutdown();
-        ImGui_ImplGlfw_Shutdown();
-        ImGui::DestroyContext();
-
-        cleanupVulkanWindow();
-        cleanupVulkan();
-
-        glfwDestroyWindow(m_pWindow);
-        glfwTerminate();
+        m_viewports.destroy();
+        if (!m_headless)
+            ImGui_ImplGlfw_Shutdown();
+        ImGui::DestroyContext(m_imguiContext);
+        m_imguiContext = nullptr;
+        imgui_contexts--;
+        if (platform_windows_owner == this)
+            platform_windows_owner = nullptr;
+
+        if (m_headless) {
+            m_offscreen.destroy();
+        } else {
+            m_frameRing.destroy();
+            cleanupVulkanWindow();
+        }
+        m_profiler.destroyGpuQueries();
+        m_memory.destroy();
+        // The last window releasing the context destroys the device
+        m_context.reset();
+        m_device = VK_NULL_HANDLE;
+
+        if (!m_headless) {
+            glfwDestroyWindow(m_pWindow);
+            m_pWindow = nullptr;
+            glfw_release();
+        }
 
     }
 
@@ -474,80 +569,883 @@ namespace engine {
  * @brief Main update loop
  */
     void window::update() {
+        ImGui::SetCurrentContext(m_imguiContext);
         // Main loop
-        while (!glfwWindowShouldClose(m_pWindow)) {
+        while (!shouldClose()) {
+            if (m_idleMode && !m_headless) {
+                waitForRedraw();
+                if (shouldClose())
+                    break;
+            }
+            updateFrame();
+        }
+
+    }
+
+    /**
+     * @brief Runs exactly one iteration of the main loop: events, ImGui frame, render and present
+     */
+    void window::updateFrame() {
+        // Several windows can be updated in turn from the same thread
+        ImGui::SetCurrentContext(m_imguiContext);
+        applyPipelining();
+        applyFramesInFlight();
+        m_profiler.beginFrame(m_frameCount);
+
+        // Anything that caused this frame keeps ImGui busy for a few more frames until it settled
+        bool dirty = m_dirty.exchange(false, std::memory_order_acq_rel);
+        if (dirty || (m_pWindow != nullptr && hasPendingInput()))
+            m_settleFrames = idle_settle_frames;
+        else if (m_settleFrames > 0)
+            m_settleFrames--;
+        m_lastRedraw = std::chrono::steady_clock::now();
+
+        if (m_headless) {
+            // Fixed time step keeps headless runs deterministic
+            ImGuiIO &io = ImGui::GetIO();
+            io.DeltaTime = 1.0f / 60.0f;
+            io.DisplaySize = ImVec2((float) m_width, (float) m_height);
+            limitFrameRate();
+            m_inputTime = std::chrono::steady_clock::now();
+        } else {
             // Poll and handle events (inputs, window resize, etc.)
             // You can read the io.WantCaptureMouse, io.WantCaptureKeyboard flags to tell if dear imgui wants to use your inputs.
             // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
             // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application, or clear/overwrite your copy of the keyboard data.
             // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
-            glfwPollEvents();
+            limitFrameRate();
+            {
+                scopedPhaseTimer timer(m_profiler, framePhase::pollEvents);
+                glfwPollEvents();
+            }
+            m_inputTime = std::chrono::steady_clock::now();
 
-            // Resize swap chain?
-            if (m_swapChainRebuild) {
+            // Resize swap chain? Rebuilt without waiting for the device, frames in flight finish on the old one.
+            // Rebuilds are at least the debounce interval apart, so a drag resize does not rebuild every frame
+            auto now = std::chrono::steady_clock::now();
+            if (m_swapChainRebuild &&
+                std::chrono::duration<double, std::milli>(now - m_lastSwapchainResize).count() >= m_resizeDebounceMs) {
                 int width, height;
                 glfwGetFramebufferSize(m_pWindow, &width, &height);
                 if (width > 0 && height > 0) {
-                    ImGui_ImplVulkan_SetMinImageCount(m_minImageCount);
-                    ImGui_ImplVulkanH_CreateOrResizeWindow(m_instance, m_physicalDevice, m_device, &m_mainWindowData,
-                                                           m_queueFamily, m_allocator, width, height, m_minImageCount);
-                    m_mainWindowData.FrameIndex = 0;
-                    m_swapChainRebuild = false;
+                    // The swapchain frames belong to the render thread while it records
+                    m_renderThread.waitIdle();
+                    m_mainWindowData.PresentMode = selectPresentMode();
+                    // The backend keeps the count it was initialized with, changing it there asserts in the docking
+                    // branch and would wait for the device and rebuild every viewport
+                    m_viewports.setMinImageCount((uint32_t) m_minImageCount);
+                    if (resizeSwapchain(m_physicalDevice, m_device, &m_mainWindowData, m_queueFamily, m_allocator,
+                                        width, height, (uint32_t) m_minImageCount, m_retiredSwapchains,
+                                        m_frameCount + 1, m_retiredPresents, m_acquireCount.load())) {
+                        m_presentedHash = 0;
+                        m_swapChainRebuild = false;
+                        m_lastSwapchainResize = now;
+                    }
                 }
             }
+            // An acquire may be recorded by the frame the render thread is still working on
+            m_retiredPresents.transfer(m_acquireCount.load(std::memory_order_acquire), m_retiredSwapchains,
+                                       m_frameCount + 1);
+            m_retiredSwapchains.collect(m_frameRing.completedFrame());
+        }
 
-            // Start the Dear ImGui frame
+        // Start the Dear ImGui frame
+        {
+            scopedPhaseTimer timer(m_profiler, framePhase::newFrame);
             ImGui_ImplVulkan_NewFrame();
-            ImGui_ImplGlfw_NewFrame();
+            if (!m_headless)
+                ImGui_ImplGlfw_NewFrame();
             ImGui::NewFrame();
+        }
+        m_uploads.collect();
+        // A finished upload does not change the draw data, its texture id was drawn before already
+        if (m_uploads.stats().batchesRetired != m_uploadsRetired) {
+            m_uploadsRetired = m_uploads.stats().batchesRetired;
+            dirty = true;
+            m_settleFrames = idle_settle_frames;
+        }
+        m_plots.newFrame();
 
+        {
+            scopedPhaseTimer timer(m_profiler, framePhase::channels);
+            drainChannels();
+            snapshotVariableFeeds();
+        }
 
-            if (m_onUpdateCallback != nullptr) {
-                m_onUpdateCallback();
-            }
+        {
+            scopedPhaseTimer timer(m_profiler, framePhase::updateCallback);
+            m_scheduler.run();
+            if (!m_watches.empty())
+                m_watches.draw();
+        }
+
+        if (m_showProfilerOverlay) {
+            m_profiler.drawOverlay(&m_showProfilerOverlay);
+            if (!m_scheduler.empty())
+                m_scheduler.drawOverlay();
+        }
+        if (m_showConsole)
+            m_console.draw("Console", &m_showConsole);
+        else
+            m_console.update();
+
+        // The ImGui backend holds one more set for the font atlas
+        m_memory.update(m_uploads.arenaSize() + m_heatmaps.stagingBytes(), m_heatmaps.descriptorSets() + 1);
+        if (m_showMemoryPanel)
+            m_memory.drawPanel(&m_showMemoryPanel);
+
+        // Uploads issued by the callbacks start copying before the frame gets recorded
+        m_uploads.flush();
 
-            // Rendering
+        // Rendering
+        {
+            scopedPhaseTimer timer(m_profiler, framePhase::render);
             ImGui::Render();
-            m_mainDrawData = ImGui::GetDrawData();
-            const bool main_is_minimized = (m_mainDrawData->DisplaySize.x <= 0.0f ||
-                                            m_mainDrawData->DisplaySize.y <= 0.0f);
-            m_wd->ClearValue.color.float32[0] = clear_color.x * clear_color.w;
-            m_wd->ClearValue.color.float32[1] = clear_color.y * clear_color.w;
-            m_wd->ClearValue.color.float32[2] = clear_color.z * clear_color.w;
-            m_wd->ClearValue.color.float32[3] = clear_color.w;
-            if (!main_is_minimized)
+        }
+        m_mainDrawData = ImGui::GetDrawData();
+        if (m_externalDrawData != nullptr && m_externalDrawData->Valid)
+            composeDrawData();
+        if (m_capture.isOpen()) {
+            scopedPhaseTimer timer(m_profiler, framePhase::render);
+            const ImGuiContext &g = *ImGui::GetCurrentContext();
+            double time = std::chrono::duration<double>(m_inputTime - m_captureStart).count();
+            if (!m_capture.writeFrame(m_mainDrawData, m_frameCount, time, ImGui::GetIO().DeltaTime,
+                                      g.InputEventsTrail.Data, (uint32_t) g.InputEventsTrail.Size))
+                m_capture.close();
+        }
+        const bool main_is_minimized = (m_mainDrawData->DisplaySize.x <= 0.0f ||
+                                        m_mainDrawData->DisplaySize.y <= 0.0f);
+        m_clearValue.color.float32[0] = clear_color.x * clear_color.w;
+        m_clearValue.color.float32[1] = clear_color.y * clear_color.w;
+        m_clearValue.color.float32[2] = clear_color.z * clear_color.w;
+        m_clearValue.color.float32[3] = clear_color.w;
+        bool skip = false;
+        if (!main_is_minimized && m_frameSkipping && !m_headless) {
+            // The image on screen already shows this frame unless something outside the draw data changed
+            bool callbacks;
+            uint64_t hash;
+            {
+                scopedPhaseTimer timer(m_profiler, framePhase::render);
+                hash = hashDrawData(m_mainDrawData, &callbacks, &m_skipStats.hashedBytes);
+            }
+            m_skipStats.hashedFrames++;
+            if (callbacks)
+                m_skipStats.callbackFrames++;
+            skip = hash == m_presentedHash && !callbacks && !dirty && !m_heatmaps.hasPendingWork();
+            m_presentedHash = hash;
+            if (skip)
+                m_skipStats.skippedFrames++;
+        }
+        if (!main_is_minimized && !skip) {
+            if (m_renderThread.running()) {
+                // Copied while the render thread may still record the previous frame from the other snapshot
+                drawDataSnapshot &snapshot = m_snapshots[m_snapshotIndex];
+                m_snapshotIndex ^= 1;
+                {
+                    scopedPhaseTimer timer(m_profiler, framePhase::render);
+                    snapshot.capture(m_mainDrawData);
+                }
+                {
+                    scopedPhaseTimer timer(m_profiler, framePhase::renderWait);
+                    m_renderThread.waitIdle();
+                }
+                collectSubmit();
+                prepareRecording(snapshot.data());
+                m_renderThread.submit();
+            } else {
+                scopedPhaseTimer timer(m_profiler, framePhase::frameRender);
+                prepareRecording(m_mainDrawData);
                 frameRender();
-            ImGuiIO &io = ImGui::GetIO();
-            (void) io;
-            // Update and Render additional Platform Windows
-            if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
+            }
+        }
+        ImGuiIO &io = ImGui::GetIO();
+        (void) io;
+        // Update and Render additional Platform Windows
+        if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
+            scopedPhaseTimer timer(m_profiler, framePhase::renderPlatformWindows);
+            if (m_viewports.active()) {
+                // Creating and resizing waits for the device idle, recording takes no lock at all
+                {
+                    std::lock_guard<std::mutex> lock(m_context->queueMutex());
+                    ImGui::UpdatePlatformWindows();
+                }
+                m_viewports.render();
+            } else {
+                // The backend creates, submits and presents on the queue the render thread uses as well
+                std::lock_guard<std::mutex> lock(m_context->queueMutex());
                 ImGui::UpdatePlatformWindows();
                 ImGui::RenderPlatformWindowsDefault();
             }
+        }
 
-            // Present Main Platform Window
-            if (!main_is_minimized)
+        // Present Main Platform Window
+        if (!m_renderThread.running()) {
+            if (!main_is_minimized && !skip && !m_headless) {
+                scopedPhaseTimer timer(m_profiler, framePhase::framePresent);
                 framePresent();
+            }
+            collectSubmit();
         }
 
+        m_profiler.endFrame();
+        m_frameCount++;
     }
 
-    window::window(int width, int height) :
-            m_width(width), m_height(height) {
+    /**
+     * @brief Whether the main loop should stop: the window was closed, requestClose() was called or the
+     * headless frame limit has been reached
+     */
+    bool window::shouldClose() const {
+        if (m_closeRequested)
+            return true;
+        if (m_headless)
+            return m_headlessFrameLimit > 0 && m_frameCount >= m_headlessFrameLimit;
+        return glfwWindowShouldClose(m_pWindow);
+    }
+
+    void window::requestClose() {
+        m_closeRequested = true;
+    }
+
+    /**
+     * @brief Switches to headless mode: no GLFW window, surface or swapchain, frames are rendered offscreen.
+     * Must be called before create()
+     * @param headless Enable or disable headless rendering
+     * @param frameLimit Number of frames update() renders before returning, 0 renders until requestClose()
+     */
+    void window::setHeadless(bool headless, uint64_t frameLimit) {
+        m_headless = headless;
+        m_headlessFrameLimit = frameLimit;
+    }
+
+    /**
+     * @brief Copies the next rendered frame back to host memory (headless mode only). The copy runs
+     * asynchronously and is delivered a few frames later to the readback callback
+     * @param path Optional file to write the frame to, .png writes PNG, anything else PPM
+     */
+    void window::requestReadback(const std::string &path) {
+        m_readbackRequested = true;
+        m_readbackPath = path;
+    }
+
+    /**
+     * @brief Registers a callback that receives the RGBA8 pixels of every completed readback.
+     * The pixel pointer is only valid for the duration of the call
+     */
+    void window::setReadbackCallback(const readbackCallback &cb) {
+        m_onReadback = cb;
+    }
+
+    /**
+     * @brief In idle mode update() blocks in glfwWaitEventsTimeout and only renders a frame for input,
+     * resizes, animations, markDirty() or new channel data, or when the minimum refresh interval elapsed
+     */
+    void window::setIdleMode(bool enabled) {
+        m_idleMode = enabled;
+        markDirty();
+    }
+
+    /**
+     * @brief Lowest rate at which idle mode still redraws without any event, e.g. for clocks. 0 disables it
+     */
+    void window::setMinRefreshRate(double hz) {
+        m_minRefreshInterval = hz > 0.0 ? 1.0 / hz : 0.0;
+    }
+
+    /**
+     * @brief Requests a redraw in idle mode. Safe to call from any thread
+     */
+    void window::markDirty() {
+        if (!m_dirty.exchange(true, std::memory_order_acq_rel) && m_idleMode && m_pWindow != nullptr)
+            glfwPostEmptyEvent();
+    }
+
+    /**
+     * @brief Skips recording, submitting and presenting the main viewport while its draw data stays the same as
+     * in the frame on screen. Frames with draw callbacks, like plots, and frames after markDirty(), new channel
+     * data or heatmap changes are always rendered. Textures changed by other means need a markDirty(). On by
+     * default, headless windows always render
+     */
+    void window::setFrameSkipping(bool enabled) {
+        m_frameSkipping = enabled;
+        m_presentedHash = 0;
+    }
+
+    /**
+     * @brief While animating, idle mode renders every frame as if it was disabled
+     */
+    void window::setAnimating(bool animating) {
+        m_animating = animating;
+    }
+
+    /**
+     * @brief Blocks until something needs to be drawn, the minimum refresh interval elapsed, an update
+     * callback with a rate or a swapchain rebuild held back by the resize debounce is due. Worker callbacks
+     * mark the window dirty when they finish
+     */
+    void window::waitForRedraw() {
+        using clock = std::chrono::steady_clock;
+        for (;;) {
+            if (m_animating || m_settleFrames > 0) {
+                m_idleStats.redraws++;
+                return;
+            }
+            if (m_dirty.load(std::memory_order_acquire)) {
+                m_idleStats.redraws++;
+                m_idleStats.dirtyRedraws++;
+                return;
+            }
+            if (hasPendingInput()) {
+                m_idleStats.redraws++;
+                m_idleStats.inputRedraws++;
+                return;
+            }
+
+            // A text field with keyboard focus needs its cursor to blink
+            double interval = m_minRefreshInterval;
+            if (ImGui::GetIO().WantTextInput)
+                interval = interval > 0.0 ? std::min(interval, 0.5) : 0.5;
+
+            bool timed = interval > 0.0;
+            double timeout = timed ? interval - std::chrono::duration<double>(clock::now() - m_lastRedraw).count()
+                                   : 0.0;
+            // Update callbacks with a rate need their frame once due, nothing else may wake the loop then
+            double scheduled = m_scheduler.timeUntilDue();
+            if (scheduled >= 0.0 && (!timed || scheduled < timeout)) {
+                timed = true;
+                timeout = scheduled;
+            }
+            if (timed && timeout <= 0.0) {
+                m_idleStats.redraws++;
+                m_idleStats.timeoutRedraws++;
+                return;
+            }
+            // A rebuild held back by the resize debounce needs a frame once it expired, no event may cause one
+            double debounce = m_viewports.pendingRebuild();
+            if (m_swapChainRebuild) {
+                double remaining = m_resizeDebounceMs / 1000.0 -
+                                   std::chrono::duration<double>(clock::now() - m_lastSwapchainResize).count();
+                if (remaining > 0.0 && (debounce < 0.0 || remaining < debounce))
+                    debounce = remaining;
+            }
+            const bool rebuild_pending = debounce > 0.0 && (!timed || debounce < timeout);
+            const auto rebuild_due = clock::now() + std::chrono::duration_cast<clock::duration>(
+                    std::chrono::duration<double>(debounce));
+            if (rebuild_pending) {
+                timed = true;
+                timeout = debounce;
+            }
+
+            if (timed)
+                glfwWaitEventsTimeout(timeout);
+            else
+                glfwWaitEvents();
+            m_idleStats.wakeups++;
+            if (glfwWindowShouldClose(m_pWindow))
+                return;
+            if (rebuild_pending && clock::now() >= rebuild_due) {
+                m_idleStats.redraws++;
+                m_idleStats.timeoutRedraws++;
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Whether the platform backends queued input for ImGui or a platform window wants to change
+     */
+    bool window::hasPendingInput() const {
+        if (GImGui->InputEventsQueue.Size > 0)
+            return true;
+        for (ImGuiViewport *viewport: ImGui::GetPlatformIO().Viewports) {
+            if (viewport->PlatformRequestMove || viewport->PlatformRequestResize || viewport->PlatformRequestClose)
+                return true;
+        }
+        return false;
+    }
+
+    void window::glfwFramebufferSizeCallback(GLFWwindow *pWindow, int, int) {
+        auto *self = static_cast<window *>(glfwGetWindowUserPointer(pWindow));
+        if (self != nullptr) {
+            // Not every platform reports a resized surface through the swapchain
+            self->m_swapChainRebuild = true;
+            self->markDirty();
+        }
+    }
+
+    void window::glfwWindowRefreshCallback(GLFWwindow *pWindow) {
+        auto *self = static_cast<window *>(glfwGetWindowUserPointer(pWindow));
+        if (self != nullptr)
+            self->markDirty();
+    }
+
+    void window::glfwWindowFocusCallback(GLFWwindow *pWindow, int focused) {
+        auto *self = static_cast<window *>(glfwGetWindowUserPointer(pWindow));
+        imgui_context_scope scope(self->m_imguiContext);
+        ImGui_ImplGlfw_WindowFocusCallback(pWindow, focused);
+    }
+
+    void window::glfwCursorEnterCallback(GLFWwindow *pWindow, int entered) {
+        auto *self = static_cast<window *>(glfwGetWindowUserPointer(pWindow));
+        imgui_context_scope scope(self->m_imguiContext);
+        ImGui_ImplGlfw_CursorEnterCallback(pWindow, entered);
+    }
+
+    void window::glfwCursorPosCallback(GLFWwindow *pWindow, double x, double y) {
+        auto *self = static_cast<window *>(glfwGetWindowUserPointer(pWindow));
+        imgui_context_scope scope(self->m_imguiContext);
+        ImGui_ImplGlfw_CursorPosCallback(pWindow, x, y);
+    }
+
+    void window::glfwMouseButtonCallback(GLFWwindow *pWindow, int button, int action, int mods) {
+        auto *self = static_cast<window *>(glfwGetWindowUserPointer(pWindow));
+        imgui_context_scope scope(self->m_imguiContext);
+        ImGui_ImplGlfw_MouseButtonCallback(pWindow, button, action, mods);
+    }
+
+    void window::glfwScrollCallback(GLFWwindow *pWindow, double xOffset, double yOffset) {
+        auto *self = static_cast<window *>(glfwGetWindowUserPointer(pWindow));
+        imgui_context_scope scope(self->m_imguiContext);
+        ImGui_ImplGlfw_ScrollCallback(pWindow, xOffset, yOffset);
+    }
+
+    void window::glfwKeyCallback(GLFWwindow *pWindow, int key, int scancode, int action, int mods) {
+        auto *self = static_cast<window *>(glfwGetWindowUserPointer(pWindow));
+        imgui_context_scope scope(self->m_imguiContext);
+        ImGui_ImplGlfw_KeyCallback(pWindow, key, scancode, action, mods);
+    }
+
+    void window::glfwCharCallback(GLFWwindow *pWindow, unsigned int c) {
+        auto *self = static_cast<window *>(glfwGetWindowUserPointer(pWindow));
+        imgui_context_scope scope(self->m_imguiContext);
+        ImGui_ImplGlfw_CharCallback(pWindow, c);
+    }
+
+    /**
+     * @brief Switches the presentation profile at runtime, rebuilding the swapchain if the present mode changes
+     */
+    void window::setPresentProfile(presentProfile profile) {
+        m_presentProfile = profile;
+        if (m_wd != nullptr && m_wd->Swapchain != VK_NULL_HANDLE)
+            m_swapChainRebuild = true;
+        markDirty();
+    }
+
+    /**
+     * @brief Caps the frame rate with a sleep based limiter, 0 removes the cap. Throughput ignores the cap
+     */
+    void window::setFrameRateCap(double fps) {
+        m_frameRateCap = fps > 0.0 ? fps : 0.0;
+    }
+
+    /**
+     * @brief Minimum number of swapchain images, fewer images mean less queued latency. How far the CPU may run
+     * ahead of the GPU is set independently with setFramesInFlight(). A change at runtime applies to the main
+     * window and the viewports of setParallelViewports(), platform windows created by the ImGui backend keep the
+     * count the window was created with
+     */
+    void window::setMinImageCount(int count) {
+        m_minImageCount = std::max(2, count);
+        if (m_wd != nullptr && m_wd->Swapchain != VK_NULL_HANDLE)
+            m_swapChainRebuild = true;
+    }
 
+    /**
+     * @brief Minimum time between two swapchain rebuilds, of the main and the platform windows. While a window
+     * is dragged larger or smaller, the sizes in between are coalesced into one rebuild per interval
+     */
+    void window::setResizeDebounce(double milliseconds) {
+        m_resizeDebounceMs = std::max(0.0, milliseconds);
+        m_viewports.setResizeDebounce(m_resizeDebounceMs);
+    }
 
+    /**
+     * @brief File the pipeline cache is loaded from and saved to, has to be set before create().
+     * Defaults to a file in the user's cache directory, an empty path keeps the cache in memory only
+     */
+    void window::setPipelineCachePath(const std::string &path) {
+        m_pipelineCachePath = path;
+    }
+
+    /**
+     * @brief Routes the host allocations of the Vulkan objects through hostMemory(), which pools small
+     * allocations and keeps statistics per allocation scope. On by default, has to be set before create()
+     */
+    void window::setHostAllocatorEnabled(bool enabled) {
+        m_hostMemoryEnabled = enabled;
+    }
+
+    /**
+     * @brief Enables VK_EXT_memory_budget when the driver has it, so memory() reports the budget and usage of
+     * every heap instead of only the engine's own allocations. On by default, has to be set before create() and
+     * only applies to the window that creates the shared device context
+     */
+    void window::setMemoryBudgetEnabled(bool enabled) {
+        m_memoryBudgetEnabled = enabled;
+    }
+
+    /**
+     * @brief Records the platform windows in parallel on a few workers and submits and presents them in one go,
+     * instead of one after another through ImGui::RenderPlatformWindowsDefault(). Both are timed as the
+     * renderPlatformWindows phase. Off by default, has to be set before create()
+     */
+    void window::setParallelViewports(bool enabled) {
+        m_parallelViewports = enabled;
+    }
+
+    /**
+     * @brief Lets ImGui windows be dragged out of the main window into platform windows of their own. Only one
+     * window per process gets them and the headless ones never do. On by default, has to be set before create()
+     */
+    void window::setPlatformWindowsEnabled(bool enabled) {
+        m_platformWindows = enabled;
+    }
+
+    /**
+     * @brief Draws the lists of another ImDrawData below this window's own ImGui windows, e.g. the frames of a
+     * remoteReceiver. The lists are used as they are, so their vertices have to be in the coordinates of the
+     * main viewport (origin at 0,0 without platform windows) and their texture ids have to be this window's.
+     * The draw data has to stay valid until the next call or the next updateFrame(), nullptr stops drawing it
+     */
+    void window::setExternalDrawData(const ImDrawData *drawData) {
+        m_externalDrawData = drawData;
+    }
+
+    /**
+     * @brief Records every frame from now on to a memory-mapped capture file: the draw data of the main viewport,
+     * the input events ImGui processed and the frame timing. Draw callbacks are left out and only the font
+     * atlas can be mapped to a texture again on replay. Usable once create() returned
+     * @return false if the file could not be created
+     */
+    bool window::startCapture(const std::string &path) {
+        ImGui::SetCurrentContext(m_imguiContext);
+        ImFontAtlas *fonts = ImGui::GetIO().Fonts;
+        m_captureStart = std::chrono::steady_clock::now();
+        return m_capture.open(path, fonts->TexID, (uint32_t) fonts->TexWidth, (uint32_t) fonts->TexHeight);
+    }
+
+    /**
+     * @brief Finishes the capture, writing its frame index
+     */
+    void window::stopCapture() {
+        m_capture.close();
+    }
+
+    // Prepends the external lists to the main viewport's, frame skipping and snapshots treat them like any other
+    void window::composeDrawData() {
+        const ImDrawData *external = m_externalDrawData;
+#if IMGUI_VERSION_NUM >= 18980
+        ImVector<ImDrawList *> &lists = m_composedDrawData.CmdLists;
+#else
+        ImVector<ImDrawList *> &lists = m_composedLists;
+#endif
+        lists.resize(0);
+        for (int n = 0; n < external->CmdListsCount; n++)
+            lists.push_back(external->CmdLists[n]);
+        for (int n = 0; n < m_mainDrawData->CmdListsCount; n++)
+            lists.push_back(m_mainDrawData->CmdLists[n]);
+
+        m_composedDrawData.Valid = true;
+        m_composedDrawData.CmdListsCount = lists.Size;
+        m_composedDrawData.TotalVtxCount = m_mainDrawData->TotalVtxCount + external->TotalVtxCount;
+        m_composedDrawData.TotalIdxCount = m_mainDrawData->TotalIdxCount + external->TotalIdxCount;
+#if IMGUI_VERSION_NUM < 18980
+        m_composedDrawData.CmdLists = lists.Data;
+#endif
+        m_composedDrawData.DisplayPos = m_mainDrawData->DisplayPos;
+        m_composedDrawData.DisplaySize = m_mainDrawData->DisplaySize;
+        m_composedDrawData.FramebufferScale = m_mainDrawData->FramebufferScale;
+        m_composedDrawData.OwnerViewport = m_mainDrawData->OwnerViewport;
+        m_mainDrawData = &m_composedDrawData;
+    }
+
+    /**
+     * @brief Time from sampling input (right after polling events) until the frame was submitted, in ms
+     */
+    timingStats window::inputLatencyStats() const {
+        size_t count = std::min(m_latencyCount, m_latencyHistory.size());
+        return computeTimingStats(std::vector<double>(m_latencyHistory.begin(), m_latencyHistory.begin() + (ptrdiff_t) count));
+    }
+
+    VkPresentModeKHR window::selectPresentMode() {
+        const VkPresentModeKHR throughput_modes[] = {VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR,
+                                                     VK_PRESENT_MODE_FIFO_KHR};
+        const VkPresentModeKHR power_saving_modes[] = {VK_PRESENT_MODE_FIFO_KHR};
+        // Mailbox replaces the queued image instead of waiting for vsync, FIFO_RELAXED tears instead of waiting
+        const VkPresentModeKHR low_latency_modes[] = {VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR,
+                                                      VK_PRESENT_MODE_FIFO_KHR};
+        switch (m_presentProfile) {
+            case presentProfile::throughput:
+                return ImGui_ImplVulkanH_SelectPresentMode(m_physicalDevice, m_wd->Surface, throughput_modes,
+                                                           IM_ARRAYSIZE(throughput_modes));
+            case presentProfile::lowLatency:
+                return ImGui_ImplVulkanH_SelectPresentMode(m_physicalDevice, m_wd->Surface, low_latency_modes,
+                                                           IM_ARRAYSIZE(low_latency_modes));
+            case presentProfile::powerSaving:
+            default:
+                return ImGui_ImplVulkanH_SelectPresentMode(m_physicalDevice, m_wd->Surface, power_saving_modes,
+                                                           IM_ARRAYSIZE(power_saving_modes));
+        }
+    }
+
+    /**
+     * @brief Sleeps until the next frame is due. Runs before input is polled, so the sleep does not add
+     * to the input latency. Low latency additionally waits for the previous frame to finish on the GPU
+     */
+    void window::limitFrameRate() {
+        using clock = std::chrono::steady_clock;
+        if (m_presentProfile == presentProfile::lowLatency) {
+            // Input is only sampled once the previous frame left the render thread and finished on the GPU
+            m_renderThread.waitIdle();
+            if (m_lastSubmitFence != VK_NULL_HANDLE) {
+                m_err = vkWaitForFences(m_device, 1, &m_lastSubmitFence, VK_TRUE, UINT64_MAX);
+                check_vk_result(m_err);
+            }
+        }
+
+        if (m_frameRateCap <= 0.0 || m_presentProfile == presentProfile::throughput)
+            return;
+        auto interval = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / m_frameRateCap));
+        auto now = clock::now();
+        if (m_nextFrameTime > now) {
+            if (m_presentProfile == presentProfile::lowLatency) {
+                // Sleep most of the way and spin the rest, oversleeping would delay the input sample
+                const auto spin = std::chrono::microseconds(500);
+                if (m_nextFrameTime - now > spin)
+                    std::this_thread::sleep_until(m_nextFrameTime - spin);
+                while (clock::now() < m_nextFrameTime) {}
+            } else {
+                std::this_thread::sleep_until(m_nextFrameTime);
+            }
+        }
+        // Keep a steady cadence, but do not try to catch up after a long frame
+        m_nextFrameTime = std::max(m_nextFrameTime, clock::now() - interval) + interval;
+    }
+
+    /**
+     * @brief Notes the submit time of the recorded frame, called from frameRender() on either thread
+     */
+    void window::recordSubmit() {
+        m_submitTime = std::chrono::steady_clock::now();
+        m_submitted = true;
+    }
+
+    /**
+     * @brief Adds the input latency of the last submitted frame to the history, while the render thread is idle
+     */
+    void window::collectSubmit() {
+        if (!m_submitted)
+            return;
+        m_submitted = false;
+        double latency = std::chrono::duration<double, std::milli>(m_submitTime - m_recordInputTime).count();
+        m_latencyHistory[m_latencyCount % m_latencyHistory.size()] = latency;
+        m_latencyCount++;
+    }
+
+    /**
+     * @brief Records and presents every frame on a render thread while the next one is built, which hides the
+     * command recording behind the next frame's update callback at the cost of one more frame in flight.
+     * Only takes effect for a window with a swapchain that is the only window of the process, since the ImGui
+     * backend records with the current ImGui context. The low latency profile waits for the render thread
+     * before sampling input and therefore gains nothing from it. Can be switched at any time
+     */
+    void window::setPipelined(bool enabled) {
+        m_pipelined = enabled;
+    }
+
+    /**
+     * @brief Starts or stops the render thread to match setPipelined() and the number of windows
+     */
+    void window::applyPipelining() {
+        bool pipelined = m_pipelined && !m_headless && imgui_contexts == 1;
+        if (pipelined == m_renderThread.running())
+            return;
+        if (pipelined) {
+            m_renderThread.start([this]() { renderPipelinedFrame(); });
+        } else {
+            m_renderThread.stop();
+            collectSubmit();
+        }
+
+        // The renderers keep a staging slot per frame in flight, the render thread adds one
+        {
+            std::lock_guard<std::mutex> lock(m_context->queueMutex());
+            m_err = vkDeviceWaitIdle(m_device);
+            check_vk_result(m_err);
+        }
+        m_plots.setFrameCount(rendererFrameCount());
+        m_heatmaps.setFrameCount(rendererFrameCount());
+    }
+
+    /**
+     * @brief Number of frames the CPU may run ahead of the GPU, 1 to 4, independent of the swapchain images.
+     * One gives the lowest latency, as every frame waits for the previous one to finish on the GPU, more keep the
+     * GPU busy. The fence wait of every frame shows up as the fenceWait phase of the profiler. Headless windows
+     * take the count at create(), windows with a swapchain switch at the start of the next frame
+     */
+    void window::setFramesInFlight(int count) {
+        m_framesInFlight = (uint32_t) std::clamp(count, 1, (int) frameRing::maxFramesInFlight);
+    }
+
+    /**
+     * @brief Rebuilds the frame contexts after setFramesInFlight(), waits for the device once
+     */
+    void window::applyFramesInFlight() {
+        if (m_headless || m_frameRing.size() == 0 || m_frameRing.size() == m_framesInFlight)
+            return;
+        // The contexts belong to the render thread while it records
+        m_renderThread.waitIdle();
+        {
+            std::lock_guard<std::mutex> lock(m_context->queueMutex());
+            m_err = vkDeviceWaitIdle(m_device);
+            check_vk_result(m_err);
+        }
+        m_frameRing.destroy();
+        m_frameRing.create(m_device, m_queueFamily, m_allocator, m_framesInFlight);
+        m_lastSubmitFence = VK_NULL_HANDLE;
+        m_plots.setFrameCount(rendererFrameCount());
+        m_heatmaps.setFrameCount(rendererFrameCount());
+    }
+
+    uint32_t window::rendererFrameCount() const {
+        uint32_t frames = m_headless ? m_offscreen.frameCount() : m_frameRing.size();
+        return m_renderThread.running() ? frames + 1 : frames;
+    }
+
+    /**
+     * @brief Hands the finished frame over to frameRender(), together with everything it reads from the main thread
+     */
+    void window::prepareRecording(ImDrawData *drawData) {
+        m_heatmaps.endFrame();
+        m_recordDrawData = drawData;
+        m_recordFrameNumber = m_frameCount;
+        m_recordInputTime = m_inputTime;
+        if (!m_headless)
+            m_wd->ClearValue = m_clearValue;
+    }
+
+    /**
+     * @brief Render thread job, records, submits and presents the frame handed over by updateFrame()
+     */
+    void window::renderPipelinedFrame() {
+        using clock = std::chrono::steady_clock;
+        auto start = clock::now();
+        frameRender();
+        auto rendered = clock::now();
+        framePresent();
+        m_profiler.addPhaseTime(m_recordFrameNumber, framePhase::frameRender,
+                                std::chrono::duration<double, std::milli>(rendered - start).count());
+        m_profiler.addPhaseTime(m_recordFrameNumber, framePhase::framePresent,
+                                std::chrono::duration<double, std::milli>(clock::now() - rendered).count());
+    }
+
+    /**
+     * @brief Turns the per-phase CPU timers and the render pass GPU timestamps on or off
+     */
+    void window::setProfilingEnabled(bool enabled) {
+        m_profiler.setEnabled(enabled);
+    }
+
+    /**
+     * @brief Shows the built-in profiler panel with per-phase percentiles
+     */
+    void window::showProfilerOverlay(bool show) {
+        m_showProfilerOverlay = show;
+    }
+
+    /**
+     * @brief Shows the built-in memory panel with usage and budget per heap, see memory()
+     */
+    void window::showMemoryPanel(bool show) {
+        m_showMemoryPanel = show;
+    }
+
+    /**
+     * @brief Shows the built-in log console, see console()
+     */
+    void window::showConsole(bool show) {
+        m_showConsole = show;
+    }
+
+    window::window(int width, int height) :
+            m_width(width), m_height(height), m_presentProfile(default_present_profile) {
+        m_pipelineCachePath = default_pipeline_cache_path();
+        m_resizeDebounceMs = default_resize_debounce_ms;
+        // A finished worker callback hands its result over in the next frame, idle mode has to render one
+        m_scheduler.setWakeCallback([this]() { markDirty(); });
     }
 
     /**
      * @brief Registers a callback that gets invoked every frame
-     * @param cb Pointer to callback function withing the user content gets created
+     * @param cb Pointer to callback function withing the user content gets created. Replaces the callback of
+     * an earlier call, it is the update callback named "update", see addUpdateCallback()
      */
     void window::registerOnUpdateCallback(const std::function<void()> &cb) {
 
         if (cb != nullptr) {
-            m_onUpdateCallback = cb;
+            m_scheduler.add("update", cb);
+        }
+
+    }
+
+    /**
+     * @brief Adds a named update callback, replacing one with the same name
+     * @param options Rate, priority and whether it runs on the worker pool, see frameScheduler. Without
+     * options it runs every frame like registerOnUpdateCallback()
+     */
+    void window::addUpdateCallback(const std::string &name, std::function<void()> cb,
+                                   const callbackOptions &options) {
+        if (cb != nullptr)
+            m_scheduler.add(name, std::move(cb), options);
+    }
+
+    /**
+     * @brief Removes a named update callback, a callback may remove itself
+     * @return false if there is no callback with that name
+     */
+    bool window::removeUpdateCallback(const std::string &name) {
+        return m_scheduler.remove(name);
+    }
+
+    /**
+     * @brief Main thread time per frame for callbacks with a rate, once spent they wait for a later frame.
+     * Callbacks without a rate are never skipped. 0 disables the budget
+     */
+    void window::setCallbackBudget(double milliseconds) {
+        m_scheduler.setBudget(milliseconds);
+    }
+
+    /**
+     * @brief Hands all samples pushed by worker threads since the last frame to their consumers
+     */
+    void window::drainChannels() {
+        for (auto &ch: m_channels) {
+            ch->drain();
         }
+    }
+
+    variableFeed &window::openVariableFeed(const std::string &name) {
+        if (variableFeed *feed = getVariableFeed(name))
+            return *feed;
+        m_variableFeeds.push_back(std::make_unique<variableFeed>(name));
+        return *m_variableFeeds.back();
+    }
 
+    variableFeed *window::getVariableFeed(const std::string &name) {
+        for (auto &feed: m_variableFeeds) {
+            if (feed->name() == name)
+                return feed.get();
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Copies the current values of all variable feeds, the update callback then sees consistent values
+     */
+    void window::snapshotVariableFeeds() {
+        for (auto &feed: m_variableFeeds) {
+            feed->snapshot();
+        }
     }
 
 
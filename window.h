@@ -5,17 +5,75 @@
 #ifndef TICTACTOE_WINDOW_H
 #define TICTACTOE_WINDOW_H
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 #include "vulkan/vulkan.h"
 #include "imgui_impl_vulkan.h"
 #include "GLFW/glfw3.h"
+#include "capture.h"
+#include "channel.h"
+#include "devicecontext.h"
+#include "framering.h"
+#include "heatmap.h"
+#include "logconsole.h"
+#include "memorytelemetry.h"
+#include "offscreen.h"
+#include "plot.h"
+#include "profiler.h"
+#include "renderthread.h"
+#include "scheduler.h"
+#include "swapchain.h"
+#include "upload.h"
+#include "variablefeed.h"
+#include "watch.h"
+#include "viewportrenderer.h"
 
 namespace engine {
 
 
+    /**
+     * @brief Counters to verify how often the idle mode actually redraws
+     */
+    struct idleStatistics {
+        uint64_t redraws = 0;        // Frames rendered while idle mode was on
+        uint64_t inputRedraws = 0;   // ... because of input, resize or platform window requests
+        uint64_t dirtyRedraws = 0;   // ... because of markDirty() or new channel data
+        uint64_t timeoutRedraws = 0; // ... because the minimum refresh interval elapsed
+        uint64_t wakeups = 0;        // Times the wait returned, including spurious wakeups
+    };
+
+    /**
+     * @brief Counters of the frame skipping, see window::setFrameSkipping()
+     */
+    struct frameSkipStatistics {
+        uint64_t hashedFrames = 0;   // Frames whose main viewport draw data was hashed
+        uint64_t skippedFrames = 0;  // ... and neither recorded nor presented, since nothing changed
+        uint64_t callbackFrames = 0; // ... and rendered anyway, draw callbacks may draw something new
+        uint64_t hashedBytes = 0;
+    };
+
+    /**
+     * @brief Presentation profiles selectable at runtime
+     */
+    enum class presentProfile {
+        throughput,  // Mailbox/immediate, never blocks on vsync
+        powerSaving, // FIFO (vsync) plus the optional frame rate cap
+        lowLatency   // Mailbox if available, waits for the GPU and the frame limiter before sampling input
+    };
+
     class window {
 
     public:
+        using readbackCallback = offscreenTarget::readbackCallback;
+
         explicit window(int width = 1024, int height = 768);
 
         [[nodiscard]] int create();
@@ -24,16 +82,215 @@ namespace engine {
 
         void update();
 
+        void updateFrame();
+
+        [[nodiscard]] bool shouldClose() const;
+
+        void requestClose();
+
         void registerOnUpdateCallback(const std::function<void()> &cb);
 
+        void addUpdateCallback(const std::string &name, std::function<void()> cb,
+                               const callbackOptions &options = {});
 
-    private:
+        bool removeUpdateCallback(const std::string &name);
 
-        void setupVulkan();
+        void setCallbackBudget(double milliseconds);
 
-        void setupVulkanWindow();
+        [[nodiscard]] frameScheduler &scheduler() { return m_scheduler; }
+
+        void setHeadless(bool headless, uint64_t frameLimit = 0);
+
+        [[nodiscard]] bool isHeadless() const { return m_headless; }
+
+        void requestReadback(const std::string &path = "");
+
+        void setReadbackCallback(const readbackCallback &cb);
+
+        [[nodiscard]] uint64_t frameCount() const { return m_frameCount; }
+
+        /**
+         * @brief Draw data of the main viewport from the last updateFrame(), valid until the next one
+         */
+        [[nodiscard]] const ImDrawData *drawData() const { return m_mainDrawData; }
+
+        void setProfilingEnabled(bool enabled);
+
+        void showProfilerOverlay(bool show);
+
+        /**
+         * @brief Built-in log console, any thread may append to it
+         */
+        [[nodiscard]] logConsole &console() { return m_console; }
+
+        void showConsole(bool show);
+
+        [[nodiscard]] frameProfiler &profiler() { return m_profiler; }
+
+        void setIdleMode(bool enabled);
+
+        void setMinRefreshRate(double hz);
+
+        void markDirty();
+
+        void setAnimating(bool animating);
+
+        [[nodiscard]] const idleStatistics &idleStats() const { return m_idleStats; }
+
+        void setFrameSkipping(bool enabled);
+
+        [[nodiscard]] bool isFrameSkipping() const { return m_frameSkipping; }
+
+        [[nodiscard]] const frameSkipStatistics &skipStats() const { return m_skipStats; }
+
+        void setPresentProfile(presentProfile profile);
+
+        [[nodiscard]] presentProfile getPresentProfile() const { return m_presentProfile; }
+
+        void setFrameRateCap(double fps);
+
+        void setMinImageCount(int count);
+
+        void setResizeDebounce(double milliseconds);
+
+        void setFramesInFlight(int count);
+
+        [[nodiscard]] uint32_t framesInFlight() const { return m_framesInFlight; }
+
+        [[nodiscard]] timingStats inputLatencyStats() const;
+
+        void setPipelined(bool enabled);
+
+        [[nodiscard]] bool isPipelined() const { return m_pipelined; }
+
+        /**
+         * @brief GPU plot renderer, series can be created once create() returned
+         */
+        [[nodiscard]] plotRenderer &plots() { return m_plots; }
+
+        /**
+         * @brief GPU colormapped heatmaps, shown with ImGui::Image(heatmap->textureId(), size).
+         * Heatmaps can be created once create() returned
+         */
+        [[nodiscard]] heatmapRenderer &heatmaps() { return m_heatmaps; }
+
+        /**
+         * @brief Non-blocking buffer and image uploads, usable once create() returned
+         */
+        [[nodiscard]] uploadManager &uploads() { return m_uploads; }
+
+        void setPipelineCachePath(const std::string &path);
+
+        void setHostAllocatorEnabled(bool enabled);
+
+        void setMemoryBudgetEnabled(bool enabled);
+
+        /**
+         * @brief Heap budgets and the engine's memory usage, sampled once per memoryTelemetry interval
+         */
+        [[nodiscard]] memoryTelemetry &memory() { return m_memory; }
+
+        void showMemoryPanel(bool show);
+
+        void setParallelViewports(bool enabled);
+
+        [[nodiscard]] bool parallelViewports() const { return m_parallelViewports; }
+
+        void setPlatformWindowsEnabled(bool enabled);
+
+        void setExternalDrawData(const ImDrawData *drawData);
 
-        void cleanupVulkan();
+        bool startCapture(const std::string &path);
+
+        void stopCapture();
+
+        [[nodiscard]] bool isCapturing() const { return m_capture.isOpen(); }
+
+        [[nodiscard]] const captureStatistics &captureStats() const { return m_capture.stats(); }
+
+        /**
+         * @brief Pooled allocator behind the Vulkan allocation callbacks, see setHostAllocatorEnabled().
+         * Usable once create() returned
+         */
+        [[nodiscard]] const hostAllocator &hostMemory() const { return m_context->hostMemory(); }
+
+        /**
+         * @brief Sub-allocator for buffers and images, usable once create() returned
+         */
+        [[nodiscard]] deviceAllocator &deviceMemory() { return m_context->deviceMemory(); }
+
+        /**
+         * @brief Device context shared with the other windows of the process, valid once create() returned
+         */
+        [[nodiscard]] const std::shared_ptr<deviceContext> &context() const { return m_context; }
+
+        /**
+         * @brief Creates a typed data channel that worker threads can push samples into without locking.
+         * The render loop drains every channel once per frame, right before the update callback runs.
+         * Channels must be created before the producing threads start and live as long as the window.
+         * @param name Unique name used to look the channel up again
+         * @param onDrain Invoked on the render thread with all samples that arrived since the last frame
+         * @param capacity Ring size, rounded up to the next power of two
+         * @param policy What happens to samples pushed while the ring is full
+         */
+        template<typename T>
+        channel<T> &createChannel(const std::string &name, typename channel<T>::drainCallback onDrain,
+                                  size_t capacity = 4096, overflowPolicy policy = overflowPolicy::dropOldest) {
+            auto ch = std::make_unique<channel<T>>(name, capacity, policy, std::move(onDrain));
+            ch->setNotify([this]() { markDirty(); });
+            channel<T> &ref = *ch;
+            m_channels.push_back(std::move(ch));
+            return ref;
+        }
+
+        /**
+         * @brief Looks up a channel created with createChannel
+         * @return nullptr if no channel with that name and sample type exists
+         */
+        template<typename T>
+        channel<T> *getChannel(const std::string &name) {
+            for (auto &ch: m_channels) {
+                if (ch->name() == name)
+                    return dynamic_cast<channel<T> *>(ch.get());
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief Subscribes to the variables another process publishes with varfeed.h. The feed's snapshot is
+         * taken once per frame, right before the update callback, and does not change while the callback runs.
+         * In idle mode new values show up with the minimum refresh rate, the writers cannot wake the window
+         * @param name Shared memory name like "/simulator", the feed does not have to exist yet
+         */
+        variableFeed &openVariableFeed(const std::string &name);
+
+        /**
+         * @return nullptr if the feed was not opened with openVariableFeed
+         */
+        variableFeed *getVariableFeed(const std::string &name);
+
+        /**
+         * @brief Shows a value in a panel, drawn after the update callback. Only read while it is on screen
+         * @param name "panel/label", see watchRegistry
+         * @param value Has to outlive the watch
+         */
+        template<typename T>
+        requires (!std::is_function_v<T>)
+        void watch(const std::string &name, const T *value) { m_watches.add(name, value); }
+
+        /**
+         * @brief Shows what getter returns in a panel, the getter is only invoked while the watch is on screen
+         */
+        template<typename Getter>
+        requires std::invocable<Getter &>
+        void watch(const std::string &name, Getter getter) { m_watches.add(name, std::move(getter)); }
+
+        [[nodiscard]] watchRegistry &watches() { return m_watches; }
+
+
+    private:
+
+        void setupVulkanWindow();
 
         void cleanupVulkanWindow();
 
@@ -41,32 +298,172 @@ namespace engine {
 
         void framePresent();
 
-        //Vulkan
-        VkAllocationCallbacks *m_allocator = nullptr;
+        void frameRenderOffscreen();
+
+        void onReadbackComplete(const uint8_t *rgba, uint32_t width, uint32_t height, uint64_t frameNumber);
+
+        void drainChannels();
+
+        void snapshotVariableFeeds();
+
+        void waitForRedraw();
+
+        VkPresentModeKHR selectPresentMode();
+
+        void limitFrameRate();
+
+        void recordSubmit();
+
+        void collectSubmit();
+
+        void applyPipelining();
+
+        void applyFramesInFlight();
+
+        [[nodiscard]] uint32_t rendererFrameCount() const;
+
+        void prepareRecording(ImDrawData *drawData);
+
+        void composeDrawData();
+
+        void renderPipelinedFrame();
+
+        [[nodiscard]] bool hasPendingInput() const;
+
+        static void glfwFramebufferSizeCallback(GLFWwindow *pWindow, int width, int height);
+
+        static void glfwWindowRefreshCallback(GLFWwindow *pWindow);
+
+        // ImGui's GLFW callbacks feed the current ImGui context, these route the events to the window's own
+        static void glfwWindowFocusCallback(GLFWwindow *pWindow, int focused);
+
+        static void glfwCursorEnterCallback(GLFWwindow *pWindow, int entered);
+
+        static void glfwCursorPosCallback(GLFWwindow *pWindow, double x, double y);
+
+        static void glfwMouseButtonCallback(GLFWwindow *pWindow, int button, int action, int mods);
+
+        static void glfwScrollCallback(GLFWwindow *pWindow, double xOffset, double yOffset);
+
+        static void glfwKeyCallback(GLFWwindow *pWindow, int key, int scancode, int action, int mods);
+
+        static void glfwCharCallback(GLFWwindow *pWindow, unsigned int c);
+
+        //Vulkan, the handles are copied from the shared context
+        std::shared_ptr<deviceContext> m_context;
+        bool m_hostMemoryEnabled = true;
+        bool m_memoryBudgetEnabled = true;
+        const VkAllocationCallbacks *m_allocator = nullptr;
         VkInstance m_instance = VK_NULL_HANDLE;
         VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
         VkDevice m_device = VK_NULL_HANDLE;
         uint32_t m_queueFamily = (uint32_t) -1;
         VkQueue m_queue = VK_NULL_HANDLE;
-        VkDebugReportCallbackEXT m_debugReport = VK_NULL_HANDLE;
-        VkPipelineCache m_pipelineCache = VK_NULL_HANDLE;
+        uint32_t m_transferQueueFamily = (uint32_t) -1;
+        VkQueue m_transferQueue = VK_NULL_HANDLE;
+        std::string m_pipelineCachePath;
         VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
         VkResult m_err = VK_NOT_READY;
+        uploadManager m_uploads;
         VkSurfaceKHR m_surface{};
 
         //GLFW3
         GLFWwindow *m_pWindow = nullptr;
 
         //ImGui
+        ImGuiContext *m_imguiContext = nullptr;
         ImGui_ImplVulkanH_Window m_mainWindowData;
         int m_minImageCount = 2;
-        bool m_swapChainRebuild = false;
+        std::atomic<bool> m_swapChainRebuild{false};
         ImGui_ImplVulkanH_Window *m_wd = nullptr;
+        bool m_imageAcquired = false;               // Acquired by frameRender(), not presented yet
+        deletionQueue m_retiredSwapchains;          // Tagged with frame number + 1, see frameRing::completedFrame()
+        deletionQueue m_retiredPresents;            // Keyed by m_acquireCount, then moved to m_retiredSwapchains
+        std::atomic<uint64_t> m_acquireCount{0};    // Images acquired from the main swapchain, by frameRender()
+        frameRing m_frameRing;
+        uint32_t m_framesInFlight = 2;
+        double m_resizeDebounceMs = 0.0;
+        std::chrono::steady_clock::time_point m_lastSwapchainResize;
         ImDrawData *m_mainDrawData = nullptr;
+        ImDrawData *m_recordDrawData = nullptr;     // What frameRender() records, m_mainDrawData or a snapshot
+        VkClearValue m_clearValue{};
+        plotRenderer m_plots;
+        heatmapRenderer m_heatmaps;
+        bool m_parallelViewports = false;
+        viewportRenderer m_viewports;
+        bool m_platformWindows = true;
+        const ImDrawData *m_externalDrawData = nullptr;
+        ImDrawData m_composedDrawData;              // External lists below the window's own, see composeDrawData()
+        ImVector<ImDrawList *> m_composedLists;     // Before ImGui 1.89.8, ImDrawData only points to its lists
+
+        //Headless
+        bool m_headless = false;
+        uint64_t m_headlessFrameLimit = 0;
+        offscreenTarget m_offscreen;
+        bool m_readbackRequested = false;
+        std::string m_readbackPath;
+        std::deque<std::pair<uint64_t, std::string>> m_readbackPaths;
+        readbackCallback m_onReadback = nullptr;
+        std::vector<std::future<void>> m_pendingWrites;
 
         //Interns
         int m_width, m_height;
-        std::function<void()> m_onUpdateCallback = nullptr;
+        frameScheduler m_scheduler;
+        std::vector<std::unique_ptr<channelBase>> m_channels;
+        std::vector<std::unique_ptr<variableFeed>> m_variableFeeds;
+        watchRegistry m_watches;
+        uint64_t m_frameCount = 0;
+        bool m_closeRequested = false;
+
+        //Idle rendering
+        bool m_idleMode = false;
+        double m_minRefreshInterval = 1.0;
+        std::atomic<bool> m_dirty{true};
+        bool m_animating = false;
+        int m_settleFrames = 0;
+        std::chrono::steady_clock::time_point m_lastRedraw;
+        idleStatistics m_idleStats;
+
+        //Capture
+        captureWriter m_capture;
+        std::chrono::steady_clock::time_point m_captureStart;
+
+        //Frame skipping
+        bool m_frameSkipping = true;
+        uint64_t m_presentedHash = 0;   // Draw data of the image on screen, 0 if unknown
+        uint64_t m_uploadsRetired = 0;  // uploadStatistics::batchesRetired seen by the last frame
+        frameSkipStatistics m_skipStats;
+
+        //Frame pacing
+        presentProfile m_presentProfile;
+        double m_frameRateCap = 0.0;
+        std::chrono::steady_clock::time_point m_nextFrameTime;
+        std::chrono::steady_clock::time_point m_inputTime;
+        VkFence m_lastSubmitFence = VK_NULL_HANDLE;
+        std::array<double, 256> m_latencyHistory{};
+        size_t m_latencyCount = 0;
+
+        //Render thread, everything below is handed over while it is idle
+        bool m_pipelined = false;
+        renderThread m_renderThread;
+        drawDataSnapshot m_snapshots[2];
+        uint32_t m_snapshotIndex = 0;
+        uint64_t m_recordFrameNumber = 0;
+        std::chrono::steady_clock::time_point m_recordInputTime;
+        std::chrono::steady_clock::time_point m_submitTime;
+        bool m_submitted = false;
+
+        //Profiling
+        frameProfiler m_profiler;
+        bool m_showProfilerOverlay = false;
+
+        //Console
+        logConsole m_console;
+        bool m_showConsole = false;
+
+        //Memory
+        memoryTelemetry m_memory;
+        bool m_showMemoryPanel = false;
 
 
     };